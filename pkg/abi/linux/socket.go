@@ -723,6 +723,13 @@ const SizeOfControlMessageTClass = 4
 // SizeOfControlMessageHopLimit is the size of an IPV6_HOPLIMIT control message.
 const SizeOfControlMessageHopLimit = 4
 
+// SizeOfControlMessageUDPSegment is the size of a UDP_SEGMENT control
+// message.
+const SizeOfControlMessageUDPSegment = 2
+
+// SizeOfControlMessageUDPGRO is the size of a UDP_GRO control message.
+const SizeOfControlMessageUDPGRO = 4
+
 // SizeOfControlMessageIPPacketInfo is the size of an IP_PKTINFO control
 // message.
 const SizeOfControlMessageIPPacketInfo = 12
@@ -0,0 +1,149 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package linux
+
+import (
+	"structs"
+)
+
+// Flags for userfaultfd(2), from include/uapi/linux/userfaultfd.h.
+const (
+	UFFD_USER_MODE_ONLY = 1
+)
+
+// UFFD_API is the userfaultfd API version, from
+// include/uapi/linux/userfaultfd.h.
+const UFFD_API = 0xAA
+
+// ioctl(2) request numbers for userfaultfds, from
+// include/uapi/linux/userfaultfd.h.
+const (
+	UFFDIO_API        = 0xc018aa3f // _IOWR(UFFDIO, _UFFDIO_API, struct uffdio_api)
+	UFFDIO_REGISTER   = 0xc020aa00 // _IOWR(UFFDIO, _UFFDIO_REGISTER, struct uffdio_register)
+	UFFDIO_UNREGISTER = 0x8010aa01 // _IOR(UFFDIO, _UFFDIO_UNREGISTER, struct uffdio_range)
+	UFFDIO_WAKE       = 0x8010aa02 // _IOR(UFFDIO, _UFFDIO_WAKE, struct uffdio_range)
+	UFFDIO_COPY       = 0xc028aa03 // _IOWR(UFFDIO, _UFFDIO_COPY, struct uffdio_copy)
+	UFFDIO_ZEROPAGE   = 0xc020aa04 // _IOWR(UFFDIO, _UFFDIO_ZEROPAGE, struct uffdio_zeropage)
+)
+
+// ioctl(2) numbers for userfaultfds, used in UffdioAPI.Ioctls and
+// UffdioRegister.Ioctls, from include/uapi/linux/userfaultfd.h.
+const (
+	UFFDIO_REGISTER_NR   = 0x00
+	UFFDIO_UNREGISTER_NR = 0x01
+	UFFDIO_WAKE_NR       = 0x02
+	UFFDIO_COPY_NR       = 0x03
+	UFFDIO_ZEROPAGE_NR   = 0x04
+	UFFDIO_API_NR        = 0x3f
+)
+
+// Modes for UFFDIO_REGISTER, from include/uapi/linux/userfaultfd.h.
+const (
+	UFFDIO_REGISTER_MODE_MISSING = 1 << 0
+	UFFDIO_REGISTER_MODE_WP      = 1 << 1
+	UFFDIO_REGISTER_MODE_MINOR   = 1 << 2
+)
+
+// Modes for UFFDIO_COPY and UFFDIO_ZEROPAGE, from
+// include/uapi/linux/userfaultfd.h.
+const (
+	UFFDIO_COPY_MODE_DONTWAKE     = 1 << 0
+	UFFDIO_COPY_MODE_WP           = 1 << 1
+	UFFDIO_ZEROPAGE_MODE_DONTWAKE = 1 << 0
+)
+
+// Userfaultfd events, from include/uapi/linux/userfaultfd.h.
+const (
+	UFFD_EVENT_PAGEFAULT = 0x12
+)
+
+// Flags for UFFD_EVENT_PAGEFAULT, from include/uapi/linux/userfaultfd.h.
+const (
+	UFFD_PAGEFAULT_FLAG_WRITE = 1 << 0
+	UFFD_PAGEFAULT_FLAG_WP    = 1 << 1
+	UFFD_PAGEFAULT_FLAG_MINOR = 1 << 2
+)
+
+// UffdioAPI is struct uffdio_api, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioAPI struct {
+	_        structs.HostLayout
+	API      uint64
+	Features uint64
+	Ioctls   uint64
+}
+
+// UffdioRange is struct uffdio_range, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioRange struct {
+	_     structs.HostLayout
+	Start uint64
+	Len   uint64
+}
+
+// UffdioRegister is struct uffdio_register, from
+// include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioRegister struct {
+	_      structs.HostLayout
+	Range  UffdioRange
+	Mode   uint64
+	Ioctls uint64
+}
+
+// UffdioCopy is struct uffdio_copy, from include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioCopy struct {
+	_    structs.HostLayout
+	Dst  uint64
+	Src  uint64
+	Len  uint64
+	Mode uint64
+	Copy int64
+}
+
+// UffdioZeropage is struct uffdio_zeropage, from
+// include/uapi/linux/userfaultfd.h.
+//
+// +marshal
+type UffdioZeropage struct {
+	_        structs.HostLayout
+	Range    UffdioRange
+	Mode     uint64
+	Zeropage int64
+}
+
+// UffdMsg is struct uffd_msg, from include/uapi/linux/userfaultfd.h, for
+// UFFD_EVENT_PAGEFAULT messages; the other events are not supported.
+//
+// +marshal slice:UffdMsgSlice
+type UffdMsg struct {
+	_       structs.HostLayout
+	Event   uint8
+	_       uint8
+	_       uint16
+	_       uint32
+	Flags   uint64
+	Address uint64
+	PTID    uint32
+	_       uint32
+}
+
+// SizeOfUffdMsg is the size of struct uffd_msg.
+const SizeOfUffdMsg = 32
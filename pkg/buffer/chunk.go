@@ -76,6 +76,14 @@ func getChunkPool(size int) *sync.Pool {
 type chunk struct {
 	chunkRefs
 	data []byte
+
+	// external indicates that data is owned by someone other than the chunk
+	// pools; see NewViewWithExternalData. External chunks are never written
+	// in place or returned to a pool.
+	external bool
+
+	// release is called when an external chunk is destroyed.
+	release func() `state:"nosave"`
 }
 
 func newChunk(size int) *chunk {
@@ -94,6 +102,14 @@ func newChunk(size int) *chunk {
 }
 
 func (c *chunk) destroy() {
+	if c.external {
+		if c.release != nil {
+			c.release()
+		}
+		c.data = nil
+		c.release = nil
+		return
+	}
 	if len(c.data) > MaxChunkSize {
 		c.data = nil
 		return
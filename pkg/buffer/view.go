@@ -83,6 +83,22 @@ func NewViewWithData(data []byte) *View {
 	return v
 }
 
+// NewViewWithExternalData creates a new view of data without copying it. data
+// is not owned by the view: release is called once the view and all of its
+// clones have been released, and data must remain valid until then. Writes
+// through the view never modify data; they copy it first.
+func NewViewWithExternalData(data []byte, release func()) *View {
+	c := &chunk{
+		data:     data,
+		external: true,
+		release:  release,
+	}
+	c.InitRefs()
+	v := viewPool.Get().(*View)
+	*v = View{chunk: c, write: len(data)}
+	return v
+}
+
 // Clone creates a shallow clone of v where the underlying chunk is shared.
 //
 // The caller must own the View to call Clone. It is not safe to call Clone
@@ -119,7 +135,7 @@ func (v *View) Reset() {
 }
 
 func (v *View) sharesChunk() bool {
-	return v.chunk.refCount.Load() > 1
+	return v.chunk.external || v.chunk.refCount.Load() > 1
 }
 
 // Full indicates the chunk is full.
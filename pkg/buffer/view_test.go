@@ -227,3 +227,34 @@ func TestReadFrom(t *testing.T) {
 		}
 	}
 }
+
+func TestExternalData(t *testing.T) {
+	data := []byte("external data")
+	want := append([]byte(nil), data...)
+	released := 0
+	v := NewViewWithExternalData(data, func() { released++ })
+	if !cmp.Equal(v.AsSlice(), want) {
+		t.Errorf("got v.AsSlice() = %v, want %v", v.AsSlice(), want)
+	}
+
+	clone := v.Clone()
+	v.Release()
+	if released != 0 {
+		t.Fatalf("release called with a live clone")
+	}
+
+	// Writes must copy rather than modify the external data.
+	if _, err := clone.WriteAt([]byte("E"), 0); err != nil {
+		t.Fatalf("clone.WriteAt: %v", err)
+	}
+	if !cmp.Equal(data, want) {
+		t.Errorf("external data modified: got %v, want %v", data, want)
+	}
+	if released != 1 {
+		t.Errorf("got %d release calls after copy-on-write, want 1", released)
+	}
+	clone.Release()
+	if released != 1 {
+		t.Errorf("got %d release calls, want 1", released)
+	}
+}
@@ -637,6 +637,25 @@ func (i *Inode) DataOffset() (uint64, error) {
 	return i.dataOff, nil
 }
 
+// AlignedData returns the offset within the image and the length of the
+// block-aligned part of the data of this inode. For the flat plain layout, this
+// is all of the data; for the flat inline layout, the tail of the data that is
+// stored inline with the inode is excluded.
+func (i *Inode) AlignedData() (uint64, uint64, error) {
+	switch dataLayout := i.DataLayout(); dataLayout {
+	case InodeDataLayoutFlatPlain:
+		return i.dataOff, i.size, nil
+
+	case InodeDataLayoutFlatInline:
+		idataSize := i.size & (uint64(i.image.BlockSize()) - 1)
+		return i.dataOff, i.size - idataSize, nil
+
+	default:
+		log.Warningf("Unsupported data layout 0x%x at inode (nid=%v)", dataLayout, i.Nid())
+		return 0, 0, linuxerr.ENOTSUP
+	}
+}
+
 // Data returns the read-only file data of this inode.
 func (i *Inode) Data() (safemem.BlockSeq, error) {
 	switch dataLayout := i.DataLayout(); dataLayout {
@@ -364,6 +364,34 @@ func (f *ClientFD) Walk(ctx context.Context, name string) (Inode, error) {
 	return inode[0], err
 }
 
+// WalkChildren makes the WalkChildren RPC. It returns an Inode for each of
+// names; the Inodes of children that could not be walked have an invalid
+// ControlFD.
+func (f *ClientFD) WalkChildren(ctx context.Context, names []string) ([]Inode, error) {
+	req := WalkReq{
+		DirFD: f.fd,
+		Path:  StringArray(names),
+	}
+
+	var resp WalkResp
+	ctx.UninterruptibleSleepStart()
+	err := f.client.SndRcvMessage(WalkChildren, uint32(req.SizeBytes()), req.MarshalBytes, resp.CheckedUnmarshal, nil, req.String, resp.String)
+	ctx.UninterruptibleSleepFinish()
+	if err != nil {
+		return nil, err
+	}
+	if len(resp.Inodes) != len(names) {
+		for i := range resp.Inodes {
+			if resp.Inodes[i].ControlFD.Ok() {
+				f.client.CloseFD(ctx, resp.Inodes[i].ControlFD, false /* flush */)
+			}
+		}
+		log.Warningf("requested to walk %d children, but got %d results", len(names), len(resp.Inodes))
+		return nil, unix.EIO
+	}
+	return resp.Inodes, nil
+}
+
 // WalkStat makes the WalkStat RPC with multiple path components to walk.
 func (f *ClientFD) WalkStat(ctx context.Context, names []string) ([]Statx, error) {
 	req := WalkReq{
@@ -81,6 +81,7 @@ var handlers = [...]RPCHandler{
 	Accept:           AcceptHandler,
 	ConnectWithCreds: ConnectWithCredsHandler,
 	RenameAt2:        RenameAt2Handler,
+	WalkChildren:     WalkChildrenHandler,
 }
 
 // ErrorHandler handles Error message.
@@ -370,6 +371,81 @@ func WalkHandler(c *Connection, comm Communicator, payloadLen uint32) (uint32, e
 	return uint32(payloadPos), nil
 }
 
+// WalkChildrenHandler handles the WalkChildren RPC.
+func WalkChildrenHandler(c *Connection, comm Communicator, payloadLen uint32) (uint32, error) {
+	var req WalkReq
+	if _, ok := req.CheckedUnmarshal(comm.PayloadBuf(payloadLen)); !ok {
+		return 0, unix.EIO
+	}
+
+	dir, err := c.lookupControlFD(req.DirFD)
+	if err != nil {
+		return 0, err
+	}
+	defer dir.DecRef(nil)
+	if !dir.IsDir() {
+		return 0, unix.ENOTDIR
+	}
+
+	// Manually marshal the inodes into the payload buffer, as in WalkHandler.
+	var (
+		numInodes primitive.Uint16
+		status    = WalkSuccess
+	)
+	respMetaSize := status.SizeBytes() + numInodes.SizeBytes()
+	maxPayloadSize := respMetaSize + (len(req.Path) * (*Inode)(nil).SizeBytes())
+	if maxPayloadSize > int(c.maxMessageSize) {
+		// Too much to walk, can't do.
+		return 0, unix.EIO
+	}
+	payloadBuf := comm.PayloadBuf(uint32(maxPayloadSize))
+	payloadPos := respMetaSize
+	if err := c.server.withRenameReadLock(func() error {
+		cu := cleanup.Make(func() {
+			// Destroy all newly created FDs until now. Read the new FDIDs from the
+			// payload buffer.
+			buf := comm.PayloadBuf(uint32(maxPayloadSize))[respMetaSize:]
+			var curIno Inode
+			for i := 0; i < int(numInodes); i++ {
+				buf = curIno.UnmarshalBytes(buf)
+				if curIno.ControlFD.Ok() {
+					c.removeControlFDLocked(curIno.ControlFD)
+				}
+			}
+		})
+		defer cu.Clean()
+
+		dir.node.opMu.RLock()
+		defer dir.node.opMu.RUnlock()
+		if dir.node.isDeleted() {
+			return unix.ENOENT
+		}
+		for _, name := range req.Path {
+			if err := checkSafeName(name); err != nil {
+				return err
+			}
+			// Children that can't be walked are reported with an invalid
+			// control FD, so that the client can look them up individually if
+			// it needs to.
+			var i Inode
+			if child, childStat, err := dir.impl.Walk(name); err == nil {
+				i = Inode{ControlFD: child.id, Stat: childStat}
+			}
+			i.MarshalUnsafe(payloadBuf[payloadPos:])
+			payloadPos += i.SizeBytes()
+			numInodes++
+		}
+		cu.Release()
+		return nil
+	}); err != nil {
+		return 0, err
+	}
+
+	payloadBuf = status.MarshalUnsafe(payloadBuf)
+	numInodes.MarshalUnsafe(payloadBuf)
+	return uint32(payloadPos), nil
+}
+
 // WalkStatHandler handles the WalkStat RPC.
 func WalkStatHandler(c *Connection, comm Communicator, payloadLen uint32) (uint32, error) {
 	var req WalkReq
@@ -179,6 +179,10 @@ const (
 
 	// RenameAt2 is loosely analogous to renameat2(2).
 	RenameAt2 MID = 33
+
+	// WalkChildren walks each of the specified names in the specified
+	// directory, rather than walking them as successive path components.
+	WalkChildren MID = 34
 )
 
 const (
@@ -483,7 +487,7 @@ func (s *SetStatResp) String() string {
 }
 
 // WalkReq is used to request to walk multiple path components at once. This
-// is used for both Walk and WalkStat.
+// is used for Walk, WalkStat and WalkChildren.
 type WalkReq struct {
 	DirFD FDID
 	Path  StringArray
@@ -553,7 +557,8 @@ func walkStatusToString(ws WalkStatus) string {
 }
 
 // WalkResp is used to communicate the inodes walked by the server. In memory,
-// the inode array is preceded by a uint16 integer denoting array length.
+// the inode array is preceded by a uint16 integer denoting array length. This
+// is used for both Walk and WalkChildren.
 type WalkResp struct {
 	Status WalkStatus
 	Inodes []Inode
@@ -76,6 +76,7 @@ var localFSTests = map[string]TestFunc{
 	"Symlink":         testSymlink,
 	"HardLink":        testHardLink,
 	"Walk":            testWalk,
+	"WalkChildren":    testWalkChildren,
 	"Rename":          testRename,
 	"Mknod":           testMknod,
 	"UDS":             testUDS,
@@ -560,6 +561,45 @@ func testWalk(ctx context.Context, t *testing.T, tester Tester, root lisafs.Clie
 	}
 }
 
+func testWalkChildren(ctx context.Context, t *testing.T, tester Tester, root lisafs.ClientFD) {
+	fileName, dirName := "file", "dir"
+	file, fileStat := mknod(ctx, t, root, fileName)
+	defer closeFD(ctx, t, file)
+	defer unlinkFile(ctx, t, root, fileName, false /* isDir */)
+	dir, dirStat := mkdir(ctx, t, root, dirName)
+	defer closeFD(ctx, t, dir)
+	defer unlinkFile(ctx, t, root, dirName, true /* isDir */)
+
+	inodes, err := root.WalkChildren(ctx, []string{dirName, "missing", fileName})
+	if err != nil {
+		t.Fatalf("WalkChildren failed: %v", err)
+	}
+	if len(inodes) != 3 {
+		t.Fatalf("WalkChildren returned the incorrect number of inodes: wanted 3, got %d", len(inodes))
+	}
+	for i := range inodes {
+		if inodes[i].ControlFD.Ok() {
+			defer closeFD(ctx, t, root.Client().NewFD(inodes[i].ControlFD))
+		}
+	}
+	if inodes[1].ControlFD.Ok() {
+		t.Errorf("WalkChildren returned a control FD for a child that does not exist")
+	}
+	for _, want := range []struct {
+		inode *lisafs.Inode
+		stat  *lisafs.Statx
+	}{
+		{&inodes[0], &dirStat},
+		{&inodes[2], &fileStat},
+	} {
+		if !want.inode.ControlFD.Ok() {
+			t.Errorf("WalkChildren did not return a control FD for an existing child")
+			continue
+		}
+		cmpStatx(t, *want.stat, want.inode.Stat)
+	}
+}
+
 func testRename(ctx context.Context, t *testing.T, tester Tester, root lisafs.ClientFD) {
 	name := "tempFile"
 	tempFile, _, fd, hostFD := openCreateFile(ctx, t, root, name)
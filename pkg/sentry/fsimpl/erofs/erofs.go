@@ -29,6 +29,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/checkpoint"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/sync"
 )
@@ -282,6 +283,19 @@ type inode struct {
 	// +checklocks:mapsMu
 	mappings memmap.MappingSet
 
+	// tailMu protects tail and tailMF.
+	tailMu sync.Mutex `state:"nosave"`
+
+	// If the inode represents a regular file whose last page(s) can't be
+	// mapped directly from the image, tail is a private copy of those pages
+	// allocated from tailMF. tail is allocated on the first Translate of the
+	// pages, and released when the inode is destroyed or invalidated for
+	// save.
+	// +checklocks:tailMu
+	tail memmap.FileRange `state:"nosave"`
+	// +checklocks:tailMu
+	tailMF *pgalloc.MemoryFile `state:"nosave"`
+
 	// locks supports POSIX and BSD style locks.
 	locks vfs.FileLocks
 
@@ -323,6 +337,7 @@ func (i *inode) DecRef(ctx context.Context) {
 	i.inodeRefs.DecRef(func() {
 		nid := i.Nid()
 		i.fs.inodeBucket(nid).removeInode(nid)
+		i.releaseTail()
 	})
 }
 
@@ -26,6 +26,8 @@ import (
 	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/usermem"
 )
@@ -173,19 +175,102 @@ func (i *inode) Translate(ctx context.Context, required, optional memmap.Mappabl
 		})
 		return nil, &memmap.BusError{linuxerr.EROFS}
 	}
-	offset, err := i.DataOffset()
+	off, n, err := i.AlignedData()
 	if err != nil {
 		return nil, &memmap.BusError{err}
 	}
-	mr := optional
-	return []memmap.Translation{
-		{
+	// Pages containing only block-aligned data are translated directly to the
+	// image file, so they are backed by the host page cache and shared with
+	// any other sandbox that uses the same image. Pages containing data stored
+	// inline with the inode, which is not page-aligned within the image, are
+	// translated to a private copy.
+	directEnd := pgend
+	if n != i.Size() {
+		directEnd = hostarch.PageRoundDown(n)
+	}
+	if !hostarch.IsPageAligned(off) {
+		directEnd = 0
+	}
+	var ts []memmap.Translation
+	if optional.Start < directEnd {
+		mr := memmap.MappableRange{Start: optional.Start, End: min(optional.End, directEnd)}
+		ts = append(ts, memmap.Translation{
 			Source: mr,
 			File:   &i.fs.mf,
-			Offset: mr.Start + offset,
+			Offset: mr.Start + off,
 			Perms:  hostarch.ReadExecute,
-		},
-	}, nil
+		})
+	}
+	if optional.End <= directEnd {
+		return ts, nil
+	}
+	tail, mf, err := i.getTail(ctx, directEnd, pgend)
+	if err != nil {
+		if required.End <= directEnd {
+			return ts, nil
+		}
+		return ts, &memmap.BusError{err}
+	}
+	mr := memmap.MappableRange{Start: max(optional.Start, directEnd), End: optional.End}
+	return append(ts, memmap.Translation{
+		Source: mr,
+		File:   mf,
+		Offset: tail.Start + (mr.Start - directEnd),
+		Perms:  hostarch.ReadExecute,
+	}), nil
+}
+
+// getTail returns a private copy of the file's data in [start, end), which must
+// be page-aligned and extend to the end of the file's last page, and the
+// memmap.File containing it.
+func (i *inode) getTail(ctx context.Context, start, end uint64) (memmap.FileRange, memmap.File, error) {
+	i.tailMu.Lock()
+	defer i.tailMu.Unlock()
+	if i.tailMF != nil {
+		return i.tail, i.tailMF, nil
+	}
+	mf := pgalloc.MemoryFileFromContext(ctx)
+	if mf == nil {
+		return memmap.FileRange{}, nil, linuxerr.ENOMEM
+	}
+	data, err := i.Data()
+	if err != nil {
+		return memmap.FileRange{}, nil, err
+	}
+	// Newly allocated memory is zeroed, so only the file's data needs to be
+	// copied.
+	fr, err := mf.Allocate(end-start, pgalloc.AllocOpts{
+		Kind:    usage.PageCache,
+		MemCgID: pgalloc.MemoryCgroupIDFromContext(ctx),
+		Mode:    pgalloc.AllocateAndWritePopulate,
+	})
+	if err != nil {
+		return memmap.FileRange{}, nil, err
+	}
+	ims, err := mf.MapInternal(fr, hostarch.Write)
+	if err == nil {
+		_, err = safemem.CopySeq(ims, data.DropFirst64(start))
+	}
+	if err != nil {
+		mf.DecRef(fr)
+		return memmap.FileRange{}, nil, err
+	}
+	i.tail = fr
+	i.tailMF = mf
+	return fr, mf, nil
+}
+
+// releaseTail releases the private copy of the file's last page(s), if any.
+// The caller must ensure that there are no translations of it that are not
+// otherwise referenced.
+func (i *inode) releaseTail() {
+	i.tailMu.Lock()
+	defer i.tailMu.Unlock()
+	if i.tailMF != nil {
+		i.tailMF.DecRef(i.tail)
+		i.tail = memmap.FileRange{}
+		i.tailMF = nil
+	}
 }
 
 var inodeTranslateWriteWarnOnce sync.Once
@@ -195,6 +280,9 @@ func (i *inode) InvalidateUnsavable(ctx context.Context) error {
 	i.mapsMu.Lock()
 	i.mappings.InvalidateAll(memmap.InvalidateOpts{})
 	i.mapsMu.Unlock()
+	// The private copy of the file's last page(s) is reallocated by Translate
+	// after restore.
+	i.releaseTail()
 	return nil
 }
 
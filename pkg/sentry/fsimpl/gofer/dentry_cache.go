@@ -0,0 +1,211 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package gofer
+
+import (
+	"hash/maphash"
+
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/sentry/fsmetric"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+)
+
+// An adaptive dentryCache starts with a capacity of maxCachedDentries, and
+// remembers (as "ghosts") the dentries that it has recently evicted. If a
+// significant fraction of cache misses are for ghosts, then the working set of
+// path resolution is larger than the cache, and the cache's capacity is
+// doubled. Conversely, if the sandbox is close to its memory limit, the cache's
+// capacity is halved, but never below maxCachedDentries.
+const (
+	// maxAdaptiveCachedDentries is the maximum capacity of an adaptive
+	// dentryCache.
+	maxAdaptiveCachedDentries = 1 << 18
+
+	// maxDentryCacheGhosts is the maximum number of ghosts remembered by an
+	// adaptive dentryCache.
+	maxDentryCacheGhosts = 1 << 16
+
+	// minDentryCacheResizeMisses is the minimum number of cache misses
+	// between adjustments to the capacity of an adaptive dentryCache. The
+	// actual period is also proportional to the capacity of the cache.
+	minDentryCacheResizeMisses = 256
+
+	// If the fraction of cache misses that are ghost hits is at least
+	// 1/dentryCacheGrowGhostRatio, an adaptive dentryCache grows.
+	dentryCacheGrowGhostRatio = 4
+
+	// If memory usage exceeds (1 - 1/dentryCachePressureRatio) of the
+	// sandbox's total memory, an adaptive dentryCache shrinks.
+	dentryCachePressureRatio = 8
+
+	// maxDentryCacheEvictionBatch is the maximum number of dentries evicted by
+	// a single call to filesystem.evictExcessCachedDentriesLocked().
+	maxDentryCacheEvictionBatch = 64
+)
+
+var dentryCacheGhostSeed = maphash.MakeSeed()
+
+// dentryCacheGhostKey returns the key identifying the child of parent with the
+// given name in dentryCacheGhosts.
+func dentryCacheGhostKey(parent *dentry, name string) uint64 {
+	k := &parent.inode.inoKey
+	h := maphash.String(dentryCacheGhostSeed, name)
+	return h ^ (k.ino * 0x9e3779b97f4a7c15) ^ (uint64(k.devMajor)<<32 | uint64(k.devMinor))
+}
+
+// dentryCacheGhosts is a bounded FIFO set of keys for recently evicted
+// dentries.
+type dentryCacheGhosts struct {
+	// ring holds keys in eviction order; next is the index of the oldest key
+	// once ring is full.
+	ring []uint64
+	next int
+	// set counts the occurrences of each key in ring.
+	set map[uint64]uint32
+}
+
+func (g *dentryCacheGhosts) add(key uint64, capacity int) {
+	if g.set == nil {
+		g.set = make(map[uint64]uint32)
+	}
+	if len(g.ring) < capacity {
+		g.ring = append(g.ring, key)
+	} else {
+		old := g.ring[g.next]
+		if n := g.set[old]; n > 1 {
+			g.set[old] = n - 1
+		} else {
+			delete(g.set, old)
+		}
+		g.ring[g.next] = key
+		g.next++
+		if g.next == len(g.ring) {
+			g.next = 0
+		}
+	}
+	g.set[key]++
+}
+
+func (g *dentryCacheGhosts) contains(key uint64) bool {
+	_, ok := g.set[key]
+	return ok
+}
+
+func (g *dentryCacheGhosts) reset() {
+	*g = dentryCacheGhosts{}
+}
+
+// addGhost records that the child of parent with the given name was evicted.
+func (c *dentryCache) addGhost(parent *dentry, name string) {
+	key := dentryCacheGhostKey(parent, name)
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.ghosts.add(key, int(min(c.limit, maxDentryCacheGhosts)))
+}
+
+// overLimit returns true if c holds more dentries than its capacity.
+func (c *dentryCache) overLimit() bool {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.dentriesLen > c.limit
+}
+
+// prefetchLimit returns the maximum number of dentries that may be added to c
+// by prefetching at once, which is half of its capacity so that prefetching
+// can't evict the entire working set.
+func (c *dentryCache) prefetchLimit() int {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return int(c.limit / 2)
+}
+
+// resizeLocked adjusts the capacity of an adaptive dentryCache given the
+// number of misses and ghost hits since it was last called, and whether the
+// sandbox is under memory pressure.
+//
+// Preconditions: c.mu must be locked.
+func (c *dentryCache) resizeLocked(misses, ghostHits uint64, pressure bool) {
+	switch {
+	case pressure:
+		if c.limit > c.maxCachedDentries {
+			c.limit = max(c.limit/2, c.maxCachedDentries)
+			c.ghosts.reset()
+		}
+	case ghostHits*dentryCacheGrowGhostRatio >= misses:
+		c.limit = min(max(c.limit*2, 1), maxAdaptiveCachedDentries)
+	}
+}
+
+// recordDentryCacheMiss is called when path resolution did not find the child
+// of parent with the given name in the dentry tree. If fs.dentryCache is
+// adaptive, it may change its capacity.
+func (fs *filesystem) recordDentryCacheMiss(parent *dentry, name string) {
+	fsmetric.GoferDentryCacheMisses.Increment()
+	c := fs.dentryCache
+	if !c.adaptive {
+		return
+	}
+	key := dentryCacheGhostKey(parent, name)
+	c.mu.Lock()
+	c.misses++
+	if c.ghosts.contains(key) {
+		c.ghostHits++
+	}
+	if c.misses < max(c.limit/8, minDentryCacheResizeMisses) {
+		c.mu.Unlock()
+		return
+	}
+	misses, ghostHits := c.misses, c.ghostHits
+	c.misses, c.ghostHits = 0, 0
+	c.mu.Unlock()
+
+	// Checking for memory pressure requires a syscall, so do it without
+	// holding c.mu.
+	pressure := fs.underMemoryPressure()
+	c.mu.Lock()
+	c.resizeLocked(misses, ghostHits, pressure)
+	c.mu.Unlock()
+}
+
+// underMemoryPressure returns true if the sandbox has a memory limit and is
+// close to it.
+func (fs *filesystem) underMemoryPressure() bool {
+	limit := usage.MaximumTotalMemoryBytes
+	if limit == 0 || fs.mf == nil {
+		return false
+	}
+	used, err := fs.mf.TotalUsage()
+	if err != nil {
+		return false
+	}
+	memStats, _ := usage.MemoryAccounting.Copy()
+	used += memStats.Mapped
+	return used >= limit-limit/dentryCachePressureRatio
+}
+
+// evictExcessCachedDentriesLocked evicts cached dentries until fs.dentryCache
+// is no longer over its capacity. At most maxDentryCacheEvictionBatch dentries
+// are evicted, so that shrinking a large cache is amortized across subsequent
+// calls.
+//
+// Preconditions:
+//   - fs.renameMu must be locked for writing; it may be temporarily unlocked.
+//
+// +checklocks:fs.renameMu
+func (fs *filesystem) evictExcessCachedDentriesLocked(ctx context.Context) {
+	for i := 0; i < maxDentryCacheEvictionBatch && fs.dentryCache.overLimit(); i++ {
+		fs.evictCachedDentryLocked(ctx)
+	}
+}
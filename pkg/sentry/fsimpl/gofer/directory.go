@@ -73,14 +73,29 @@ func (d *dentry) cacheNewChildLocked(child *dentry, name string) {
 //
 // +checklocks:d.childrenMu
 func (d *dentry) cacheNegativeLookupLocked(name string) {
-	// Don't cache negative lookups if InteropModeShared is in effect (since
-	// this makes remote lookup unavoidable), or if d.inode.isSynthetic() (in which
-	// case the only files in the directory are those for which a dentry exists
-	// in d.children). Instead, just delete any previously-cached dentry.
-	if d.inode.fs.opts.interop == InteropModeShared || d.inode.isSynthetic() {
+	// Don't cache negative lookups if d.inode.isSynthetic() (in which case the
+	// only files in the directory are those for which a dentry exists in
+	// d.children). Instead, just delete any previously-cached dentry.
+	if d.inode.isSynthetic() {
 		delete(d.children, name)
 		return
 	}
+	if d.inode.fs.opts.interop == InteropModeShared {
+		// Negative lookups are only valid while the directory's mtime is
+		// unchanged, which revalidation will detect. Since timestamps are
+		// coarse, a file created immediately after the directory's last
+		// modification may not change its mtime, so don't cache negative
+		// lookups in recently-modified directories.
+		mtime := d.inode.mtime.Load()
+		if d.inode.fs.clock.Now().Nanoseconds()-mtime < minNegativeChildrenMtimeAge {
+			delete(d.children, name)
+			return
+		}
+		if mtime != d.negativeChildrenMtime {
+			d.clearNegativeChildrenLocked()
+			d.negativeChildrenMtime = mtime
+		}
+	}
 	if d.children == nil {
 		d.children = make(map[string]*dentry)
 	}
@@ -107,6 +122,41 @@ func (d *dentry) cacheNegativeLookupLocked(name string) {
 	}
 }
 
+// minNegativeChildrenMtimeAge is the minimum time in nanoseconds since a
+// directory's last modification before negative lookups in that directory are
+// cached when InteropModeShared is in effect.
+const minNegativeChildrenMtimeAge = 1e9
+
+// revalidateNegativeChildrenLocked drops d's negative children if they may be
+// stale.
+//
+// Preconditions:
+//   - d.childrenMu must be locked.
+//   - d's metadata has been revalidated.
+//
+// +checklocks:d.childrenMu
+func (d *dentry) revalidateNegativeChildrenLocked() {
+	if d.negativeChildren != 0 && d.inode.fs.opts.interop == InteropModeShared && d.inode.mtime.Load() != d.negativeChildrenMtime {
+		d.clearNegativeChildrenLocked()
+	}
+}
+
+// clearNegativeChildrenLocked drops all of d's negative children.
+//
+// +checklocks:d.childrenMu
+func (d *dentry) clearNegativeChildrenLocked() {
+	if d.negativeChildren == 0 {
+		return
+	}
+	for name, child := range d.children {
+		if child == nil {
+			delete(d.children, name)
+		}
+	}
+	d.negativeChildren = 0
+	d.negativeChildrenCache = stringFixedCache{}
+}
+
 type createSyntheticOpts struct {
 	name string
 	mode linux.FileMode
@@ -230,8 +280,9 @@ func (d *dentry) getDirents(ctx context.Context) ([]vfs.Dirent, error) {
 
 	// filesystem.renameMu is needed for d.parent, and must be locked before
 	// d.opMu.
+	var ds *[]*dentry
 	d.inode.fs.renameMu.RLock()
-	defer d.inode.fs.renameMu.RUnlock()
+	defer d.inode.fs.renameMuRUnlockAndCheckCaching(ctx, &ds)
 	d.opMu.RLock()
 	defer d.opMu.RUnlock()
 
@@ -265,6 +316,16 @@ func (d *dentry) getDirents(ctx context.Context) ([]vfs.Dirent, error) {
 		},
 	}
 	var realChildren map[string]struct{}
+	// Uncached children of d are prefetched, so that walking them after
+	// reading d's entries (as in ls -l) doesn't need an RPC per child. This is
+	// unnecessary with directfs, where walks don't need RPCs, and pointless
+	// when InteropModeShared is in effect, since walks must revalidate cached
+	// dentries anyway.
+	var prefetch []string
+	prefetchLimit := 0
+	if _, ok := d.inode.impl.(*lisafsInode); ok && d.inode.fs.opts.interop != InteropModeShared {
+		prefetchLimit = d.inode.fs.dentryCache.prefetchLimit()
+	}
 	if !d.inode.isSynthetic() {
 		if d.syntheticChildren != 0 && d.inode.fs.opts.interop == InteropModeShared {
 			// Record the set of children d actually has so that we don't emit
@@ -288,11 +349,19 @@ func (d *dentry) getDirents(ctx context.Context) ([]vfs.Dirent, error) {
 			if realChildren != nil {
 				realChildren[name] = struct{}{}
 			}
+			if len(prefetch) < prefetchLimit {
+				if child := d.children[name]; child == nil { // +checklocksforce: d.childrenMu is locked above.
+					prefetch = append(prefetch, name)
+				}
+			}
 		})
 		d.inode.handleMu.RUnlock()
 		if err != nil {
 			return nil, err
 		}
+		if len(prefetch) != 0 {
+			d.inode.impl.(*lisafsInode).prefetchChildrenLocked(ctx, d, prefetch, &ds)
+		}
 	}
 
 	// Emit entries for synthetic children.
@@ -238,6 +238,7 @@ func (fs *filesystem) getChildLocked(ctx context.Context, parent *dentry, name s
 	if child, err := parent.getCachedChildLocked(name); child != nil || err != nil {
 		return child, err
 	}
+	fs.recordDentryCacheMiss(parent, name)
 	// We don't need to check for race here because parent.opMu is held for
 	// writing.
 	return fs.getRemoteChildLocked(ctx, parent, name, false /* checkForRace */, ds)
@@ -309,6 +310,7 @@ func (fs *filesystem) getChildAndWalkPathLocked(ctx context.Context, parent *den
 	if child, err := parent.getCachedChildLocked(rp.Component()); child != nil || err != nil {
 		return child, err
 	}
+	fs.recordDentryCacheMiss(parent, rp.Component())
 	// dentry.inode.getRemoteChildAndWalkPathLocked already handles dentry caching.
 	return parent.inode.getRemoteChildAndWalkPathLocked(ctx, rp, ds, parent)
 }
@@ -330,7 +332,11 @@ func (d *dentry) getCachedChildLocked(name string) (*dentry, error) {
 	}
 	d.childrenMu.Lock()
 	defer d.childrenMu.Unlock()
+	d.revalidateNegativeChildrenLocked()
 	if child, ok := d.children[name]; ok || d.inode.isSynthetic() {
+		if ok {
+			fsmetric.GoferDentryCacheHits.Increment()
+		}
 		if child == nil {
 			return nil, linuxerr.ENOENT
 		}
@@ -615,6 +621,7 @@ func (fs *filesystem) unlinkAt(ctx context.Context, rp *vfs.ResolvingPath, dir b
 	if parent.inode.mode.Load()&linux.ModeSticky == 0 {
 		var ok bool
 		parent.childrenMu.Lock()
+		parent.revalidateNegativeChildrenLocked()
 		child, ok = parent.children[name]
 		parent.childrenMu.Unlock()
 		if ok && child == nil {
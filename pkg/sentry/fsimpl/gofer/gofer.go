@@ -20,9 +20,9 @@
 //	regularFileFD/directoryFD.mu
 //	  filesystem.renameMu
 //	    dentry.cachingMu
-//	      dentryCache.mu
 //	      dentry.opMu
 //	        dentry.childrenMu
+//	        dentryCache.mu
 //	        filesystem.syncMu
 //	        dentry.metadataMu
 //	          *** "memmap.Mappable/MappingIdentity locks" below this point
@@ -39,6 +39,9 @@
 // Locking dentry.opMu and dentry.metadataMu in multiple dentries requires that
 // either ancestor dentries are locked before descendant dentries, or that
 // filesystem.renameMu is locked for writing.
+//
+// Locking dentry.handleMu in multiple inodes requires locking them in order of
+// increasing inode address; see rlockTwoHandles().
 package gofer
 
 import (
@@ -60,6 +63,7 @@ import (
 	"gvisor.dev/gvisor/pkg/refs"
 	"gvisor.dev/gvisor/pkg/sentry/checkpoint"
 	fslock "gvisor.dev/gvisor/pkg/sentry/fsimpl/lock"
+	"gvisor.dev/gvisor/pkg/sentry/fsmetric"
 	"gvisor.dev/gvisor/pkg/sentry/fsutil"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/pipe"
@@ -147,9 +151,14 @@ func (cache *stringFixedCache) add(name string) string {
 
 // +stateify savable
 type dentryCache struct {
-	// maxCachedDentries is the maximum number of cacheable dentries.
+	// maxCachedDentries is the maximum number of cacheable dentries if
+	// adaptive is false, and the minimum capacity of the cache otherwise.
 	// maxCachedDentries is immutable.
 	maxCachedDentries uint64
+	// If adaptive is true, the capacity of the cache is adjusted based on its
+	// miss rate and on memory pressure; see dentry_cache.go. adaptive is
+	// immutable.
+	adaptive bool
 	// mu protects the below fields.
 	mu sync.Mutex `state:"nosave"`
 	// dentries contains all dentries with 0 references. Due to race conditions,
@@ -157,6 +166,26 @@ type dentryCache struct {
 	dentries dentryList
 	// dentriesLen is the number of dentries in dentries.
 	dentriesLen uint64
+	// limit is the current capacity of the cache. If adaptive is false, limit
+	// is always maxCachedDentries. limit is not saved; it is reset to
+	// maxCachedDentries on restore.
+	limit uint64 `state:"nosave"`
+	// misses and ghostHits are the number of cache misses, and the number of
+	// misses for recently evicted dentries, since the cache's capacity was
+	// last reconsidered.
+	misses    uint64
+	ghostHits uint64
+	// ghosts remembers recently evicted dentries.
+	ghosts dentryCacheGhosts `state:"nosave"`
+}
+
+// newDentryCache returns a dentryCache with the given initial capacity.
+func newDentryCache(maxCachedDentries uint64, adaptive bool) *dentryCache {
+	return &dentryCache{
+		maxCachedDentries: maxCachedDentries,
+		adaptive:          adaptive,
+		limit:             maxCachedDentries,
+	}
 }
 
 // SetDentryCacheSize sets the size of the global gofer dentry cache.
@@ -168,7 +197,7 @@ func SetDentryCacheSize(size int) {
 		log.Warningf("Global dentry cache has already been initialized. Ignoring subsequent attempt.")
 		return
 	}
-	globalDentryCache = &dentryCache{maxCachedDentries: uint64(size)}
+	globalDentryCache = newDentryCache(uint64(size), false /* adaptive */)
 }
 
 // globalDentryCache is a global cache of dentries across all gofer clients.
@@ -301,6 +330,10 @@ type filesystemOptions struct {
 	// effective only if globalDentryCache is not being used.
 	dcache uint64
 
+	// If adaptiveDcache is true, the dentry cache may grow beyond dcache.
+	// adaptiveDcache is true unless the "dcache" mount option was given.
+	adaptiveDcache bool
+
 	// If forcePageCache is true, host FDs may not be used for application
 	// memory mappings even if available; instead, the client must perform its
 	// own caching of regular file pages. This is primarily useful for testing.
@@ -494,8 +527,10 @@ func (fstype FilesystemType) GetFilesystem(ctx context.Context, vfsObj *vfs.Virt
 
 	// Parse the dentry cache size.
 	fsopts.dcache = defaultMaxCachedDentries
+	fsopts.adaptiveDcache = true
 	if dcacheStr, ok := mopts[moptDcache]; ok {
 		delete(mopts, moptDcache)
+		fsopts.adaptiveDcache = false
 		dcache, err := strconv.ParseInt(dcacheStr, 10, 64)
 		if err != nil {
 			ctx.Warningf("gofer.FilesystemType.GetFilesystem: invalid dcache: %s=%s", moptDcache, dcacheStr)
@@ -602,7 +637,7 @@ func (fstype FilesystemType) GetFilesystem(ctx context.Context, vfsObj *vfs.Virt
 	if globalDentryCache != nil {
 		fs.dentryCache = globalDentryCache
 	} else {
-		fs.dentryCache = &dentryCache{maxCachedDentries: fsopts.dcache}
+		fs.dentryCache = newDentryCache(fsopts.dcache, fsopts.adaptiveDcache)
 	}
 
 	fs.vfsfs.Init(vfsObj, &fstype, fs)
@@ -945,6 +980,16 @@ type inode struct {
 	// tracks dirty segments in cache. dirty is protected by dataMu.
 	dirty fsutil.DirtySet
 
+	// writeBehind is the number of bytes written into cache by appending
+	// writes since they were last written back. writeBehind is protected by
+	// dataMu. See dentryReadWriter.WriteFromBlocks().
+	writeBehind uint64
+
+	// syncBatchMu protects syncing and nextSync. See inode.groupSync().
+	syncBatchMu sync.Mutex `state:"nosave"`
+	syncing     *syncBatch `state:"nosave"`
+	nextSync    *syncBatch `state:"nosave"`
+
 	// If this inode represents a deleted regular file, savedDeletedData is used
 	// to store file data for save/restore.
 	savedDeletedData []byte
@@ -1132,8 +1177,9 @@ type dentry struct {
 	//	- Mappings of child filenames to dentries representing those children.
 	//
 	//	- Mappings of child filenames that are known not to exist to nil
-	//		dentries (only if InteropModeShared is not in effect and the directory
-	//		is not synthetic).
+	//		dentries (only if the directory is not synthetic). If
+	//		InteropModeShared is in effect, these are only valid while the
+	//		directory's mtime is negativeChildrenMtime.
 	//
 	// +checklocks:childrenMu
 	children map[string]*dentry
@@ -1150,6 +1196,12 @@ type dentry struct {
 	//
 	// +checklocks:childrenMu
 	negativeChildren int `state:"nosave"`
+	// If this dentry represents a directory and InteropModeShared is in
+	// effect, negativeChildrenMtime is the value of inode.mtime when negative
+	// children were cached in dentry.children.
+	//
+	// +checklocks:childrenMu
+	negativeChildrenMtime int64 `state:"nosave"`
 
 	// If this dentry represents a directory, syntheticChildren is the number
 	// of child dentries for which dentry.isSynthetic() == true.
@@ -1762,18 +1814,18 @@ func (d *dentry) checkCachingLocked(ctx context.Context, renameMuWriteLocked boo
 	d.inode.fs.dentryCache.dentries.PushFront(&d.cacheEntry)
 	d.inode.fs.dentryCache.dentriesLen++
 	d.cached = true
-	shouldEvict := d.inode.fs.dentryCache.dentriesLen > d.inode.fs.dentryCache.maxCachedDentries
+	shouldEvict := d.inode.fs.dentryCache.dentriesLen > d.inode.fs.dentryCache.limit
 	d.inode.fs.dentryCache.mu.Unlock()
 	d.cachingMu.Unlock()
 
 	if shouldEvict {
 		if !renameMuWriteLocked {
 			// Need to lock d.inode.fs.renameMu for writing as needed by
-			// d.evictCachedDentryLocked().
+			// d.evictExcessCachedDentriesLocked().
 			d.inode.fs.renameMu.Lock()
 			defer d.inode.fs.renameMu.Unlock()
 		}
-		d.inode.fs.evictCachedDentryLocked(ctx) // +checklocksforce: see above.
+		d.inode.fs.evictExcessCachedDentriesLocked(ctx) // +checklocksforce: see above.
 	}
 }
 
@@ -1811,7 +1863,13 @@ func (fs *filesystem) evictCachedDentryLocked(ctx context.Context) {
 		return
 	}
 
+	fsmetric.GoferDentryCacheEvictions.Increment()
 	if victim.d.inode.fs == fs {
+		if fs.dentryCache.adaptive {
+			if parent := victim.d.parent.Load(); parent != nil {
+				fs.dentryCache.addGhost(parent, victim.d.name)
+			}
+		}
 		victim.d.evictLocked(ctx) // +checklocksforce: owned as precondition, victim.fs == fs
 		return
 	}
@@ -2228,6 +2286,9 @@ func (d *dentry) syncCachedFile(ctx context.Context, forFilesystemSync bool) err
 		d.inode.dataMu.Lock()
 		h := d.inode.writeHandle()
 		err := fsutil.SyncDirtyAll(ctx, &d.inode.cache, &d.inode.dirty, d.inode.size.Load(), d.inode.fs.mf, h.writeFromBlocksAt)
+		if err == nil {
+			d.inode.writeBehind = 0
+		}
 		d.inode.dataMu.Unlock()
 		if err != nil {
 			return err
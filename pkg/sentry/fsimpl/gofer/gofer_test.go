@@ -194,3 +194,65 @@ func TestXattrCacheList(t *testing.T) {
 		t.Errorf("getList() = (%v, %v), want (%v, true)", list, found, wantList)
 	}
 }
+
+func TestDentryCacheGhosts(t *testing.T) {
+	var g dentryCacheGhosts
+	for key := uint64(0); key < 4; key++ {
+		g.add(key, 3)
+	}
+	// Key 0 should have been displaced by key 3.
+	for key, want := range []bool{false, true, true, true} {
+		if got := g.contains(uint64(key)); got != want {
+			t.Errorf("g.contains(%d) = %v, want %v", key, got, want)
+		}
+	}
+	// Duplicate keys are counted.
+	g.add(1, 3)
+	g.add(1, 3)
+	if !g.contains(1) {
+		t.Errorf("g.contains(1) = false after re-adding it")
+	}
+	g.add(4, 3)
+	if !g.contains(1) {
+		t.Errorf("g.contains(1) = false, but it is still in the ring")
+	}
+	g.reset()
+	if g.contains(4) {
+		t.Errorf("g.contains(4) = true after reset")
+	}
+}
+
+func TestDentryCacheResize(t *testing.T) {
+	c := newDentryCache(1000, true /* adaptive */)
+
+	// Misses for dentries that were never cached shouldn't grow the cache.
+	c.resizeLocked(1000, 0, false /* pressure */)
+	if c.limit != 1000 {
+		t.Errorf("limit = %d after cold misses, want 1000", c.limit)
+	}
+
+	// Misses for recently evicted dentries should.
+	c.resizeLocked(1000, 500, false /* pressure */)
+	if c.limit != 2000 {
+		t.Errorf("limit = %d after ghost hits, want 2000", c.limit)
+	}
+	for i := 0; i < 20; i++ {
+		c.resizeLocked(1000, 1000, false /* pressure */)
+	}
+	if c.limit != maxAdaptiveCachedDentries {
+		t.Errorf("limit = %d, want maximum %d", c.limit, maxAdaptiveCachedDentries)
+	}
+
+	// Memory pressure should shrink the cache, regardless of ghost hits, but
+	// not below its initial capacity.
+	c.resizeLocked(1000, 1000, true /* pressure */)
+	if c.limit != maxAdaptiveCachedDentries/2 {
+		t.Errorf("limit = %d under pressure, want %d", c.limit, maxAdaptiveCachedDentries/2)
+	}
+	for i := 0; i < 20; i++ {
+		c.resizeLocked(1000, 1000, true /* pressure */)
+	}
+	if c.limit != 1000 {
+		t.Errorf("limit = %d under sustained pressure, want 1000", c.limit)
+	}
+}
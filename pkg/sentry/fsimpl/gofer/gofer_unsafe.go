@@ -0,0 +1,29 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package gofer
+
+import (
+	"unsafe"
+)
+
+// rlockTwoHandles read-locks x.handleMu and y.handleMu in order of increasing
+// inode address. x and y must be distinct.
+func rlockTwoHandles(x, y *inode) {
+	if uintptr(unsafe.Pointer(x)) > uintptr(unsafe.Pointer(y)) {
+		x, y = y, x
+	}
+	x.handleMu.RLock()
+	y.handleMu.RLock()
+}
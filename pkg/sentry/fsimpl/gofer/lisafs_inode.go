@@ -379,7 +379,7 @@ func (i *lisafsInode) getRemoteChildAndWalkPathLocked(ctx context.Context, rp re
 		return true
 	})
 	// Walk as much of the path as possible in 1 RPC.
-	_, inodes, err := i.controlFD.WalkMultiple(ctx, names)
+	status, inodes, err := i.controlFD.WalkMultiple(ctx, names)
 	if err != nil {
 		return nil, err
 	}
@@ -449,6 +449,19 @@ func (i *lisafsInode) getRemoteChildAndWalkPathLocked(ctx context.Context, rp re
 			ret = child
 		}
 	}
+	if status == lisafs.WalkComponentDoesNotExist && len(inodes) < len(names) && dentryCreationErr == nil && curParent.isDir() {
+		// The walk stopped at a component that does not exist. Cache this, so
+		// that stepping to it does not need another RPC. Since fs.renameMu is
+		// locked and a file is only created in curParent with curParent.opMu
+		// locked for writing, any child that was created after the walk is
+		// already cached.
+		name := names[len(inodes)]
+		curParentLock()
+		if _, ok := curParent.children[name]; !ok { // +checklocksforce: locked via curParentLock().
+			curParent.cacheNegativeLookupLocked(name) // +checklocksforce: locked via curParentLock().
+		}
+		curParentUnlock()
+	}
 	return ret, dentryCreationErr
 }
 
@@ -583,6 +596,54 @@ func (i *lisafsInode) getDirentsLocked(ctx context.Context, recordDirent func(na
 	}
 }
 
+// maxWalkChildrenBatch is the maximum number of children walked by each
+// WalkChildren RPC.
+const maxWalkChildrenBatch = 1024
+
+// prefetchChildrenLocked walks the children of d with the given names in bulk
+// and caches dentries for them, so that path resolution after reading d's
+// entries (e.g. by ls -l) doesn't need an RPC per child.
+//
+// Preconditions:
+//   - fs.renameMu must be locked.
+//   - d.opMu must be locked for reading.
+//   - d.childrenMu must be locked.
+//   - None of names are cached in d.children, except as negative entries.
+//
+// +checklocksread:d.opMu
+// +checklocks:d.childrenMu
+func (i *lisafsInode) prefetchChildrenLocked(ctx context.Context, d *dentry, names []string, ds **[]*dentry) {
+	if !i.fs.client.IsSupported(lisafs.WalkChildren) {
+		return
+	}
+	prefetched := false
+	for len(names) != 0 {
+		batch := names[:min(len(names), maxWalkChildrenBatch)]
+		names = names[len(batch):]
+		inodes, err := i.controlFD.WalkChildren(ctx, batch)
+		if err != nil {
+			// Prefetching is best-effort.
+			return
+		}
+		for j := range inodes {
+			if !inodes[j].ControlFD.Ok() {
+				continue
+			}
+			child, err := i.fs.newLisafsDentry(ctx, &inodes[j])
+			if err != nil {
+				continue
+			}
+			d.cacheNewChildLocked(child, batch[j])
+			// See appendNewChildDentry. d only needs to be checked once.
+			if !prefetched {
+				*ds = appendDentry(*ds, d)
+				prefetched = true
+			}
+			*ds = appendDentry(*ds, child)
+		}
+	}
+}
+
 func flush(ctx context.Context, fd lisafs.ClientFD) error {
 	if fd.Ok() {
 		return fd.Flush(ctx)
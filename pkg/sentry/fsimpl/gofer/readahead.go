@@ -0,0 +1,151 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package gofer
+
+import (
+	"math"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sync"
+)
+
+// When a read through the page cache misses, the cache is filled with up to
+// a readahead window's worth of data starting at the read. The window starts
+// at minReadahead, and doubles with each fill performed by a run of
+// sequential reads through the same file description, up to maxReadahead. A
+// non-sequential read resets the window.
+const (
+	// minReadahead is the initial readahead window, and the readahead window
+	// used for page faults.
+	minReadahead = 64 << 10
+
+	// maxReadahead is the maximum readahead window.
+	maxReadahead = 2 << 20
+
+	// maxWillNeed is the maximum number of bytes cached by each call to
+	// dentry.Readahead. Compare Linux's mm/readahead.c:force_page_cache_ra(),
+	// which similarly limits readahead to the device's maximum readahead
+	// window; data beyond it is read when it is accessed.
+	maxWillNeed = 4 * maxReadahead
+)
+
+// fileReadahead tracks the access pattern of reads through a regularFileFD.
+//
+// +stateify savable
+type fileReadahead struct {
+	mu sync.Mutex `state:"nosave"`
+
+	// advice is the last of POSIX_FADV_NORMAL, POSIX_FADV_RANDOM or
+	// POSIX_FADV_SEQUENTIAL applied to the file description.
+	advice int32
+
+	// prevEnd is the offset at which the last read is expected to end.
+	prevEnd int64
+
+	// window is the readahead window for the next cache fill. If window is
+	// 0, minReadahead is used.
+	window uint64
+}
+
+// access records a read of up to length bytes at offset.
+func (ra *fileReadahead) access(offset, length int64) {
+	ra.mu.Lock()
+	defer ra.mu.Unlock()
+	if offset != ra.prevEnd {
+		ra.window = 0
+	}
+	ra.prevEnd = offset + length
+}
+
+// fillWindow returns the readahead window for a cache fill performed by the
+// current read, and advances the window for the next one. ra may be nil, in
+// which case fillWindow returns minReadahead.
+func (ra *fileReadahead) fillWindow() uint64 {
+	if ra == nil {
+		return minReadahead
+	}
+	ra.mu.Lock()
+	defer ra.mu.Unlock()
+	switch ra.advice {
+	case linux.POSIX_FADV_RANDOM:
+		return 0
+	case linux.POSIX_FADV_SEQUENTIAL:
+		return maxReadahead
+	}
+	w := max(ra.window, minReadahead)
+	ra.window = min(w*2, maxReadahead)
+	return w
+}
+
+func (ra *fileReadahead) setAdvice(advice int32) {
+	ra.mu.Lock()
+	defer ra.mu.Unlock()
+	ra.advice = advice
+	ra.window = 0
+}
+
+// Fadvise implements vfs.Fadviser.Fadvise.
+func (fd *regularFileFD) Fadvise(ctx context.Context, offset, length int64, advice int32) error {
+	switch advice {
+	case linux.POSIX_FADV_NORMAL, linux.POSIX_FADV_RANDOM, linux.POSIX_FADV_SEQUENTIAL:
+		fd.ra.setAdvice(advice)
+	case linux.POSIX_FADV_WILLNEED:
+		// Reads that bypass the page cache can't benefit from readahead.
+		// Compare dentryReadWriter.ReadToBlocks().
+		d := fd.dentry()
+		if fd.vfsfd.StatusFlags()&linux.O_DIRECT != 0 || d.inode.fs.opts.interop == InteropModeShared {
+			return nil
+		}
+		mr := fadviseRange(offset, length)
+		t := kernel.TaskFromContext(ctx)
+		if t == nil {
+			d.Readahead(ctx, mr)
+			return nil
+		}
+		// As in Linux, read ahead without blocking the caller. Kernel.Pause
+		// waits for the read to complete, so it doesn't race with save.
+		d.IncRef()
+		t.QueueAIO(func(ctx context.Context) {
+			d.Readahead(ctx, mr)
+			d.DecRef(ctx)
+		})
+	case linux.POSIX_FADV_DONTNEED:
+		// Write back and drop cached data that is not memory-mapped, as is
+		// done for cache eviction.
+		mr := fadviseRange(offset, length)
+		fd.dentry().inode.Evict(ctx, pgalloc.EvictableRange{Start: mr.Start, End: mr.End})
+	}
+	return nil
+}
+
+// fadviseRange returns the page-aligned range of the file covered by a call
+// to Fadvise.
+func fadviseRange(offset, length int64) memmap.MappableRange {
+	mr := memmap.MappableRange{
+		Start: hostarch.PageRoundDown(uint64(offset)),
+		End:   math.MaxUint64,
+	}
+	if end := uint64(offset) + uint64(length); length != 0 && end > uint64(offset) {
+		if rend, ok := hostarch.PageRoundUp(end); ok {
+			mr.End = rend
+		}
+	}
+	return mr
+}
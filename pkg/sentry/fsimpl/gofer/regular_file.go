@@ -19,6 +19,7 @@ import (
 	"io"
 	"math"
 
+	"golang.org/x/sys/unix"
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
@@ -48,6 +49,9 @@ type regularFileFD struct {
 	// off is the file offset. off is protected by mu.
 	mu  sync.Mutex `state:"nosave"`
 	off int64
+
+	// ra tracks the access pattern of reads through fd.
+	ra fileReadahead
 }
 
 func newRegularFileFD(mnt *vfs.Mount, d *dentry, flags uint32, creds *auth.Credentials) (*regularFileFD, error) {
@@ -80,6 +84,11 @@ func (fd *regularFileFD) OnClose(ctx context.Context) error {
 	}
 	i := fd.dentry().inode
 	if i.fs.opts.interop == InteropModeExclusive {
+		// Write back cached appends, which would otherwise have reached the
+		// remote file before the writes returned.
+		if err := i.writeBackAppends(ctx); err != nil {
+			return err
+		}
 		// d may have dirty pages that we won't write back now (and wouldn't
 		// have in VFS1), making a flushf RPC ineffective. If this is the case,
 		// skip the flushf.
@@ -100,6 +109,10 @@ func (fd *regularFileFD) OnClose(ctx context.Context) error {
 
 // Allocate implements vfs.FileDescriptionImpl.Allocate.
 func (fd *regularFileFD) Allocate(ctx context.Context, mode, offset, length uint64) error {
+	// doAllocate always extends the file's size to cover the allocation.
+	if mode != 0 {
+		return linuxerr.EOPNOTSUPP
+	}
 	d := fd.dentry()
 	return d.doAllocate(ctx, offset, length, func() error {
 		return d.inode.allocate(ctx, mode, offset, length)
@@ -158,6 +171,8 @@ func (fd *regularFileFD) PRead(ctx context.Context, dst usermem.IOSequence, offs
 		}
 	} else {
 		rw := getDentryReadWriter(ctx, d, offset)
+		rw.ra = &fd.ra
+		fd.ra.access(offset, dst.NumBytes())
 		n, readErr = dst.CopyOutFrom(ctx, rw)
 		putDentryReadWriter(rw)
 		if d.inode.fs.opts.interop != InteropModeShared {
@@ -177,6 +192,122 @@ func (fd *regularFileFD) Read(ctx context.Context, dst usermem.IOSequence, opts
 	return n, err
 }
 
+// SplicePages implements vfs.SplicePageSource.SplicePages.
+func (fd *regularFileFD) SplicePages(ctx context.Context, offset, count int64, f vfs.SplicePagesFunc) (int64, error) {
+	if offset == -1 {
+		fd.mu.Lock()
+		n, err := fd.splicePages(ctx, fd.off, count, f)
+		fd.off += n
+		fd.mu.Unlock()
+		return n, err
+	}
+	return fd.splicePages(ctx, offset, count, f)
+}
+
+func (fd *regularFileFD) splicePages(ctx context.Context, offset, count int64, f vfs.SplicePagesFunc) (int64, error) {
+	if offset < 0 {
+		return 0, linuxerr.EINVAL
+	}
+	d := fd.dentry()
+	// Only data in the page cache can be referenced. Compare
+	// dentryReadWriter.ReadToBlocks().
+	if count <= 0 || fd.vfsfd.StatusFlags()&linux.O_DIRECT != 0 || d.inode.fs.opts.interop == InteropModeShared {
+		return 0, nil
+	}
+	d.inode.handleMu.RLock()
+	if d.inode.mmapFD.RacyLoad() >= 0 && !d.inode.fs.opts.forcePageCache {
+		d.inode.handleMu.RUnlock()
+		return 0, nil
+	}
+	fd.ra.access(offset, count)
+	h := d.inode.readHandle()
+	mf := d.inode.fs.mf
+	fillCache := mf.ShouldCacheEvictable()
+	if fillCache {
+		d.inode.dataMu.Lock()
+	} else {
+		d.inode.dataMu.RLock()
+	}
+
+	var (
+		done   uint64
+		err    error
+		filled bool
+	)
+	// Compute the range to splice (limited by file size and overflow-checked).
+	start := uint64(offset)
+	end := d.inode.size.Load()
+	if start >= end {
+		err = io.EOF
+	} else if rend := start + uint64(count); rend > start && rend < end {
+		end = rend
+	}
+	seg, gap := d.inode.cache.Find(start)
+	for err == nil && start+done < end {
+		cur := start + done
+		mr := memmap.MappableRange{cur, end}
+		if seg.Ok() {
+			fr := seg.FileRangeOf(seg.Range().Intersect(mr))
+			n := f(mf, fr)
+			done += n
+			if n < fr.Length() {
+				break
+			}
+			seg, gap = seg.NextNonEmpty()
+			continue
+		}
+		if !fillCache {
+			// Leave uncached data to be copied by the caller.
+			break
+		}
+		// Read into the cache, then re-enter the loop to reference the cache.
+		gapMR := gap.Range().Intersect(mr)
+		gapEnd, _ := hostarch.PageRoundUp(gapMR.End)
+		reqMR := memmap.MappableRange{
+			Start: hostarch.PageRoundDown(gapMR.Start),
+			End:   gapEnd,
+		}
+		optMR := gap.Range()
+		_, err = d.inode.cache.Fill(ctx, reqMR, maxFillRange(reqMR, optMR, fd.ra.fillWindow()), d.inode.size.Load(), mf, pgalloc.AllocOpts{
+			Kind:    usage.PageCache,
+			MemCgID: pgalloc.MemoryCgroupIDFromContext(ctx),
+			Mode:    pgalloc.AllocateAndWritePopulate,
+		}, h.readToBlocksAt)
+		filled = true
+		mf.MarkEvictable(d.inode, pgalloc.EvictableRange{Start: optMR.Start, End: optMR.End})
+		seg, gap = d.inode.cache.Find(cur)
+		if !seg.Ok() {
+			break
+		}
+		// As in dentryReadWriter.ReadToBlocks(), err may apply to a part of
+		// gap.Range() that we don't need.
+		err = nil
+	}
+
+	if fillCache {
+		d.inode.dataMu.Unlock()
+	} else {
+		d.inode.dataMu.RUnlock()
+	}
+	// Only count reads that went to the remote file, rather than being served
+	// entirely from the cache.
+	if filled {
+		if h.fd >= 0 {
+			fsmetric.GoferReadsHost.Increment()
+		} else {
+			fsmetric.GoferReads9P.Increment()
+		}
+	}
+	d.inode.handleMu.RUnlock()
+
+	if done == 0 {
+		return 0, err
+	}
+	// Compare Linux's mm/filemap.c:do_generic_file_read() => file_accessed().
+	d.touchAtime(fd.vfsfd.Mount())
+	return int64(done), nil
+}
+
 // PWrite implements vfs.FileDescriptionImpl.PWrite.
 func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, offset int64, opts vfs.WriteOptions) (int64, error) {
 	n, _, err := fd.pwrite(ctx, src, offset, opts)
@@ -233,7 +364,7 @@ func (fd *regularFileFD) pwrite(ctx context.Context, src usermem.IOSequence, off
 	defer putDentryReadWriter(rw)
 
 	if fd.vfsfd.StatusFlags()&linux.O_DIRECT != 0 {
-		if err := fd.writeCache(ctx, d, offset, src); err != nil {
+		if err := fd.writeCache(ctx, d, offset, src.NumBytes()); err != nil {
 			return 0, offset, err
 		}
 
@@ -265,30 +396,41 @@ func (fd *regularFileFD) pwrite(ctx context.Context, src usermem.IOSequence, off
 
 	// As with Linux, writing clears the setuid and setgid bits.
 	if n > 0 {
-		oldMode := d.inode.mode.Load()
-		// If setuid or setgid were set, update d.inode.mode and propagate
-		// changes to the host.
-		if newMode := vfs.ClearSUIDAndSGID(oldMode); newMode != oldMode {
-			if err := d.chmod(ctx, uint16(newMode)); err != nil {
-				return 0, offset, err
-			}
-			d.inode.mode.Store(newMode)
+		if err := d.killPrivLocked(ctx); err != nil {
+			return 0, offset, err
 		}
 	}
 
 	return n, offset + n, nil
 }
 
-func (fd *regularFileFD) writeCache(ctx context.Context, d *dentry, offset int64, src usermem.IOSequence) error {
+// killPrivLocked clears the file's setuid and setgid bits, as writing to it
+// does.
+//
+// Preconditions: d.inode.metadataMu must be locked.
+func (d *dentry) killPrivLocked(ctx context.Context) error {
+	oldMode := d.inode.mode.Load()
+	// If setuid or setgid were set, update d.inode.mode and propagate
+	// changes to the host.
+	if newMode := vfs.ClearSUIDAndSGID(oldMode); newMode != oldMode {
+		if err := d.chmod(ctx, uint16(newMode)); err != nil {
+			return err
+		}
+		d.inode.mode.Store(newMode)
+	}
+	return nil
+}
+
+func (fd *regularFileFD) writeCache(ctx context.Context, d *dentry, offset, size int64) error {
 	// Write dirty cached pages that will be touched by the write back to
 	// the remote file.
-	if err := d.writeback(ctx, offset, src.NumBytes()); err != nil {
+	if err := d.writeback(ctx, offset, size); err != nil {
 		return err
 	}
 
 	// Remove touched pages from the cache.
 	pgstart := hostarch.PageRoundDown(uint64(offset))
-	pgend, ok := hostarch.PageRoundUp(uint64(offset + src.NumBytes()))
+	pgend, ok := hostarch.PageRoundUp(uint64(offset + size))
 	if !ok {
 		return linuxerr.EINVAL
 	}
@@ -323,11 +465,96 @@ func (fd *regularFileFD) Write(ctx context.Context, src usermem.IOSequence, opts
 	return n, err
 }
 
+// CopyFileRangeFrom implements vfs.FileRangeCopier.CopyFileRangeFrom.
+//
+// If src is also a gofer file, and both files have host FDs, the data is
+// copied by the host's copy_file_range(2) without passing through the
+// sentry.
+func (fd *regularFileFD) CopyFileRangeFrom(ctx context.Context, src *vfs.FileDescription, srcOffset, dstOffset, count int64) (int64, error) {
+	srcFD, ok := src.Impl().(*regularFileFD)
+	if !ok || srcOffset < 0 || dstOffset < 0 || count <= 0 {
+		return 0, nil
+	}
+	srcD := srcFD.dentry()
+	d := fd.dentry()
+	if srcD.inode.readFD.Load() < 0 || d.inode.writeFD.Load() < 0 {
+		return 0, nil
+	}
+	count, err := vfs.CheckLimit(ctx, dstOffset, count)
+	if err != nil {
+		return 0, err
+	}
+
+	// The host copy bypasses the page cache. Write back cached data that will
+	// be copied, and drop cached data that will be overwritten. The source is
+	// written back before locking the destination's metadataMu, so that the
+	// destination isn't locked for the duration of the write-back.
+	if err := srcD.writeback(ctx, srcOffset, count); err != nil {
+		return 0, err
+	}
+
+	d.inode.metadataMu.Lock()
+	defer d.inode.metadataMu.Unlock()
+
+	if err := fd.writeCache(ctx, d, dstOffset, count); err != nil {
+		return 0, err
+	}
+
+	if srcD.inode != d.inode {
+		rlockTwoHandles(d.inode, srcD.inode)
+	} else {
+		d.inode.handleMu.RLock()
+	}
+	var done int64
+	for done < count {
+		srcOff := srcOffset + done
+		dstOff := dstOffset + done
+		var n int
+		n, err = unix.CopyFileRange(int(srcD.inode.readFD.RacyLoad()), &srcOff, int(d.inode.writeFD.RacyLoad()), &dstOff, int(count-done), 0 /* flags */)
+		if err == unix.EINTR {
+			continue
+		}
+		if n <= 0 {
+			break
+		}
+		done += int64(n)
+	}
+	if srcD.inode != d.inode {
+		srcD.inode.handleMu.RUnlock()
+	}
+	d.inode.handleMu.RUnlock()
+
+	if done == 0 {
+		switch err {
+		case unix.EXDEV, unix.EINVAL, unix.EOPNOTSUPP, unix.ENOSYS:
+			// The host can't copy between these files.
+			return 0, nil
+		}
+		return 0, err
+	}
+	d.inode.dataMu.Lock()
+	if end := uint64(dstOffset + done); end > d.inode.size.Load() {
+		d.inode.size.Store(end)
+	}
+	d.inode.dataMu.Unlock()
+	srcD.touchAtime(src.Mount())
+	if d.inode.fs.opts.interop != InteropModeShared {
+		d.touchCMtimeLocked()
+	}
+	if err := d.killPrivLocked(ctx); err != nil {
+		return done, err
+	}
+	return done, nil
+}
+
 type dentryReadWriter struct {
 	ctx    context.Context
 	d      *dentry
 	off    uint64
 	direct bool
+
+	// If ra is not nil, it sizes readahead for cache fills.
+	ra *fileReadahead
 }
 
 var dentryReadWriterPool = sync.Pool{
@@ -342,12 +569,14 @@ func getDentryReadWriter(ctx context.Context, d *dentry, offset int64) *dentryRe
 	rw.d = d
 	rw.off = uint64(offset)
 	rw.direct = false
+	rw.ra = nil
 	return rw
 }
 
 func putDentryReadWriter(rw *dentryReadWriter) {
 	rw.ctx = nil
 	rw.d = nil
+	rw.ra = nil
 	dentryReadWriterPool.Put(rw)
 }
 
@@ -429,7 +658,7 @@ func (rw *dentryReadWriter) ReadToBlocks(dsts safemem.BlockSeq) (uint64, error)
 					End:   gapEnd,
 				}
 				optMR := gap.Range()
-				_, err := rw.d.inode.cache.Fill(rw.ctx, reqMR, maxFillRange(reqMR, optMR), rw.d.inode.size.Load(), mf, pgalloc.AllocOpts{
+				_, err := rw.d.inode.cache.Fill(rw.ctx, reqMR, maxFillRange(reqMR, optMR, rw.ra.fillWindow()), rw.d.inode.size.Load(), mf, pgalloc.AllocOpts{
 					Kind:    usage.PageCache,
 					MemCgID: memCgID,
 					Mode:    pgalloc.AllocateAndWritePopulate,
@@ -505,8 +734,9 @@ func (rw *dentryReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, erro
 	}
 
 	var (
-		done   uint64
-		retErr error
+		done        uint64
+		retErr      error
+		wroteBehind bool
 	)
 	seg, gap := rw.d.inode.cache.Find(rw.off)
 	for rw.off < end {
@@ -536,11 +766,22 @@ func (rw *dentryReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64, erro
 			seg, gap = seg.NextNonEmpty()
 
 		case gap.Ok():
-			// Write directly to the file. At present, we never fill the cache
-			// when writing, since doing so can convert small writes into
-			// inefficient read-modify-write cycles, and we have no mechanism
-			// for detecting or avoiding this.
 			gapMR := gap.Range().Intersect(mr)
+			if rw.d.inode.canWriteBehind(gapMR) {
+				// Allocate cache pages for the write, then re-enter the loop
+				// to write to the cache. If no pages could be allocated at
+				// rw.off, write directly to the file instead.
+				rw.d.inode.fillWriteBehindLocked(rw.ctx, gapMR)
+				seg, gap = rw.d.inode.cache.Find(rw.off)
+				if seg.Ok() {
+					wroteBehind = true
+					continue
+				}
+			}
+			// Write directly to the file. Other than for appends (above), we
+			// never fill the cache when writing, since doing so can convert
+			// small writes into inefficient read-modify-write cycles, and we
+			// have no mechanism for detecting or avoiding this.
 			gapSrcs := srcs.TakeFirst64(gapMR.Length())
 			n, err := h.writeFromBlocksAt(rw.ctx, gapSrcs, gapMR.Start)
 			done += n
@@ -562,6 +803,9 @@ exitLoop:
 		// The remote file's size will implicitly be extended to the correct
 		// value when we write back to it.
 	}
+	if wroteBehind {
+		rw.d.inode.writeBehindDoneLocked(rw.ctx, done)
+	}
 	// If InteropModeWritethrough is in effect, flush written data back to the
 	// remote filesystem.
 	if rw.d.inode.fs.opts.interop == InteropModeWritethrough && done != 0 {
@@ -656,7 +900,10 @@ func regularFileSeekLocked(ctx context.Context, d *dentry, fdOffset, offset int6
 
 // Sync implements vfs.FileDescriptionImpl.Sync.
 func (fd *regularFileFD) Sync(ctx context.Context) error {
-	return fd.dentry().syncCachedFile(ctx, false /* forFilesystemSync */)
+	d := fd.dentry()
+	return d.inode.groupSync(ctx, func() error {
+		return d.syncCachedFile(ctx, false /* forFilesystemSync */)
+	})
 }
 
 // ConfigureMMap implements vfs.FileDescriptionImpl.ConfigureMMap.
@@ -746,7 +993,7 @@ func (d *dentry) Translate(ctx context.Context, required, optional memmap.Mappab
 	if d.inode.mmapFD.RacyLoad() >= 0 && !d.inode.fs.opts.forcePageCache {
 		mr := optional
 		if d.inode.fs.opts.limitHostFDTranslation {
-			mr = maxFillRange(required, optional)
+			mr = maxFillRange(required, optional, minReadahead)
 		}
 		return []memmap.Translation{
 			{
@@ -779,7 +1026,7 @@ func (d *dentry) Translate(ctx context.Context, required, optional memmap.Mappab
 
 	mf := d.inode.fs.mf
 	h := d.inode.readHandle()
-	_, cerr := d.inode.cache.Fill(ctx, required, maxFillRange(required, optional), d.inode.size.Load(), mf, pgalloc.AllocOpts{
+	_, cerr := d.inode.cache.Fill(ctx, required, maxFillRange(required, optional, minReadahead), d.inode.size.Load(), mf, pgalloc.AllocOpts{
 		Kind:    usage.PageCache,
 		MemCgID: memCgID,
 		Mode:    pgalloc.AllocateAndWritePopulate,
@@ -818,19 +1065,57 @@ func (d *dentry) Translate(ctx context.Context, required, optional memmap.Mappab
 	return ts, nil
 }
 
-func maxFillRange(required, optional memmap.MappableRange) memmap.MappableRange {
-	const maxReadahead = 64 << 10 // 64 KB, chosen arbitrarily
-	if required.Length() >= maxReadahead {
+// Readahead implements memmap.Readaheader.Readahead.
+func (d *dentry) Readahead(ctx context.Context, mr memmap.MappableRange) {
+	if mr.Length() > maxWillNeed {
+		mr.End = mr.Start + maxWillNeed
+	}
+	d.inode.handleMu.RLock()
+	defer d.inode.handleMu.RUnlock()
+	if d.inode.mmapFD.RacyLoad() >= 0 && !d.inode.fs.opts.forcePageCache {
+		// Mappings use the host's page cache, which does its own readahead.
+		return
+	}
+
+	d.inode.dataMu.Lock()
+	defer d.inode.dataMu.Unlock()
+	pgend, _ := hostarch.PageRoundUp(d.inode.size.Load())
+	if mr.End > pgend {
+		mr.End = pgend
+	}
+	if mr.Start >= mr.End {
+		return
+	}
+	// Unlike Translate, fill all of mr. Errors are returned by Translate if
+	// they recur when the data is accessed.
+	mf := d.inode.fs.mf
+	d.inode.cache.Fill(ctx, mr, mr, d.inode.size.Load(), mf, pgalloc.AllocOpts{
+		Kind:    usage.PageCache,
+		MemCgID: pgalloc.MemoryCgroupIDFromContext(ctx),
+		Mode:    pgalloc.AllocateAndWritePopulate,
+	}, d.inode.readHandle().readToBlocksAt)
+	if mf.ShouldCacheEvictable() {
+		// As in dentryReadWriter.ReadToBlocks(), data that was read ahead
+		// may be evicted if it isn't mapped.
+		mf.MarkEvictable(d.inode, pgalloc.EvictableRange{Start: mr.Start, End: mr.End})
+	}
+}
+
+// maxFillRange returns the range of the page cache to fill for a read of
+// required, given that optional may also be filled and that the fill should
+// span at most window bytes unless required is larger.
+func maxFillRange(required, optional memmap.MappableRange, window uint64) memmap.MappableRange {
+	if required.Length() >= window {
 		return required
 	}
-	if optional.Length() <= maxReadahead {
+	if optional.Length() <= window {
 		return optional
 	}
 	optional.Start = required.Start
-	if optional.Length() <= maxReadahead {
+	if optional.Length() <= window {
 		return optional
 	}
-	optional.End = optional.Start + maxReadahead
+	optional.End = optional.Start + window
 	return optional
 }
 
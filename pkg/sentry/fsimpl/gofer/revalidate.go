@@ -74,14 +74,13 @@ func (fs *filesystem) revalidateOne(ctx context.Context, vfsObj *vfs.VirtualFile
 	parent.childrenMu.Lock()
 	child, ok := parent.children[name]
 	parent.childrenMu.Unlock()
-	if !ok {
+	if !ok || child == nil {
+		// Negative children are revalidated against parent's mtime.
 		return nil
 	}
 
 	state := makeRevalidateState(parent, false /* refreshStart */)
 	defer state.release()
-	// Note that child can not be nil, because we don't cache negative entries
-	// when InteropModeShared is in effect.
 	state.add(child)
 	return state.doRevalidation(ctx, vfsObj, ds)
 }
@@ -142,7 +141,7 @@ done:
 // Preconditions:
 //   - fs.renameMu must be locked.
 //   - !rp.Done().
-//   - InteropModeShared is in effect (assumes no negative dentries).
+//   - InteropModeShared is in effect.
 func (fs *filesystem) revalidateStep(ctx context.Context, rp resolvingPath, d *dentry, state *revalidateState) (*dentry, error) {
 	switch name := rp.Component(); name {
 	case ".":
@@ -174,13 +173,13 @@ func (fs *filesystem) revalidateStep(ctx context.Context, rp resolvingPath, d *d
 		d.childrenMu.Lock()
 		child, ok := d.children[name]
 		d.childrenMu.Unlock()
-		if !ok {
-			// child is not cached, no need to validate any further.
+		if !ok || child == nil {
+			// child is not cached, no need to validate any further. If child is
+			// a negative entry, it is revalidated against the mtime of d, which
+			// is already in state.
 			return nil, errRevalidationStepDone{}
 		}
 
-		// Note that child can not be nil, because we don't cache negative entries
-		// when InteropModeShared is in effect.
 		state.add(child)
 
 		// Symlink must be resolved before continuing with revalidation.
@@ -280,12 +279,17 @@ func (d *dentry) disownAllChildrenForInvalidation(ctx context.Context, vfsObj *v
 	d.childrenMu.Lock()
 	defer d.childrenMu.Unlock()
 	for name, child := range d.children {
-		children = append(children, child)
 		delete(d.children, name)
+		if child == nil {
+			continue
+		}
+		children = append(children, child)
 		if child.inode.isSynthetic() {
 			child.deleteSynthetic(d, ds)
 		}
 	}
+	d.negativeChildren = 0
+	d.negativeChildrenCache = stringFixedCache{}
 	return children
 }
 
@@ -231,6 +231,11 @@ func (fs *filesystem) afterLoad(ctx goContext.Context) {
 	fs.mf = pgalloc.MemoryFileFromContext(ctx)
 }
 
+// afterLoad is invoked by stateify.
+func (c *dentryCache) afterLoad(goContext.Context) {
+	c.limit = c.maxCachedDentries
+}
+
 // afterLoad is invoked by stateify.
 func (i *inode) afterLoad(goContext.Context) {
 	i.readFD = atomicbitops.FromInt32(-1)
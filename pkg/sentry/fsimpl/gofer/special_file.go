@@ -199,6 +199,10 @@ func (fd *specialFileFD) Epollable() bool {
 
 func (fd *specialFileFD) Allocate(ctx context.Context, mode, offset, length uint64) error {
 	if fd.isRegularFile {
+		// doAllocate always extends the file's size to cover the allocation.
+		if mode != 0 {
+			return linuxerr.EOPNOTSUPP
+		}
 		d := fd.dentry()
 		return d.doAllocate(ctx, offset, length, func() error {
 			return fd.handle.allocate(ctx, mode, offset, length)
@@ -469,7 +473,7 @@ func (fd *specialFileFD) CopyMapping(ctx context.Context, ms memmap.MappingSpace
 func (fd *specialFileFD) Translate(ctx context.Context, required, optional memmap.MappableRange, at hostarch.AccessType) ([]memmap.Translation, error) {
 	mr := optional
 	if fd.filesystem().opts.limitHostFDTranslation {
-		mr = maxFillRange(required, optional)
+		mr = maxFillRange(required, optional, minReadahead)
 	}
 	return []memmap.Translation{
 		{
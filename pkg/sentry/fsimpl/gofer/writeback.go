@@ -0,0 +1,179 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package gofer
+
+import (
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/sentry/fsutil"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+)
+
+// Appending writes of less than maxWriteBehind bytes through the page cache
+// are written into the cache rather than to the remote file, so that runs of
+// small appends (as made by loggers and write-ahead logs) reach the remote
+// file as a few large writes. Cached appends are written back once
+// maxWriteBehind bytes have accumulated, when the file is synced or closed,
+// or when the cache is evicted.
+const maxWriteBehind = 1 << 20
+
+// canWriteBehind returns true if the write of mr, which lies in a gap in
+// i.cache, may be written into the cache rather than the remote file.
+//
+// Preconditions:
+//   - i.handleMu must be locked.
+//   - i.dataMu must be locked for writing.
+func (i *inode) canWriteBehind(mr memmap.MappableRange) bool {
+	if i.fs.opts.interop != InteropModeExclusive || mr.Length() >= maxWriteBehind || !i.fs.mf.ShouldCacheEvictable() {
+		return false
+	}
+	// Other than the page containing EOF, which is read from the remote file,
+	// the written pages must lie beyond EOF, so that filling them doesn't
+	// turn the write into a read-modify-write.
+	size := i.size.Load()
+	pgstart := hostarch.PageRoundDown(mr.Start)
+	if pgstart < hostarch.PageRoundDown(size) {
+		return false
+	}
+	return pgstart >= size || i.isReadHandleOk()
+}
+
+// fillWriteBehindLocked allocates cache pages for mr, in preparation for a
+// write into them. Errors are not returned, since the write can go directly
+// to the remote file instead.
+//
+// Preconditions: As for canWriteBehind, which must have returned true for mr.
+func (i *inode) fillWriteBehindLocked(ctx context.Context, mr memmap.MappableRange) {
+	pgend, _ := hostarch.PageRoundUp(mr.End)
+	fillMR := memmap.MappableRange{
+		Start: hostarch.PageRoundDown(mr.Start),
+		End:   pgend,
+	}
+	mf := i.fs.mf
+	opts := pgalloc.AllocOpts{
+		Kind:    usage.PageCache,
+		MemCgID: pgalloc.MemoryCgroupIDFromContext(ctx),
+		Mode:    pgalloc.AllocateAndWritePopulate,
+	}
+	size := i.size.Load()
+	if fillMR.Start < size {
+		// Read the existing part of the page containing EOF.
+		eofMR := memmap.MappableRange{
+			Start: fillMR.Start,
+			End:   fillMR.Start + hostarch.PageSize,
+		}
+		if _, err := i.cache.Fill(ctx, eofMR, eofMR, size, mf, opts, i.readHandle().readToBlocksAt); err != nil {
+			return
+		}
+	}
+	// The remaining pages are beyond EOF, so they are zero-filled.
+	i.cache.Fill(ctx, fillMR, fillMR, size, mf, opts, nil)
+	// Eviction writes back dirty pages before dropping them.
+	mf.MarkEvictable(i, pgalloc.EvictableRange{Start: fillMR.Start, End: fillMR.End})
+}
+
+// writeBehindDoneLocked is called after n bytes are written into the cache by
+// appending writes. If enough cached appends have accumulated, it writes back
+// the file's dirty pages. i.writeBehind is only reset once write-back
+// succeeds, so that a failed write-back is retried, and its error reported,
+// when the file is synced or closed.
+//
+// Preconditions:
+//   - i.handleMu must be locked.
+//   - i.dataMu must be locked for writing.
+func (i *inode) writeBehindDoneLocked(ctx context.Context, n uint64) {
+	i.writeBehind += n
+	if i.writeBehind < maxWriteBehind {
+		return
+	}
+	h := i.writeHandle()
+	if err := fsutil.SyncDirtyAll(ctx, &i.cache, &i.dirty, i.size.Load(), i.fs.mf, h.writeFromBlocksAt); err != nil {
+		ctx.Debugf("gofer.inode.writeBehindDoneLocked: failed to write back cached appends: %v", err)
+		return
+	}
+	i.writeBehind = 0
+}
+
+// writeBackAppends writes back the file's dirty pages if they include cached
+// appends.
+func (i *inode) writeBackAppends(ctx context.Context) error {
+	i.handleMu.RLock()
+	defer i.handleMu.RUnlock()
+	i.dataMu.Lock()
+	defer i.dataMu.Unlock()
+	if i.writeBehind == 0 {
+		return nil
+	}
+	h := i.writeHandle()
+	if err := fsutil.SyncDirtyAll(ctx, &i.cache, &i.dirty, i.size.Load(), i.fs.mf, h.writeFromBlocksAt); err != nil {
+		return err
+	}
+	i.writeBehind = 0
+	return nil
+}
+
+// A syncBatch is a sync of a file that is shared by every caller of
+// inode.groupSync() that arrived while the previous sync was in progress.
+type syncBatch struct {
+	// done is closed when the sync is complete.
+	done chan struct{}
+
+	// err is the result of the sync. err is immutable once done is closed.
+	err error
+}
+
+// groupSync calls sync, or waits for a call to sync by a concurrent caller of
+// groupSync that starts after groupSync is called, and returns its result.
+// This allows concurrent fsyncs of the same file, as made by databases with
+// many writers, to share remote syncs.
+func (i *inode) groupSync(ctx context.Context, sync func() error) error {
+	i.syncBatchMu.Lock()
+	if i.syncing == nil {
+		b := &syncBatch{done: make(chan struct{})}
+		i.syncing = b
+		i.syncBatchMu.Unlock()
+		return i.runSyncBatch(b, sync)
+	}
+	// The sync in progress may have started before our caller's writes, so
+	// join the batch that will run after it.
+	if b := i.nextSync; b != nil {
+		i.syncBatchMu.Unlock()
+		ctx.UninterruptibleSleepStart()
+		<-b.done
+		ctx.UninterruptibleSleepFinish()
+		return b.err
+	}
+	b := &syncBatch{done: make(chan struct{})}
+	i.nextSync = b
+	prev := i.syncing
+	i.syncBatchMu.Unlock()
+	// prev's runner makes b the sync in progress before closing prev.done.
+	ctx.UninterruptibleSleepStart()
+	<-prev.done
+	ctx.UninterruptibleSleepFinish()
+	return i.runSyncBatch(b, sync)
+}
+
+func (i *inode) runSyncBatch(b *syncBatch, sync func() error) error {
+	b.err = sync()
+	i.syncBatchMu.Lock()
+	i.syncing = i.nextSync
+	i.nextSync = nil
+	i.syncBatchMu.Unlock()
+	close(b.done)
+	return b.err
+}
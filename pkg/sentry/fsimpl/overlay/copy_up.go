@@ -16,8 +16,10 @@ package overlay
 
 import (
 	"fmt"
+	"io"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/atomicbitops"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
 	"gvisor.dev/gvisor/pkg/fspath"
@@ -25,6 +27,8 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/sync"
+	"gvisor.dev/gvisor/pkg/usermem"
 )
 
 func (d *dentry) isCopiedUp() bool {
@@ -60,6 +64,11 @@ func (d *dentry) copyUpMaybeSyntheticMountpointLocked(ctx context.Context, forSy
 		return nil
 	}
 
+	// If ctx can create contexts for other goroutines, regular file data may
+	// be copied by multiple goroutines. This must be checked before ctx is
+	// wrapped below.
+	ac, _ := ctx.(asyncContexter)
+
 	// Attach our credentials to the context, as some VFS operations use
 	// credentials from context rather an take an explicit creds parameter.
 	ctx = auth.ContextWithCredentials(ctx, d.fs.creds)
@@ -145,7 +154,7 @@ func (d *dentry) copyUpMaybeSyntheticMountpointLocked(ctx context.Context, forSy
 			return err
 		}
 		defer newFD.DecRef(ctx)
-		if _, err := vfs.CopyRegularFileData(ctx, newFD, oldFD); err != nil {
+		if err := d.copyUpRegularFileDataLocked(ctx, ac, newFD, oldFD); err != nil {
 			cleanupUndoCopyUp()
 			return err
 		}
@@ -174,7 +183,7 @@ func (d *dentry) copyUpMaybeSyntheticMountpointLocked(ctx context.Context, forSy
 				GID:   d.gid.RacyLoad(),
 				Atime: oldStat.Atime,
 				Mtime: oldStat.Mtime,
-				// Mode is specified again because the vfs.CopyRegularFileData() clears the setid bits.
+				// Mode is specified again because writing file data clears the setid bits.
 				Mode: uint16(d.mode.RacyLoad() &^ linux.S_IFMT),
 			},
 		}); err != nil {
@@ -371,6 +380,180 @@ func (d *dentry) copyUpMaybeSyntheticMountpointLocked(ctx context.Context, forSy
 	return nil
 }
 
+const (
+	// copyUpChunkSize is the maximum number of bytes of regular file data
+	// copied by a single unit of work during copy-up.
+	copyUpChunkSize = 1 << 20
+
+	// maxCopyUpWorkers is the maximum number of goroutines that copy regular
+	// file data concurrently during copy-up.
+	maxCopyUpWorkers = 4
+)
+
+// asyncContexter is implemented by contexts that can create a context.Context
+// for use by goroutines acting on their behalf, i.e. kernel.Task.
+type asyncContexter interface {
+	AsyncContext() context.Context
+}
+
+// copyUpRegularFileDataLocked copies the data of the lower layer file
+// represented by oldFD to the empty upper layer file represented by newFD.
+// Regions of oldFD that SEEK_DATA and SEEK_HOLE report as holes are left as
+// holes in newFD rather than copied. If ac is not nil, data is copied by up to
+// maxCopyUpWorkers goroutines.
+//
+// Preconditions: d.copyMu must be locked.
+func (d *dentry) copyUpRegularFileDataLocked(ctx context.Context, ac asyncContexter, newFD, oldFD *vfs.FileDescription) error {
+	stat, err := oldFD.Stat(ctx, vfs.StatOptions{Mask: linux.STATX_SIZE})
+	if err != nil {
+		return err
+	}
+	size := int64(stat.Size)
+	if size == 0 {
+		return nil
+	}
+	// Extend newFD to its final size first, so that regions that aren't
+	// copied below are holes.
+	if err := newFD.SetStat(ctx, vfs.SetStatOptions{
+		Stat: linux.Statx{
+			Mask: linux.STATX_SIZE,
+			Size: uint64(size),
+		},
+	}); err != nil {
+		return err
+	}
+	chunks, err := copyUpDataChunks(ctx, oldFD, size)
+	if err != nil {
+		return err
+	}
+
+	workers := min(len(chunks), maxCopyUpWorkers)
+	if ac == nil || workers <= 1 {
+		buf := make([]byte, copyUpChunkSize)
+		for _, fr := range chunks {
+			if err := copyUpChunk(ctx, newFD, oldFD, fr, buf); err != nil {
+				return err
+			}
+		}
+		return nil
+	}
+
+	var (
+		wg       sync.WaitGroup
+		next     atomicbitops.Int64
+		errMu    sync.Mutex
+		firstErr error
+	)
+	copyChunks := func(ctx context.Context) {
+		buf := make([]byte, copyUpChunkSize)
+		for {
+			i := next.Add(1) - 1
+			if i >= int64(len(chunks)) {
+				return
+			}
+			if err := copyUpChunk(ctx, newFD, oldFD, chunks[i], buf); err != nil {
+				errMu.Lock()
+				if firstErr == nil {
+					firstErr = err
+				}
+				errMu.Unlock()
+				// Stop other workers from starting new chunks.
+				next.Store(int64(len(chunks)))
+				return
+			}
+		}
+	}
+	// Contexts may not be shared between goroutines, so each worker gets its
+	// own; the calling goroutine is also a worker.
+	for i := 1; i < workers; i++ {
+		workerCtx := auth.ContextWithCredentials(ac.AsyncContext(), d.fs.creds)
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			copyChunks(workerCtx)
+		}()
+	}
+	copyChunks(ctx)
+	wg.Wait()
+	return firstErr
+}
+
+// copyUpDataChunks returns the regions of fd, which represents a file of the
+// given size, that may contain data, split into chunks of at most
+// copyUpChunkSize bytes. If fd does not support SEEK_DATA, the whole file is
+// assumed to contain data.
+func copyUpDataChunks(ctx context.Context, fd *vfs.FileDescription, size int64) ([]memmap.FileRange, error) {
+	var chunks []memmap.FileRange
+	for off := int64(0); off < size; {
+		start, err := fd.Seek(ctx, off, linux.SEEK_DATA)
+		if err != nil {
+			if linuxerr.Equals(linuxerr.ENXIO, err) {
+				// No data after off.
+				break
+			}
+			if off == 0 && (linuxerr.Equals(linuxerr.EINVAL, err) || linuxerr.Equals(linuxerr.ESPIPE, err)) {
+				start = 0
+			} else {
+				return nil, err
+			}
+		}
+		if start >= size {
+			break
+		}
+		end, err := fd.Seek(ctx, start, linux.SEEK_HOLE)
+		if err != nil {
+			if !linuxerr.Equals(linuxerr.EINVAL, err) && !linuxerr.Equals(linuxerr.ESPIPE, err) {
+				return nil, err
+			}
+			end = size
+		}
+		end = min(end, size)
+		for ; start < end; start += copyUpChunkSize {
+			chunks = append(chunks, memmap.FileRange{Start: uint64(start), End: uint64(min(start+copyUpChunkSize, end))})
+		}
+		off = end
+	}
+	return chunks, nil
+}
+
+// copyUpChunk copies the data in fr from oldFD to newFD. If the upper layer
+// can copy the data without reading and writing it, e.g. by sharing pages
+// between tmpfs files or by using the host's copy_file_range(2) between gofer
+// files, it does so. Otherwise, buf, which must be at least fr.Length() bytes
+// long, is used as an intermediate buffer.
+func copyUpChunk(ctx context.Context, newFD, oldFD *vfs.FileDescription, fr memmap.FileRange, buf []byte) error {
+	off, end := int64(fr.Start), int64(fr.End)
+	for off < end {
+		n, err := newFD.CopyFileRangeFrom(ctx, oldFD, off, off, end-off)
+		off += n
+		if err != nil {
+			return err
+		}
+		if n == 0 {
+			break
+		}
+	}
+	for off < end {
+		readN, readErr := oldFD.PRead(ctx, usermem.BytesIOSequence(buf[:end-off]), off, vfs.ReadOptions{})
+		if readErr != nil && readErr != io.EOF {
+			return readErr
+		}
+		src := usermem.BytesIOSequence(buf[:readN])
+		for src.NumBytes() != 0 {
+			writeN, writeErr := newFD.PWrite(ctx, src, off, vfs.WriteOptions{})
+			off += writeN
+			src = src.DropFirst64(writeN)
+			if writeErr != nil {
+				return writeErr
+			}
+		}
+		if readErr == io.EOF || readN == 0 {
+			return nil
+		}
+	}
+	return nil
+}
+
 // mustCopyXattr returns true if a copy-up failure on the given xattr must
 // abort the copy-up. Loosely analogous to Linux's
 // fs/overlayfs/util.c:ovl_must_copy_xattr(). Here are the differences:
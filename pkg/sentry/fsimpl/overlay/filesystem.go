@@ -181,8 +181,14 @@ func (fs *filesystem) getChildLocked(ctx context.Context, parent *dentry, name s
 	if child, ok := parent.children[name]; ok {
 		return child, child.topLookupLayer(), nil
 	}
+	if topLookupLayer, ok := parent.negativeChildren[name]; ok {
+		return nil, topLookupLayer, linuxerr.ENOENT
+	}
 	child, topLookupLayer, err := fs.lookupLocked(ctx, parent, name)
 	if err != nil {
+		if linuxerr.Equals(linuxerr.ENOENT, err) {
+			parent.cacheNegativeChildLocked(name, topLookupLayer)
+		}
 		return nil, topLookupLayer, err
 	}
 	if parent.children == nil {
@@ -194,6 +200,28 @@ func (fs *filesystem) getChildLocked(ctx context.Context, parent *dentry, name s
 	return child, topLookupLayer, nil
 }
 
+// maxNegativeChildren is the maximum number of negative lookups cached by
+// each directory dentry.
+const maxNegativeChildren = 1000
+
+// cacheNegativeChildLocked records that d has no child with the given name.
+// Since lower layers are immutable, and the upper layer is only mutated through
+// the overlay, this remains true until d is next modified.
+//
+// Preconditions: d.dirMu must be locked.
+func (d *dentry) cacheNegativeChildLocked(name string, topLookupLayer lookupLayer) {
+	if d.negativeChildren == nil {
+		d.negativeChildren = make(map[string]lookupLayer)
+	} else if len(d.negativeChildren) >= maxNegativeChildren {
+		// Evict an arbitrary entry.
+		for victim := range d.negativeChildren {
+			delete(d.negativeChildren, victim)
+			break
+		}
+	}
+	d.negativeChildren[name] = topLookupLayer
+}
+
 // Preconditions:
 //   - fs.renameMu must be locked.
 //   - parent.dirMu must be locked.
@@ -352,6 +380,9 @@ func (fs *filesystem) lookupLocked(ctx context.Context, parent *dentry, name str
 //   - fs.renameMu must be locked.
 //   - parent.dirMu must be locked.
 func (fs *filesystem) lookupLayerLocked(ctx context.Context, parent *dentry, name string) (lookupLayer, error) {
+	if lookupLayer, ok := parent.negativeChildren[name]; ok {
+		return lookupLayer, nil
+	}
 	childPath := fspath.Parse(name)
 	lookupLayer := lookupLayerNone
 	var lookupErr error
@@ -551,6 +582,7 @@ func (fs *filesystem) doCreateAt(ctx context.Context, rp *vfs.ResolvingPath, ct
 	}
 
 	parent.dirents = nil
+	parent.negativeChildren = nil
 	ev := linux.IN_CREATE
 	if ct != createNonDirectory {
 		ev |= linux.IN_ISDIR
@@ -1016,6 +1048,7 @@ func (fs *filesystem) createAndOpenLocked(ctx context.Context, rp *vfs.Resolving
 	// cleanup (the file was created successfully even if we can no longer open
 	// it for some reason).
 	parent.dirents = nil
+	parent.negativeChildren = nil
 	upperFlags := upperFD.StatusFlags()
 	fd := &regularFileFD{
 		copiedUp:    true,
@@ -1297,6 +1330,7 @@ func (fs *filesystem) RenameAt(ctx context.Context, rp *vfs.ResolvingPath, oldPa
 	}
 	if oldParent != newParent {
 		newParent.dirents = nil
+		newParent.negativeChildren = nil
 		// This can't drop the last reference on oldParent because one is held
 		// by oldParentVD, so lock recursion is impossible.
 		oldParent.DecRef(ctx)
@@ -1309,6 +1343,7 @@ func (fs *filesystem) RenameAt(ctx context.Context, rp *vfs.ResolvingPath, oldPa
 	}
 	newParent.children[newName] = renamed
 	oldParent.dirents = nil
+	oldParent.negativeChildren = nil
 
 	if err := CreateWhiteout(ctx, vfsObj, fs.creds, &oldpop); err != nil {
 		panic(fmt.Sprintf("unrecoverable overlayfs inconsistency: failed to create whiteout at origin after RenameAt: %v", err))
@@ -1465,6 +1500,7 @@ func (fs *filesystem) RmdirAt(ctx context.Context, rp *vfs.ResolvingPath) error
 	fs.releaseDirIno(child.dirInoHash)
 	ds = appendDentry(ds, child)
 	parent.dirents = nil
+	parent.negativeChildren = nil
 	// Linux sends the parent's IN_DELETE|IN_ISDIR at rmdir() time, but
 	// defers the child's IN_DELETE_SELF/IN_IGNORED until the last ref is
 	// dropped. Emit the child notifications now only when no extra refs
@@ -1703,6 +1739,7 @@ func (fs *filesystem) UnlinkAt(ctx context.Context, rp *vfs.ResolvingPath) error
 	ds = appendDentry(ds, child)
 	vfs.InotifyRemoveChild(ctx, &child.watches, &parent.watches, name)
 	parent.dirents = nil
+	parent.negativeChildren = nil
 	return nil
 }
 
@@ -583,11 +583,15 @@ type dentry struct {
 	// If this dentry represents a directory, children maps the names of
 	// children for which dentries have been instantiated to those dentries,
 	// and dirents (if not nil) is a cache of dirents as returned by
-	// directoryFDs representing this directory. children is protected by
-	// dirMu.
-	dirMu    dirMutex `state:"nosave"`
-	children map[string]*dentry
-	dirents  []vfs.Dirent
+	// directoryFDs representing this directory. negativeChildren maps the
+	// names of at most maxNegativeChildren children that are known not to
+	// exist to the topLookupLayer returned by their lookup; it is dropped
+	// whenever this directory is modified. children and negativeChildren are
+	// protected by dirMu.
+	dirMu            dirMutex `state:"nosave"`
+	children         map[string]*dentry
+	dirents          []vfs.Dirent
+	negativeChildren map[string]lookupLayer `state:"nosave"`
 
 	// upperVD and lowerVDs are the files from the overlay filesystem's layers
 	// that comprise the file on the overlay filesystem.
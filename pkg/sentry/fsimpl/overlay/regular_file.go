@@ -288,6 +288,16 @@ func (fd *regularFileFD) Read(ctx context.Context, dst usermem.IOSequence, opts
 	return wrappedFD.Read(ctx, dst, opts)
 }
 
+// Fadvise implements vfs.Fadviser.Fadvise.
+func (fd *regularFileFD) Fadvise(ctx context.Context, offset, length int64, advice int32) error {
+	wrappedFD, err := fd.getCurrentFD(ctx)
+	if err != nil {
+		return err
+	}
+	defer wrappedFD.DecRef(ctx)
+	return wrappedFD.Fadvise(ctx, offset, length, advice)
+}
+
 // PWrite implements vfs.FileDescriptionImpl.PWrite.
 func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, offset int64, opts vfs.WriteOptions) (int64, error) {
 	wrappedFD, err := fd.getCurrentFD(ctx)
@@ -155,6 +155,8 @@ func (cb *fsckptTarReaderCallbacks) regularFileSetContents(ctx context.Context,
 		gap = rf.data.Insert(gap, memmap.MappableRange{rfseg.Start, rfseg.End}, rfseg.Value).NextGap()
 		n += (rfseg.End - rfseg.Start) / hostarch.PageSize
 	}
+	// Pages may have been shared with other files by copy_file_range(2).
+	rf.sharedData = len(crf.data) != 0
 	if !cb.fs.accountPages(n) {
 		return fmt.Errorf("restored filesystem would exceed size limit of %d pages", cb.fs.maxSizeInPages)
 	}
@@ -80,6 +80,14 @@ type regularFile struct {
 	// Protected by dataMu.
 	seals uint32
 
+	// sharedData is true if pages in data may be shared with other files, as
+	// a result of copy_file_range(2). Shared pages are copied before the file
+	// writes to them (see regularFile.unshareLocked). Files with shared pages
+	// are never mapped, since writes through mappings can not be intercepted.
+	//
+	// Protected by dataMu.
+	sharedData bool
+
 	// initiallyUnlinked is true if this file was created using NewZeroFile or
 	// NewMemfd => newUnlinkedRegularFileDescription. initiallyUnlinked should
 	// be true when the equivalent shmem file in Linux would use
@@ -210,10 +218,6 @@ func (rf *regularFile) growLocked(newSize uint64) error {
 // Preconditions: rf.inode.mu must be held.
 func (rf *regularFile) truncateNoTimeUpdateLocked(newSize uint64) error {
 	oldSize := rf.size.RacyLoad()
-	if newSize == oldSize {
-		// Nothing to do.
-		return nil
-	}
 
 	// Need to hold inode.mu and dataMu while modifying size.
 	rf.dataMu.Lock()
@@ -223,12 +227,26 @@ func (rf *regularFile) truncateNoTimeUpdateLocked(newSize uint64) error {
 		return err
 	}
 
-	// We are shrinking the file. First check if this is allowed.
-	if rf.seals&linux.F_SEAL_SHRINK != 0 {
+	// We are shrinking the file, or truncating it to its current size, which
+	// still releases pages allocated beyond EOF by
+	// fallocate(FALLOC_FL_KEEP_SIZE); compare Linux's
+	// mm/shmem.c:shmem_setattr(). First check if shrinking is allowed.
+	if newSize < oldSize && rf.seals&linux.F_SEAL_SHRINK != 0 {
 		rf.dataMu.Unlock()
 		return linuxerr.EPERM
 	}
 
+	if rf.sharedData && !hostarch.IsPageAligned(newSize) {
+		// data.Truncate zeroes the end of the page containing the new EOF,
+		// which must not be visible to other files sharing that page. Pages
+		// containing EOF are never shared again (see
+		// regularFile.refSharedPages).
+		pgstart := hostarch.PageRoundDown(newSize)
+		if err := rf.unshareLocked(memmap.MappableRange{pgstart, pgstart + hostarch.PageSize}, 0 /* memCgID */); err != nil {
+			rf.dataMu.Unlock()
+			return err
+		}
+	}
 	rf.size.Store(newSize)
 	rf.dataMu.Unlock()
 
@@ -258,14 +276,22 @@ func (rf *regularFile) truncateNoTimeUpdateLocked(newSize uint64) error {
 func (rf *regularFile) AddMapping(ctx context.Context, ms memmap.MappingSpace, ar hostarch.AddrRange, offset uint64, writable bool) error {
 	rf.mapsMu.Lock()
 	defer rf.mapsMu.Unlock()
-	rf.dataMu.RLock()
-	defer rf.dataMu.RUnlock()
+	rf.dataMu.Lock()
+	defer rf.dataMu.Unlock()
 
 	// Reject writable mapping if F_SEAL_WRITE is set.
 	if rf.seals&linux.F_SEAL_WRITE != 0 && writable {
 		return linuxerr.EPERM
 	}
 
+	// Mapped files can't share pages with other files.
+	if rf.sharedData {
+		if err := rf.unshareLocked(memmap.MappableRange{0, math.MaxUint64}, pgalloc.MemoryCgroupIDFromContext(ctx)); err != nil {
+			return err
+		}
+		rf.sharedData = false
+	}
+
 	rf.mappings.AddMapping(ms, ar, offset, writable)
 	if writable {
 		pagesBefore := rf.writableMappingPages
@@ -432,6 +458,10 @@ func (fd *regularFileFD) Release(context.Context) {
 	// noop
 }
 
+// maxAllocatePopulate is the largest range for which fallocate(2) populates
+// pages in memory-backed MemoryFiles; see regularFile.allocateLocked.
+const maxAllocatePopulate = 64 << 20 // 64 MiB
+
 // Allocate implements vfs.FileDescriptionImpl.Allocate.
 func (fd *regularFileFD) Allocate(ctx context.Context, mode, offset, length uint64) error {
 	f := fd.inode().impl.(*regularFile)
@@ -441,6 +471,9 @@ func (fd *regularFileFD) Allocate(ctx context.Context, mode, offset, length uint
 	f.inode.mu.Lock()
 	defer f.inode.mu.Unlock()
 	end := offset + length
+	if mode&linux.FALLOC_FL_PUNCH_HOLE != 0 {
+		return f.punchHoleLocked(offset, end)
+	}
 	pgEnd, ok := hostarch.PageRoundUp(end)
 	if !ok {
 		return linuxerr.EFBIG
@@ -495,13 +528,16 @@ func (rf *regularFile) allocateLocked(ctx context.Context, mode, newSize uint64,
 	// Given our definitions in pgalloc, fallocate(2) semantics imply that pages
 	// in the MemoryFile must be committed, in addition to being allocated.
 	allocMode := pgalloc.AllocateAndCommit
-	if !rf.inode.fs.mf.IsDiskBacked() {
+	if !rf.inode.fs.mf.IsDiskBacked() && required.Length() <= maxAllocatePopulate {
 		// Upgrade to AllocateAndWritePopulate for memory(shmem)-backed files. We
 		// take a more aggressive approach in populating pages for memory-backed
 		// MemoryFiles. shmem pages are subject to swap rather than disk writeback.
 		// They are not likely to be swapped before they are written to. Hence it
 		// is beneficial to populate (in addition to commit) shmem pages to avoid
 		// faulting page-by-page when these pages are written to in the future.
+		// Larger ranges, such as preallocated database or disk image files, are
+		// rarely written in full soon after, and are only committed rather than
+		// touched page by page.
 		allocMode = pgalloc.AllocateAndWritePopulate
 	}
 	pagesAlloced, err := rf.data.Fill(ctx, required, required, newSize, rf.inode.fs.mf, pgalloc.AllocOpts{
@@ -518,12 +554,95 @@ func (rf *regularFile) allocateLocked(ctx context.Context, mode, newSize uint64,
 	}
 
 	oldSize := rf.size.Load()
-	if oldSize >= newSize {
+	if oldSize >= newSize || mode&linux.FALLOC_FL_KEEP_SIZE != 0 {
 		return nil
 	}
 	return rf.growLocked(newSize)
 }
 
+// punchHoleLocked implements fallocate(FALLOC_FL_PUNCH_HOLE) for the range
+// [offset, end). Pages that lie entirely within the range are removed from the
+// file and released to the MemoryFile without being touched; the remainder of
+// the range is zeroed.
+//
+// Preconditions: rf.inode.mu must be locked.
+func (rf *regularFile) punchHoleLocked(offset, end uint64) error {
+	// Compare Linux's mm/shmem.c:shmem_fallocate().
+	if rf.seals&linux.F_SEAL_WRITE != 0 {
+		return linuxerr.EPERM
+	}
+	holeMR := memmap.MappableRange{Start: math.MaxUint64, End: hostarch.PageRoundDown(end)}
+	if pgstart, ok := hostarch.PageRoundUp(offset); ok {
+		holeMR.Start = pgstart
+	}
+	mf := rf.inode.fs.mf
+
+	rf.dataMu.Lock()
+	// Zero the parts of the range that only cover part of a page.
+	partial := []memmap.MappableRange{{Start: offset, End: end}}
+	if holeMR.Start < holeMR.End {
+		partial = []memmap.MappableRange{
+			{Start: offset, End: holeMR.Start},
+			{Start: holeMR.End, End: end},
+		}
+	}
+	for _, mr := range partial {
+		if mr.Length() == 0 {
+			continue
+		}
+		if rf.sharedData {
+			pgMR := memmap.MappableRange{Start: hostarch.PageRoundDown(mr.Start), End: hostarch.PageRoundDown(mr.End-1) + hostarch.PageSize}
+			if err := rf.unshareLocked(pgMR, 0 /* memCgID */); err != nil {
+				rf.dataMu.Unlock()
+				return err
+			}
+		}
+		if err := rf.zeroLocked(mr); err != nil {
+			rf.dataMu.Unlock()
+			return err
+		}
+	}
+	// Remove the pages in the hole. Existing translations of these pages hold
+	// references on them, so they're freed once the translations are
+	// invalidated below.
+	var pagesFreed uint64
+	if holeMR.Start < holeMR.End {
+		rf.data.RemoveRangeWith(holeMR, func(seg fsutil.FileRangeIterator) {
+			mf.DecRef(seg.FileRange())
+			pagesFreed += seg.Range().Length() / hostarch.PageSize
+		})
+	}
+	rf.dataMu.Unlock()
+	rf.inode.fs.unaccountPages(pagesFreed)
+
+	if pagesFreed != 0 {
+		// Compare Linux's mm/shmem.c:shmem_fallocate() =>
+		// mm/memory.c:unmap_mapping_range(even_cows=0).
+		rf.mapsMu.Lock()
+		rf.mappings.Invalidate(holeMR, memmap.InvalidateOpts{})
+		rf.mapsMu.Unlock()
+	}
+	rf.inode.touchCMtimeLocked()
+	return nil
+}
+
+// zeroLocked zeroes the file's cached data in mr.
+//
+// Preconditions: rf.dataMu must be locked for writing.
+func (rf *regularFile) zeroLocked(mr memmap.MappableRange) error {
+	mf := rf.inode.fs.mf
+	for seg := rf.data.LowerBoundSegment(mr.Start); seg.Ok() && seg.Start() < mr.End; seg = seg.NextSegment() {
+		ims, err := mf.MapInternal(seg.FileRangeOf(seg.Range().Intersect(mr)), hostarch.Write)
+		if err != nil {
+			return err
+		}
+		if _, err := safemem.ZeroSeq(ims); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
 // PRead implements vfs.FileDescriptionImpl.PRead.
 func (fd *regularFileFD) PRead(ctx context.Context, dst usermem.IOSequence, offset int64, opts vfs.ReadOptions) (int64, error) {
 	start := fsmetric.StartReadWait()
@@ -564,6 +683,73 @@ func (fd *regularFileFD) Read(ctx context.Context, dst usermem.IOSequence, opts
 	return n, err
 }
 
+// SplicePages implements vfs.SplicePageSource.SplicePages.
+func (fd *regularFileFD) SplicePages(ctx context.Context, offset, count int64, f vfs.SplicePagesFunc) (int64, error) {
+	if offset == -1 {
+		fd.offMu.Lock()
+		n, err := fd.splicePages(offset, count, f)
+		fd.off += n
+		fd.offMu.Unlock()
+		return n, err
+	}
+	return fd.splicePages(offset, count, f)
+}
+
+// Preconditions: If offset is -1, fd.offMu must be locked.
+func (fd *regularFileFD) splicePages(offset, count int64, f vfs.SplicePagesFunc) (int64, error) {
+	fsmetric.TmpfsReads.Increment()
+	if offset == -1 {
+		offset = fd.off
+	}
+	if offset < 0 {
+		return 0, linuxerr.EINVAL
+	}
+	if count <= 0 {
+		return 0, nil
+	}
+
+	rf := fd.inode().impl.(*regularFile)
+	rf.dataMu.RLock()
+	// Compute the range to splice (limited by file size and overflow-checked).
+	start := uint64(offset)
+	size := rf.size.RacyLoad()
+	if start >= size {
+		rf.dataMu.RUnlock()
+		return 0, io.EOF
+	}
+	end := size
+	if rend := start + uint64(count); rend > start && rend < end {
+		end = rend
+	}
+
+	var done uint64
+	seg, gap := rf.data.Find(start)
+	for start+done < end {
+		mr := memmap.MappableRange{start + done, end}
+		var want, n uint64
+		switch {
+		case seg.Ok():
+			fr := seg.FileRangeOf(seg.Range().Intersect(mr))
+			want = fr.Length()
+			n = f(rf.inode.fs.mf, fr)
+			seg, gap = seg.NextNonEmpty()
+		case gap.Ok():
+			// Tmpfs holes are zero-filled.
+			want = gap.Range().Intersect(mr).Length()
+			n = f(nil, memmap.FileRange{0, want})
+			seg, gap = gap.NextSegment(), fsutil.FileRangeGapIterator{}
+		}
+		done += n
+		if n < want {
+			break
+		}
+	}
+	rf.dataMu.RUnlock()
+
+	fd.inode().touchAtime(fd.vfsfd.Mount())
+	return int64(done), nil
+}
+
 // PWrite implements vfs.FileDescriptionImpl.PWrite.
 func (fd *regularFileFD) PWrite(ctx context.Context, src usermem.IOSequence, offset int64, opts vfs.WriteOptions) (int64, error) {
 	n, _, err := fd.pwrite(ctx, src, offset, opts)
@@ -614,16 +800,24 @@ func (fd *regularFileFD) pwrite(ctx context.Context, src usermem.IOSequence, off
 	n, err := src.CopyInTo(ctx, rw)
 
 	f.inode.touchCMtimeLocked()
+	f.killPrivLocked()
+	putRegularFileReadWriter(rw)
+	return n, n + offset, err
+}
+
+// killPrivLocked clears the file's setuid and setgid bits and security
+// capabilities, as writing to it does.
+//
+// Preconditions: rf.inode.mu must be held.
+func (rf *regularFile) killPrivLocked() {
 	for {
-		old := f.inode.mode.Load()
+		old := rf.inode.mode.Load()
 		new := vfs.ClearSUIDAndSGID(old)
-		if swapped := f.inode.mode.CompareAndSwap(old, new); swapped {
+		if swapped := rf.inode.mode.CompareAndSwap(old, new); swapped {
 			break
 		}
 	}
-	f.inode.xattrs.KillPriv()
-	putRegularFileReadWriter(rw)
-	return n, n + offset, err
+	rf.inode.xattrs.KillPriv()
 }
 
 // Write implements vfs.FileDescriptionImpl.Write.
@@ -635,6 +829,230 @@ func (fd *regularFileFD) Write(ctx context.Context, src usermem.IOSequence, opts
 	return n, err
 }
 
+// CopyFileRangeFrom implements vfs.FileRangeCopier.CopyFileRangeFrom.
+//
+// If src is also a tmpfs file, whole pages are copied by sharing the pages
+// that store them between both files; see regularFile.sharedData. Partial
+// pages at either end of the range are copied.
+func (fd *regularFileFD) CopyFileRangeFrom(ctx context.Context, src *vfs.FileDescription, srcOffset, dstOffset, count int64) (int64, error) {
+	srcFD, ok := src.Impl().(*regularFileFD)
+	if !ok || srcOffset < 0 || dstOffset < 0 || count <= 0 {
+		return 0, nil
+	}
+	srcRF := srcFD.inode().impl.(*regularFile)
+	dstRF := fd.inode().impl.(*regularFile)
+	if srcRF == dstRF || srcRF.inode.fs.mf != dstRF.inode.fs.mf || (srcOffset-dstOffset)&hostarch.PageMask != 0 {
+		return 0, nil
+	}
+	count, err := vfs.CheckLimit(ctx, dstOffset, count)
+	if err != nil {
+		return 0, err
+	}
+
+	// Find the whole pages to share, which must be before src's EOF.
+	start := uint64(srcOffset)
+	end := start + uint64(count)
+	if size := srcRF.size.Load(); end > size {
+		end = size
+	}
+	pgstart, ok := hostarch.PageRoundUp(start)
+	if !ok {
+		return 0, nil
+	}
+	pgend := hostarch.PageRoundDown(end)
+	if pgstart >= pgend {
+		return 0, nil
+	}
+
+	var done uint64
+	if pgstart > start {
+		n, err := fd.copyBytes(ctx, srcFD, start, uint64(dstOffset), pgstart-start)
+		done += n
+		if err != nil || done < pgstart-start {
+			return int64(done), err
+		}
+	}
+	memCgID := pgalloc.MemoryCgroupIDFromContext(ctx)
+	dstpgstart := uint64(dstOffset) + done
+	n, err := dstRF.shareDataFrom(srcRF, memmap.MappableRange{pgstart, pgend}, dstpgstart, memCgID)
+	done += n
+	if err != nil || n < pgend-pgstart {
+		return int64(done), err
+	}
+	srcFD.inode().touchAtime(src.Mount())
+	if end > pgend {
+		n, err := fd.copyBytes(ctx, srcFD, pgend, dstpgstart+n, end-pgend)
+		done += n
+		if err != nil {
+			return int64(done), err
+		}
+	}
+	return int64(done), nil
+}
+
+// copyBytes copies count bytes from src at srcOff into the file at dstOff
+// through a temporary buffer. It is used for small copies.
+func (fd *regularFileFD) copyBytes(ctx context.Context, src *regularFileFD, srcOff, dstOff, count uint64) (uint64, error) {
+	buf := make([]byte, count)
+	n, err := src.PRead(ctx, usermem.BytesIOSequence(buf), int64(srcOff), vfs.ReadOptions{})
+	if n == 0 {
+		if err == io.EOF {
+			err = nil
+		}
+		return 0, err
+	}
+	wn, _, err := fd.pwrite(ctx, usermem.BytesIOSequence(buf[:n]), int64(dstOff), vfs.WriteOptions{})
+	return uint64(wn), err
+}
+
+// shareDataFrom replaces the file's data starting at dstStart with src's data
+// in srcMR by sharing the pages that store it, rather than copying them. It
+// returns the number of bytes replaced, which is 0 if either file can not
+// share pages.
+//
+// Preconditions:
+//   - rf != src, and both files store data in the same MemoryFile.
+//   - srcMR and dstStart are page-aligned.
+func (rf *regularFile) shareDataFrom(src *regularFile, srcMR memmap.MappableRange, dstStart uint64, memCgID uint32) (uint64, error) {
+	exts, ok := src.refSharedPages(srcMR, memCgID)
+	if !ok {
+		return 0, nil
+	}
+	mf := rf.inode.fs.mf
+	var pages uint64
+	for _, ext := range exts {
+		pages += ext.fr.Length() / hostarch.PageSize
+	}
+	dstMR := memmap.MappableRange{dstStart, dstStart + srcMR.Length()}
+
+	rf.inode.mu.Lock()
+	defer rf.inode.mu.Unlock()
+	rf.mapsMu.Lock()
+	defer rf.mapsMu.Unlock()
+	rf.dataMu.Lock()
+	defer rf.dataMu.Unlock()
+	if !rf.canShareLocked() || rf.seals&(linux.F_SEAL_WRITE|linux.F_SEAL_GROW) != 0 || !rf.inode.fs.accountPages(pages) {
+		for _, ext := range exts {
+			mf.DecRef(ext.fr)
+		}
+		return 0, nil
+	}
+
+	// Replace existing data with src's. Holes in src become holes here.
+	var freed uint64
+	rf.data.RemoveRangeWith(dstMR, func(seg fsutil.FileRangeIterator) {
+		mf.DecRef(seg.FileRange())
+		freed += seg.Range().Length() / hostarch.PageSize
+	})
+	rf.inode.fs.unaccountPages(freed)
+	for _, ext := range exts {
+		rf.data.InsertRange(memmap.MappableRange{dstStart + ext.off, dstStart + ext.off + ext.fr.Length()}, ext.fr.Start)
+	}
+	if len(exts) != 0 {
+		rf.sharedData = true
+	}
+	if dstMR.End > rf.size.RacyLoad() {
+		rf.size.Store(dstMR.End)
+	}
+	rf.inode.touchCMtimeLocked()
+	rf.killPrivLocked()
+	return dstMR.Length(), nil
+}
+
+// sharedExtent is a range of a file's data, stored in MemoryFile pages that
+// are being shared with another file.
+type sharedExtent struct {
+	// off is the offset of the data from the start of the shared range.
+	off uint64
+
+	// fr is the range of the MemoryFile storing the data.
+	fr memmap.FileRange
+}
+
+// refSharedPages takes references on the pages storing the file's data in mr,
+// which must be page-aligned, and returns them in file order for sharing with
+// another file. Holes in mr are omitted. If the file's pages can't be shared,
+// or mr extends past the last page before EOF, refSharedPages returns false
+// without taking references.
+func (rf *regularFile) refSharedPages(mr memmap.MappableRange, memCgID uint32) ([]sharedExtent, bool) {
+	rf.mapsMu.Lock()
+	defer rf.mapsMu.Unlock()
+	rf.dataMu.Lock()
+	defer rf.dataMu.Unlock()
+	if !rf.canShareLocked() || mr.End > hostarch.PageRoundDown(rf.size.RacyLoad()) {
+		return nil, false
+	}
+	mf := rf.inode.fs.mf
+	var exts []sharedExtent
+	for seg := rf.data.LowerBoundSegment(mr.Start); seg.Ok() && seg.Start() < mr.End; seg = seg.NextSegment() {
+		segMR := seg.Range().Intersect(mr)
+		fr := seg.FileRangeOf(segMR)
+		mf.IncRef(fr, memCgID)
+		exts = append(exts, sharedExtent{
+			off: segMR.Start - mr.Start,
+			fr:  fr,
+		})
+	}
+	if len(exts) != 0 {
+		rf.sharedData = true
+	}
+	return exts, true
+}
+
+// canShareLocked returns true if the file's pages may be shared with other
+// files.
+//
+// Preconditions: rf.mapsMu and rf.dataMu must be locked.
+func (rf *regularFile) canShareLocked() bool {
+	// Writes through mappings can't be intercepted to copy shared pages, and
+	// huge pages aren't worth sharing in part.
+	return rf.mappings.IsEmpty() && !rf.huge
+}
+
+// unshareLocked replaces the pages storing the file's data in mr that are
+// shared with other files by private copies.
+//
+// Preconditions: rf.dataMu must be locked for writing.
+func (rf *regularFile) unshareLocked(mr memmap.MappableRange, memCgID uint32) error {
+	mf := rf.inode.fs.mf
+	for seg := rf.data.LowerBoundSegment(mr.Start); seg.Ok() && seg.Start() < mr.End; seg = seg.NextSegment() {
+		segMR := seg.Range().Intersect(mr)
+		fr := seg.FileRangeOf(segMR)
+		if mf.HasUniqueRef(fr) {
+			continue
+		}
+		newFR, err := mf.Allocate(fr.Length(), pgalloc.AllocOpts{
+			Kind:    rf.memoryUsageKind,
+			MemCgID: memCgID,
+		})
+		if err != nil {
+			return err
+		}
+		if err := copyMF(mf, newFR, fr); err != nil {
+			mf.DecRef(newFR)
+			return err
+		}
+		seg = rf.data.Isolate(seg, segMR)
+		seg.SetValue(newFR.Start)
+		mf.DecRef(fr)
+	}
+	return nil
+}
+
+// copyMF copies the contents of src to dst, which must have the same length.
+func copyMF(mf *pgalloc.MemoryFile, dst, src memmap.FileRange) error {
+	dsts, err := mf.MapInternal(dst, hostarch.Write)
+	if err != nil {
+		return err
+	}
+	srcs, err := mf.MapInternal(src, hostarch.Read)
+	if err != nil {
+		return err
+	}
+	_, err = safemem.CopySeq(dsts, srcs)
+	return err
+}
+
 // Seek implements vfs.FileDescriptionImpl.Seek.
 func (fd *regularFileFD) Seek(ctx context.Context, offset int64, whence int32) (int64, error) {
 	fd.offMu.Lock()
@@ -646,6 +1064,12 @@ func (fd *regularFileFD) Seek(ctx context.Context, offset int64, whence int32) (
 		offset += fd.off
 	case linux.SEEK_END:
 		offset += int64(fd.inode().impl.(*regularFile).size.Load())
+	case linux.SEEK_DATA, linux.SEEK_HOLE:
+		off, err := fd.inode().impl.(*regularFile).seekDataOrHole(offset, whence)
+		if err != nil {
+			return 0, err
+		}
+		offset = off
 	default:
 		return 0, linuxerr.EINVAL
 	}
@@ -656,6 +1080,39 @@ func (fd *regularFileFD) Seek(ctx context.Context, offset int64, whence int32) (
 	return offset, nil
 }
 
+// seekDataOrHole returns the offset of the first byte of data (if whence is
+// SEEK_DATA) or hole (if whence is SEEK_HOLE) at or after offset. Ranges of
+// the file with no pages allocated are holes; all other ranges, including
+// pages allocated by fallocate(2) that have never been written, are data. The
+// search skips over whole ranges of allocated pages or holes at once, so its
+// cost is independent of the file's size.
+func (rf *regularFile) seekDataOrHole(offset int64, whence int32) (int64, error) {
+	// Compare Linux's mm/shmem.c:shmem_file_llseek().
+	rf.dataMu.RLock()
+	defer rf.dataMu.RUnlock()
+	size := rf.size.Load()
+	if offset < 0 || uint64(offset) >= size {
+		return 0, linuxerr.ENXIO
+	}
+	off := uint64(offset)
+	if whence == linux.SEEK_DATA {
+		seg := rf.data.LowerBoundSegment(off)
+		if !seg.Ok() || seg.Start() >= size {
+			return 0, linuxerr.ENXIO
+		}
+		return int64(max(off, seg.Start())), nil
+	}
+	// There is an implicit hole at EOF.
+	gap := rf.data.LowerBoundGap(off)
+	for gap.Ok() && gap.Range().Length() == 0 {
+		gap = gap.NextGap()
+	}
+	if !gap.Ok() {
+		return int64(size), nil
+	}
+	return int64(min(max(off, gap.Start()), size)), nil
+}
+
 // ConfigureMMap implements vfs.FileDescriptionImpl.ConfigureMMap.
 func (fd *regularFileFD) ConfigureMMap(ctx context.Context, opts *memmap.MMapOpts) error {
 	file := fd.inode().impl.(*regularFile)
@@ -820,6 +1277,11 @@ func (rw *regularFileReadWriter) WriteFromBlocks(srcs safemem.BlockSeq) (uint64,
 	pgMR := memmap.MappableRange{uint64(pgstartaddr), uint64(pgendaddr)}
 	fs := rw.file.inode.fs
 	mayHuge := rw.file.huge && fs.mf.HugepagesEnabled()
+	if rw.file.sharedData {
+		if err := rw.file.unshareLocked(pgMR, rw.memCgID); err != nil {
+			return 0, err
+		}
+	}
 
 	var (
 		done   uint64
@@ -22,6 +22,7 @@ import (
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/hostarch"
 	"gvisor.dev/gvisor/pkg/sentry/contexttest"
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/lock"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
@@ -325,3 +326,34 @@ func TestTruncate(t *testing.T) {
 		t.Errorf("fd.Stat got Ctime %v, want > %v", got, stat.Ctime)
 	}
 }
+
+func TestTruncateReleasesKeepSizePages(t *testing.T) {
+	ctx := contexttest.Context(t)
+	fd, cleanup, err := newFileFD(ctx, 0644)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer cleanup()
+	rf := fd.Impl().(*regularFileFD).inode().impl.(*regularFile)
+
+	// Allocate pages beyond EOF.
+	if err := fd.Allocate(ctx, linux.FALLOC_FL_KEEP_SIZE, 0, 4*hostarch.PageSize); err != nil {
+		t.Fatalf("fd.Allocate failed: %v", err)
+	}
+	if rf.data.IsEmpty() {
+		t.Fatalf("fd.Allocate did not allocate any pages")
+	}
+
+	// Truncating the file to its current size should release them.
+	if err := fd.SetStat(ctx, vfs.SetStatOptions{
+		Stat: linux.Statx{
+			Mask: linux.STATX_SIZE,
+			Size: 0,
+		},
+	}); err != nil {
+		t.Fatalf("fd.SetStat failed: %v", err)
+	}
+	if !rf.data.IsEmpty() {
+		t.Errorf("pages beyond EOF remain allocated after truncation")
+	}
+}
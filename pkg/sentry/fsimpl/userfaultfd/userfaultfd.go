@@ -0,0 +1,282 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Package userfaultfd implements userfaultfds.
+package userfaultfd
+
+import (
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/atomicbitops"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/marshal"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/arch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/sentry/vfs"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// UserfaultfdFileDescription implements vfs.FileDescriptionImpl for
+// userfaultfds.
+//
+// +stateify savable
+type UserfaultfdFileDescription struct {
+	vfsfd vfs.FileDescription
+	vfs.FileDescriptionDefaultImpl
+	vfs.DentryMetadataFileDescriptionImpl
+	vfs.NoLockFD
+
+	uffd *mm.Userfaultfd
+
+	// apiDone is true if the UFFDIO_API handshake has completed. Until it
+	// has, all other operations fail with EINVAL.
+	apiDone atomicbitops.Bool
+}
+
+var _ vfs.FileDescriptionImpl = (*UserfaultfdFileDescription)(nil)
+
+// New returns a new userfaultfd for memory in m.
+func New(ctx context.Context, vfsObj *vfs.VirtualFilesystem, m *mm.MemoryManager, flags uint32, userModeOnly bool) (*vfs.FileDescription, error) {
+	vd := vfsObj.NewAnonVirtualDentry("[userfaultfd]")
+	defer vd.DecRef(ctx)
+	fd := &UserfaultfdFileDescription{
+		uffd: mm.NewUserfaultfd(m, userModeOnly),
+	}
+	if err := fd.vfsfd.Init(fd, flags, auth.CredentialsFromContext(ctx), vd.Mount(), vd.Dentry(), &vfs.FileDescriptionOptions{
+		UseDentryMetadata: true,
+		DenyPRead:         true,
+		DenyPWrite:        true,
+	}); err != nil {
+		return nil, err
+	}
+	return &fd.vfsfd, nil
+}
+
+// Release implements vfs.FileDescriptionImpl.Release.
+func (fd *UserfaultfdFileDescription) Release(context.Context) {
+	fd.uffd.Release()
+}
+
+// Read implements vfs.FileDescriptionImpl.Read.
+func (fd *UserfaultfdFileDescription) Read(ctx context.Context, dst usermem.IOSequence, opts vfs.ReadOptions) (int64, error) {
+	if !fd.apiDone.Load() || dst.NumBytes() < linux.SizeOfUffdMsg {
+		return 0, linuxerr.EINVAL
+	}
+	msgs := fd.uffd.ReadFaults(int(dst.NumBytes() / linux.SizeOfUffdMsg))
+	if len(msgs) == 0 {
+		return 0, linuxerr.ErrWouldBlock
+	}
+	buf := make([]byte, len(msgs)*linux.SizeOfUffdMsg)
+	linux.MarshalUnsafeUffdMsgSlice(msgs, buf)
+	// As in Linux, faults that have been read are not reported again even
+	// if copying them out fails.
+	n, err := dst.CopyOut(ctx, buf)
+	return int64(n), err
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (fd *UserfaultfdFileDescription) Readiness(mask waiter.EventMask) waiter.EventMask {
+	return fd.uffd.Readiness(mask)
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (fd *UserfaultfdFileDescription) EventRegister(e *waiter.Entry) error {
+	return fd.uffd.EventRegister(e)
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (fd *UserfaultfdFileDescription) EventUnregister(e *waiter.Entry) {
+	fd.uffd.EventUnregister(e)
+}
+
+// Epollable implements FileDescriptionImpl.Epollable.
+func (fd *UserfaultfdFileDescription) Epollable() bool {
+	return true
+}
+
+// Ioctl implements vfs.FileDescriptionImpl.Ioctl.
+func (fd *UserfaultfdFileDescription) Ioctl(ctx context.Context, uio usermem.IO, sysno uintptr, args arch.SyscallArguments) (uintptr, error) {
+	cc := &usermem.IOCopyContext{
+		Ctx: ctx,
+		IO:  uio,
+		Opts: usermem.IOOpts{
+			AddressSpaceActive: true,
+		},
+	}
+	cmd := args[1].Uint()
+	addr := args[2].Pointer()
+	if cmd == linux.UFFDIO_API {
+		return 0, fd.api(cc, addr)
+	}
+	switch cmd {
+	case linux.UFFDIO_REGISTER, linux.UFFDIO_UNREGISTER, linux.UFFDIO_WAKE, linux.UFFDIO_COPY, linux.UFFDIO_ZEROPAGE:
+		if !fd.apiDone.Load() {
+			return 0, linuxerr.EINVAL
+		}
+	default:
+		return 0, linuxerr.ENOTTY
+	}
+
+	switch cmd {
+	case linux.UFFDIO_REGISTER:
+		var reg linux.UffdioRegister
+		if _, err := reg.CopyIn(cc, addr); err != nil {
+			return 0, err
+		}
+		// Only missing-page tracking is supported.
+		if reg.Mode != linux.UFFDIO_REGISTER_MODE_MISSING {
+			return 0, linuxerr.EINVAL
+		}
+		ar, ok := rangeOf(reg.Range)
+		if !ok {
+			return 0, linuxerr.EINVAL
+		}
+		if err := fd.uffd.Register(ar); err != nil {
+			return 0, err
+		}
+		reg.Ioctls = 1<<linux.UFFDIO_WAKE_NR | 1<<linux.UFFDIO_COPY_NR | 1<<linux.UFFDIO_ZEROPAGE_NR
+		_, err := reg.CopyOut(cc, addr)
+		return 0, err
+
+	case linux.UFFDIO_UNREGISTER:
+		var rng linux.UffdioRange
+		if _, err := rng.CopyIn(cc, addr); err != nil {
+			return 0, err
+		}
+		ar, ok := rangeOf(rng)
+		if !ok {
+			return 0, linuxerr.EINVAL
+		}
+		return 0, fd.uffd.Unregister(ar)
+
+	case linux.UFFDIO_WAKE:
+		var rng linux.UffdioRange
+		if _, err := rng.CopyIn(cc, addr); err != nil {
+			return 0, err
+		}
+		ar, ok := rangeOf(rng)
+		if !ok || !ar.IsPageAligned() {
+			return 0, linuxerr.EINVAL
+		}
+		fd.uffd.Wake(ar)
+		return 0, nil
+
+	case linux.UFFDIO_COPY:
+		var cp linux.UffdioCopy
+		if _, err := cp.CopyIn(cc, addr); err != nil {
+			return 0, err
+		}
+		if cp.Mode&^linux.UFFDIO_COPY_MODE_DONTWAKE != 0 {
+			return 0, linuxerr.EINVAL
+		}
+		ar, ok := rangeOf(linux.UffdioRange{Start: cp.Dst, Len: cp.Len})
+		if !ok {
+			return 0, linuxerr.EINVAL
+		}
+		srcAR, ok := hostarch.Addr(cp.Src).ToRange(cp.Len)
+		if !ok {
+			return 0, linuxerr.EINVAL
+		}
+		src := safemem.ReaderFunc(func(dsts safemem.BlockSeq) (uint64, error) {
+			n, err := uio.CopyInTo(ctx, hostarch.AddrRangeSeqOf(srcAR), &safemem.BlockSeqWriter{Blocks: dsts}, cc.Opts)
+			srcAR.Start += hostarch.Addr(n)
+			return uint64(n), err
+		})
+		n, err := fd.uffd.Fill(ctx, ar, src)
+		cp.Copy = resultOf(n, err)
+		return 0, fd.finishFill(cc, addr, &cp, ar, n, cp.Mode&linux.UFFDIO_COPY_MODE_DONTWAKE == 0, err)
+
+	case linux.UFFDIO_ZEROPAGE:
+		var zp linux.UffdioZeropage
+		if _, err := zp.CopyIn(cc, addr); err != nil {
+			return 0, err
+		}
+		if zp.Mode&^linux.UFFDIO_ZEROPAGE_MODE_DONTWAKE != 0 {
+			return 0, linuxerr.EINVAL
+		}
+		ar, ok := rangeOf(zp.Range)
+		if !ok {
+			return 0, linuxerr.EINVAL
+		}
+		n, err := fd.uffd.Fill(ctx, ar, nil /* src */)
+		zp.Zeropage = resultOf(n, err)
+		return 0, fd.finishFill(cc, addr, &zp, ar, n, zp.Mode&linux.UFFDIO_ZEROPAGE_MODE_DONTWAKE == 0, err)
+	}
+	panic("unreachable")
+}
+
+// api handles UFFDIO_API.
+func (fd *UserfaultfdFileDescription) api(cc *usermem.IOCopyContext, addr hostarch.Addr) error {
+	var api linux.UffdioAPI
+	if _, err := api.CopyIn(cc, addr); err != nil {
+		return err
+	}
+	// No optional features are supported.
+	if api.API != linux.UFFD_API || api.Features != 0 {
+		return linuxerr.EINVAL
+	}
+	if fd.apiDone.Swap(true) {
+		return linuxerr.EINVAL
+	}
+	api.Ioctls = 1<<linux.UFFDIO_REGISTER_NR | 1<<linux.UFFDIO_UNREGISTER_NR | 1<<linux.UFFDIO_API_NR
+	_, err := api.CopyOut(cc, addr)
+	return err
+}
+
+// finishFill reports the result of a UFFDIO_COPY or UFFDIO_ZEROPAGE ioctl,
+// which populated n bytes at the start of ar, and wakes faults in the
+// populated range if wake is true.
+func (fd *UserfaultfdFileDescription) finishFill(cc *usermem.IOCopyContext, addr hostarch.Addr, res marshal.Marshallable, ar hostarch.AddrRange, n uint64, wake bool, err error) error {
+	if wake && n != 0 {
+		fd.uffd.Wake(hostarch.AddrRange{ar.Start, ar.Start + hostarch.Addr(n)})
+	}
+	if _, cerr := res.CopyOut(cc, addr); cerr != nil {
+		return cerr
+	}
+	if err != nil {
+		return err
+	}
+	if n < uint64(ar.Length()) {
+		// Partial fills without an error are retried by userspace.
+		return linuxerr.EAGAIN
+	}
+	return nil
+}
+
+// rangeOf returns the address range described by r, or false if r does not
+// describe a non-empty page-aligned range.
+func rangeOf(r linux.UffdioRange) (hostarch.AddrRange, bool) {
+	ar, ok := hostarch.Addr(r.Start).ToRange(r.Len)
+	if !ok || ar.Length() == 0 || !ar.IsPageAligned() {
+		return hostarch.AddrRange{}, false
+	}
+	return ar, true
+}
+
+// resultOf returns the value reported in uffdio_copy.copy or
+// uffdio_zeropage.zeropage for a fill that populated n bytes and returned
+// err.
+func resultOf(n uint64, err error) int64 {
+	if n != 0 || err == nil {
+		return int64(n)
+	}
+	if errno, ok := linuxerr.TranslateError(err); ok {
+		return -int64(linuxerr.ToUnix(errno))
+	}
+	return -int64(linuxerr.ToUnix(linuxerr.EFAULT))
+}
@@ -88,6 +88,21 @@ var (
 			Description: "Time waiting on host file reads from a gofer, in nanoseconds.",
 			Unit:        metricpb.MetricMetadata_UNITS_NANOSECONDS,
 		})
+	GoferDentryCacheHits = metric.MustCreateNewUint64Metric("/gofer/dentry_cache_hits",
+		metric.Uint64Metadata{
+			Cumulative:  true,
+			Description: "Number of path component lookups satisfied by cached gofer dentries.",
+		})
+	GoferDentryCacheMisses = metric.MustCreateNewUint64Metric("/gofer/dentry_cache_misses",
+		metric.Uint64Metadata{
+			Cumulative:  true,
+			Description: "Number of path component lookups that required a gofer RPC.",
+		})
+	GoferDentryCacheEvictions = metric.MustCreateNewUint64Metric("/gofer/dentry_cache_evictions",
+		metric.Uint64Metadata{
+			Cumulative:  true,
+			Description: "Number of unreferenced gofer dentries evicted from the dentry cache.",
+		})
 )
 
 // Metrics that only apply to fs/tmpfs and fsimpl/tmpfs.
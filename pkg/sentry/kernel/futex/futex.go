@@ -19,10 +19,13 @@ package futex
 
 import (
 	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/atomicbitops"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
 	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/metric"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sync"
 )
 
 // KeyKind indicates the type of a Key.
@@ -220,7 +223,8 @@ type Waiter struct {
 	// waiter is not waiting and is not in any bucket.
 	bucket AtomicPtrBucket
 
-	// C is sent to when the Waiter is woken.
+	// C is sent to when the Waiter is woken. C may be shared by the Waiters
+	// of a MultiWaiter.
 	C chan struct{}
 
 	// key is what this waiter is waiting on.
@@ -254,6 +258,52 @@ type bucket struct {
 	mu futexBucketMutex `state:"nosave"`
 
 	waiters waiterList `state:"zerovalue"`
+
+	// contended is the number of times that locking mu has found it already
+	// locked.
+	contended atomicbitops.Uint64 `state:"nosave"`
+}
+
+// Futex metrics.
+var (
+	bucketContentionCounter = metric.MustCreateNewUint64Metric(
+		"/futex/bucket_contention", metric.Uint64Metadata{
+			Cumulative:  true,
+			Description: "The number of times a futex bucket lock was contended.",
+		})
+	maxBucketContention = metric.MustCreateNewUint64Metric(
+		"/futex/max_bucket_contention", metric.Uint64Metadata{
+			Description: "The greatest number of times any single futex bucket lock was contended. If this is close to /futex/bucket_contention, contention is on a single futex rather than due to hash collisions.",
+		})
+)
+
+// lock locks b.mu.
+// +checklocksacquire:b.mu
+func (b *bucket) lock() {
+	if b.mu.TryLock() {
+		return // +checklocksforce: TryLock.
+	}
+	b.recordContention()
+	b.mu.Lock()
+}
+
+// nestedLock locks b.mu knowing that another bucket is locked.
+// +checklocksacquire:b.mu
+func (b *bucket) nestedLock() {
+	if b.mu.NestedTryLock(futexBucketLockB) {
+		return // +checklocksforce: TryLock.
+	}
+	b.recordContention()
+	b.mu.NestedLock(futexBucketLockB)
+}
+
+func (b *bucket) recordContention() {
+	n := b.contended.Add(1)
+	bucketContentionCounter.Increment()
+	// This races with other buckets, but is only an estimate anyway.
+	if n > maxBucketContention.Value() {
+		maxBucketContention.Set(n)
+	}
 }
 
 // wakeLocked wakes up to n waiters matching the bitmask at the addr for this
@@ -279,9 +329,14 @@ func (b *bucket) wakeLocked(key *Key, bitmask uint32, n int) int {
 }
 
 func (b *bucket) wakeWaiterLocked(w *Waiter) {
-	// Remove from the bucket and wake the waiter.
+	// Remove from the bucket and wake the waiter. The send can only fail if
+	// w.C is shared with other Waiters that have already been woken; see
+	// MultiWaiter.
 	b.waiters.Remove(w)
-	w.C <- struct{}{}
+	select {
+	case w.C <- struct{}{}:
+	default:
+	}
 
 	// NOTE: The above channel write establishes a write barrier according
 	// to the memory model, so nothing may be ordered around it. Since
@@ -320,12 +375,37 @@ func (b *bucket) requeueLocked(t Target, to *bucket, key, nkey *Key, n int) int
 }
 
 const (
-	// bucketCount is the number of buckets per Manager. By having many of
-	// these we reduce contention when concurrent yet unrelated calls are made.
-	bucketCount     = 1 << bucketCountBits
-	bucketCountBits = 10
+	// minBucketCountBits is log2 of the minimum number of buckets in a
+	// bucketTable. By having many of these we reduce contention when
+	// concurrent yet unrelated calls are made.
+	minBucketCountBits = 10
+
+	// privateBucketsPerCPU and maxPrivateBucketCountBits determine the
+	// number of buckets per Manager for private futexes, which is scaled with
+	// the number of CPUs since concurrent futex operations are bounded by the
+	// number of tasks that can run at once.
+	privateBucketsPerCPU      = 64
+	maxPrivateBucketCountBits = 14
+
+	// sharedBucketsPerCPU and maxSharedBucketCountBits determine the number
+	// of buckets for shared futexes. Since there is one table of shared
+	// buckets for all Managers, it can afford to be larger, as in Linux's
+	// futex_init().
+	sharedBucketsPerCPU      = 256
+	maxSharedBucketCountBits = 16
 )
 
+// bucketCountForCPUs returns the number of buckets in a bucketTable with
+// perCPU buckets per CPU, rounded up to a power of 2 and clamped to
+// [1 << minBucketCountBits, 1 << maxBits].
+func bucketCountForCPUs(cpus uint, perCPU uint, maxBits uint) int {
+	n := uint(1) << minBucketCountBits
+	for n < cpus*perCPU && n < 1<<maxBits {
+		n <<= 1
+	}
+	return int(n)
+}
+
 // getKey returns a Key representing address addr in c.
 func getKey(t Target, addr hostarch.Addr, private bool) (Key, error) {
 	addr = hostarch.UntaggedUserAddr(addr)
@@ -340,8 +420,9 @@ func getKey(t Target, addr hostarch.Addr, private bool) (Key, error) {
 	return t.GetSharedKey(addr)
 }
 
-// bucketIndexForAddr returns the index into Manager.buckets for addr.
-func bucketIndexForAddr(addr hostarch.Addr) uintptr {
+// bucketHashForAddr returns a hash of addr, which bucketTable.index reduces to
+// a bucket index.
+func bucketHashForAddr(addr hostarch.Addr) uintptr {
 	//	- The bottom 2 bits of addr must be 0, per getKey.
 	//
 	//	- On amd64, the top 16 bits of addr (bits 48-63) must be equal to bit 47
@@ -350,9 +431,10 @@ func bucketIndexForAddr(addr hostarch.Addr) uintptr {
 	//
 	// Thus 19 bits of addr are "useless" for hashing, leaving only 45 "useful"
 	// bits. We choose one of the simplest possible hash functions that at
-	// least uses all 45 useful bits in the output, given that bucketCountBits
-	// == 10. This hash function also has the property that it will usually map
-	// adjacent addresses to adjacent buckets, slightly improving memory
+	// least uses all 45 useful bits in the output, given that bucket indices
+	// use at least the low minBucketCountBits bits of the hash. This hash
+	// function also has the property that it will usually map adjacent
+	// addresses to adjacent buckets, slightly improving memory
 	// locality when an application synchronization structure uses multiple
 	// nearby futexes.
 	//
@@ -364,27 +446,58 @@ func bucketIndexForAddr(addr hostarch.Addr) uintptr {
 	// additions in the critical path.
 	h1 := uintptr(addr>>2) + uintptr(addr>>12) + uintptr(addr>>22)
 	h2 := uintptr(addr>>32) + uintptr(addr>>42)
-	return (h1 + h2) % bucketCount
+	return h1 + h2
+}
+
+// bucketTable is a hash table of buckets.
+//
+// +stateify savable
+type bucketTable struct {
+	// buckets is the table's buckets. len(buckets) is a power of 2, and
+	// buckets is immutable.
+	buckets []bucket
+}
+
+func newBucketTable(n int) bucketTable {
+	return bucketTable{
+		buckets: make([]bucket, n),
+	}
+}
+
+// index returns the index into bt.buckets for the given hash.
+func (bt *bucketTable) index(hash uintptr) uintptr {
+	return hash & uintptr(len(bt.buckets)-1)
 }
 
 // Manager holds futex state for a single virtual address space.
 //
 // +stateify savable
 type Manager struct {
-	// privateBuckets holds buckets for KindPrivate and KindSharedPrivate
-	// futexes.
-	privateBuckets [bucketCount]bucket `state:"zerovalue"`
+	// private holds buckets for KindPrivate and KindSharedPrivate futexes.
+	// It is allocated by the first operation on a private futex, since every
+	// process gets its own Manager and many never use futexes. private is
+	// nil or immutable.
+	private AtomicPtrBucketTable
 
-	// sharedBucket is the bucket for KindSharedMappable futexes. sharedBucket
-	// may be shared by multiple Managers. The sharedBucket pointer is
+	// privateMu serializes allocation of private.
+	privateMu sync.Mutex `state:"nosave"`
+
+	// privateBuckets is the number of buckets in private. privateBuckets is
 	// immutable.
-	sharedBucket *bucket
+	privateBuckets int
+
+	// shared holds buckets for KindSharedMappable futexes. shared may be
+	// shared by multiple Managers. The shared pointer is immutable.
+	shared *bucketTable
 }
 
-// NewManager returns an initialized futex manager.
-func NewManager() *Manager {
+// NewManager returns an initialized futex manager whose bucket tables are
+// sized for the given number of CPUs.
+func NewManager(cpus uint) *Manager {
+	shared := newBucketTable(bucketCountForCPUs(cpus, sharedBucketsPerCPU, maxSharedBucketCountBits))
 	return &Manager{
-		sharedBucket: &bucket{},
+		privateBuckets: bucketCountForCPUs(cpus, privateBucketsPerCPU, maxPrivateBucketCountBits),
+		shared:         &shared,
 	}
 }
 
@@ -392,19 +505,48 @@ func NewManager() *Manager {
 // may interoperate with those using m.
 func (m *Manager) Fork() *Manager {
 	return &Manager{
-		sharedBucket: m.sharedBucket,
+		privateBuckets: m.privateBuckets,
+		shared:         m.shared,
 	}
 }
 
+// privateTable returns m.private, allocating it if necessary.
+func (m *Manager) privateTable() *bucketTable {
+	if bt := m.private.Load(); bt != nil {
+		return bt
+	}
+	m.privateMu.Lock()
+	defer m.privateMu.Unlock()
+	bt := m.private.Load()
+	if bt == nil {
+		private := newBucketTable(m.privateBuckets)
+		bt = &private
+		m.private.Store(bt)
+	}
+	return bt
+}
+
+// bucketFor returns the bucket for the given key, and the bucket's position in
+// the order in which buckets must be locked.
+func (m *Manager) bucketFor(k *Key) (*bucket, uintptr) {
+	if k.Kind == KindSharedMappable {
+		// Shared futexes are hashed only by offset, so the same offset in
+		// different Mappables maps to the same bucket; this is harmless since
+		// waiters are matched by the full key. Buckets in m.shared are
+		// ordered after all buckets in m.private.
+		i := m.shared.index(bucketHashForAddr(hostarch.Addr(k.Offset)))
+		return &m.shared.buckets[i], uintptr(m.privateBuckets) + i
+	}
+	private := m.privateTable()
+	i := private.index(bucketHashForAddr(k.addr()))
+	return &private.buckets[i], i
+}
+
 // lockBucket returns a locked bucket for the given key.
 // +checklocksacquire:b.mu
 func (m *Manager) lockBucket(k *Key) (b *bucket) {
-	if k.Kind == KindSharedMappable {
-		b = m.sharedBucket
-	} else {
-		b = &m.privateBuckets[bucketIndexForAddr(k.addr())]
-	}
-	b.mu.Lock()
+	b, _ = m.bucketFor(k)
+	b.lock()
 	return b
 }
 
@@ -416,46 +558,22 @@ func (m *Manager) lockBucket(k *Key) (b *bucket) {
 // +checklocksacquire:lockedSecond.mu
 func (m *Manager) lockBuckets(k1, k2 *Key) (b1, b2, lockedFirst, lockedSecond *bucket) {
 	// Buckets must be consistently ordered to avoid circular lock
-	// dependencies. We order buckets in m.privateBuckets by index (lowest
-	// index first), and all buckets in m.privateBuckets precede
-	// m.sharedBucket.
-
-	// Handle the common case first:
-	if k1.Kind != KindSharedMappable && k2.Kind != KindSharedMappable {
-		i1 := bucketIndexForAddr(k1.addr())
-		i2 := bucketIndexForAddr(k2.addr())
-		b1 = &m.privateBuckets[i1]
-		b2 = &m.privateBuckets[i2]
-		switch {
-		case i1 < i2:
-			b1.mu.Lock()
-			b2.mu.NestedLock(futexBucketLockB)
-			return b1, b2, b1, b2
-		case i2 < i1:
-			b2.mu.Lock()
-			b1.mu.NestedLock(futexBucketLockB)
-			return b1, b2, b2, b1
-		default:
-			b1.mu.Lock()
-			return b1, b2, b1, nil // +checklocksforce
-		}
-	}
-
-	// At least one of b1 or b2 should be m.sharedBucket.
-	b1 = m.sharedBucket
-	b2 = m.sharedBucket
-	if k1.Kind != KindSharedMappable {
-		b1 = m.lockBucket(k1)
-		b2.mu.NestedLock(futexBucketLockB)
+	// dependencies; see Manager.bucketFor.
+	b1, o1 := m.bucketFor(k1)
+	b2, o2 := m.bucketFor(k2)
+	switch {
+	case o1 < o2:
+		b1.lock()
+		b2.nestedLock()
 		return b1, b2, b1, b2
-	}
-	if k2.Kind != KindSharedMappable {
-		b2 = m.lockBucket(k2)
-		b1.mu.NestedLock(futexBucketLockB)
+	case o2 < o1:
+		b2.lock()
+		b1.nestedLock()
 		return b1, b2, b2, b1
+	default:
+		b1.lock()
+		return b1, b2, b1, nil // +checklocksforce
 	}
-	b1.mu.Lock()
-	return b1, b2, b1, nil // +checklocksforce
 }
 
 // unlockBuckets unlocks two buckets.
@@ -605,6 +723,13 @@ func (m *Manager) WaitPrepare(w *Waiter, t Target, addr hostarch.Addr, private b
 // WaitComplete must be called when a Waiter previously added by WaitPrepare is
 // no longer eligible to be woken.
 func (m *Manager) WaitComplete(w *Waiter, t Target) {
+	m.waitComplete(w, t)
+}
+
+// waitComplete implements WaitComplete, and returns true if w was dequeued by
+// a wakeup rather than by waitComplete.
+func (m *Manager) waitComplete(w *Waiter, t Target) bool {
+	woken := true
 	// Remove w from the bucket it's in.
 	for {
 		b := w.bucket.Load()
@@ -622,7 +747,7 @@ func (m *Manager) WaitComplete(w *Waiter, t Target) {
 		// it happens to have changed, we release the old bucket lock and try
 		// again with the new bucket; if it hasn't changed, we know it won't
 		// change now because we hold the lock.
-		b.mu.Lock()
+		b.lock()
 		if b != w.bucket.Load() {
 			b.mu.Unlock()
 			continue
@@ -632,11 +757,120 @@ func (m *Manager) WaitComplete(w *Waiter, t Target) {
 		b.waiters.Remove(w)
 		w.bucket.Store(nil)
 		b.mu.Unlock()
+		woken = false
 		break
 	}
 
 	// Release references held by the waiter.
 	w.key.release(t)
+	return woken
+}
+
+// WaitvFutex is one of the futexes waited on by Manager.WaitvPrepare.
+type WaitvFutex struct {
+	// Addr is the address of the futex.
+	Addr hostarch.Addr
+
+	// Private is true if the futex is private.
+	Private bool
+
+	// Val is the value that the futex must contain for the wait to proceed.
+	Val uint32
+}
+
+// MultiWaiter waits on up to linux.FUTEX_WAITV_MAX futexes at once, as for
+// futex_waitv(2). Each futex is waited on by one of its Waiters, all of which
+// share the channel C.
+type MultiWaiter struct {
+	// C is sent to when any of the waited-on futexes is woken.
+	C chan struct{}
+
+	// waiters[:n] are the Waiters for the futexes passed to the last call to
+	// WaitvPrepare.
+	waiters [linux.FUTEX_WAITV_MAX]Waiter
+	n       int
+}
+
+// NewMultiWaiter returns a new unqueued MultiWaiter.
+func NewMultiWaiter() *MultiWaiter {
+	mw := &MultiWaiter{
+		C: make(chan struct{}, 1),
+	}
+	for i := range mw.waiters {
+		mw.waiters[i].C = mw.C
+	}
+	return mw
+}
+
+// WaitvPrepare atomically checks that each futex in fs contains its expected
+// value, then enqueues mw to be woken by a send to mw.C when any of them is
+// woken. If WaitvPrepare returns (-1, nil), mw must be subsequently removed by
+// calling WaitvComplete, whether or not a wakeup is received on mw.C.
+//
+// If a futex does not contain its expected value, mw is removed from the
+// futexes it was already enqueued on. If one of them was woken in the
+// meantime, WaitvPrepare returns its index and a nil error, and the wakeup
+// must be reported to the caller as for WaitvComplete; compare Linux's
+// kernel/futex/waitwake.c:futex_wait_multiple_setup(). Otherwise,
+// WaitvPrepare returns the error.
+//
+// Preconditions: 0 < len(fs) <= linux.FUTEX_WAITV_MAX.
+func (m *Manager) WaitvPrepare(mw *MultiWaiter, t Target, fs []WaitvFutex) (int, error) {
+	// Obtain all keys before queueing anything, so that invalid futexes are
+	// reported without having to unwind.
+	for i := range fs {
+		k, err := getKey(t, fs[i].Addr, fs[i].Private)
+		if err != nil {
+			for j := 0; j < i; j++ {
+				mw.waiters[j].key.release(t)
+			}
+			return -1, err
+		}
+		// Ownership of k is transferred to mw.waiters[i].
+		mw.waiters[i].key = k
+		mw.waiters[i].bitmask = linux.FUTEX_BITSET_MATCH_ANY
+	}
+
+	// Prepare the MultiWaiter before taking any bucket lock.
+	select {
+	case <-mw.C:
+	default:
+	}
+	mw.n = 0
+
+	for i := range fs {
+		w := &mw.waiters[i]
+		b := m.lockBucket(&w.key)
+		if err := check(t, fs[i].Addr, fs[i].Val); err != nil {
+			b.mu.Unlock()
+			for j := i; j < len(fs); j++ {
+				mw.waiters[j].key.release(t)
+			}
+			if idx := m.WaitvComplete(mw, t); idx >= 0 {
+				return idx, nil
+			}
+			return -1, err
+		}
+		b.waiters.PushBack(w)
+		w.bucket.Store(b)
+		b.mu.Unlock()
+		mw.n++
+	}
+	return -1, nil
+}
+
+// WaitvComplete must be called when a MultiWaiter previously added by
+// WaitvPrepare is no longer eligible to be woken. It returns the index of the
+// first futex whose wakeup woke mw, or -1 if mw was not woken.
+func (m *Manager) WaitvComplete(mw *MultiWaiter, t Target) int {
+	idx := -1
+	for i := 0; i < mw.n; i++ {
+		if m.waitComplete(&mw.waiters[i], t) && idx < 0 {
+			idx = i
+		}
+	}
+	mw.n = 0
+	return idx
 }
 
 // LockPI attempts to lock the futex following the Priority-inheritance futex
@@ -648,6 +882,18 @@ func (m *Manager) WaitComplete(w *Waiter, t Target) {
 // exit_robust_list()). Given we don't support robust lists, although handled
 // below, it's never set.
 func (m *Manager) LockPI(w *Waiter, t Target, addr hostarch.Addr, tid uint32, private, try bool) (bool, error) {
+	// Fast path: an unowned futex can be acquired without getting its key or
+	// locking its bucket, since waiters are only queued on owned futexes.
+	if addr&0x3 == 0 {
+		prev, err := t.CompareAndSwapUint32(addr, 0, tid)
+		if err != nil {
+			return false, err
+		}
+		if prev == 0 {
+			return true, nil
+		}
+	}
+
 	k, err := getKey(t, addr, private)
 	if err != nil {
 		return false, err
@@ -741,6 +987,20 @@ func (m *Manager) lockPILocked(w *Waiter, t Target, addr hostarch.Addr, tid uint
 // TID of the next waiter (FIFO) is set to the given address, and the waiter
 // woken up. If there are no waiters, 0 is set to the address.
 func (m *Manager) UnlockPI(t Target, addr hostarch.Addr, tid uint32, private bool) error {
+	// Fast path: a futex owned by tid without FUTEX_WAITERS has no waiters to
+	// hand off to, so it can be released without getting its key or locking
+	// its bucket. A concurrent LockPI that is about to wait must set
+	// FUTEX_WAITERS first, which will either fail or cause this to fail.
+	if addr&0x3 == 0 {
+		prev, err := t.CompareAndSwapUint32(addr, tid, 0)
+		if err != nil {
+			return err
+		}
+		if prev == tid {
+			return nil
+		}
+	}
+
 	k, err := getKey(t, addr, private)
 	if err != nil {
 		return err
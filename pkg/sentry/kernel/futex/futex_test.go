@@ -20,6 +20,7 @@ import (
 	"testing"
 	"unsafe"
 
+	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/atomicbitops"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
@@ -84,7 +85,7 @@ func newPreparedTestWaiter(t *testing.T, m *Manager, ta Target, addr hostarch.Ad
 func TestFutexWake(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(sizeofInt32)
 
 			// Start waiting for wakeup.
@@ -107,7 +108,7 @@ func TestFutexWake(t *testing.T) {
 func TestFutexWakeBitmask(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(sizeofInt32)
 
 			// Start waiting for wakeup.
@@ -140,7 +141,7 @@ func TestFutexWakeBitmask(t *testing.T) {
 func TestFutexWakeTwo(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(sizeofInt32)
 
 			// Start three waiters waiting for wakeup.
@@ -175,7 +176,7 @@ func TestFutexWakeTwo(t *testing.T) {
 func TestFutexWakeUnrelated(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(2 * sizeofInt32)
 
 			// Start two waiters waiting for wakeup on different addresses.
@@ -203,7 +204,7 @@ func TestFutexWakeUnrelated(t *testing.T) {
 func TestWakeOpEmpty(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(2 * sizeofInt32)
 
 			// Perform wakeups with no waiters.
@@ -217,7 +218,7 @@ func TestWakeOpEmpty(t *testing.T) {
 func TestWakeOpFirstNonEmpty(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add two waiters on address 0.
@@ -245,7 +246,7 @@ func TestWakeOpFirstNonEmpty(t *testing.T) {
 func TestWakeOpSecondNonEmpty(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add two waiters on address sizeofInt32.
@@ -274,7 +275,7 @@ func TestWakeOpSecondNonEmpty(t *testing.T) {
 func TestWakeOpSecondNonEmptyFailingOp(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add two waiters on address sizeofInt32.
@@ -303,7 +304,7 @@ func TestWakeOpSecondNonEmptyFailingOp(t *testing.T) {
 func TestWakeOpAllNonEmpty(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add two waiters on address 0.
@@ -345,7 +346,7 @@ func TestWakeOpAllNonEmpty(t *testing.T) {
 func TestWakeOpAllNonEmptyFailingOp(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add two waiters on address 0.
@@ -387,7 +388,7 @@ func TestWakeOpAllNonEmptyFailingOp(t *testing.T) {
 func TestWakeOpSameAddress(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add four waiters on address 0.
@@ -421,7 +422,7 @@ func TestWakeOpSameAddress(t *testing.T) {
 func TestWakeOpSameAddressFailingOp(t *testing.T) {
 	for _, private := range []bool{false, true} {
 		t.Run(futexKind(private), func(t *testing.T) {
-			m := NewManager()
+			m := NewManager(1)
 			d := newTestData(8)
 
 			// Add four waiters on address 0.
@@ -452,6 +453,275 @@ func TestWakeOpSameAddressFailingOp(t *testing.T) {
 	}
 }
 
+func TestBucketCountForCPUs(t *testing.T) {
+	for _, test := range []struct {
+		cpus uint
+		want int
+	}{
+		{cpus: 1, want: 1 << minBucketCountBits},
+		{cpus: 16, want: 1 << minBucketCountBits},
+		{cpus: 17, want: 2 << minBucketCountBits},
+		{cpus: 64, want: 4 << minBucketCountBits},
+		{cpus: 100, want: 8 << minBucketCountBits},
+		{cpus: 1024, want: 1 << maxPrivateBucketCountBits},
+	} {
+		if got := bucketCountForCPUs(test.cpus, privateBucketsPerCPU, maxPrivateBucketCountBits); got != test.want {
+			t.Errorf("bucketCountForCPUs(%d): got %d, wanted %d", test.cpus, got, test.want)
+		}
+	}
+}
+
+func TestPrivateBucketsAllocatedOnUse(t *testing.T) {
+	m := NewManager(64).Fork()
+	if m.private.Load() != nil {
+		t.Fatal("private buckets allocated before first use")
+	}
+	d := newTestData(sizeofInt32)
+	if _, err := m.Wake(d, 0, true /* private */, ^uint32(0), 1); err != nil {
+		t.Fatalf("Wake: %v", err)
+	}
+	private := m.private.Load()
+	if private == nil {
+		t.Fatal("private buckets not allocated by first use")
+	}
+	if got, want := len(private.buckets), bucketCountForCPUs(64, privateBucketsPerCPU, maxPrivateBucketCountBits); got != want {
+		t.Errorf("got %d private buckets, wanted %d", got, want)
+	}
+}
+
+func TestRequeueAcrossBuckets(t *testing.T) {
+	for _, private := range []bool{false, true} {
+		t.Run(futexKind(private), func(t *testing.T) {
+			m := NewManager(64)
+			d := newTestData(2 * hostarch.PageSize)
+			// Choose addresses that hash to different buckets in both bucket
+			// tables.
+			const addr1, addr2 = 0, hostarch.PageSize + sizeofInt32
+
+			w := newPreparedTestWaiter(t, m, d, addr1, private, 0, ^uint32(0))
+			defer m.WaitComplete(w, d)
+			if n, err := m.Requeue(d, addr1, addr2, private, 0, 1); err != nil || n != 0 {
+				t.Fatalf("Requeue: got (%d, %v), wanted (0, nil)", n, err)
+			}
+			if w.woken() {
+				t.Error("waiter woken by requeue")
+			}
+			if n, err := m.Wake(d, addr2, private, ^uint32(0), 1); err != nil || n != 1 {
+				t.Errorf("Wake: got (%d, %v), wanted (1, nil)", n, err)
+			}
+			if !w.woken() {
+				t.Error("waiter not woken")
+			}
+		})
+	}
+}
+
+func testWaitvFutexes(private bool, n int) []WaitvFutex {
+	fs := make([]WaitvFutex, n)
+	for i := range fs {
+		fs[i] = WaitvFutex{
+			Addr:    hostarch.Addr(i * sizeofInt32),
+			Private: private,
+		}
+	}
+	return fs
+}
+
+func TestWaitvWake(t *testing.T) {
+	for _, private := range []bool{false, true} {
+		t.Run(futexKind(private), func(t *testing.T) {
+			m := NewManager(1)
+			d := newTestData(4 * sizeofInt32)
+			mw := NewMultiWaiter()
+			if _, err := m.WaitvPrepare(mw, d, testWaitvFutexes(private, 4)); err != nil {
+				t.Fatalf("WaitvPrepare failed: %v", err)
+			}
+
+			// Wake the third futex.
+			if n, err := m.Wake(d, 2*sizeofInt32, private, ^uint32(0), 1); err != nil || n != 1 {
+				t.Errorf("Wake: got (%d, %v), wanted (1, nil)", n, err)
+			}
+
+			// Expect the MultiWaiter to have been woken by the third futex, and
+			// to no longer be waiting on the others.
+			select {
+			case <-mw.C:
+			default:
+				t.Error("MultiWaiter not woken")
+			}
+			if idx := m.WaitvComplete(mw, d); idx != 2 {
+				t.Errorf("WaitvComplete: got %d, wanted 2", idx)
+			}
+			if n, err := m.Wake(d, 0, private, ^uint32(0), 1); err != nil || n != 0 {
+				t.Errorf("Wake after WaitvComplete: got (%d, %v), wanted (0, nil)", n, err)
+			}
+		})
+	}
+}
+
+func TestWaitvWakeMultiple(t *testing.T) {
+	m := NewManager(1)
+	d := newTestData(4 * sizeofInt32)
+	mw := NewMultiWaiter()
+	if _, err := m.WaitvPrepare(mw, d, testWaitvFutexes(true, 4)); err != nil {
+		t.Fatalf("WaitvPrepare failed: %v", err)
+	}
+
+	// Waking several of the futexes must not block, even though they share a
+	// channel, and the lowest woken index wins.
+	for _, i := range []int{3, 1} {
+		if n, err := m.Wake(d, hostarch.Addr(i*sizeofInt32), true, ^uint32(0), 1); err != nil || n != 1 {
+			t.Errorf("Wake(%d): got (%d, %v), wanted (1, nil)", i, n, err)
+		}
+	}
+	if idx := m.WaitvComplete(mw, d); idx != 1 {
+		t.Errorf("WaitvComplete: got %d, wanted 1", idx)
+	}
+}
+
+func TestWaitvTimeout(t *testing.T) {
+	m := NewManager(1)
+	d := newTestData(4 * sizeofInt32)
+	mw := NewMultiWaiter()
+	if _, err := m.WaitvPrepare(mw, d, testWaitvFutexes(true, 4)); err != nil {
+		t.Fatalf("WaitvPrepare failed: %v", err)
+	}
+	if idx := m.WaitvComplete(mw, d); idx != -1 {
+		t.Errorf("WaitvComplete: got %d, wanted -1", idx)
+	}
+	for i := 0; i < 4; i++ {
+		if n, err := m.Wake(d, hostarch.Addr(i*sizeofInt32), true, ^uint32(0), 1); err != nil || n != 0 {
+			t.Errorf("Wake(%d) after WaitvComplete: got (%d, %v), wanted (0, nil)", i, n, err)
+		}
+	}
+}
+
+func TestWaitvValueMismatch(t *testing.T) {
+	m := NewManager(1)
+	d := newTestData(4 * sizeofInt32)
+	mw := NewMultiWaiter()
+	fs := testWaitvFutexes(true, 4)
+	fs[2].Val = 1
+	if idx, err := m.WaitvPrepare(mw, d, fs); idx != -1 || !linuxerr.Equals(linuxerr.EAGAIN, err) {
+		t.Fatalf("WaitvPrepare: got (%d, %v), wanted (-1, EAGAIN)", idx, err)
+	}
+
+	// Waiters queued before the mismatch must have been dequeued.
+	for i := 0; i < 4; i++ {
+		if n, err := m.Wake(d, hostarch.Addr(i*sizeofInt32), true, ^uint32(0), 1); err != nil || n != 0 {
+			t.Errorf("Wake(%d): got (%d, %v), wanted (0, nil)", i, n, err)
+		}
+	}
+}
+
+// wakeOnLoad is a Target that wakes the private futex at wakeAddr when the
+// futex at loadAddr is loaded.
+type wakeOnLoad struct {
+	testData
+	m        *Manager
+	loadAddr hostarch.Addr
+	wakeAddr hostarch.Addr
+}
+
+func (t wakeOnLoad) LoadUint32(addr hostarch.Addr) (uint32, error) {
+	if addr == t.loadAddr {
+		t.m.Wake(t.testData, t.wakeAddr, true, ^uint32(0), 1)
+	}
+	return t.testData.LoadUint32(addr)
+}
+
+func TestWaitvValueMismatchAfterWake(t *testing.T) {
+	m := NewManager(1)
+	d := newTestData(2 * sizeofInt32)
+	mw := NewMultiWaiter()
+	// The second futex is shared, so that its bucket, which is locked while
+	// its value is loaded, differs from the first futex's.
+	fs := testWaitvFutexes(true, 2)
+	fs[1].Private = false
+	fs[1].Val = 1
+	target := wakeOnLoad{testData: d, m: m, loadAddr: fs[1].Addr, wakeAddr: fs[0].Addr}
+	if idx, err := m.WaitvPrepare(mw, target, fs); idx != 0 || err != nil {
+		t.Fatalf("WaitvPrepare: got (%d, %v), wanted (0, nil)", idx, err)
+	}
+}
+
+func TestLockPIUncontended(t *testing.T) {
+	for _, private := range []bool{false, true} {
+		t.Run(futexKind(private), func(t *testing.T) {
+			m := NewManager(1)
+			d := newTestData(sizeofInt32)
+			const tid = 1
+
+			if ok, err := m.LockPI(NewWaiter(), d, 0, tid, private, false); err != nil || !ok {
+				t.Fatalf("LockPI: got (%t, %v), wanted (true, nil)", ok, err)
+			}
+			if v, _ := d.LoadUint32(0); v != tid {
+				t.Errorf("futex value after LockPI: got %#x, wanted %#x", v, tid)
+			}
+			if _, err := m.LockPI(NewWaiter(), d, 0, tid, private, false); !linuxerr.Equals(linuxerr.EDEADLK, err) {
+				t.Errorf("recursive LockPI: got %v, wanted EDEADLK", err)
+			}
+			if err := m.UnlockPI(d, 0, tid+1, private); !linuxerr.Equals(linuxerr.EPERM, err) {
+				t.Errorf("UnlockPI by non-owner: got %v, wanted EPERM", err)
+			}
+			if err := m.UnlockPI(d, 0, tid, private); err != nil {
+				t.Fatalf("UnlockPI: got %v, wanted nil", err)
+			}
+			if v, _ := d.LoadUint32(0); v != 0 {
+				t.Errorf("futex value after UnlockPI: got %#x, wanted 0", v)
+			}
+		})
+	}
+}
+
+func TestUnlockPIHandoff(t *testing.T) {
+	for _, private := range []bool{false, true} {
+		t.Run(futexKind(private), func(t *testing.T) {
+			m := NewManager(1)
+			d := newTestData(sizeofInt32)
+			const owner, waiter = 1, 2
+
+			if ok, err := m.LockPI(NewWaiter(), d, 0, owner, private, false); err != nil || !ok {
+				t.Fatalf("LockPI(owner): got (%t, %v), wanted (true, nil)", ok, err)
+			}
+			if ok, err := m.LockPI(NewWaiter(), d, 0, waiter, private, true); err != nil || ok {
+				t.Fatalf("TryLockPI(waiter): got (%t, %v), wanted (false, nil)", ok, err)
+			}
+			w := NewWaiter()
+			if ok, err := m.LockPI(w, d, 0, waiter, private, false); err != nil || ok {
+				t.Fatalf("LockPI(waiter): got (%t, %v), wanted (false, nil)", ok, err)
+			}
+			defer m.WaitComplete(w, d)
+			if v, _ := d.LoadUint32(0); v != owner|linux.FUTEX_WAITERS {
+				t.Errorf("futex value with waiter: got %#x, wanted %#x", v, owner|linux.FUTEX_WAITERS)
+			}
+
+			// Unlocking must take the slow path and hand the futex to the
+			// waiter.
+			if err := m.UnlockPI(d, 0, owner, private); err != nil {
+				t.Fatalf("UnlockPI: got %v, wanted nil", err)
+			}
+			if !w.woken() {
+				t.Error("waiter not woken")
+			}
+			if v, _ := d.LoadUint32(0); v != waiter {
+				t.Errorf("futex value after handoff: got %#x, wanted %#x", v, waiter)
+			}
+		})
+	}
+}
+
+func TestLockPIUnaligned(t *testing.T) {
+	m := NewManager(1)
+	d := newTestData(2 * sizeofInt32)
+	if _, err := m.LockPI(NewWaiter(), d, 1, 1, true, false); !linuxerr.Equals(linuxerr.EINVAL, err) {
+		t.Errorf("LockPI: got %v, wanted EINVAL", err)
+	}
+	if err := m.UnlockPI(d, 1, 1, true); !linuxerr.Equals(linuxerr.EINVAL, err) {
+		t.Errorf("UnlockPI: got %v, wanted EINVAL", err)
+	}
+}
+
 const (
 	testMutexSize            = sizeofInt32
 	testMutexLocked   uint32 = 1
@@ -520,7 +790,7 @@ func HammerMutex(l sync.Locker, loops int, cdone chan bool) {
 }
 
 func TestMutexStress(t *testing.T) {
-	m := NewManager()
+	m := NewManager(1)
 	d := newTestData(testMutexSize)
 	tm := newTestMutex(0*testMutexSize, d, m)
 	c := make(chan bool)
@@ -570,7 +570,7 @@ func (k *Kernel) Init(args InitKernelArgs) error {
 	k.extraAuxv = args.ExtraAuxv
 	k.vdso = args.Vdso
 	k.vdsoParams = args.VdsoParams
-	k.futexes = futex.NewManager()
+	k.futexes = futex.NewManager(k.applicationCores)
 	k.netlinkPorts = port.New()
 	k.ptraceExceptions = make(map[*Task]*Task)
 	k.YAMAPtraceScope = atomicbitops.FromInt32(linux.YAMA_SCOPE_RELATIONAL)
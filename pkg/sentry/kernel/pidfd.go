@@ -22,6 +22,7 @@ import (
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
 	"gvisor.dev/gvisor/pkg/sentry/fsimpl/kernfs"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/waiter"
 )
@@ -203,6 +204,63 @@ func (t *Task) ThreadGroupFromPIDFD(pfdNum int32) (*ThreadGroup, bool, error) {
 	return tg, nonBlock, nil
 }
 
+// MemoryManagerFromPIDFD returns the task referred to by the integral pidfd
+// and its MemoryManager, with an additional user reference that the caller
+// must release with MemoryManager.DecUsers. It helps implement
+// process_madvise(2) and process_mrelease(2), and performs no permission
+// checks.
+func (t *Task) MemoryManagerFromPIDFD(pfdNum int32) (*Task, *mm.MemoryManager, error) {
+	pfd, err := t.pidFDFromFDNum(pfdNum)
+	if err != nil {
+		return nil, nil, err
+	}
+	target := pfd.pid.t.Load()
+	if target == nil {
+		return nil, nil, linuxerr.ESRCH
+	}
+	var m *mm.MemoryManager
+	target.WithMuLocked(func(*Task) {
+		m = target.MemoryManager()
+	})
+	// Tasks that have exited no longer have a MemoryManager.
+	if m == nil || !m.IncUsers() {
+		return nil, nil, linuxerr.ESRCH
+	}
+	return target, m, nil
+}
+
+// MemoryManagerWillBeReleased returns true if m, which must be target's
+// MemoryManager, will be released without further use because every task
+// using it is exiting. It is analogous to Linux's
+// mm/oom_kill.c:task_will_free_mem().
+//
+// Preconditions: The caller holds a user of m.
+func (t *Task) MemoryManagerWillBeReleased(target *Task, m *mm.MemoryManager) bool {
+	ts := t.k.tasks
+	ts.mu.RLock()
+	defer ts.mu.RUnlock()
+	tg := target.tg
+	tg.signalHandlers.mu.Lock()
+	defer tg.signalHandlers.mu.Unlock()
+	if !tg.exiting {
+		return false
+	}
+	// Every task using m holds a user of m. If m has more users than the
+	// tasks in tg that use it, plus the caller, then m is also used outside
+	// of tg, either by another process sharing m or by a transient user
+	// (e.g. a reader of /proc/[pid]/mem), and may not be released. Unlike
+	// Linux, which scans every process in this case, treat m as in use.
+	var tgUsers int32
+	for user := tg.tasks.Front(); user != nil; user = user.Next() {
+		user.mu.Lock()
+		if user.MemoryManager() == m {
+			tgUsers++
+		}
+		user.mu.Unlock()
+	}
+	return m.Users() <= tgUsers+1
+}
+
 func (t *Task) pidFDFromFDNum(pfdNum int32) (*pidFD, error) {
 	file := t.GetFile(pfdNum)
 	if file == nil {
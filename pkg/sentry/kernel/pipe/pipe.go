@@ -23,7 +23,9 @@ import (
 	"gvisor.dev/gvisor/pkg/atomicbitops"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
 	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
 	"gvisor.dev/gvisor/pkg/waiter"
 )
 
@@ -144,6 +146,21 @@ type Pipe struct {
 	off         int64
 	size        int64
 
+	// exts describes the order of the pipe's data when some of it is held
+	// by reference to memmap.File pages rather than in buf, as a result of
+	// splicing from a vfs.SplicePageSource. If exts is empty, all size bytes
+	// are stored in buf. Otherwise, the sizes of all extents in exts sum to
+	// size, and extents with a nil file are stored in buf in order. refSize is
+	// the number of bytes in extents with a non-nil file. refPages is the
+	// number of page references held by those extents; see maxRefPagesLocked.
+	//
+	// exts is not saved; beforeSave copies referenced data into buf.
+	//
+	// These fields are protected by mu.
+	exts     []pipeExtent `state:"nosave"`
+	refSize  int64        `state:"nosave"`
+	refPages int64        `state:"nosave"`
+
 	// max is the maximum size of the pipe in bytes. When this max has been
 	// reached, writers will get EWOULDBLOCK.
 	//
@@ -159,6 +176,26 @@ type Pipe struct {
 	hadWriter bool
 }
 
+// pipeExtent is a contiguous range of bytes in a Pipe.
+type pipeExtent struct {
+	// size is the number of bytes in the extent.
+	size int64
+
+	// If file is nil, the extent's bytes are stored in Pipe.buf. Otherwise,
+	// they are stored in file starting at offset off, and the pipe holds a
+	// reference on every page spanned by [off, off+size).
+	file memmap.File
+	off  uint64
+}
+
+// pageRange returns the range of pages spanned by ext.
+func (ext *pipeExtent) pageRange() memmap.FileRange {
+	return memmap.FileRange{
+		Start: hostarch.PageRoundDown(ext.off),
+		End:   hostarch.MustPageRoundUp(ext.off + uint64(ext.size)),
+	}
+}
+
 // NewPipe initializes and returns a pipe.
 //
 // N.B. The size will be bounded.
@@ -209,6 +246,18 @@ func (p *Pipe) peekLocked(off, count int64, f func(safemem.BlockSeq) (uint64, er
 		count = rem
 	}
 
+	if len(p.exts) != 0 {
+		bs, err := p.extentBlocksLocked(off, count)
+		if bs.IsEmpty() {
+			return 0, err
+		}
+		done, ferr := f(bs)
+		if ferr == nil {
+			ferr = err
+		}
+		return int64(done), ferr
+	}
+
 	// Prepare the view of the data to be read.
 	pipeOff := p.off + off
 	if max := int64(len(p.buf)); pipeOff >= max {
@@ -221,6 +270,57 @@ func (p *Pipe) peekLocked(off, count int64, f func(safemem.BlockSeq) (uint64, er
 	return int64(done), err
 }
 
+// extentBlocksLocked returns a safemem.BlockSeq representing count bytes of
+// the pipe's data starting at offset off. If mapping referenced pages fails,
+// it returns the blocks preceding the failure along with the error.
+//
+// Preconditions:
+//   - p.mu must be locked.
+//   - len(p.exts) != 0.
+//   - off+count <= p.size.
+func (p *Pipe) extentBlocksLocked(off, count int64) (safemem.BlockSeq, error) {
+	var blocks []safemem.Block
+	// bufOff is the offset into buf's data of the current extent, if it is
+	// stored in buf.
+	bufOff := int64(0)
+	for i := range p.exts {
+		if count == 0 {
+			break
+		}
+		ext := &p.exts[i]
+		if off >= ext.size {
+			off -= ext.size
+			if ext.file == nil {
+				bufOff += ext.size
+			}
+			continue
+		}
+		n := min(ext.size-off, count)
+		if ext.file == nil {
+			pipeOff := p.off + bufOff + off
+			if max := int64(len(p.buf)); pipeOff >= max {
+				pipeOff -= max
+			}
+			for bs := p.bufBlockSeq.DropFirst64(uint64(pipeOff)).TakeFirst64(uint64(n)); !bs.IsEmpty(); bs = bs.Tail() {
+				blocks = append(blocks, bs.Head())
+			}
+			bufOff += ext.size
+		} else {
+			start := ext.off + uint64(off)
+			ims, err := ext.file.MapInternal(memmap.FileRange{start, start + uint64(n)}, hostarch.Read)
+			if err != nil {
+				return safemem.BlockSeqFromSlice(blocks), err
+			}
+			for ; !ims.IsEmpty(); ims = ims.Tail() {
+				blocks = append(blocks, ims.Head())
+			}
+		}
+		off = 0
+		count -= n
+	}
+	return safemem.BlockSeqFromSlice(blocks), nil
+}
+
 // consumeLocked consumes the first n bytes in the pipe, such that they will no
 // longer be visible to future reads.
 //
@@ -228,13 +328,120 @@ func (p *Pipe) peekLocked(off, count int64, f func(safemem.BlockSeq) (uint64, er
 //   - p.mu must be locked.
 //   - The pipe must contain at least n bytes.
 func (p *Pipe) consumeLocked(n int64) {
-	p.off += n
+	bufN := n
+	if len(p.exts) != 0 {
+		bufN = p.consumeExtentsLocked(n)
+	}
+	p.off += bufN
 	if max := int64(len(p.buf)); p.off >= max {
 		p.off -= max
 	}
 	p.size -= n
 }
 
+// consumeExtentsLocked consumes the first n bytes of p.exts, releasing page
+// references that are no longer needed, and returns the number of consumed
+// bytes that were stored in p.buf. The caller is responsible for consuming
+// those bytes from p.buf and for updating p.size.
+//
+// Preconditions:
+//   - p.mu must be locked.
+//   - The pipe must contain at least n bytes.
+func (p *Pipe) consumeExtentsLocked(n int64) int64 {
+	bufN := int64(0)
+	for n > 0 {
+		ext := &p.exts[0]
+		m := min(n, ext.size)
+		if ext.file == nil {
+			bufN += m
+		} else {
+			if m == ext.size {
+				fr := ext.pageRange()
+				ext.file.DecRef(fr)
+				p.refPages -= int64(fr.Length() / hostarch.PageSize)
+			} else if oldStart, newStart := hostarch.PageRoundDown(ext.off), hostarch.PageRoundDown(ext.off+uint64(m)); newStart > oldStart {
+				ext.file.DecRef(memmap.FileRange{oldStart, newStart})
+				p.refPages -= int64((newStart - oldStart) / hostarch.PageSize)
+			}
+			ext.off += uint64(m)
+			p.refSize -= m
+		}
+		ext.size -= m
+		n -= m
+		if ext.size == 0 {
+			p.exts[0] = pipeExtent{}
+			p.exts = p.exts[1:]
+		}
+	}
+	if p.refSize == 0 {
+		// All remaining data is stored in p.buf.
+		p.exts = nil
+	}
+	return bufN
+}
+
+// maxRefPagesLocked returns the maximum number of page references that the
+// pipe may hold. Since a referenced page may hold as little as one byte of
+// the pipe's data, this bounds the memory pinned by the pipe to its capacity,
+// as Linux does by storing each page in one of a limited number of pipe
+// buffer slots.
+//
+// Preconditions: p.mu must be locked.
+func (p *Pipe) maxRefPagesLocked() int64 {
+	return max(p.max/hostarch.PageSize, 1)
+}
+
+// appendRefLocked appends size bytes stored in file at offset off to the
+// pipe. The caller must hold a reference on the pages spanned by those bytes,
+// which is transferred to the pipe.
+//
+// Preconditions:
+//   - p.mu must be locked.
+//   - size > 0.
+//   - p.size+size <= p.max.
+func (p *Pipe) appendRefLocked(file memmap.File, off uint64, size int64) {
+	if len(p.exts) == 0 && p.size != 0 {
+		p.exts = append(p.exts, pipeExtent{size: p.size})
+	}
+	p.exts = append(p.exts, pipeExtent{
+		size: size,
+		file: file,
+		off:  off,
+	})
+	p.size += size
+	p.refSize += size
+	p.refPages += int64(p.exts[len(p.exts)-1].pageRange().Length() / hostarch.PageSize)
+}
+
+// flattenLocked copies all data held by page references into p.buf and
+// releases the references.
+//
+// Preconditions: p.mu must be locked.
+func (p *Pipe) flattenLocked() {
+	if len(p.exts) == 0 {
+		return
+	}
+	newBuf := make([]byte, p.size)
+	bs, err := p.extentBlocksLocked(0, p.size)
+	if err != nil {
+		log.Warningf("Failed to map pipe data, discarding it: %v", err)
+	}
+	safemem.CopySeq(safemem.BlockSeqOf(safemem.BlockFromSafeSlice(newBuf)), bs)
+	for i := range p.exts {
+		if ext := &p.exts[i]; ext.file != nil {
+			ext.file.DecRef(ext.pageRange())
+		}
+	}
+	p.exts = nil
+	p.refSize = 0
+	p.refPages = 0
+	p.buf = newBuf
+	p.bufBlocks[0] = safemem.BlockFromSafeSlice(newBuf)
+	p.bufBlocks[1] = p.bufBlocks[0]
+	p.bufBlockSeq = safemem.BlockSeqFromSlice(p.bufBlocks[:])
+	p.off = 0
+}
+
 // writeLocked passes a safemem.BlockSeq representing the first count bytes of
 // unused space in the pipe to f and returns the result. If fewer than count
 // bytes are free, the safemem.BlockSeq passed to f will be less than count
@@ -272,7 +479,8 @@ func (p *Pipe) writeLocked(count int64, f func(safemem.BlockSeq) (uint64, error)
 	}
 
 	// Ensure that the buffer is big enough.
-	if newLen, oldCap := p.size+count, int64(len(p.buf)); newLen > oldCap {
+	bufSize := p.size - p.refSize
+	if newLen, oldCap := bufSize+count, int64(len(p.buf)); newLen > oldCap {
 		// Allocate a new buffer.
 		newCap := oldCap * 2
 		if oldCap == 0 {
@@ -288,7 +496,7 @@ func (p *Pipe) writeLocked(count int64, f func(safemem.BlockSeq) (uint64, error)
 		// Copy the old buffer's contents to the beginning of the new one.
 		safemem.CopySeq(
 			safemem.BlockSeqOf(safemem.BlockFromSafeSlice(newBuf)),
-			p.bufBlockSeq.DropFirst64(uint64(p.off)).TakeFirst64(uint64(p.size)))
+			p.bufBlockSeq.DropFirst64(uint64(p.off)).TakeFirst64(uint64(bufSize)))
 		// Switch to the new buffer.
 		p.buf = newBuf
 		p.bufBlocks[0] = safemem.BlockFromSafeSlice(newBuf)
@@ -298,7 +506,7 @@ func (p *Pipe) writeLocked(count int64, f func(safemem.BlockSeq) (uint64, error)
 	}
 
 	// Prepare the view of the space to be written.
-	woff := p.off + p.size
+	woff := p.off + bufSize
 	if woff >= int64(len(p.buf)) {
 		woff -= int64(len(p.buf))
 	}
@@ -308,6 +516,13 @@ func (p *Pipe) writeLocked(count int64, f func(safemem.BlockSeq) (uint64, error)
 	doneU64, err := f(bs)
 	done := int64(doneU64)
 	p.size += done
+	if done > 0 && len(p.exts) != 0 {
+		if last := &p.exts[len(p.exts)-1]; last.file == nil {
+			last.size += done
+		} else {
+			p.exts = append(p.exts, pipeExtent{size: done})
+		}
+	}
 	if done < count || err != nil {
 		return done, err
 	}
@@ -20,7 +20,10 @@ import (
 
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/contexttest"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/usermem"
 	"gvisor.dev/gvisor/pkg/waiter"
@@ -147,3 +150,176 @@ func TestPipeWriteUntilEnd(t *testing.T) {
 		}
 	})
 }
+
+// testFile is a memmap.File backed by a byte slice that tracks references on
+// its pages.
+type testFile struct {
+	memmap.DefaultMemoryType
+	memmap.NoBufferedIOFallback
+
+	data []byte
+	refs map[uint64]int
+}
+
+func newTestFile(size int) *testFile {
+	f := &testFile{
+		data: make([]byte, size),
+		refs: make(map[uint64]int),
+	}
+	for i := range f.data {
+		f.data[i] = byte(i)
+	}
+	return f
+}
+
+// IncRef implements memmap.File.IncRef.
+func (f *testFile) IncRef(fr memmap.FileRange, memCgID uint32) {
+	for off := fr.Start; off < fr.End; off += hostarch.PageSize {
+		f.refs[off]++
+	}
+}
+
+// DecRef implements memmap.File.DecRef.
+func (f *testFile) DecRef(fr memmap.FileRange) {
+	for off := fr.Start; off < fr.End; off += hostarch.PageSize {
+		if f.refs[off]--; f.refs[off] == 0 {
+			delete(f.refs, off)
+		}
+	}
+}
+
+// MapInternal implements memmap.File.MapInternal.
+func (f *testFile) MapInternal(fr memmap.FileRange, at hostarch.AccessType) (safemem.BlockSeq, error) {
+	return safemem.BlockSeqOf(safemem.BlockFromSafeSlice(f.data[fr.Start:fr.End])), nil
+}
+
+// DataFD implements memmap.File.DataFD.
+func (f *testFile) DataFD(fr memmap.FileRange) (int, error) {
+	return -1, linuxerr.ENOSYS
+}
+
+// FD implements memmap.File.FD.
+func (f *testFile) FD() int {
+	return -1
+}
+
+// newPipeWithRef returns an open pipe containing "head", followed by a
+// reference to fr in f, followed by "tail", and the data expected to be read
+// from it.
+func newPipeWithRef(t *testing.T, f *testFile, fr memmap.FileRange) (*Pipe, []byte) {
+	p := NewPipe(false /* isNamed */, 65536)
+	p.rOpen()
+	p.wOpen()
+	write := func(b []byte) {
+		if n, err := p.writeLocked(int64(len(b)), func(dsts safemem.BlockSeq) (uint64, error) {
+			return safemem.CopySeq(dsts, safemem.BlockSeqOf(safemem.BlockFromSafeSlice(b)))
+		}); n != int64(len(b)) || err != nil {
+			t.Fatalf("writeLocked: got (%d, %v), wanted (%d, nil)", n, err, len(b))
+		}
+	}
+	p.mu.Lock()
+	write([]byte("head"))
+	f.IncRef(memmap.FileRange{hostarch.PageRoundDown(fr.Start), hostarch.MustPageRoundUp(fr.End)}, 0)
+	p.appendRefLocked(f, fr.Start, int64(fr.Length()))
+	write([]byte("tail"))
+	p.mu.Unlock()
+
+	var want []byte
+	want = append(want, "head"...)
+	want = append(want, f.data[fr.Start:fr.End]...)
+	want = append(want, "tail"...)
+	return p, want
+}
+
+func TestPipeSplicedPages(t *testing.T) {
+	ctx := contexttest.Context(t)
+	f := newTestFile(3 * hostarch.PageSize)
+	p, want := newPipeWithRef(t, f, memmap.FileRange{100, 2*hostarch.PageSize + 50})
+
+	// Read in two parts, the first of which ends in the middle of the
+	// referenced range, past its first page.
+	got := make([]byte, len(want))
+	first := 4 + hostarch.PageSize
+	if n, err := p.Read(ctx, usermem.BytesIOSequence(got[:first])); n != int64(first) || err != nil {
+		t.Fatalf("Read: got (%d, %v), wanted (%d, nil)", n, err, first)
+	}
+	if _, ok := f.refs[0]; ok {
+		t.Errorf("First page is still referenced after being consumed")
+	}
+	if n, err := p.Read(ctx, usermem.BytesIOSequence(got[first:])); n != int64(len(want)-first) || err != nil {
+		t.Fatalf("Read: got (%d, %v), wanted (%d, nil)", n, err, len(want)-first)
+	}
+	if !bytes.Equal(got, want) {
+		t.Errorf("Read: got %v, wanted %v", got, want)
+	}
+	if len(f.refs) != 0 {
+		t.Errorf("Pages still referenced after all data was consumed: %v", f.refs)
+	}
+	if p.exts != nil {
+		t.Errorf("Pipe still has extents after all data was consumed: %v", p.exts)
+	}
+}
+
+func TestPipeFlattenSplicedPages(t *testing.T) {
+	ctx := contexttest.Context(t)
+	f := newTestFile(2 * hostarch.PageSize)
+	p, want := newPipeWithRef(t, f, memmap.FileRange{10, 2 * hostarch.PageSize})
+
+	p.mu.Lock()
+	p.flattenLocked()
+	p.mu.Unlock()
+	if len(f.refs) != 0 {
+		t.Errorf("Pages still referenced after flattening: %v", f.refs)
+	}
+
+	got := make([]byte, len(want))
+	if n, err := p.Read(ctx, usermem.BytesIOSequence(got)); n != int64(len(want)) || err != nil {
+		t.Fatalf("Read: got (%d, %v), wanted (%d, nil)", n, err, len(want))
+	}
+	if !bytes.Equal(got, want) {
+		t.Errorf("Read: got %v, wanted %v", got, want)
+	}
+}
+
+func TestPipeSplicedPagesLimit(t *testing.T) {
+	ctx := contexttest.Context(t)
+	const pipeSize = 65536
+	const pages = 2 * pipeSize / hostarch.PageSize
+	f := newTestFile(pages * hostarch.PageSize)
+	p := NewPipe(false /* isNamed */, pipeSize)
+	p.rOpen()
+	p.wOpen()
+
+	// Splice one byte from each page of f, so that each reference would pin
+	// a page to store a single byte.
+	var want []byte
+	p.mu.Lock()
+	n, err := p.appendPagesLocked(pages, func(count int64, fn vfs.SplicePagesFunc) (int64, error) {
+		for i := uint64(0); i < pages; i++ {
+			off := i * hostarch.PageSize
+			if fn(f, memmap.FileRange{off, off + 1}) != 1 {
+				t.Fatalf("SplicePagesFunc consumed less than all of page %d", i)
+			}
+			want = append(want, f.data[off])
+		}
+		return pages, nil
+	})
+	p.mu.Unlock()
+	if n != pages || err != nil {
+		t.Fatalf("appendPagesLocked: got (%d, %v), wanted (%d, nil)", n, err, pages)
+	}
+	if got, limit := len(f.refs), pipeSize/hostarch.PageSize; got > limit {
+		t.Errorf("Pipe references %d pages, wanted at most %d", got, limit)
+	}
+
+	got := make([]byte, len(want))
+	if n, err := p.Read(ctx, usermem.BytesIOSequence(got)); n != int64(len(want)) || err != nil {
+		t.Fatalf("Read: got (%d, %v), wanted (%d, nil)", n, err, len(want))
+	}
+	if !bytes.Equal(got, want) {
+		t.Errorf("Read: got %v, wanted %v", got, want)
+	}
+	if len(f.refs) != 0 {
+		t.Errorf("Pages still referenced after all data was consumed: %v", f.refs)
+	}
+}
@@ -20,6 +20,14 @@ import (
 	"gvisor.dev/gvisor/pkg/safemem"
 )
 
+// beforeSave is invoked by stateify.
+func (p *Pipe) beforeSave() {
+	// Page references are not saved, so copy the data they hold into buf.
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	p.flattenLocked()
+}
+
 // afterLoad is called by stateify.
 func (p *Pipe) afterLoad(context.Context) {
 	p.bufBlocks[0] = safemem.BlockFromSafeSlice(p.buf)
@@ -15,6 +15,7 @@
 package pipe
 
 import (
+	"golang.org/x/sys/unix"
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
@@ -23,6 +24,7 @@ import (
 	"gvisor.dev/gvisor/pkg/safemem"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/auth"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/usermem"
 	"gvisor.dev/gvisor/pkg/waiter"
@@ -192,6 +194,12 @@ func (fd *VFSPipeFD) Release(context.Context) {
 	if event == 0 {
 		panic("invalid pipe flags: must be readable, writable, or both")
 	}
+	if !fd.pipe.HasReaders() && !fd.pipe.HasWriters() {
+		// Don't pin spliced pages while the pipe is unused.
+		fd.pipe.mu.Lock()
+		fd.pipe.flattenLocked()
+		fd.pipe.mu.Unlock()
+	}
 
 	fd.pipe.queue.Notify(event)
 }
@@ -316,6 +324,16 @@ func (fd *VFSPipeFD) SpliceFromNonPipe(ctx context.Context, in *vfs.FileDescript
 		err error
 	)
 	fd.pipe.mu.Lock()
+	// Prefer taking references on the pages storing in's data, if it
+	// supports this, to copying it.
+	n, err = fd.pipe.spliceFromPagesLocked(ctx, in, off, count)
+	if n != 0 || err != nil {
+		fd.pipe.mu.Unlock()
+		if n > 0 {
+			fd.pipe.queue.Notify(waiter.ReadableEvents)
+		}
+		return n, err
+	}
 	fd.lastAddr = 0
 	if off == -1 {
 		n, err = in.Read(ctx, dst, vfs.ReadOptions{})
@@ -330,6 +348,97 @@ func (fd *VFSPipeFD) SpliceFromNonPipe(ctx context.Context, in *vfs.FileDescript
 	return n, err
 }
 
+// spliceFromPagesLocked moves up to count bytes from in into p by taking
+// references on the memmap.File pages that store them. If in does not support
+// this, spliceFromPagesLocked returns (0, nil). The caller is responsible for
+// calling p.queue.Notify(waiter.ReadableEvents) with p.mu unlocked.
+//
+// Preconditions:
+//   - p.mu must be locked.
+//   - count > 0.
+func (p *Pipe) spliceFromPagesLocked(ctx context.Context, in *vfs.FileDescription, off, count int64) (int64, error) {
+	if _, ok := in.Impl().(vfs.SplicePageSource); !ok {
+		return 0, nil
+	}
+	return p.appendPagesLocked(count, func(count int64, f vfs.SplicePagesFunc) (int64, error) {
+		return in.SplicePages(ctx, off, count, f)
+	})
+}
+
+// SpliceFromPages moves up to count bytes into fd's pipe by taking references
+// on the memmap.File pages that store them, rather than copying. pages is
+// called with the number of bytes that the pipe can accept, and must pass the
+// ranges of memmap.File storing those bytes to f in order, as for
+// vfs.SplicePageSource.SplicePages. pages must not block waiting for the pipe.
+func (fd *VFSPipeFD) SpliceFromPages(count int64, pages func(count int64, f vfs.SplicePagesFunc) (int64, error)) (int64, error) {
+	fd.pipe.mu.Lock()
+	n, err := fd.pipe.appendPagesLocked(count, pages)
+	fd.pipe.mu.Unlock()
+
+	if n > 0 {
+		fd.pipe.queue.Notify(waiter.ReadableEvents)
+	}
+	return n, err
+}
+
+// appendPagesLocked implements spliceFromPagesLocked and
+// VFSPipeFD.SpliceFromPages.
+//
+// Preconditions:
+//   - p.mu must be locked.
+//   - count > 0.
+func (p *Pipe) appendPagesLocked(count int64, pages func(count int64, f vfs.SplicePagesFunc) (int64, error)) (int64, error) {
+	// Apply the same capacity rules as writeLocked.
+	if !p.HasReaders() {
+		return 0, unix.EPIPE
+	}
+	avail := p.max - p.size
+	if avail == 0 {
+		return 0, linuxerr.ErrWouldBlock
+	}
+	short := false
+	if count > avail {
+		if count <= atomicIOBytes {
+			return 0, linuxerr.ErrWouldBlock
+		}
+		count = avail
+		short = true
+	}
+
+	n, err := pages(count, func(file memmap.File, fr memmap.FileRange) uint64 {
+		if file == nil {
+			// Holes are cheaper to store in buf than to reference.
+			n, _ := p.writeLocked(int64(fr.Length()), func(dsts safemem.BlockSeq) (uint64, error) {
+				return safemem.ZeroSeq(dsts)
+			})
+			return uint64(n)
+		}
+		pageFR := memmap.FileRange{hostarch.PageRoundDown(fr.Start), hostarch.MustPageRoundUp(fr.End)}
+		if p.refPages+int64(pageFR.Length()/hostarch.PageSize) > p.maxRefPagesLocked() {
+			// Referencing fr would pin more memory than the pipe can hold,
+			// e.g. because earlier splices referenced pages to store only a
+			// few bytes each. Copy fr into buf instead.
+			srcs, err := file.MapInternal(fr, hostarch.Read)
+			if err != nil {
+				return 0
+			}
+			n, _ := p.writeLocked(int64(fr.Length()), func(dsts safemem.BlockSeq) (uint64, error) {
+				return safemem.CopySeq(dsts, srcs)
+			})
+			return uint64(n)
+		}
+		// The pages in fr already exist, so the memory cgroup ID passed to
+		// IncRef is ignored.
+		file.IncRef(pageFR, 0)
+		p.appendRefLocked(file, fr.Start, int64(fr.Length()))
+		return fr.Length()
+	})
+	if err == nil && short && n == count {
+		err = linuxerr.ErrWouldBlock
+	}
+	return n, err
+}
+
 // CopyIn implements usermem.IO.CopyIn. Note that it is the caller's
 // responsibility to call fd.pipe.Notify(waiter.WritableEvents) after the read
 // is completed.
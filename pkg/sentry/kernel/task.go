@@ -625,6 +625,12 @@ type Task struct {
 	// futexWaiter is exclusive to the task goroutine.
 	futexWaiter *futex.Waiter `state:"nosave"`
 
+	// futexMultiWaiter is used for futex_waitv syscalls. It is allocated on
+	// first use, since few tasks call futex_waitv.
+	//
+	// futexMultiWaiter is exclusive to the task goroutine.
+	futexMultiWaiter *futex.MultiWaiter `state:"nosave"`
+
 	// robustList is a pointer to the head of the tasks's robust futex
 	// list.
 	robustList hostarch.Addr
@@ -753,6 +759,16 @@ func (t *Task) FutexWaiter() *futex.Waiter {
 	return t.futexWaiter
 }
 
+// FutexMultiWaiter returns the Task's futex.MultiWaiter.
+//
+// Preconditions: The caller must be running on the task goroutine.
+func (t *Task) FutexMultiWaiter() *futex.MultiWaiter {
+	if t.futexMultiWaiter == nil {
+		t.futexMultiWaiter = futex.NewMultiWaiter()
+	}
+	return t.futexMultiWaiter
+}
+
 // Kernel returns the Kernel containing t.
 func (t *Task) Kernel() *Kernel {
 	return t.k
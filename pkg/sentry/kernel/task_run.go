@@ -283,6 +283,11 @@ func (app *runApp) execute(t *Task) taskRunState {
 				// We can resume running the application.
 				return (*runApp)(nil)
 			}
+			if err == linuxerr.ErrInterrupted {
+				// The fault is waiting on userfaultfd. Handle the
+				// interrupt and then retry the faulting instruction.
+				return (*runApp)(nil)
+			}
 
 			// Is this a vsyscall that we need emulate?
 			//
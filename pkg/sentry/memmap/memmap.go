@@ -102,6 +102,19 @@ type Mappable interface {
 	InvalidateUnsavable(ctx context.Context) error
 }
 
+// Readaheader is an optional interface implemented by Mappables that can read
+// data into memory before it is accessed through mappings, as for
+// madvise(MADV_WILLNEED).
+type Readaheader interface {
+	// Readahead requests that the Mappable start reading data in mr, so that
+	// subsequent calls to Translate for mr are cheap. Readahead is advisory,
+	// so it does not return errors, and may read only part of mr.
+	//
+	// Preconditions: Same as Mappable.Translate, with mr as the required
+	// range.
+	Readahead(ctx context.Context, mr MappableRange)
+}
+
 // Translations are returned by Mappable.Translate.
 type Translation struct {
 	// Source is the translated range in the Mappable.
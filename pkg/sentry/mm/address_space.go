@@ -83,6 +83,11 @@ func (mm *MemoryManager) mapASLocked(ctx context.Context, pseg pmaIterator, ar h
 	// is not required.
 	for pseg.Ok() && pseg.Start() < ar.End {
 		pma := pseg.ValuePtr()
+		if pma.lazyFree {
+			// Accesses to lazyFree pmas must fault; see pma.lazyFree.
+			pseg = pseg.NextSegment()
+			continue
+		}
 		pmaAR := pseg.Range()
 		pmaMapAR := pmaAR.Intersect(mapAR)
 		perms := pma.effectivePerms
@@ -548,6 +548,10 @@ func (mm *MemoryManager) handleASIOFault(ctx context.Context, addr hostarch.Addr
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
+			if uerr, ok := err.(*userfaultError); ok {
+				// The I/O is retried once userspace has populated the page.
+				return mm.waitForUserfault(ctx, uerr, false /* user */)
+			}
 			return translateIOError(ctx, err)
 		}
 		ar.End = pendaddr
@@ -584,6 +588,7 @@ func (mm *MemoryManager) withInternalMappings(ctx context.Context, ar hostarch.A
 	}
 	mm.activeMu.RUnlock()
 
+retry:
 	// Ensure that we have usable vmas.
 	mm.mappingMu.RLock()
 	vseg, vend, verr := mm.getVMAsLocked(ctx, ar, at, ignorePermissions)
@@ -599,6 +604,15 @@ func (mm *MemoryManager) withInternalMappings(ctx context.Context, ar hostarch.A
 	mm.activeMu.Lock()
 	pseg, pend, perr := mm.getPMAsLocked(ctx, vseg, ar, at, true /* callerIndirectCommit */)
 	mm.mappingMu.RUnlock()
+	if uerr, ok := perr.(*userfaultError); ok {
+		// Wait for userspace to populate the missing page before doing any
+		// I/O, since f can only be called once.
+		mm.activeMu.Unlock()
+		if err := mm.waitForUserfault(ctx, uerr, false /* user */); err != nil {
+			return 0, err
+		}
+		goto retry
+	}
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
@@ -661,6 +675,7 @@ func (mm *MemoryManager) withVecInternalMappings(ctx context.Context, ars hostar
 	}
 	mm.activeMu.RUnlock()
 
+retry:
 	// Ensure that we have usable vmas.
 	mm.mappingMu.RLock()
 	vars, verr := mm.getVecVMAsLocked(ctx, ars, at, ignorePermissions)
@@ -673,6 +688,14 @@ func (mm *MemoryManager) withVecInternalMappings(ctx context.Context, ars hostar
 	mm.activeMu.Lock()
 	pars, perr := mm.getVecPMAsLocked(ctx, vars, at, true /* callerIndirectCommit */)
 	mm.mappingMu.RUnlock()
+	if uerr, ok := perr.(*userfaultError); ok {
+		// As in withInternalMappings.
+		mm.activeMu.Unlock()
+		if err := mm.waitForUserfault(ctx, uerr, false /* user */); err != nil {
+			return 0, err
+		}
+		goto retry
+	}
 	if pars.NumBytes() == 0 {
 		mm.activeMu.Unlock()
 		return 0, translateIOError(ctx, perr)
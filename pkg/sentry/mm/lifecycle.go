@@ -210,7 +210,10 @@ func (mm *MemoryManager) Fork(ctx context.Context) (*MemoryManager, error) {
 		mm.mf.IncRef(fr, memCgID)
 		addrRange := srcpseg.Range()
 		mm2.addRSSLocked(addrRange)
-		dstpgap = mm2.pmas.Insert(dstpgap, addrRange, *pma).NextGap()
+		dstpma := *pma
+		// mm2 hasn't marked the memory evictable.
+		dstpma.lazyFree = false
+		dstpgap = mm2.pmas.Insert(dstpgap, addrRange, dstpma).NextGap()
 	}
 	if unmapAR.Length() != 0 {
 		mm.unmapASLocked(unmapAR)
@@ -262,6 +265,12 @@ func (mm *MemoryManager) IncUsers() bool {
 	}
 }
 
+// Users returns mm's user count. The returned value may be stale by the time
+// it is used.
+func (mm *MemoryManager) Users() int32 {
+	return mm.users.Load()
+}
+
 // DecUsers decrements mm's user count. If the user count reaches 0, all
 // mappings in mm are unmapped.
 func (mm *MemoryManager) DecUsers(ctx context.Context) {
@@ -298,6 +307,10 @@ func (mm *MemoryManager) DecUsers(ctx context.Context) {
 	}
 	mm.mappingMu.Unlock()
 
+	// Stop eviction of memory released by MADV_FREE, which was unmapped
+	// above.
+	mm.mf.MarkAllUnevictable(mm)
+
 	for _, id := range droppedIDs {
 		id.DecRef(ctx)
 	}
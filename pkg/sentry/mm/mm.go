@@ -276,6 +276,11 @@ type vma struct {
 	// dontfork is the MADV_DONTFORK setting for this vma configured by madvise().
 	dontfork bool
 
+	// seqRead is the MADV_SEQUENTIAL setting for this vma configured by
+	// madvise(). If seqRead is true, page faults read ahead of the faulting
+	// address more aggressively.
+	seqRead bool
+
 	mlockMode memmap.MLockMode
 
 	// numaPolicy is the NUMA policy for this vma set by mbind().
@@ -284,6 +289,12 @@ type vma struct {
 	// numaNodemask is the NUMA nodemask for this vma set by mbind().
 	numaNodemask uint64
 
+	// If uffd is not nil, missing pages in this vma are populated by
+	// userspace through uffd instead of being allocated on fault. uffd is
+	// only set for private anonymous mappings, and is not inherited by vmas
+	// created by fork() or mremap().
+	uffd *Userfaultfd
+
 	// If id is not nil, it controls the lifecycle of mappable and provides vma
 	// metadata shown in /proc/[pid]/maps, and the vma holds a reference.
 	id memmap.MappingIdentity
@@ -313,6 +324,7 @@ func (v *vma) copy() vma {
 		growsDown:      v.growsDown,
 		isStack:        v.isStack,
 		dontfork:       v.dontfork,
+		seqRead:        v.seqRead,
 		mlockMode:      v.mlockMode,
 		numaPolicy:     v.numaPolicy,
 		numaNodemask:   v.numaNodemask,
@@ -370,6 +382,16 @@ type pma struct {
 	// Invariant: If huge == true, then private == true.
 	huge bool
 
+	// If lazyFree is true, this pma's memory was released by
+	// madvise(MADV_FREE) and has not been accessed since, so it may be
+	// reclaimed by MemoryManager.Evict. lazyFree pmas are never mapped into
+	// the AddressSpace, so that getPMAsLocked observes the next access and
+	// clears lazyFree. lazyFree is not saved since pgalloc evicts all
+	// evictable memory before saving.
+	//
+	// Invariant: If lazyFree == true, then private == true.
+	lazyFree bool `state:"nosave"`
+
 	// If internalMappings is not empty, it is the cached return value of
 	// file.MapInternal for the memmap.FileRange mapped by this pma.
 	internalMappings safemem.BlockSeq `state:"nosave"`
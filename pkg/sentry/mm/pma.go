@@ -59,6 +59,10 @@ func (mm *MemoryManager) existingPMAsLocked(ar hostarch.AddrRange, at hostarch.A
 		if needInternalMappings && pma.internalMappings.IsEmpty() {
 			return pmaIterator{}
 		}
+		if pma.lazyFree {
+			// getPMAsLocked must observe the access.
+			return pmaIterator{}
+		}
 
 		if ar.End <= pseg.End() {
 			return first
@@ -273,6 +277,14 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 					}
 				}
 				if vma.mappable == nil {
+					if vma.uffd != nil {
+						// Userspace populates missing pages.
+						return pstart, pgap, &userfaultError{
+							uffd: vma.uffd,
+							addr: optAR.Intersect(ar).Start,
+							at:   at,
+						}
+					}
 					// Private anonymous mappings get pmas by allocating.
 					// The allocated range is limited to ar, expanded to
 					// hugepage alignment. This is done even if the allocation
@@ -366,6 +378,9 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 						perms.Read = true
 						perms.Write = false
 					}
+					if vma.seqRead {
+						mm.readaheadSequentialLocked(ctx, vma, reqMR, optMR)
+					}
 					ts, err := vma.mappable.Translate(ctx, reqMR, optMR, perms)
 					if checkInvariants {
 						if err := memmap.CheckTranslateResult(reqMR, optMR, perms, ts, err); err != nil {
@@ -411,6 +426,13 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 				}
 
 			case pseg.Ok() && pseg.Start() < vsegAR.End:
+				if pseg.ValuePtr().lazyFree {
+					// Accessing memory released by MADV_FREE cancels its
+					// reclamation.
+					pseg = mm.pmas.Isolate(pseg, ar)
+					pseg.ValuePtr().lazyFree = false
+					pstart = pmaIterator{} // iterators invalidated
+				}
 				oldpma := pseg.ValuePtr()
 				if at.Write && mm.isPMACopyOnWriteLocked(vseg, pseg) {
 					// Break copy-on-write by copying.
@@ -603,6 +625,32 @@ func (mm *MemoryManager) getPMAsInternalLocked(ctx context.Context, vseg vmaIter
 	}
 }
 
+// seqReadahead is the number of bytes read ahead by page faults in vmas
+// advised MADV_SEQUENTIAL.
+const seqReadahead = 2 << 20
+
+// readaheadSequentialLocked asks vma.mappable to cache up to seqReadahead
+// bytes starting at reqMR.Start, limited to optMR, so that the following call
+// to vma.mappable.Translate can translate all of it.
+//
+// Preconditions:
+//   - mm.mappingMu must be locked.
+//   - mm.activeMu must be locked for writing.
+//   - vma.mappable != nil.
+func (mm *MemoryManager) readaheadSequentialLocked(ctx context.Context, vma *vma, reqMR, optMR memmap.MappableRange) {
+	ra, ok := vma.mappable.(memmap.Readaheader)
+	if !ok {
+		return
+	}
+	raMR := memmap.MappableRange{Start: reqMR.Start, End: optMR.End}
+	if raMR.Length() > seqReadahead {
+		raMR.End = raMR.Start + seqReadahead
+	}
+	if raMR.End > reqMR.End {
+		ra.Readahead(ctx, raMR)
+	}
+}
+
 func hugepageAligned(ar hostarch.AddrRange) hostarch.AddrRange {
 	aligned := hostarch.AddrRange{ar.Start.HugeRoundDown(), ar.End}
 	if end, ok := ar.End.HugeRoundUp(); ok {
@@ -744,6 +792,7 @@ func (mm *MemoryManager) Pin(ctx context.Context, ar hostarch.AddrRange, at host
 		}
 	}
 
+retry:
 	// Ensure that we have usable vmas.
 	mm.mappingMu.RLock()
 	vseg, vend, verr := mm.getVMAsLocked(ctx, ar, at, ignorePermissions)
@@ -759,6 +808,13 @@ func (mm *MemoryManager) Pin(ctx context.Context, ar hostarch.AddrRange, at host
 	mm.activeMu.Lock()
 	pseg, pend, perr := mm.getPMAsLocked(ctx, vseg, ar, at, false /* callerIndirectCommit */)
 	mm.mappingMu.RUnlock()
+	if uerr, ok := perr.(*userfaultError); ok {
+		mm.activeMu.Unlock()
+		if err := mm.waitForUserfault(ctx, uerr, false /* user */); err != nil {
+			return nil, err
+		}
+		goto retry
+	}
 	if pendaddr := pend.Start(); pendaddr < ar.End {
 		if pendaddr <= ar.Start {
 			mm.activeMu.Unlock()
@@ -860,13 +916,23 @@ func (mm *MemoryManager) movePMAsLocked(oldAR, newAR hostarch.AddrRange) {
 
 	off := newAR.Start - oldAR.Start
 	pgap := mm.pmas.FindGap(newAR.Start)
+	var lazyFreeAR hostarch.AddrRange
 	for i := range movedPMAs {
 		mpma := &movedPMAs[i]
 		pmaNewAR := hostarch.AddrRange{mpma.oldAR.Start + off, mpma.oldAR.End + off}
 		pgap = mm.pmas.Insert(pgap, pmaNewAR, mpma.pma).NextGap()
+		if mpma.pma.lazyFree {
+			lazyFreeAR = joinAddrRanges(lazyFreeAR, pmaNewAR)
+		}
 	}
 
 	mm.unmapASLocked(oldAR)
+
+	if lazyFreeAR.Length() != 0 {
+		// Evict only looks for lazyFree pmas in the range that was marked
+		// evictable, which was their address before the move.
+		mm.mf.MarkEvictable(mm, pgalloc.EvictableRange{uint64(lazyFreeAR.Start), uint64(lazyFreeAR.End)})
+	}
 }
 
 // internalMappingsLocked returns cached internal mappings for addresses in ar.
@@ -974,7 +1040,8 @@ func (pmaSetFunctions) Merge(ar1 hostarch.AddrRange, pma1 pma, ar2 hostarch.Addr
 		pma1.maxPerms != pma2.maxPerms ||
 		pma1.needCOW != pma2.needCOW ||
 		pma1.private != pma2.private ||
-		pma1.huge != pma2.huge {
+		pma1.huge != pma2.huge ||
+		pma1.lazyFree != pma2.lazyFree {
 		return pma{}, false
 	}
 
@@ -26,6 +26,7 @@ import (
 	"gvisor.dev/gvisor/pkg/sentry/kernel/futex"
 	"gvisor.dev/gvisor/pkg/sentry/limits"
 	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
 )
 
 // HandleUserFault handles an application page fault. sp is the faulting
@@ -58,6 +59,12 @@ func (mm *MemoryManager) HandleUserFault(ctx context.Context, addr hostarch.Addr
 	mm.mappingMu.RUnlock()
 	if err != nil {
 		mm.activeMu.Unlock()
+		if uerr, ok := err.(*userfaultError); ok {
+			// The faulting instruction is retried once userspace has
+			// populated the page. If the wait is interrupted, the caller
+			// retries it after handling the interrupt.
+			return mm.waitForUserfault(ctx, uerr, true /* user */)
+		}
 		return err
 	}
 
@@ -1240,6 +1247,274 @@ func (mm *MemoryManager) Decommit(addr hostarch.Addr, length uint64) error {
 	return nil
 }
 
+// Populate implements the semantics of Linux's madvise(MADV_POPULATE_READ)
+// and madvise(MADV_POPULATE_WRITE), depending on at: it obtains pmas for all
+// of the given range as if it had been accessed by the application, and maps
+// them into the active AddressSpace.
+func (mm *MemoryManager) Populate(ctx context.Context, addr hostarch.Addr, length uint64, at hostarch.AccessType) error {
+	addr = hostarch.UntaggedUserAddr(addr)
+	ar, err := madviseAddrRange(addr, length)
+	if err != nil {
+		return err
+	}
+
+	// Populate one vma at a time, so that each is populated by a single call
+	// to getPMAsLocked and mapped into the AddressSpace by a single call to
+	// mapASLocked.
+	for ar.Length() != 0 {
+		mm.mappingMu.RLock()
+		vseg := mm.vmas.FindSegment(ar.Start)
+		if !vseg.Ok() {
+			mm.mappingMu.RUnlock()
+			return linuxerr.ENOMEM
+		}
+		if !vseg.ValuePtr().effectivePerms.SupersetOf(at) {
+			// Linux: mm/madvise.c:madvise_populate() converts EFAULT from
+			// mm/gup.c:check_vma_flags() to EINVAL.
+			mm.mappingMu.RUnlock()
+			return linuxerr.EINVAL
+		}
+		vsegAR := vseg.Range().Intersect(ar)
+		mm.activeMu.Lock()
+		pseg, _, err := mm.getPMAsLocked(ctx, vseg, vsegAR, at, true /* callerIndirectCommit */)
+		mm.mappingMu.RUnlock()
+		if err != nil {
+			mm.activeMu.Unlock()
+			if uerr, ok := err.(*userfaultError); ok {
+				if err := mm.waitForUserfault(ctx, uerr, false /* user */); err != nil {
+					return err
+				}
+				continue
+			}
+			if _, ok := err.(*memmap.BusError); ok {
+				return linuxerr.EFAULT
+			}
+			return err
+		}
+		if mm.as != nil {
+			mm.activeMu.DowngradeLock()
+			err = mm.mapASLocked(ctx, pseg, vsegAR, memmap.PlatformEffectCommit)
+			mm.activeMu.RUnlock()
+			if err != nil {
+				return err
+			}
+		} else {
+			mm.activeMu.Unlock()
+		}
+		ar.Start = vsegAR.End
+	}
+	return nil
+}
+
+// Free implements the semantics of Linux's madvise(MADV_FREE): memory in the
+// given range is released when the MemoryFile needs to reclaim memory, unless
+// it is accessed again first.
+func (mm *MemoryManager) Free(addr hostarch.Addr, length uint64) error {
+	addr = hostarch.UntaggedUserAddr(addr)
+	ar, err := madviseAddrRange(addr, length)
+	if err != nil {
+		return err
+	}
+	if length == 0 {
+		return nil
+	}
+
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+
+	var freeAR hostarch.AddrRange
+	defer func() {
+		if freeAR.Length() != 0 {
+			// Ensure that accesses to freed memory fault, so that
+			// getPMAsLocked can cancel reclamation.
+			mm.unmapASLocked(freeAR)
+			mm.pmas.MergeInsideRange(freeAR)
+			mm.pmas.MergeOutsideRange(freeAR)
+			mm.mf.MarkEvictable(mm, pgalloc.EvictableRange{uint64(freeAR.Start), uint64(freeAR.End)})
+		}
+	}()
+	vseg := mm.vmas.LowerBoundSegment(ar.Start)
+	if !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	hadvgap := ar.Start < vseg.Start()
+	for vseg.Ok() && vseg.Start() < ar.End {
+		vma := vseg.ValuePtr()
+		// Linux: mm/madvise.c:madvise_dontneed_free_valid_vma(),
+		// madvise_free_single_vma().
+		if vma.mappable != nil || vma.mlockMode != memmap.MLockNone {
+			return linuxerr.EINVAL
+		}
+		vsegAR := vseg.Range().Intersect(ar)
+		for pseg := mm.pmas.LowerBoundSegment(vsegAR.Start); pseg.Ok() && pseg.Start() < vsegAR.End; pseg = pseg.NextSegment() {
+			pseg = mm.pmas.Isolate(pseg, vsegAR)
+			pseg.ValuePtr().lazyFree = true
+			freeAR = joinAddrRanges(freeAR, pseg.Range())
+		}
+		if ar.End <= vseg.End() {
+			break
+		}
+		vgap := vseg.NextGap()
+		if !vgap.IsEmpty() {
+			hadvgap = true
+		}
+		vseg = vgap.NextSegment()
+	}
+	if hadvgap || !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	return nil
+}
+
+// Evict implements pgalloc.EvictableMemoryUser.Evict by releasing memory
+// freed by Free that has not been accessed since.
+func (mm *MemoryManager) Evict(ctx context.Context, er pgalloc.EvictableRange) {
+	ar := hostarch.AddrRange{hostarch.Addr(er.Start), hostarch.Addr(er.End)}
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+	pseg := mm.pmas.LowerBoundSegment(ar.Start)
+	for pseg.Ok() && pseg.Start() < ar.End {
+		if !pseg.ValuePtr().lazyFree {
+			pseg = pseg.NextSegment()
+			continue
+		}
+		pseg = mm.pmas.Isolate(pseg, ar)
+		// lazyFree pmas are not mapped into the AddressSpace, so there is no
+		// need to call mm.unmapASLocked().
+		pseg.ValuePtr().file.DecRef(pseg.fileRange())
+		mm.removeRSSLocked(pseg.Range())
+		pseg = mm.pmas.Remove(pseg).NextSegment()
+	}
+}
+
+// WillNeed implements the semantics of Linux's madvise(MADV_WILLNEED): it
+// asks file-backed mappings in the given range to read their contents ahead
+// of accesses.
+func (mm *MemoryManager) WillNeed(ctx context.Context, addr hostarch.Addr, length uint64) error {
+	addr = hostarch.UntaggedUserAddr(addr)
+	ar, err := madviseAddrRange(addr, length)
+	if err != nil {
+		return err
+	}
+	if length == 0 {
+		return nil
+	}
+
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	vseg := mm.vmas.LowerBoundSegment(ar.Start)
+	if !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	hadvgap := ar.Start < vseg.Start()
+	for vseg.Ok() && vseg.Start() < ar.End {
+		// Anonymous memory is never swapped out, so there is nothing to do for
+		// it.
+		if ra, ok := vseg.ValuePtr().mappable.(memmap.Readaheader); ok {
+			ra.Readahead(ctx, vseg.mappableRangeOf(vseg.Range().Intersect(ar)))
+		}
+		if ar.End <= vseg.End() {
+			break
+		}
+		vgap := vseg.NextGap()
+		if !vgap.IsEmpty() {
+			hadvgap = true
+		}
+		vseg = vgap.NextSegment()
+	}
+	if hadvgap || !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	return nil
+}
+
+// Reclaim implements the semantics of Linux's madvise(MADV_COLD) and, if
+// pageout is true, madvise(MADV_PAGEOUT): private memory in the given range is
+// handed to the host for reclaim, without discarding its contents.
+//
+// Shared memory is left alone, since it may still be in use by other
+// MemoryManagers and is reclaimed by its memmap.Mappable instead.
+func (mm *MemoryManager) Reclaim(addr hostarch.Addr, length uint64, pageout bool) error {
+	addr = hostarch.UntaggedUserAddr(addr)
+	ar, err := madviseAddrRange(addr, length)
+	if err != nil {
+		return err
+	}
+	if length == 0 {
+		return nil
+	}
+
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+
+	var (
+		reclaimAR hostarch.AddrRange
+		frs       []memmap.FileRange
+	)
+	defer func() {
+		if reclaimAR.Length() == 0 {
+			return
+		}
+		if pageout {
+			// The host won't reclaim pages that are still mapped into the
+			// AddressSpace.
+			mm.unmapASLocked(reclaimAR)
+		}
+		for _, fr := range frs {
+			mm.mf.Reclaim(fr, pageout)
+		}
+	}()
+	vseg := mm.vmas.LowerBoundSegment(ar.Start)
+	if !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	hadvgap := ar.Start < vseg.Start()
+	for vseg.Ok() && vseg.Start() < ar.End {
+		// Linux: mm/madvise.c:can_madv_lru_vma()
+		if vseg.ValuePtr().mlockMode != memmap.MLockNone {
+			return linuxerr.EINVAL
+		}
+		vsegAR := vseg.Range().Intersect(ar)
+		for pseg := mm.pmas.LowerBoundSegment(vsegAR.Start); pseg.Ok() && pseg.Start() < vsegAR.End; pseg = pseg.NextSegment() {
+			// lazyFree pmas will be released by Evict instead.
+			if pma := pseg.ValuePtr(); !pma.private || pma.lazyFree {
+				continue
+			}
+			psegAR := pseg.Range().Intersect(vsegAR)
+			frs = append(frs, pseg.fileRangeOf(psegAR))
+			reclaimAR = joinAddrRanges(reclaimAR, psegAR)
+		}
+		if ar.End <= vseg.End() {
+			break
+		}
+		vgap := vseg.NextGap()
+		if !vgap.IsEmpty() {
+			hadvgap = true
+		}
+		vseg = vgap.NextSegment()
+	}
+	if hadvgap || !vseg.Ok() {
+		return linuxerr.ENOMEM
+	}
+	return nil
+}
+
+// Reap releases all private memory in mm, as for Linux's process_mrelease(2).
+// Private memory that remains mapped reads as zeroes after Reap returns, so
+// callers must ensure that no task will access mm's memory again.
+func (mm *MemoryManager) Reap() {
+	mm.activeMu.Lock()
+	defer mm.activeMu.Unlock()
+	if mm.pmas.IsEmpty() {
+		return
+	}
+	mm.invalidateLocked(hostarch.AddrRange{mm.layout.MinAddr, mm.layout.MaxAddr}, true /* invalidatePrivate */, false /* invalidateShared */)
+}
+
 // madviseMutateVMAs is similar to mm.vmas.MutateRange(), but:
 //
 // - madviseMutateVMAs locks mm.mappingMu for writing, as required to mutate
@@ -1307,6 +1582,18 @@ func (mm *MemoryManager) SetDontFork(addr hostarch.Addr, length uint64, dontfork
 	})
 }
 
+// SetSequentialRead implements the semantics of madvise MADV_SEQUENTIAL
+// (seqRead == true) and MADV_NORMAL and MADV_RANDOM (seqRead == false).
+//
+// Preconditions: addr and length are page-aligned.
+func (mm *MemoryManager) SetSequentialRead(addr hostarch.Addr, length uint64, seqRead bool) error {
+	addr = hostarch.UntaggedUserAddr(addr)
+	return mm.madviseMutateVMAs(addr, length, func(vseg vmaIterator) error {
+		vseg.ValuePtr().seqRead = seqRead
+		return nil
+	})
+}
+
 // SetVMAAnonName implements the semantics of Linux's
 // prctl(PR_SET_VMA, PR_SET_VMA_ANON_NAME).
 func (mm *MemoryManager) SetVMAAnonName(addr hostarch.Addr, length uint64, name string, nameIsNil bool) error {
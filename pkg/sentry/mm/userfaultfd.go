@@ -0,0 +1,425 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package mm
+
+import (
+	"fmt"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/context"
+	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/safemem"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/pgalloc"
+	"gvisor.dev/gvisor/pkg/sentry/usage"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// Userfaultfd is the state of a userfaultfd(2) instance. Private anonymous
+// memory in a MemoryManager may be registered with a Userfaultfd, in which
+// case accesses to pages in that memory that have not yet been populated
+// block until userspace populates them with Userfaultfd.Fill, rather than
+// being populated with zeroed pages.
+//
+// Only missing-page faults are supported; write-protect and minor faults, and
+// non-fault events, are not.
+//
+// +stateify savable
+type Userfaultfd struct {
+	// mm is the MemoryManager whose memory may be registered. mm is
+	// immutable.
+	mm *MemoryManager
+
+	// If userModeOnly is true, accesses by the sentry to missing pages fail
+	// instead of waiting for userspace. userModeOnly is immutable.
+	userModeOnly bool
+
+	// queue is notified when faults become available to read.
+	queue waiter.Queue
+
+	mu userfaultfdMutex `state:"nosave"`
+
+	// faults are the faults that are waiting for userspace, in the order
+	// they occurred. Faults are removed when woken. Waiting tasks are
+	// interrupted by checkpointing, and fault again after restore, so faults
+	// are not saved.
+	//
+	// faults is protected by mu.
+	faults []*userfault `state:"nosave"`
+
+	// released is true if Release has been called, after which faults are
+	// no longer reported. released is protected by mu.
+	released bool
+}
+
+// userfault is a fault that is waiting for userspace.
+type userfault struct {
+	// addr is the page-aligned faulting address.
+	addr hostarch.Addr
+
+	// write is true if the fault was caused by a write.
+	write bool
+
+	// read is true if the fault has been read by userspace.
+	read bool
+
+	// ch is closed when the fault is woken.
+	ch chan struct{}
+}
+
+// NewUserfaultfd returns a Userfaultfd with which memory in mm may be
+// registered.
+func NewUserfaultfd(mm *MemoryManager, userModeOnly bool) *Userfaultfd {
+	return &Userfaultfd{
+		mm:           mm,
+		userModeOnly: userModeOnly,
+	}
+}
+
+// userfaultError is returned by getPMAsLocked when it stops at a missing page
+// in memory registered with a Userfaultfd.
+type userfaultError struct {
+	uffd *Userfaultfd
+	addr hostarch.Addr
+	at   hostarch.AccessType
+}
+
+// Error implements error.Error.
+func (e *userfaultError) Error() string {
+	return fmt.Sprintf("missing page at %#x registered with userfaultfd", e.addr)
+}
+
+// waitForUserfault waits for userspace to resolve the fault described by e,
+// after which the caller should retry the access. If e was caused by the
+// sentry rather than the application, user is false.
+//
+// Preconditions: None of mm's locks may be held.
+func (mm *MemoryManager) waitForUserfault(ctx context.Context, e *userfaultError, user bool) error {
+	u := e.uffd
+	if !user && u.userModeOnly {
+		return linuxerr.EFAULT
+	}
+	f := u.addFault(e.addr, e.at.Write)
+	if f == nil {
+		return nil
+	}
+	// The page may have been populated, or the memory unregistered, after
+	// getPMAsLocked failed but before f was queued, in which case f may never
+	// be woken.
+	if !mm.isUserfaultPending(u, e.addr) {
+		u.removeFault(f)
+		return nil
+	}
+	if err := ctx.Block(f.ch); err != nil {
+		u.removeFault(f)
+		return err
+	}
+	return nil
+}
+
+// isUserfaultPending returns true if addr is registered with u and has no
+// pma.
+func (mm *MemoryManager) isUserfaultPending(u *Userfaultfd, addr hostarch.Addr) bool {
+	mm.mappingMu.RLock()
+	defer mm.mappingMu.RUnlock()
+	if vseg := mm.vmas.FindSegment(addr); !vseg.Ok() || vseg.ValuePtr().uffd != u {
+		return false
+	}
+	mm.activeMu.RLock()
+	defer mm.activeMu.RUnlock()
+	return !mm.pmas.FindSegment(addr).Ok()
+}
+
+// addFault queues a fault at addr and notifies readers. It returns nil if u
+// has been released.
+func (u *Userfaultfd) addFault(addr hostarch.Addr, write bool) *userfault {
+	u.mu.Lock()
+	if u.released {
+		u.mu.Unlock()
+		return nil
+	}
+	f := &userfault{
+		addr:  addr,
+		write: write,
+		ch:    make(chan struct{}),
+	}
+	u.faults = append(u.faults, f)
+	u.mu.Unlock()
+	u.queue.Notify(waiter.ReadableEvents)
+	return f
+}
+
+// removeFault dequeues f, if it has not already been woken.
+func (u *Userfaultfd) removeFault(f *userfault) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	for i, f2 := range u.faults {
+		if f2 == f {
+			u.faults = append(u.faults[:i], u.faults[i+1:]...)
+			return
+		}
+	}
+}
+
+// ReadFaults returns messages describing up to limit faults that have not yet
+// been read, and marks them read.
+func (u *Userfaultfd) ReadFaults(limit int) []linux.UffdMsg {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	var msgs []linux.UffdMsg
+	for _, f := range u.faults {
+		if len(msgs) == limit {
+			break
+		}
+		if f.read {
+			continue
+		}
+		f.read = true
+		msg := linux.UffdMsg{
+			Event:   linux.UFFD_EVENT_PAGEFAULT,
+			Address: uint64(f.addr),
+		}
+		if f.write {
+			msg.Flags = linux.UFFD_PAGEFAULT_FLAG_WRITE
+		}
+		msgs = append(msgs, msg)
+	}
+	return msgs
+}
+
+// Readiness implements waiter.Waitable.Readiness.
+func (u *Userfaultfd) Readiness(mask waiter.EventMask) waiter.EventMask {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	for _, f := range u.faults {
+		if !f.read {
+			return mask & waiter.ReadableEvents
+		}
+	}
+	return 0
+}
+
+// EventRegister implements waiter.Waitable.EventRegister.
+func (u *Userfaultfd) EventRegister(e *waiter.Entry) error {
+	u.queue.EventRegister(e)
+	return nil
+}
+
+// EventUnregister implements waiter.Waitable.EventUnregister.
+func (u *Userfaultfd) EventUnregister(e *waiter.Entry) {
+	u.queue.EventUnregister(e)
+}
+
+// Wake wakes all faults in ar.
+func (u *Userfaultfd) Wake(ar hostarch.AddrRange) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	faults := u.faults[:0]
+	for _, f := range u.faults {
+		if ar.Contains(f.addr) {
+			close(f.ch)
+			continue
+		}
+		faults = append(faults, f)
+	}
+	for i := len(faults); i < len(u.faults); i++ {
+		u.faults[i] = nil
+	}
+	u.faults = faults
+}
+
+// checkRange returns EINVAL if ar is not page-aligned and within the range of
+// mappable addresses.
+func (u *Userfaultfd) checkRange(ar hostarch.AddrRange) error {
+	if !ar.WellFormed() || ar.Length() == 0 || !ar.IsPageAligned() {
+		return linuxerr.EINVAL
+	}
+	if ar.Start < u.mm.layout.MinAddr || ar.End > u.mm.layout.MaxAddr {
+		return linuxerr.EINVAL
+	}
+	return nil
+}
+
+// Register registers the vmas in ar with u for missing-page faults. All vmas
+// in ar must be private anonymous mappings, and not registered with a
+// different Userfaultfd.
+func (u *Userfaultfd) Register(ar hostarch.AddrRange) error {
+	if err := u.checkRange(ar); err != nil {
+		return err
+	}
+	mm := u.mm
+	mm.mappingMu.Lock()
+	defer mm.mappingMu.Unlock()
+
+	// Check every vma before registering any, so that failures have no
+	// effect. Like Linux, gaps between vmas are skipped.
+	vseg := mm.vmas.LowerBoundSegment(ar.Start)
+	if !vseg.Ok() || vseg.Start() >= ar.End {
+		return linuxerr.EINVAL
+	}
+	for ; vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vma := vseg.ValuePtr()
+		if vma.mappable != nil {
+			return linuxerr.EINVAL
+		}
+		if vma.uffd != nil && vma.uffd != u {
+			return linuxerr.EBUSY
+		}
+	}
+
+	mm.setUserfaultfdLocked(ar, u)
+	return nil
+}
+
+// Unregister unregisters the vmas in ar from u, and wakes faults in ar.
+func (u *Userfaultfd) Unregister(ar hostarch.AddrRange) error {
+	if err := u.checkRange(ar); err != nil {
+		return err
+	}
+	mm := u.mm
+	mm.mappingMu.Lock()
+	vseg := mm.vmas.LowerBoundSegment(ar.Start)
+	if !vseg.Ok() || vseg.Start() >= ar.End {
+		mm.mappingMu.Unlock()
+		return linuxerr.EINVAL
+	}
+	for ; vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		if vma := vseg.ValuePtr(); vma.uffd != nil && vma.uffd != u {
+			mm.mappingMu.Unlock()
+			return linuxerr.EINVAL
+		}
+	}
+	mm.setUserfaultfdLocked(ar, nil)
+	mm.mappingMu.Unlock()
+
+	u.Wake(ar)
+	return nil
+}
+
+// Release unregisters all memory registered with u and wakes all faults.
+// Subsequent faults in formerly registered memory are resolved by populating
+// zeroed pages.
+func (u *Userfaultfd) Release() {
+	mm := u.mm
+	mm.mappingMu.Lock()
+	for vseg := mm.vmas.FirstSegment(); vseg.Ok(); vseg = vseg.NextSegment() {
+		if vseg.ValuePtr().uffd == u {
+			vseg.ValuePtr().uffd = nil
+			vseg = mm.vmas.MergePrev(vseg)
+			vseg = mm.vmas.MergeNext(vseg)
+		}
+	}
+	mm.mappingMu.Unlock()
+
+	u.mu.Lock()
+	u.released = true
+	u.mu.Unlock()
+	u.Wake(hostarch.AddrRange{0, ^hostarch.Addr(0)})
+}
+
+// setUserfaultfdLocked sets the Userfaultfd of all vmas in ar to u.
+//
+// Preconditions: mm.mappingMu must be locked for writing.
+func (mm *MemoryManager) setUserfaultfdLocked(ar hostarch.AddrRange, u *Userfaultfd) {
+	for vseg := mm.vmas.LowerBoundSegmentSplitBefore(ar.Start); vseg.Ok() && vseg.Start() < ar.End; vseg = vseg.NextSegment() {
+		vseg = mm.vmas.SplitAfter(vseg, ar.End)
+		vseg.ValuePtr().uffd = u
+		vseg = mm.vmas.MergePrev(vseg)
+		vseg = mm.vmas.MergeNext(vseg)
+	}
+}
+
+// Fill resolves missing-page faults in ar, which must be registered with u,
+// by populating it with new pages. The new pages' contents are read from src,
+// or zeroed if src is nil. Fill returns the number of bytes populated; if this
+// is less than ar.Length(), it also returns an error: EEXIST if Fill reached a
+// page that is already populated, ENOENT if it reached memory that isn't
+// registered with u, or the error returned by src. Fill does not wake faults.
+func (u *Userfaultfd) Fill(ctx context.Context, ar hostarch.AddrRange, src safemem.Reader) (uint64, error) {
+	if err := u.checkRange(ar); err != nil {
+		return 0, err
+	}
+	mm := u.mm
+	if !mm.IncUsers() {
+		return 0, linuxerr.ESRCH
+	}
+	defer mm.DecUsers(ctx)
+
+	// Prepare the pages without holding mm's locks, since src may read from
+	// mm.
+	opts := pgalloc.AllocOpts{
+		Kind:    usage.Anonymous,
+		MemCgID: pgalloc.MemoryCgroupIDFromContext(ctx),
+		Mode:    pgalloc.AllocateUncommitted,
+	}
+	if src != nil {
+		opts.Mode = pgalloc.AllocateAndWritePopulate
+		opts.ReaderFunc = src.ReadToBlocks
+	}
+	fr, srcErr := mm.mf.Allocate(uint64(ar.Length()), opts)
+	if fr.Length() == 0 {
+		return 0, srcErr
+	}
+
+	mm.mappingMu.RLock()
+	mm.activeMu.Lock()
+	done, err := mm.fillLocked(hostarch.AddrRange{ar.Start, ar.Start + hostarch.Addr(fr.Length())}, u, fr.Start)
+	mm.activeMu.Unlock()
+	mm.mappingMu.RUnlock()
+
+	// Release pages that weren't used.
+	if done < fr.Length() {
+		mm.mf.DecRef(memmap.FileRange{fr.Start + done, fr.End})
+	}
+	if err == nil && done < uint64(ar.Length()) {
+		err = srcErr
+	}
+	return done, err
+}
+
+// fillLocked installs pmas for ar, which are backed by mm.mf starting at off.
+// It stops at the first address that has a pma or is not registered with u.
+// The reference on each page used is transferred to its pma.
+//
+// Preconditions:
+//   - mm.mappingMu must be locked.
+//   - mm.activeMu must be locked for writing.
+func (mm *MemoryManager) fillLocked(ar hostarch.AddrRange, u *Userfaultfd, off uint64) (uint64, error) {
+	addr := ar.Start
+	for addr < ar.End {
+		vseg := mm.vmas.FindSegment(addr)
+		if !vseg.Ok() || vseg.ValuePtr().uffd != u {
+			return uint64(addr - ar.Start), linuxerr.ENOENT
+		}
+		pseg, pgap := mm.pmas.Find(addr)
+		if pseg.Ok() {
+			return uint64(addr - ar.Start), linuxerr.EEXIST
+		}
+		vma := vseg.ValuePtr()
+		fillAR := pgap.Range().Intersect(vseg.Range()).Intersect(hostarch.AddrRange{addr, ar.End})
+		mm.addRSSLocked(fillAR)
+		mm.pmas.Insert(pgap, fillAR, pma{
+			file:           mm.mf,
+			off:            off + uint64(fillAR.Start-ar.Start),
+			translatePerms: hostarch.AnyAccess,
+			effectivePerms: vma.effectivePerms,
+			maxPerms:       vma.maxPerms,
+			private:        true,
+		})
+		addr = fillAR.End
+	}
+	return uint64(ar.Length()), nil
+}
@@ -1140,6 +1140,48 @@ func (f *MemoryFile) decommitOrManuallyZero(fr memmap.FileRange) {
 	}
 }
 
+var madvReclaimDisabled atomicbitops.Uint32
+
+// Reclaim advises the host that the given pages are unlikely to be accessed
+// soon. If pageout is true, the host is asked to reclaim the pages
+// immediately, as for madvise(MADV_PAGEOUT); otherwise it is only asked to
+// prefer them for future reclaim, as for madvise(MADV_COLD). In both cases
+// page contents are preserved: reclaimed pages are written to swap (or, if f
+// is disk-backed, to its backing file) and read back on the next access.
+//
+// The host only reclaims pages that are mapped solely by f's own mappings of
+// them, so callers should remove other mappings (e.g. AddressSpace mappings)
+// of fr first.
+//
+// Preconditions:
+//   - fr.Start and fr.End must be page-aligned.
+//   - At least one reference must be held on all pages in fr.
+func (f *MemoryFile) Reclaim(fr memmap.FileRange, pageout bool) {
+	if madvReclaimDisabled.Load() != 0 {
+		return
+	}
+	advice := uintptr(unix.MADV_COLD)
+	if pageout {
+		advice = unix.MADV_PAGEOUT
+	}
+	f.forEachChunk(fr, func(chunk *chunkInfo, chunkFR memmap.FileRange) bool {
+		addr := chunk.mapping + uintptr(chunkFR.Start&chunkMask)
+		_, _, errno := unix.Syscall(unix.SYS_MADVISE, addr, uintptr(chunkFR.Length()), advice)
+		if errno != 0 {
+			if errno == unix.EINVAL {
+				// EINVAL is expected if MADV_COLD and MADV_PAGEOUT are not
+				// supported (Linux <5.4).
+				log.Infof("Disabling pgalloc.MemoryFile.Reclaim: madvise failed: %s", errno)
+			} else {
+				log.Warningf("Disabling pgalloc.MemoryFile.Reclaim: madvise failed: %s", errno)
+			}
+			madvReclaimDisabled.Store(1)
+			return false
+		}
+		return true
+	})
+}
+
 // HasUniqueRef returns true if all pages in the given range have exactly one
 // reference. A return value of false is inherently racy, but if the caller
 // holds a reference on the given range and is preventing other goroutines from
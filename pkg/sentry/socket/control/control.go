@@ -232,6 +232,17 @@ func PackInq(t *kernel.Task, inq int32, buf []byte) []byte {
 	)
 }
 
+// PackUDPGRO packs a UDP_GRO socket control message.
+func PackUDPGRO(t *kernel.Task, groSize uint16, buf []byte) []byte {
+	return putCmsgStruct(
+		buf,
+		linux.SOL_UDP,
+		linux.UDP_GRO,
+		t.Arch().Width(),
+		primitive.AllocateInt32(int32(groSize)),
+	)
+}
+
 // PackTOS packs an IP_TOS socket control message.
 func PackTOS(t *kernel.Task, tos uint8, buf []byte) []byte {
 	return putCmsgStruct(
@@ -343,6 +354,11 @@ func PackControlMessages(t *kernel.Task, cmsgs socket.ControlMessages, buf []byt
 		buf = PackInq(t, cmsgs.IP.Inq, buf)
 	}
 
+	if cmsgs.IP.HasGROSize {
+		// In Linux, UDP_GRO is added before the IP level control messages.
+		buf = PackUDPGRO(t, cmsgs.IP.GROSize, buf)
+	}
+
 	if cmsgs.IP.HasTOS {
 		buf = PackTOS(t, cmsgs.IP.TOS, buf)
 	}
@@ -396,6 +412,10 @@ func CmsgsSpace(t *kernel.Task, cmsgs socket.ControlMessages) int {
 		space += cmsgSpace(t, linux.SizeOfControlMessageInq)
 	}
 
+	if cmsgs.IP.HasGROSize {
+		space += cmsgSpace(t, linux.SizeOfControlMessageUDPGRO)
+	}
+
 	if cmsgs.IP.HasTOS {
 		space += cmsgSpace(t, linux.SizeOfControlMessageTOS)
 	}
@@ -603,6 +623,22 @@ func Parse(t *kernel.Task, socketOrEndpoint any, buf []byte, width uint) (socket
 				errCmsg.UnmarshalBytes(buf)
 				cmsgs.IP.SockErr = &errCmsg
 
+			default:
+				return socket.ControlMessages{}, linuxerr.EINVAL
+			}
+		case linux.SOL_UDP:
+			switch h.Type {
+			case linux.UDP_SEGMENT:
+				// As in Linux's net/ipv4/udp.c:__udp_cmsg_send(), the length
+				// must be exact.
+				if length != linux.SizeOfControlMessageUDPSegment {
+					return socket.ControlMessages{}, linuxerr.EINVAL
+				}
+				var gsoSize primitive.Uint16
+				gsoSize.UnmarshalUnsafe(buf)
+				cmsgs.IP.HasGSOSize = true
+				cmsgs.IP.GSOSize = uint16(gsoSize)
+
 			default:
 				return socket.ControlMessages{}, linuxerr.EINVAL
 			}
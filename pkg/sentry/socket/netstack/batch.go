@@ -0,0 +1,157 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package netstack
+
+import (
+	"io"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/ktime"
+	"gvisor.dev/gvisor/pkg/sentry/socket"
+	"gvisor.dev/gvisor/pkg/syserr"
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+var _ socket.BatchSocket = (*sock)(nil)
+
+// SupportsBatchIO implements socket.BatchSocket.SupportsBatchIO.
+func (s *sock) SupportsBatchIO() bool {
+	_, ok := s.Endpoint.(tcpip.EndpointWithBatchIO)
+	return ok
+}
+
+// nonBlockingReadBatch reads as many of len(dsts) messages as are available
+// without blocking.
+func (s *sock) nonBlockingReadBatch(t *kernel.Task, dsts []usermem.IOSequence, trunc, senderRequested bool, results []socket.RecvMsgResult) (int, *syserr.Error) {
+	ws := make([]io.Writer, len(dsts))
+	for i := range dsts {
+		ws[i] = dsts[i].Writer(t)
+	}
+	res := make([]tcpip.ReadResult, len(dsts))
+	readOptions := tcpip.ReadOptions{
+		NeedRemoteAddr:     senderRequested,
+		NeedLinkPacketInfo: true,
+	}
+
+	s.readMu.Lock()
+	defer s.readMu.Unlock()
+
+	n, err := s.Endpoint.(tcpip.EndpointWithBatchIO).ReadBatch(ws, readOptions, res)
+	if _, ok := err.(*tcpip.ErrBadBuffer); ok && dsts[n].NumBytes() == 0 {
+		// As in nonBlockingRead, a zero-length read of a message succeeds.
+		n++
+		err = nil
+	}
+	for i := 0; i < n; i++ {
+		s.updateTimestamp(res[i].ControlMessages)
+		results[i] = s.packetRecvResult(&res[i], trunc, senderRequested)
+	}
+	if n > 0 {
+		return n, nil
+	}
+	return 0, syserr.TranslateNetstackError(err)
+}
+
+// RecvMMsg implements socket.BatchSocket.RecvMMsg.
+func (s *sock) RecvMMsg(t *kernel.Task, dsts []usermem.IOSequence, flags int, haveDeadline bool, deadline ktime.Time, senderRequested bool, results []socket.RecvMsgResult) (int, *syserr.Error) {
+	trunc := flags&linux.MSG_TRUNC != 0
+	dontWait := flags&linux.MSG_DONTWAIT != 0
+
+	n, err := s.nonBlockingReadBatch(t, dsts, trunc, senderRequested, results)
+	if err == syserr.ErrClosedForReceive && dontWait {
+		// As in RecvMsg, we should return EAGAIN.
+		return 0, syserr.ErrTryAgain
+	}
+	if err != syserr.ErrWouldBlock || dontWait {
+		return n, err
+	}
+
+	// We'll have to block until at least one message is available.
+	e, ch := waiter.NewChannelEntry(waiter.ReadableEvents)
+	s.EventRegister(&e)
+	defer s.EventUnregister(&e)
+
+	for {
+		n, err = s.nonBlockingReadBatch(t, dsts, trunc, senderRequested, results)
+		if err != syserr.ErrWouldBlock {
+			return n, err
+		}
+		if err := t.BlockWithDeadline(ch, haveDeadline, deadline); err != nil {
+			if linuxerr.Equals(linuxerr.ETIMEDOUT, err) {
+				return 0, syserr.ErrTryAgain
+			}
+			return 0, syserr.FromError(err)
+		}
+	}
+}
+
+// SendMMsg implements socket.BatchSocket.SendMMsg.
+func (s *sock) SendMMsg(t *kernel.Task, srcs []usermem.IOSequence, tos [][]byte, flags int, haveDeadline bool, deadline ktime.Time, controlMessages []socket.ControlMessages, ns []int) (int, *syserr.Error) {
+	ps := make([]tcpip.Payloader, 0, len(srcs))
+	opts := make([]tcpip.WriteOptions, 0, len(srcs))
+	var optsErr *syserr.Error
+	for i := range srcs {
+		o, err := s.writeOptions(tos[i], flags, controlMessages[i])
+		if err != nil {
+			// Send the messages that precede the invalid one.
+			optsErr = err
+			break
+		}
+		ps = append(ps, srcs[i].Reader(t))
+		opts = append(opts, o)
+	}
+	if len(ps) == 0 {
+		return 0, optsErr
+	}
+
+	var (
+		written = make([]int64, len(ps))
+		entry   waiter.Entry
+		ch      <-chan struct{}
+	)
+	for {
+		n, err := s.Endpoint.(tcpip.EndpointWithBatchIO).WriteBatch(ps, opts, written)
+		if _, ok := err.(*tcpip.ErrWouldBlock); ok && n == 0 && flags&linux.MSG_DONTWAIT == 0 {
+			if ch == nil {
+				// We'll have to block. Register for notification and try
+				// again before waiting, as in SendMsg.
+				entry, ch = waiter.NewChannelEntry(waiter.WritableEvents)
+				s.EventRegister(&entry)
+				defer s.EventUnregister(&entry)
+			} else if err := t.BlockWithDeadline(ch, haveDeadline, deadline); err != nil {
+				if linuxerr.Equals(linuxerr.ETIMEDOUT, err) {
+					return 0, syserr.ErrTryAgain
+				}
+				// handleIOError will consume errors from t.Block if needed.
+				return 0, syserr.FromError(err)
+			}
+			continue
+		}
+		for i := 0; i < n; i++ {
+			ns[i] = int(written[i])
+		}
+		if err != nil {
+			return n, syserr.TranslateNetstackError(err)
+		}
+		if n < len(srcs) {
+			return n, optsErr
+		}
+		return n, nil
+	}
+}
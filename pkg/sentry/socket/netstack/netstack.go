@@ -38,6 +38,7 @@ import (
 	"google.golang.org/protobuf/proto"
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/abi/linux/errno"
+	"gvisor.dev/gvisor/pkg/atomicbitops"
 	"gvisor.dev/gvisor/pkg/context"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
 	"gvisor.dev/gvisor/pkg/eventchannel"
@@ -455,6 +456,10 @@ type sock struct {
 	// TODO(b/153685824): Move this to SocketOptions.
 	// sockOptInq corresponds to TCP_INQ.
 	sockOptInq bool
+
+	// zeroCopyNextID is the number assigned to the next MSG_ZEROCOPY send
+	// that queues data. It is analogous to Linux's sock.sk_zckey.
+	zeroCopyNextID atomicbitops.Uint32
 }
 
 var _ = socket.Socket(&sock{})
@@ -673,7 +678,11 @@ func (s *sock) GetSockOpt(t *kernel.Task, level, name int, outPtr hostarch.Addr,
 
 	case linux.SOL_PACKET:
 		return s.getSockOptPacket(t, s.Endpoint, name, outPtr, outLen)
-	case linux.SOL_UDP, linux.SOL_RAW:
+
+	case linux.SOL_UDP:
+		return s.getSockOptUDP(t, s.Endpoint, name, outLen)
+
+	case linux.SOL_RAW:
 		// Not supported.
 	}
 
@@ -727,7 +736,10 @@ func (s *sock) SetSockOpt(t *kernel.Task, level int, name int, optVal []byte) *s
 	case linux.SOL_PACKET:
 		return s.setSockOptPacket(t, s.Endpoint, name, optVal)
 
-	case linux.SOL_UDP, linux.SOL_RAW:
+	case linux.SOL_UDP:
+		return s.setSockOptUDP(t, s.Endpoint, name, optVal)
+
+	case linux.SOL_RAW:
 		// Not supported.
 	}
 
@@ -761,7 +773,13 @@ func (s *sock) isPacketBased() bool {
 
 // Readiness returns a mask of ready events for socket s.
 func (s *sock) Readiness(mask waiter.EventMask) waiter.EventMask {
-	return s.Endpoint.Readiness(mask)
+	r := s.Endpoint.Readiness(mask)
+	// A non-empty error queue, such as one holding MSG_ZEROCOPY
+	// completions, also makes the socket ready for EventErr.
+	if mask&waiter.EventErr != 0 && s.Endpoint.SocketOptions().PeekErr() != nil {
+		r |= waiter.EventErr
+	}
+	return r
 }
 
 // checkFamily returns true iff the specified address family may be used with
@@ -1107,6 +1125,14 @@ func GetSockOptSocket(t *kernel.Task, s socket.Socket, ep commonEndpoint, family
 		v := primitive.Int32(boolToInt32(ep.SocketOptions().GetKeepAlive()))
 		return &v, nil
 
+	case linux.SO_ZEROCOPY:
+		if outLen < sizeOfInt32 {
+			return nil, syserr.ErrInvalidArgument
+		}
+
+		v := primitive.Int32(boolToInt32(ep.SocketOptions().GetZeroCopy()))
+		return &v, nil
+
 	case linux.SO_LINGER:
 		if outLen < linux.SizeOfLinger {
 			return nil, syserr.ErrInvalidArgument
@@ -1391,6 +1417,30 @@ func (s *sock) getSockOptICMPv6(t *kernel.Task, ep commonEndpoint, name int, out
 	return nil, syserr.ErrProtocolNotAvailable
 }
 
+// getSockOptUDP implements linux getsockopt(2) when the level is SOL_UDP.
+func (s *sock) getSockOptUDP(t *kernel.Task, ep commonEndpoint, name, outLen int) (marshal.Marshallable, *syserr.Error) {
+	if !socket.IsUDP(s) {
+		return nil, syserr.ErrProtocolNotAvailable
+	}
+
+	switch name {
+	case linux.UDP_SEGMENT:
+		v, err := ep.GetSockOptInt(tcpip.UDPSegmentOption)
+		if err != nil {
+			return nil, syserr.TranslateNetstackError(err)
+		}
+		return truncateInt32Result(primitive.Int32(v), outLen)
+
+	case linux.UDP_GRO:
+		v, err := ep.GetSockOptInt(tcpip.UDPGROOption)
+		if err != nil {
+			return nil, syserr.TranslateNetstackError(err)
+		}
+		return truncateInt32Result(primitive.Int32(v), outLen)
+	}
+	return nil, syserr.ErrProtocolNotAvailable
+}
+
 func defaultTTL(t *kernel.Task, network tcpip.NetworkProtocolNumber) (primitive.Int32, tcpip.Error) {
 	var opt tcpip.DefaultTTLOption
 	stack := inet.StackFromContext(t)
@@ -2092,6 +2142,27 @@ func SetSockOptSocket(t *kernel.Task, s socket.Socket, ep commonEndpoint, name i
 		ep.SocketOptions().SetKeepAlive(v != 0)
 		return nil
 
+	case linux.SO_ZEROCOPY:
+		// Only TCP and UDP sockets support MSG_ZEROCOPY.
+		family, skType, protocol := s.Type()
+		if family != linux.AF_INET && family != linux.AF_INET6 {
+			return syserr.ErrNotSupported
+		}
+		isUDP := skType == linux.SOCK_DGRAM && (protocol == 0 || protocol == linux.IPPROTO_UDP)
+		if skType != linux.SOCK_STREAM && !isUDP {
+			return syserr.ErrNotSupported
+		}
+		if len(optVal) < sizeOfInt32 {
+			return syserr.ErrInvalidArgument
+		}
+
+		v := hostarch.ByteOrder.Uint32(optVal)
+		if v > 1 {
+			return syserr.ErrInvalidArgument
+		}
+		ep.SocketOptions().SetZeroCopy(v != 0)
+		return nil
+
 	case linux.SO_SNDTIMEO:
 		if len(optVal) < linux.SizeOfTimeval {
 			return syserr.ErrInvalidArgument
@@ -2216,7 +2287,6 @@ func SetSockOptSocket(t *kernel.Task, s socket.Socket, ep commonEndpoint, name i
 		linux.SO_INCOMING_NAPI_ID,
 		linux.SO_COOKIE,
 		linux.SO_PEERGROUPS,
-		linux.SO_ZEROCOPY,
 		linux.SO_TXTIME,
 		linux.SO_BINDTOIFINDEX,
 		linux.SO_TIMESTAMP_NEW,
@@ -2445,6 +2515,30 @@ func (s *sock) setSockOptICMPv6(t *kernel.Task, ep commonEndpoint, name int, opt
 	return nil
 }
 
+// setSockOptUDP implements linux setsockopt(2) when the level is SOL_UDP.
+func (s *sock) setSockOptUDP(t *kernel.Task, ep commonEndpoint, name int, optVal []byte) *syserr.Error {
+	if !socket.IsUDP(s) {
+		return nil
+	}
+
+	switch name {
+	case linux.UDP_SEGMENT:
+		if len(optVal) < sizeOfInt32 {
+			return syserr.ErrInvalidArgument
+		}
+		v := int32(hostarch.ByteOrder.Uint32(optVal))
+		return syserr.TranslateNetstackError(ep.SetSockOptInt(tcpip.UDPSegmentOption, int(v)))
+
+	case linux.UDP_GRO:
+		if len(optVal) < sizeOfInt32 {
+			return syserr.ErrInvalidArgument
+		}
+		v := hostarch.ByteOrder.Uint32(optVal)
+		return syserr.TranslateNetstackError(ep.SetSockOptInt(tcpip.UDPGROOption, int(v)))
+	}
+	return nil
+}
+
 // setSockOptIPv6 implements the linux setsockopt(2) when the level is SOL_IPV6.
 func (s *sock) setSockOptIPv6(t *kernel.Task, ep commonEndpoint, name int, optVal []byte) *syserr.Error {
 	if _, ok := ep.(tcpip.Endpoint); !ok {
@@ -3161,28 +3255,8 @@ func (s *sock) nonBlockingRead(ctx context.Context, dst usermem.IOSequence, peek
 	s.updateTimestamp(res.ControlMessages)
 
 	if isPacket {
-		var addr linux.SockAddr
-		var addrLen uint32
-		if senderRequested {
-			addr, addrLen = socket.ConvertAddress(s.family, res.RemoteAddr)
-			switch v := addr.(type) {
-			case *linux.SockAddrLink:
-				v.Protocol = socket.Htons(uint16(res.LinkPacketInfo.Protocol))
-				v.PacketType = toLinuxPacketType(res.LinkPacketInfo.PktType)
-			}
-		}
-
-		msgLen := res.Count
-		if trunc {
-			msgLen = res.Total
-		}
-
-		var flags int
-		if res.Total > res.Count {
-			flags |= linux.MSG_TRUNC
-		}
-
-		return msgLen, flags, addr, addrLen, s.netstackToLinuxControlMessages(res.ControlMessages), nil
+		r := s.packetRecvResult(&res, trunc, senderRequested)
+		return r.N, r.MsgFlags, r.SenderAddr, r.SenderAddrLen, r.ControlMessages, nil
 	}
 
 	if peek {
@@ -3210,6 +3284,39 @@ func (s *sock) nonBlockingRead(ctx context.Context, dst usermem.IOSequence, peek
 	return res.Count, 0, nil, 0, cmsg, syserr.TranslateNetstackError(err)
 }
 
+// packetRecvResult converts the result of reading a packet from a
+// packet-based endpoint to the result of recvmsg(2).
+func (s *sock) packetRecvResult(res *tcpip.ReadResult, trunc, senderRequested bool) socket.RecvMsgResult {
+	var addr linux.SockAddr
+	var addrLen uint32
+	if senderRequested {
+		addr, addrLen = socket.ConvertAddress(s.family, res.RemoteAddr)
+		switch v := addr.(type) {
+		case *linux.SockAddrLink:
+			v.Protocol = socket.Htons(uint16(res.LinkPacketInfo.Protocol))
+			v.PacketType = toLinuxPacketType(res.LinkPacketInfo.PktType)
+		}
+	}
+
+	msgLen := res.Count
+	if trunc {
+		msgLen = res.Total
+	}
+
+	var flags int
+	if res.Total > res.Count {
+		flags |= linux.MSG_TRUNC
+	}
+
+	return socket.RecvMsgResult{
+		N:               msgLen,
+		MsgFlags:        flags,
+		SenderAddr:      addr,
+		SenderAddrLen:   addrLen,
+		ControlMessages: s.netstackToLinuxControlMessages(res.ControlMessages),
+	}
+}
+
 func (s *sock) netstackToLinuxControlMessages(cm tcpip.ReceivableControlMessages) socket.ControlMessages {
 	readCM := socket.NewIPControlMessages(s.family, cm)
 	return socket.ControlMessages{
@@ -3231,6 +3338,8 @@ func (s *sock) netstackToLinuxControlMessages(cm tcpip.ReceivableControlMessages
 			HasIPv6PacketInfo:  readCM.HasIPv6PacketInfo,
 			IPv6PacketInfo:     readCM.IPv6PacketInfo,
 			OriginalDstAddress: readCM.OriginalDstAddress,
+			HasGROSize:         readCM.HasGROSize,
+			GROSize:            readCM.GROSize,
 			SockErr:            readCM.SockErr,
 		},
 	}
@@ -3242,6 +3351,8 @@ func (s *sock) linuxToNetstackControlMessages(cm socket.ControlMessages) tcpip.S
 		TTL:         uint8(cm.IP.TTL),
 		HasHopLimit: cm.IP.HasHopLimit,
 		HopLimit:    uint8(cm.IP.HopLimit),
+		HasGSOSize:  cm.IP.HasGSOSize,
+		GSOSize:     cm.IP.GSOSize,
 	}
 }
 
@@ -3385,41 +3496,57 @@ func (s *sock) RecvMsg(t *kernel.Task, dst usermem.IOSequence, flags int, haveDe
 	}
 }
 
-// SendMsg implements the linux syscall sendmsg(2) for sockets backed by
-// tcpip.Endpoint.
-func (s *sock) SendMsg(t *kernel.Task, src usermem.IOSequence, to []byte, flags int, haveDeadline bool, deadline ktime.Time, controlMessages socket.ControlMessages) (int, *syserr.Error) {
+// writeOptions returns the options used to write a message sent with
+// sendmsg(2).
+func (s *sock) writeOptions(to []byte, flags int, controlMessages socket.ControlMessages) (tcpip.WriteOptions, *syserr.Error) {
 	// Reject Unix control messages.
 	if !controlMessages.Unix.Empty() {
-		return 0, syserr.ErrInvalidArgument
+		return tcpip.WriteOptions{}, syserr.ErrInvalidArgument
 	}
 
 	var addr *tcpip.FullAddress
 	if len(to) > 0 {
 		addrBuf, family, err := socket.AddressAndFamily(to)
 		if err != nil {
-			return 0, err
+			return tcpip.WriteOptions{}, err
 		}
 		if !s.checkFamily(family, false /* exact */) {
-			return 0, syserr.ErrInvalidArgument
+			return tcpip.WriteOptions{}, syserr.ErrInvalidArgument
 		}
 		addrBuf = s.mapFamily(addrBuf, family)
 
 		addr = &addrBuf
 	}
 
-	opts := tcpip.WriteOptions{
+	return tcpip.WriteOptions{
 		To:              addr,
 		More:            flags&linux.MSG_MORE != 0,
 		EndOfRecord:     flags&linux.MSG_EOR != 0,
 		ControlMessages: s.linuxToNetstackControlMessages(controlMessages),
+	}, nil
+}
+
+// SendMsg implements the linux syscall sendmsg(2) for sockets backed by
+// tcpip.Endpoint.
+func (s *sock) SendMsg(t *kernel.Task, src usermem.IOSequence, to []byte, flags int, haveDeadline bool, deadline ktime.Time, controlMessages socket.ControlMessages) (int, *syserr.Error) {
+	opts, err := s.writeOptions(to, flags, controlMessages)
+	if err != nil {
+		return 0, err
 	}
 
-	r := src.Reader(t)
 	var (
+		r     tcpip.Payloader = src.Reader(t)
 		total int64
 		entry waiter.Entry
 		ch    <-chan struct{}
 	)
+	if flags&linux.MSG_ZEROCOPY != 0 && s.Endpoint.SocketOptions().GetZeroCopy() {
+		zc := s.newZeroCopySend(t, src)
+		if zc.payload != nil {
+			r = zc.payload
+		}
+		defer func() { zc.finish(total) }()
+	}
 	for {
 		n, err := s.Endpoint.Write(r, opts)
 		total += n
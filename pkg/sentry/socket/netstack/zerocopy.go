@@ -0,0 +1,198 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package netstack
+
+import (
+	"io"
+
+	"gvisor.dev/gvisor/pkg/abi/linux"
+	"gvisor.dev/gvisor/pkg/atomicbitops"
+	"gvisor.dev/gvisor/pkg/buffer"
+	"gvisor.dev/gvisor/pkg/hostarch"
+	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
+	"gvisor.dev/gvisor/pkg/tcpip"
+	"gvisor.dev/gvisor/pkg/tcpip/header"
+	"gvisor.dev/gvisor/pkg/usermem"
+	"gvisor.dev/gvisor/pkg/waiter"
+)
+
+// zeroCopySend tracks a single sendmsg(2) with MSG_ZEROCOPY. It is analogous
+// to Linux's struct ubuf_info_msgzc.
+//
+// The application memory being sent is pinned and handed to the endpoint as
+// buffer views. Once the sendmsg(2) call has returned and the stack has
+// released every view, the memory is unpinned and a completion notification
+// is queued on the socket's error queue.
+type zeroCopySend struct {
+	s *sock
+
+	// payload refers to the pinned application memory. It is nil if the
+	// data couldn't be pinned, in which case the send copies it and the
+	// completion is reported as copied.
+	payload *zeroCopyPayload
+
+	// prs is the pinned application memory.
+	prs []mm.PinnedRange
+
+	// refs is the number of views of prs, plus one held until finish is
+	// called.
+	refs atomicbitops.Int64
+
+	// id is the send number reported in the completion notification. It is
+	// assigned by finish.
+	id uint32
+
+	// notify is true if a completion notification should be queued. It is
+	// set by finish.
+	notify bool
+}
+
+// newZeroCopySend pins the application memory in src for a MSG_ZEROCOPY send.
+//
+// This is analogous to Linux's net/core/skbuff.c:msg_zerocopy_realloc() and
+// net/core/datagram.c:zerocopy_fill_skb_from_iter().
+func (s *sock) newZeroCopySend(t *kernel.Task, src usermem.IOSequence) *zeroCopySend {
+	z := &zeroCopySend{s: s}
+	z.refs.Store(1)
+
+	// Only stream sockets hand the payload to the endpoint without
+	// copying it; see tcp.Endpoint.readFromPayloader.
+	if s.skType != linux.SOCK_STREAM {
+		return z
+	}
+	memmgr, ok := src.IO.(*mm.MemoryManager)
+	if !ok {
+		return z
+	}
+
+	var buf buffer.Buffer
+	if !z.pin(t, memmgr, src.Addrs, &buf) {
+		// Dropping the views releases their references on z, leaving only
+		// the one held until finish; the pinned memory is released then.
+		buf.Release()
+		return z
+	}
+	z.payload = &zeroCopyPayload{buf: buf}
+	return z
+}
+
+// pin pins the memory in ars and appends views of it to buf. It returns false
+// if any of the memory couldn't be pinned or mapped into the sentry.
+func (z *zeroCopySend) pin(t *kernel.Task, memmgr *mm.MemoryManager, ars hostarch.AddrRangeSeq, buf *buffer.Buffer) bool {
+	for ; !ars.IsEmpty(); ars = ars.Tail() {
+		ar := ars.Head()
+		if ar.Length() == 0 {
+			continue
+		}
+		end, ok := ar.End.RoundUp()
+		if !ok {
+			return false
+		}
+		prs, err := memmgr.Pin(t, hostarch.AddrRange{ar.Start.RoundDown(), end}, hostarch.Read, false /* ignorePermissions */)
+		z.prs = append(z.prs, prs...)
+		if err != nil {
+			return false
+		}
+		for _, pr := range prs {
+			bs, err := pr.File.MapInternal(pr.FileRange(), hostarch.Read)
+			if err != nil {
+				return false
+			}
+			addr := pr.Source.Start
+			for ; !bs.IsEmpty(); bs = bs.Tail() {
+				b := bs.Head()
+				bar := hostarch.AddrRange{addr, addr + hostarch.Addr(b.Len())}
+				addr = bar.End
+				// Memory that may fault on access can't be handed to the
+				// stack, which accesses views directly.
+				if b.NeedSafecopy() {
+					return false
+				}
+				sar := bar.Intersect(ar)
+				if sar.Length() == 0 {
+					continue
+				}
+				data := b.ToSlice()[sar.Start-bar.Start : sar.End-bar.Start]
+				z.refs.Add(1)
+				buf.Append(buffer.NewViewWithExternalData(data, z.decRef))
+			}
+		}
+	}
+	return true
+}
+
+// finish is called when the sendmsg(2) call returns, after sent bytes were
+// queued. If any were, the send is assigned a number and its completion
+// notification is queued once the stack releases the memory.
+func (z *zeroCopySend) finish(sent int64) {
+	if z.payload != nil {
+		z.payload.buf.Release()
+	}
+	if sent > 0 {
+		z.id = z.s.zeroCopyNextID.Add(1) - 1
+		z.notify = true
+	}
+	z.decRef()
+}
+
+// decRef drops a reference on z's pinned memory.
+//
+// It may be called from any goroutine, including the stack's.
+func (z *zeroCopySend) decRef() {
+	if z.refs.Add(-1) != 0 {
+		return
+	}
+	mm.Unpin(z.prs)
+	if !z.notify {
+		return
+	}
+	net := header.IPv6ProtocolNumber
+	if z.s.family == linux.AF_INET {
+		net = header.IPv4ProtocolNumber
+	}
+	z.s.Endpoint.SocketOptions().QueueZeroCopyErr(net, z.id, z.id, z.payload == nil /* copied */)
+	z.s.Queue.Notify(waiter.EventErr)
+}
+
+// zeroCopyPayload is a tcpip.BufferPayloader over pinned application memory.
+type zeroCopyPayload struct {
+	buf buffer.Buffer
+}
+
+var _ tcpip.BufferPayloader = (*zeroCopyPayload)(nil)
+
+// Read implements io.Reader.Read.
+func (p *zeroCopyPayload) Read(dst []byte) (int, error) {
+	if p.buf.Size() == 0 {
+		return 0, io.EOF
+	}
+	n, _ := p.buf.ReadAt(dst, 0)
+	p.buf.TrimFront(int64(n))
+	return n, nil
+}
+
+// Len implements tcpip.Payloader.Len.
+func (p *zeroCopyPayload) Len() int {
+	return int(p.buf.Size())
+}
+
+// TakeBuffer implements tcpip.BufferPayloader.TakeBuffer.
+func (p *zeroCopyPayload) TakeBuffer(n int) buffer.Buffer {
+	taken := p.buf.Clone()
+	taken.Truncate(int64(n))
+	p.buf.TrimFront(int64(n))
+	return taken
+}
@@ -76,6 +76,8 @@ func errOriginToLinux(origin tcpip.SockErrOrigin) uint8 {
 		return linux.SO_EE_ORIGIN_ICMP
 	case tcpip.SockExtErrorOriginICMP6:
 		return linux.SO_EE_ORIGIN_ICMP6
+	case tcpip.SockExtErrorOriginZeroCopy:
+		return linux.SO_EE_ORIGIN_ZEROCOPY
 	default:
 		panic(fmt.Sprintf("unknown socket origin: %d", origin))
 	}
@@ -89,11 +91,16 @@ func sockErrCmsgToLinux(sockErr *tcpip.SockError) linux.SockErrCMsg {
 	}
 
 	ee := linux.SockExtendedErr{
-		Errno:  uint32(syserr.TranslateNetstackError(sockErr.Err).ToLinux()),
 		Origin: errOriginToLinux(sockErr.Cause.Origin()),
 		Type:   sockErr.Cause.Type(),
 		Code:   sockErr.Cause.Code(),
 		Info:   sockErr.Cause.Info(),
+		Data:   sockErr.Cause.Data(),
+	}
+	// Notifications that don't report an error, such as MSG_ZEROCOPY
+	// completions, have a zero errno.
+	if sockErr.Err != nil {
+		ee.Errno = uint32(syserr.TranslateNetstackError(sockErr.Err).ToLinux())
 	}
 
 	switch sockErr.NetProto {
@@ -140,6 +147,8 @@ func NewIPControlMessages(family int, cmgs tcpip.ReceivableControlMessages) IPCo
 		PacketInfo:         packetInfoToLinux(cmgs.PacketInfo),
 		HasIPv6PacketInfo:  cmgs.HasIPv6PacketInfo,
 		OriginalDstAddress: orgDstAddr,
+		HasGROSize:         cmgs.HasGROSize,
+		GROSize:            cmgs.GROSize,
 		SockErr:            sockErrCmsgToLinux(cmgs.SockErr),
 	}
 
@@ -208,6 +217,19 @@ type IPControlMessages struct {
 	// and port of the incoming packet.
 	OriginalDstAddress linux.SockAddr
 
+	// HasGSOSize indicates whether GSOSize is valid/set.
+	HasGSOSize bool
+
+	// GSOSize is the UDP segment size of an outgoing message.
+	GSOSize uint16
+
+	// HasGROSize indicates whether GROSize is valid/set.
+	HasGROSize bool
+
+	// GROSize is the size of the UDP datagrams coalesced into an incoming
+	// message.
+	GROSize uint16
+
 	// SockErr is the dequeued socket error on recvmsg(MSG_ERRQUEUE).
 	SockErr linux.SockErrCMsg
 }
@@ -303,6 +325,52 @@ type Socket interface {
 	Type() (family int, skType linux.SockType, protocol int)
 }
 
+// BatchSocket is implemented by sockets that can receive or send several
+// messages in a single call, which recvmmsg(2) and sendmmsg(2) use to avoid
+// paying per-message costs such as endpoint locking for every message.
+type BatchSocket interface {
+	Socket
+
+	// SupportsBatchIO returns true if RecvMMsg and SendMMsg may be used. If
+	// it returns false, callers must fall back to RecvMsg and SendMsg.
+	SupportsBatchIO() bool
+
+	// RecvMMsg receives up to len(dsts) messages, the i-th of which is
+	// written to dsts[i] and described by results[i]. It blocks, subject to
+	// flags and the deadline, until at least one message is available, and
+	// then receives as many as are available without blocking further.
+	//
+	// It returns the number of messages received. If err != nil, no message
+	// was received. MSG_PEEK and MSG_ERRQUEUE are not supported.
+	//
+	// Precondition: len(results) >= len(dsts).
+	RecvMMsg(t *kernel.Task, dsts []usermem.IOSequence, flags int, haveDeadline bool, deadline ktime.Time, senderRequested bool, results []RecvMsgResult) (n int, err *syserr.Error)
+
+	// SendMMsg sends each of srcs as a separate message to the corresponding
+	// address in tos with the corresponding control messages, and stores the
+	// number of bytes sent for each in ns. It blocks, subject to flags and
+	// the deadline, until at least one message can be sent. As with SendMsg,
+	// it does not take ownership of control messages that were not sent.
+	//
+	// It returns the number of messages sent and, if fewer than len(srcs)
+	// were sent, the error that stopped it.
+	//
+	// Precondition: len(tos), len(controlMessages) and len(ns) are all at
+	// least len(srcs).
+	SendMMsg(t *kernel.Task, srcs []usermem.IOSequence, tos [][]byte, flags int, haveDeadline bool, deadline ktime.Time, controlMessages []ControlMessages, ns []int) (n int, err *syserr.Error)
+}
+
+// RecvMsgResult describes a message received by BatchSocket.RecvMMsg. Its
+// fields have the same meaning as the corresponding results of
+// Socket.RecvMsg.
+type RecvMsgResult struct {
+	N               int
+	MsgFlags        int
+	SenderAddr      linux.SockAddr
+	SenderAddrLen   uint32
+	ControlMessages ControlMessages
+}
+
 // Provider is the interface implemented by providers of sockets for
 // specific address families (e.g., AF_INET).
 type Provider interface {
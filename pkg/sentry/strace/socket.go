@@ -584,6 +584,14 @@ var sockOptNames = map[uint64]abi.ValueSet{
 		linux.TCP_ULP:                  "TCP_ULP",
 		linux.TCP_WINDOW_CLAMP:         "TCP_WINDOW_CLAMP",
 	},
+	linux.SOL_UDP: {
+		linux.UDP_CORK:         "UDP_CORK",
+		linux.UDP_ENCAP:        "UDP_ENCAP",
+		linux.UDP_NO_CHECK6_TX: "UDP_NO_CHECK6_TX",
+		linux.UDP_NO_CHECK6_RX: "UDP_NO_CHECK6_RX",
+		linux.UDP_SEGMENT:      "UDP_SEGMENT",
+		linux.UDP_GRO:          "UDP_GRO",
+	},
 	linux.SOL_IPV6: {
 		linux.IPV6_V6ONLY:              "IPV6_V6ONLY",
 		linux.IPV6_PATHMTU:             "IPV6_PATHMTU",
@@ -893,9 +893,9 @@ func posixLock(t *kernel.Task, args arch.SyscallArguments, file *vfs.FileDescrip
 }
 
 // Fadvise64 implements fadvise64(2).
-// This implementation currently ignores the provided advice.
 func Fadvise64(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	fd := args[0].Int()
+	offset := args[1].Int64()
 	length := args[2].Int64()
 	advice := args[3].Int()
 
@@ -930,8 +930,11 @@ func Fadvise64(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintp
 		return 0, nil, linuxerr.EINVAL
 	}
 
-	// Sure, whatever.
-	return 0, nil, nil
+	// Filesystems that don't act on the advice ignore it, as in Linux.
+	if offset < 0 {
+		offset = 0
+	}
+	return 0, nil, file.Fadvise(t, offset, length, advice)
 }
 
 // Mkdir implements Linux syscall mkdir(2).
@@ -1622,7 +1625,11 @@ func Fallocate(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintp
 	if !file.IsWritable() {
 		return 0, nil, linuxerr.EBADF
 	}
-	if mode != 0 {
+	switch mode {
+	case 0, linux.FALLOC_FL_KEEP_SIZE, linux.FALLOC_FL_PUNCH_HOLE | linux.FALLOC_FL_KEEP_SIZE:
+	default:
+		// Punching holes also requires FALLOC_FL_KEEP_SIZE; other modes are
+		// unsupported.
 		return 0, nil, linuxerr.ENOTSUP
 	}
 	if offset < 0 || length <= 0 {
@@ -1634,7 +1641,7 @@ func Fallocate(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintp
 		return 0, nil, linuxerr.EFBIG
 	}
 	limit := limits.FromContext(t).Get(limits.FileSize).Cur
-	if uint64(size) >= limit {
+	if mode&linux.FALLOC_FL_KEEP_SIZE == 0 && uint64(size) >= limit {
 		t.SendSignal(&linux.SignalInfo{
 			Signo: int32(linux.SIGXFSZ),
 			Code:  linux.SI_USER,
@@ -22,6 +22,7 @@ import (
 	"gvisor.dev/gvisor/pkg/hostarch"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
+	"gvisor.dev/gvisor/pkg/sentry/kernel/futex"
 	"gvisor.dev/gvisor/pkg/sentry/ktime"
 )
 
@@ -273,6 +274,89 @@ func Futex(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr,
 	}
 }
 
+// FutexWaitv implements linux syscall futex_waitv(2).
+func FutexWaitv(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	waitersAddr := args[0].Pointer()
+	nr := args[1].Uint()
+	flags := args[2].Uint()
+	timeout := args[3].Pointer()
+	clockid := args[4].Int()
+
+	if flags != 0 {
+		return 0, nil, linuxerr.EINVAL
+	}
+	if waitersAddr == 0 || nr == 0 || nr > linux.FUTEX_WAITV_MAX {
+		return 0, nil, linuxerr.EINVAL
+	}
+
+	// The timeout is absolute, and measured against clockid.
+	forever := timeout == 0
+	var timespec linux.Timespec
+	if !forever {
+		if clockid != linux.CLOCK_REALTIME && clockid != linux.CLOCK_MONOTONIC {
+			return 0, nil, linuxerr.EINVAL
+		}
+		var err error
+		timespec, err = copyTimespecIn(t, timeout)
+		if err != nil {
+			return 0, nil, err
+		}
+		if !timespec.Valid() {
+			return 0, nil, linuxerr.EINVAL
+		}
+	}
+
+	var waiters [linux.FUTEX_WAITV_MAX]linux.FutexWaitv
+	if _, err := linux.CopyFutexWaitvSliceIn(t, waitersAddr, waiters[:nr]); err != nil {
+		return 0, nil, err
+	}
+	var fs [linux.FUTEX_WAITV_MAX]futex.WaitvFutex
+	for i := range waiters[:nr] {
+		w := &waiters[i]
+		// Only 32-bit futexes are supported, as in Linux.
+		if w.Flags&^(linux.FUTEX2_SIZE_MASK|linux.FUTEX2_PRIVATE) != 0 || w.Reserved != 0 {
+			return 0, nil, linuxerr.EINVAL
+		}
+		if w.Flags&linux.FUTEX2_SIZE_MASK != linux.FUTEX2_SIZE_U32 || w.Val > uint64(^uint32(0)) {
+			return 0, nil, linuxerr.EINVAL
+		}
+		fs[i] = futex.WaitvFutex{
+			Addr:    hostarch.Addr(w.Uaddr),
+			Private: w.Flags&linux.FUTEX2_PRIVATE != 0,
+			Val:     uint32(w.Val),
+		}
+	}
+
+	mw := t.FutexMultiWaiter()
+	for {
+		if idx, err := t.Futex().WaitvPrepare(mw, t, fs[:nr]); err != nil {
+			return 0, nil, err
+		} else if idx >= 0 {
+			// A futex was woken before another's value was found to differ.
+			return uintptr(idx), nil, nil
+		}
+
+		var err error
+		if forever {
+			err = t.Block(mw.C)
+		} else if clockid == linux.CLOCK_REALTIME {
+			err = t.BlockWithDeadlineFrom(mw.C, t.Kernel().RealtimeClock(), true, ktime.FromTimespec(timespec))
+		} else {
+			err = t.BlockWithDeadline(mw.C, true, ktime.FromTimespec(timespec))
+		}
+
+		// A wakeup takes precedence over a concurrent timeout or signal.
+		if idx := t.Futex().WaitvComplete(mw, t); idx >= 0 {
+			return uintptr(idx), nil, nil
+		}
+		if err != nil {
+			return 0, nil, linuxerr.ConvertIntr(err, linuxerr.ERESTARTSYS)
+		}
+		// Spurious wakeup, e.g. from a wakeup that raced with a previous
+		// wait. Wait again.
+	}
+}
+
 // SetRobustList implements linux syscall set_robust_list(2).
 func SetRobustList(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
 	// Despite the syscall using the name 'pid' for this variable, it is
@@ -212,13 +212,31 @@ func Madvise(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr
 	length := uint64(args[1].SizeT())
 	adv := args[2].Int()
 
+	return 0, nil, madvise(t, t.MemoryManager(), addr, length, adv)
+}
+
+// madvise applies the advice adv to the given range in m, which may belong
+// to a task other than t.
+func madvise(t *kernel.Task, m *mm.MemoryManager, addr hostarch.Addr, length uint64, adv int32) error {
 	switch adv {
 	case linux.MADV_DONTNEED:
-		return 0, nil, t.MemoryManager().Decommit(addr, length)
+		return m.Decommit(addr, length)
+	case linux.MADV_FREE:
+		return m.Free(addr, length)
+	case linux.MADV_COLD:
+		return m.Reclaim(addr, length, false /* pageout */)
+	case linux.MADV_PAGEOUT:
+		return m.Reclaim(addr, length, true /* pageout */)
+	case linux.MADV_POPULATE_READ:
+		return m.Populate(t, addr, length, hostarch.Read)
+	case linux.MADV_POPULATE_WRITE:
+		return m.Populate(t, addr, length, hostarch.Write)
+	case linux.MADV_WILLNEED:
+		return m.WillNeed(t, addr, length)
 	case linux.MADV_DOFORK:
-		return 0, nil, t.MemoryManager().SetDontFork(addr, length, false)
+		return m.SetDontFork(addr, length, false)
 	case linux.MADV_DONTFORK:
-		return 0, nil, t.MemoryManager().SetDontFork(addr, length, true)
+		return m.SetDontFork(addr, length, true)
 	case linux.MADV_HUGEPAGE, linux.MADV_NOHUGEPAGE:
 		fallthrough
 	case linux.MADV_MERGEABLE, linux.MADV_UNMERGEABLE:
@@ -226,21 +244,94 @@ func Madvise(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr
 	case linux.MADV_DONTDUMP, linux.MADV_DODUMP:
 		// TODO(b/72045799): Core dumping isn't implemented, so these are
 		// no-ops.
-		fallthrough
-	case linux.MADV_NORMAL, linux.MADV_RANDOM, linux.MADV_SEQUENTIAL, linux.MADV_WILLNEED:
-		// Do nothing, we totally ignore the suggestions above.
-		return 0, nil, nil
+		return nil
+	case linux.MADV_SEQUENTIAL:
+		return m.SetSequentialRead(addr, length, true)
+	case linux.MADV_NORMAL, linux.MADV_RANDOM:
+		return m.SetSequentialRead(addr, length, false)
 	case linux.MADV_REMOVE:
 		// These "suggestions" have application-visible side effects, so we
 		// have to indicate that we don't support them.
-		return 0, nil, linuxerr.ENOSYS
+		return linuxerr.ENOSYS
 	case linux.MADV_HWPOISON:
 		// Only privileged processes are allowed to poison pages.
-		return 0, nil, linuxerr.EPERM
+		return linuxerr.EPERM
 	default:
 		// If adv is not a valid value tell the caller.
+		return linuxerr.EINVAL
+	}
+}
+
+// ProcessMadvise implements linux syscall process_madvise(2).
+func ProcessMadvise(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	pidfd := args[0].Int()
+	iovAddr := args[1].Pointer()
+	iovCnt := int(args[2].Int64())
+	adv := args[3].Int()
+	flags := args[4].Uint()
+
+	if flags != 0 || iovCnt < 0 || iovCnt > linux.UIO_MAXIOV {
+		return 0, nil, linuxerr.EINVAL
+	}
+	iovecs, err := t.CopyInIovecsAsSlice(iovAddr, iovCnt)
+	if err != nil {
+		return 0, nil, err
+	}
+	target, m, err := t.MemoryManagerFromPIDFD(pidfd)
+	if err != nil {
+		return 0, nil, err
+	}
+	defer m.DecUsers(t)
+	if m != t.MemoryManager() {
+		// Linux: mm/madvise.c:process_madvise() => kernel/fork.c:mm_access()
+		if !t.CanTrace(target, false /* attach */) {
+			return 0, nil, linuxerr.EACCES
+		}
+		// Only advice that does not change the contents of the target's
+		// memory may be given to other processes.
+		switch adv {
+		case linux.MADV_COLD, linux.MADV_PAGEOUT, linux.MADV_WILLNEED:
+		default:
+			return 0, nil, linuxerr.EINVAL
+		}
+		if !t.HasRootCapability(linux.CAP_SYS_NICE) {
+			return 0, nil, linuxerr.EPERM
+		}
+	}
+
+	var total uint64
+	for _, iov := range iovecs {
+		if err := madvise(t, m, iov.Start, iov.Length(), adv); err != nil {
+			if total != 0 {
+				return uintptr(total), nil, nil
+			}
+			return 0, nil, err
+		}
+		total += iov.Length()
+	}
+	return uintptr(total), nil, nil
+}
+
+// ProcessMrelease implements linux syscall process_mrelease(2).
+func ProcessMrelease(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	pidfd := args[0].Int()
+	flags := args[1].Uint()
+
+	if flags != 0 {
+		return 0, nil, linuxerr.EINVAL
+	}
+	target, m, err := t.MemoryManagerFromPIDFD(pidfd)
+	if err != nil {
+		return 0, nil, err
+	}
+	defer m.DecUsers(t)
+	// "The task must be exiting (e.g. due to a fatal signal) for its memory
+	// to be released." Linux: mm/oom_kill.c:process_mrelease()
+	if !t.MemoryManagerWillBeReleased(target, m) {
 		return 0, nil, linuxerr.EINVAL
 	}
+	m.Reap()
+	return 0, nil, nil
 }
 
 // Mincore implements the syscall mincore(2).
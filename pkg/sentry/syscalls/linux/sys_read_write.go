@@ -581,8 +581,13 @@ func Readahead(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintp
 		return 0, nil, linuxerr.EINVAL
 	}
 
-	// Return EINVAL; if the underlying file type does not support readahead,
-	// then Linux will return EINVAL to indicate as much. In the future, we
-	// may extend this function to actually support readahead hints.
-	return 0, nil, linuxerr.EINVAL
+	// If the underlying file type does not support readahead, then Linux
+	// returns EINVAL to indicate as much.
+	if _, ok := file.Impl().(vfs.Fadviser); !ok {
+		return 0, nil, linuxerr.EINVAL
+	}
+	if size == 0 {
+		return 0, nil, nil
+	}
+	return 0, nil, file.Fadvise(t, offset, int64(size), linux.POSIX_FADV_WILLNEED)
 }
@@ -726,6 +726,11 @@ func RecvMMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 		}
 	}
 
+	if bs, ok := s.(socket.BatchSocket); ok && flags&linux.MSG_ERRQUEUE == 0 && bs.SupportsBatchIO() {
+		n, err := recvMMsgBatch(t, bs, msgPtr, vlen, flags, haveDeadline, deadline)
+		return n, nil, err
+	}
+
 	var count uint32
 	var err error
 	for i := uint64(0); i < uint64(vlen); i++ {
@@ -755,6 +760,66 @@ func RecvMMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 	return uintptr(count), nil, nil
 }
 
+// recvMMsgBatch implements recvmmsg(2) for sockets that can receive all
+// available messages with a single call to socket.BatchSocket.RecvMMsg, rather
+// than one call to socket.Socket.RecvMsg per message.
+func recvMMsgBatch(t *kernel.Task, s socket.BatchSocket, msgPtr hostarch.Addr, vlen uint32, flags int32, haveDeadline bool, deadline ktime.Time) (uintptr, error) {
+	// Capture every message header up front. As in the unbatched loop, an
+	// invalid header only fails the call if no message precedes it.
+	var err error
+	mps := make([]hostarch.Addr, 0, vlen)
+	msgs := make([]MessageHeader64, 0, vlen)
+	dsts := make([]usermem.IOSequence, 0, vlen)
+	senderRequested := false
+	for i := uint64(0); i < uint64(vlen); i++ {
+		mp, ok := msgPtr.AddLength(i * multipleMessageHeader64Len)
+		if !ok {
+			err = linuxerr.EFAULT
+			break
+		}
+		msg, dst, cerr := captureRecvMsg(t, mp)
+		if cerr != nil {
+			err = cerr
+			break
+		}
+		mps = append(mps, mp)
+		msgs = append(msgs, msg)
+		dsts = append(dsts, dst)
+		senderRequested = senderRequested || msg.NameLen != 0
+	}
+
+	var count int
+	results := make([]socket.RecvMsgResult, len(dsts))
+	for count < len(dsts) {
+		n, e := s.RecvMMsg(t, dsts[count:], int(flags), haveDeadline, deadline, senderRequested, results[count:])
+		if e != nil {
+			err = linuxerr.ConvertIntr(e.ToError(), linuxerr.ERESTARTSYS)
+			break
+		}
+		for end := count + n; count < end; count++ {
+			var rn uintptr
+			if rn, err = finishRecvMsg(t, s, mps[count], &msgs[count], flags, results[count]); err == nil {
+				// Copy the received length to the caller.
+				_, err = primitive.CopyUint32Out(t, mps[count]+hostarch.Addr(messageHeader64Len), uint32(rn))
+			}
+			if err != nil {
+				for i := count + 1; i < end; i++ {
+					results[i].ControlMessages.Release(t)
+				}
+				break
+			}
+		}
+		if err != nil {
+			break
+		}
+	}
+
+	if count == 0 {
+		return 0, err
+	}
+	return uintptr(count), nil
+}
+
 func getSCMRights(t *kernel.Task, rights transport.RightsControlMessage) control.SCMRights {
 	switch v := rights.(type) {
 	case control.SCMRights:
@@ -798,26 +863,53 @@ func fdsToHostFiles(ctx context.Context, fds []int) []*vfs.FileDescription {
 }
 
 func recvSingleMsg(t *kernel.Task, s socket.Socket, msgPtr hostarch.Addr, flags int32, haveDeadline bool, deadline ktime.Time) (uintptr, error) {
+	msg, dst, err := captureRecvMsg(t, msgPtr)
+	if err != nil {
+		return 0, err
+	}
+	n, mflags, sender, senderLen, cms, e := s.RecvMsg(t, dst, int(flags), haveDeadline, deadline, msg.NameLen != 0, msg.ControlLen)
+	if e != nil {
+		return 0, linuxerr.ConvertIntr(e.ToError(), linuxerr.ERESTARTSYS)
+	}
+	return finishRecvMsg(t, s, msgPtr, &msg, flags, socket.RecvMsgResult{
+		N:               n,
+		MsgFlags:        mflags,
+		SenderAddr:      sender,
+		SenderAddrLen:   senderLen,
+		ControlMessages: cms,
+	})
+}
+
+// captureRecvMsg copies in the message header at msgPtr and returns it along
+// with the destination of the data it describes.
+func captureRecvMsg(t *kernel.Task, msgPtr hostarch.Addr) (MessageHeader64, usermem.IOSequence, error) {
 	// Capture the message header and io vectors.
 	var msg MessageHeader64
 	if _, err := msg.CopyIn(t, msgPtr); err != nil {
-		return 0, err
+		return msg, usermem.IOSequence{}, err
 	}
 
 	if msg.IovLen > linux.UIO_MAXIOV {
-		return 0, linuxerr.EMSGSIZE
+		return msg, usermem.IOSequence{}, linuxerr.EMSGSIZE
 	}
 	dst, err := t.IovecsIOSequence(hostarch.Addr(msg.Iov), int(msg.IovLen), usermem.IOOpts{})
 	if err != nil {
-		return 0, err
+		return msg, usermem.IOSequence{}, err
 	}
+	if msg.ControlLen > maxControlLen {
+		return msg, usermem.IOSequence{}, linuxerr.ENOBUFS
+	}
+	return msg, dst, nil
+}
+
+// finishRecvMsg copies out the sender address, control messages and flags of
+// a message received into the message header msg at msgPtr, and returns the
+// message length. It takes ownership of res.ControlMessages.
+func finishRecvMsg(t *kernel.Task, s socket.Socket, msgPtr hostarch.Addr, msg *MessageHeader64, flags int32, res socket.RecvMsgResult) (uintptr, error) {
+	n, mflags, cms := res.N, res.MsgFlags, res.ControlMessages
 
 	// Fast path when no control message nor name buffers are provided.
 	if msg.ControlLen == 0 && msg.NameLen == 0 {
-		n, mflags, _, _, cms, err := s.RecvMsg(t, dst, int(flags), haveDeadline, deadline, false, 0)
-		if err != nil {
-			return 0, linuxerr.ConvertIntr(err.ToError(), linuxerr.ERESTARTSYS)
-		}
 		if !cms.Unix.Empty() {
 			mflags |= linux.MSG_CTRUNC
 			cms.Release(t)
@@ -833,13 +925,6 @@ func recvSingleMsg(t *kernel.Task, s socket.Socket, msgPtr hostarch.Addr, flags
 		return uintptr(n), nil
 	}
 
-	if msg.ControlLen > maxControlLen {
-		return 0, linuxerr.ENOBUFS
-	}
-	n, mflags, sender, senderLen, cms, e := s.RecvMsg(t, dst, int(flags), haveDeadline, deadline, msg.NameLen != 0, msg.ControlLen)
-	if e != nil {
-		return 0, linuxerr.ConvertIntr(e.ToError(), linuxerr.ERESTARTSYS)
-	}
 	defer cms.Release(t)
 
 	controlData := make([]byte, 0, msg.ControlLen)
@@ -857,7 +942,7 @@ func recvSingleMsg(t *kernel.Task, s socket.Socket, msgPtr hostarch.Addr, flags
 
 	// Copy the address to the caller.
 	if msg.NameLen != 0 {
-		if err := writeAddress(t, sender, senderLen, hostarch.Addr(msg.Name), hostarch.Addr(msgPtr+nameLenOffset)); err != nil {
+		if err := writeAddress(t, res.SenderAddr, res.SenderAddrLen, hostarch.Addr(msg.Name), hostarch.Addr(msgPtr+nameLenOffset)); err != nil {
 			return 0, err
 		}
 	}
@@ -977,7 +1062,7 @@ func SendMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr
 	}
 
 	// Reject flags that we don't handle yet.
-	if flags & ^(linux.MSG_DONTWAIT|linux.MSG_EOR|linux.MSG_MORE|linux.MSG_NOSIGNAL) != 0 {
+	if flags & ^(linux.MSG_DONTWAIT|linux.MSG_EOR|linux.MSG_MORE|linux.MSG_NOSIGNAL|linux.MSG_ZEROCOPY) != 0 {
 		return 0, nil, linuxerr.EINVAL
 	}
 
@@ -1019,7 +1104,7 @@ func SendMMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 	}
 
 	// Reject flags that we don't handle yet.
-	if flags & ^(linux.MSG_DONTWAIT|linux.MSG_EOR|linux.MSG_MORE|linux.MSG_NOSIGNAL) != 0 {
+	if flags & ^(linux.MSG_DONTWAIT|linux.MSG_EOR|linux.MSG_MORE|linux.MSG_NOSIGNAL|linux.MSG_ZEROCOPY) != 0 {
 		return 0, nil, linuxerr.EINVAL
 	}
 
@@ -1027,6 +1112,13 @@ func SendMMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 		flags |= linux.MSG_DONTWAIT
 	}
 
+	// MSG_ZEROCOPY sends are sent one message at a time, since each message
+	// is assigned its own completion notification.
+	if bs, ok := s.(socket.BatchSocket); ok && bs.SupportsBatchIO() && flags&linux.MSG_ZEROCOPY == 0 {
+		n, err := sendMMsgBatch(t, bs, file, msgPtr, vlen, flags)
+		return n, nil, err
+	}
+
 	var count uint32
 	var err error
 	for i := uint64(0); i < uint64(vlen); i++ {
@@ -1056,22 +1148,114 @@ func SendMMsg(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 	return uintptr(count), nil, nil
 }
 
+// sendMMsgBatch implements sendmmsg(2) for sockets that can send several
+// messages with a single call to socket.BatchSocket.SendMMsg, rather than one
+// call to socket.Socket.SendMsg per message.
+func sendMMsgBatch(t *kernel.Task, s socket.BatchSocket, file *vfs.FileDescription, msgPtr hostarch.Addr, vlen uint32, flags int32) (uintptr, error) {
+	// Capture every message up front. As in the unbatched loop, an invalid
+	// message only fails the call if no message precedes it.
+	var err error
+	mps := make([]hostarch.Addr, 0, vlen)
+	srcs := make([]usermem.IOSequence, 0, vlen)
+	tos := make([][]byte, 0, vlen)
+	cms := make([]socket.ControlMessages, 0, vlen)
+	for i := uint64(0); i < uint64(vlen); i++ {
+		mp, ok := msgPtr.AddLength(i * multipleMessageHeader64Len)
+		if !ok {
+			err = linuxerr.EFAULT
+			break
+		}
+		src, to, controlMessages, cerr := captureSendMsg(t, s, mp)
+		if cerr != nil {
+			err = cerr
+			break
+		}
+		mps = append(mps, mp)
+		srcs = append(srcs, src)
+		tos = append(tos, to)
+		cms = append(cms, controlMessages)
+	}
+
+	haveDeadline, deadline, flags := sendDeadline(t, s, flags)
+
+	var count int
+	ns := make([]int, len(srcs))
+	for count < len(srcs) && err == nil {
+		n, e := s.SendMMsg(t, srcs[count:], tos[count:], int(flags), haveDeadline, deadline, cms[count:], ns[count:])
+		for i := count; i < count+n; i++ {
+			// Control messages should be released for zero-length messages,
+			// which are discarded by the receiver.
+			if ns[i] == 0 {
+				cms[i].Release(t)
+			}
+			cms[i] = socket.ControlMessages{}
+		}
+		for end := count + n; count < end; count++ {
+			// Copy the sent length to the caller.
+			if _, err = primitive.CopyUint32Out(t, mps[count]+hostarch.Addr(messageHeader64Len), uint32(ns[count])); err != nil {
+				break
+			}
+		}
+		if err == nil && (e != nil || n == 0) {
+			if n != 0 && e == syserr.ErrWouldBlock && flags&linux.MSG_DONTWAIT == 0 {
+				// The send buffer filled up after some messages were sent.
+				// As in sendSingleMsg, a blocking send waits, subject to
+				// the deadline, until the remaining messages can be sent.
+				continue
+			}
+			err = HandleIOError(t, false /* partialResult */, e.ToError(), linuxerr.ERESTARTSYS, "sendmmsg", file)
+			break
+		}
+	}
+	// As in sendSingleMsg, control messages of messages that weren't sent
+	// are released.
+	for i := count; i < len(cms); i++ {
+		cms[i].Release(t)
+	}
+
+	if count == 0 {
+		return 0, err
+	}
+	return uintptr(count), nil
+}
+
 func sendSingleMsg(t *kernel.Task, s socket.Socket, file *vfs.FileDescription, msgPtr hostarch.Addr, flags int32) (uintptr, error) {
+	src, to, controlMessages, err := captureSendMsg(t, s, msgPtr)
+	if err != nil {
+		return 0, err
+	}
+
+	haveDeadline, deadline, flags := sendDeadline(t, s, flags)
+
+	// Call the syscall implementation.
+	n, e := s.SendMsg(t, src, to, int(flags), haveDeadline, deadline, controlMessages)
+	err = HandleIOError(t, n != 0, e.ToError(), linuxerr.ERESTARTSYS, "sendmsg", file)
+	// Control messages should be released on error as well as for zero-length
+	// messages, which are discarded by the receiver.
+	if n == 0 || err != nil {
+		controlMessages.Release(t)
+	}
+	return uintptr(n), err
+}
+
+// captureSendMsg copies in the message header at msgPtr and returns the
+// source of its data, its destination address and its control messages.
+func captureSendMsg(t *kernel.Task, s socket.Socket, msgPtr hostarch.Addr) (usermem.IOSequence, []byte, socket.ControlMessages, error) {
 	// Capture the message header.
 	var msg MessageHeader64
 	if _, err := msg.CopyIn(t, msgPtr); err != nil {
-		return 0, err
+		return usermem.IOSequence{}, nil, socket.ControlMessages{}, err
 	}
 
 	var controlData []byte
 	if msg.ControlLen > 0 {
 		// Put an upper bound to prevent large allocations.
 		if msg.ControlLen > maxControlLen {
-			return 0, linuxerr.ENOBUFS
+			return usermem.IOSequence{}, nil, socket.ControlMessages{}, linuxerr.ENOBUFS
 		}
 		controlData = make([]byte, msg.ControlLen)
 		if _, err := t.CopyInBytes(hostarch.Addr(msg.Control), controlData); err != nil {
-			return 0, err
+			return usermem.IOSequence{}, nil, socket.ControlMessages{}, err
 		}
 	}
 
@@ -1081,24 +1265,29 @@ func sendSingleMsg(t *kernel.Task, s socket.Socket, file *vfs.FileDescription, m
 		var err error
 		to, err = CaptureAddress(t, hostarch.Addr(msg.Name), msg.NameLen)
 		if err != nil {
-			return 0, err
+			return usermem.IOSequence{}, nil, socket.ControlMessages{}, err
 		}
 	}
 
 	// Read data then call the sendmsg implementation.
 	if msg.IovLen > linux.UIO_MAXIOV {
-		return 0, linuxerr.EMSGSIZE
+		return usermem.IOSequence{}, nil, socket.ControlMessages{}, linuxerr.EMSGSIZE
 	}
 	src, err := t.IovecsIOSequence(hostarch.Addr(msg.Iov), int(msg.IovLen), usermem.IOOpts{})
 	if err != nil {
-		return 0, err
+		return usermem.IOSequence{}, nil, socket.ControlMessages{}, err
 	}
 
 	controlMessages, err := control.Parse(t, s, controlData, t.Arch().Width())
 	if err != nil {
-		return 0, err
+		return usermem.IOSequence{}, nil, socket.ControlMessages{}, err
 	}
+	return src, to, controlMessages, nil
+}
 
+// sendDeadline returns the deadline for a send on s, and flags updated to
+// include MSG_DONTWAIT if the socket's send timeout requires it.
+func sendDeadline(t *kernel.Task, s socket.Socket, flags int32) (bool, ktime.Time, int32) {
 	var haveDeadline bool
 	var deadline ktime.Time
 	if dl := s.SendTimeout(); dl > 0 {
@@ -1107,16 +1296,7 @@ func sendSingleMsg(t *kernel.Task, s socket.Socket, file *vfs.FileDescription, m
 	} else if dl < 0 {
 		flags |= linux.MSG_DONTWAIT
 	}
-
-	// Call the syscall implementation.
-	n, e := s.SendMsg(t, src, to, int(flags), haveDeadline, deadline, controlMessages)
-	err = HandleIOError(t, n != 0, e.ToError(), linuxerr.ERESTARTSYS, "sendmsg", file)
-	// Control messages should be released on error as well as for zero-length
-	// messages, which are discarded by the receiver.
-	if n == 0 || err != nil {
-		controlMessages.Release(t)
-	}
-	return uintptr(n), err
+	return haveDeadline, deadline, flags
 }
 
 // sendTo is the implementation of the sendto syscall. It is called by sendto
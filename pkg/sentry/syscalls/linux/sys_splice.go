@@ -16,14 +16,18 @@ package linux
 
 import (
 	"io"
+	"math"
 
 	"gvisor.dev/gvisor/pkg/abi/linux"
 	"gvisor.dev/gvisor/pkg/errors/linuxerr"
+	"gvisor.dev/gvisor/pkg/hostarch"
 	"gvisor.dev/gvisor/pkg/log"
 	"gvisor.dev/gvisor/pkg/marshal/primitive"
 	"gvisor.dev/gvisor/pkg/sentry/arch"
 	"gvisor.dev/gvisor/pkg/sentry/kernel"
 	"gvisor.dev/gvisor/pkg/sentry/kernel/pipe"
+	"gvisor.dev/gvisor/pkg/sentry/memmap"
+	"gvisor.dev/gvisor/pkg/sentry/mm"
 	"gvisor.dev/gvisor/pkg/sentry/vfs"
 	"gvisor.dev/gvisor/pkg/sync"
 	"gvisor.dev/gvisor/pkg/usermem"
@@ -267,6 +271,154 @@ func Tee(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *k
 	return uintptr(n), nil, HandleIOError(t, n != 0, err, linuxerr.ERESTARTSYS, "tee", inFile)
 }
 
+// Vmsplice implements Linux syscall vmsplice(2).
+func Vmsplice(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	fd := args[0].Int()
+	addr := args[1].Pointer()
+	iovcnt := args[2].Uint64()
+	flags := args[3].Int()
+
+	// Check for invalid flags.
+	if flags&^(linux.SPLICE_F_MOVE|linux.SPLICE_F_NONBLOCK|linux.SPLICE_F_MORE|linux.SPLICE_F_GIFT) != 0 {
+		return 0, nil, linuxerr.EINVAL
+	}
+
+	file := t.GetFile(fd)
+	if file == nil {
+		return 0, nil, linuxerr.EBADF
+	}
+	defer file.DecRef(t)
+
+	// The file description must represent a pipe.
+	pipeFD, ok := file.Impl().(*pipe.VFSPipeFD)
+	if !ok {
+		return 0, nil, linuxerr.EBADF
+	}
+
+	if iovcnt > linux.UIO_MAXIOV {
+		return 0, nil, linuxerr.EINVAL
+	}
+	iovs, err := t.IovecsIOSequence(addr, int(iovcnt), usermem.IOOpts{})
+	if err != nil {
+		return 0, nil, err
+	}
+	if iovs.NumBytes() == 0 {
+		return 0, nil, nil
+	}
+
+	// As for splice(2), the operation is non-blocking if either the file or
+	// the flags say so.
+	nonBlock := file.StatusFlags()&linux.O_NONBLOCK != 0 || flags&linux.SPLICE_F_NONBLOCK != 0
+
+	// Like Linux, move data into the pipe if it is writable and out of it
+	// otherwise.
+	var (
+		transfer func() (int64, error)
+		mask     waiter.EventMask
+	)
+	switch {
+	case file.IsWritable():
+		mask = eventMaskWrite
+		transfer = func() (int64, error) {
+			if flags&linux.SPLICE_F_GIFT != 0 {
+				return vmspliceGift(t, pipeFD, iovs)
+			}
+			return file.Write(t, iovs, vfs.WriteOptions{})
+		}
+	case file.IsReadable():
+		mask = eventMaskRead
+		transfer = func() (int64, error) {
+			return file.Read(t, iovs, vfs.ReadOptions{})
+		}
+	default:
+		return 0, nil, linuxerr.EBADF
+	}
+
+	// Block until some data can be moved; the transfer may then be short.
+	var (
+		n  int64
+		w  waiter.Entry
+		ch chan struct{}
+	)
+	for {
+		n, err = transfer()
+		if n != 0 || !linuxerr.Equals(linuxerr.ErrWouldBlock, err) || nonBlock {
+			break
+		}
+		if ch == nil {
+			w, ch = waiter.NewChannelEntry(mask)
+			if err = file.EventRegister(&w); err != nil {
+				break
+			}
+			defer file.EventUnregister(&w)
+			// We might be ready now. Try again before blocking.
+			continue
+		}
+		if err = t.Block(ch); err != nil {
+			break
+		}
+	}
+
+	return uintptr(n), nil, HandleIOError(t, n != 0, err, linuxerr.ERESTARTSYS, "vmsplice", file)
+}
+
+// vmspliceGift moves up to src.NumBytes() bytes of t's memory into pipeFD by
+// taking references on the pages that store them, for vmsplice(2) with
+// SPLICE_F_GIFT. Like Linux, later changes to gifted memory may be visible to
+// the pipe's reader.
+func vmspliceGift(t *kernel.Task, pipeFD *pipe.VFSPipeFD, src usermem.IOSequence) (int64, error) {
+	return pipeFD.SpliceFromPages(src.NumBytes(), func(count int64, f vfs.SplicePagesFunc) (int64, error) {
+		var done int64
+		for ars := src.Addrs; !ars.IsEmpty() && done < count; ars = ars.Tail() {
+			ar := ars.Head()
+			if remaining := count - done; int64(ar.Length()) > remaining {
+				ar.End = ar.Start + hostarch.Addr(remaining)
+			}
+			if ar.Length() == 0 {
+				continue
+			}
+			n, err := vmspliceGiftRange(t, ar, f)
+			done += n
+			if err != nil || n < int64(ar.Length()) {
+				return done, err
+			}
+		}
+		return done, nil
+	})
+}
+
+// vmspliceGiftRange passes the memmap.File ranges storing the memory in ar to
+// f, in order, and returns the number of bytes f consumed.
+func vmspliceGiftRange(t *kernel.Task, ar hostarch.AddrRange, f vfs.SplicePagesFunc) (int64, error) {
+	end, ok := ar.End.RoundUp()
+	if !ok {
+		return 0, linuxerr.EFAULT
+	}
+	// Pinning keeps the pages from being released while f takes its own
+	// references on them.
+	prs, err := t.MemoryManager().Pin(t, hostarch.AddrRange{ar.Start.RoundDown(), end}, hostarch.Read, false /* ignorePermissions */)
+	defer mm.Unpin(prs)
+	var done int64
+	for _, pr := range prs {
+		sar := pr.Source.Intersect(ar)
+		if sar.Length() == 0 {
+			continue
+		}
+		start := pr.Offset + uint64(sar.Start-pr.Source.Start)
+		fr := memmap.FileRange{start, start + uint64(sar.Length())}
+		n := f(pr.File, fr)
+		done += int64(n)
+		if n < fr.Length() {
+			return done, nil
+		}
+	}
+	if done != 0 {
+		// Report the error, if any, on the next call.
+		return done, nil
+	}
+	return 0, err
+}
+
 var sendfileBufPool = sync.Pool{
 	New: func() any {
 		b := make([]byte, pipe.MaximumPipeSize)
@@ -475,6 +627,161 @@ func Sendfile(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintpt
 	return uintptr(total), nil, HandleIOError(t, total != 0, err, linuxerr.ERESTARTSYS, "sendfile", inFile)
 }
 
+// CopyFileRange implements Linux syscall copy_file_range(2).
+func CopyFileRange(t *kernel.Task, sysno uintptr, args arch.SyscallArguments) (uintptr, *kernel.SyscallControl, error) {
+	inFD := args[0].Int()
+	inOffsetPtr := args[1].Pointer()
+	outFD := args[2].Int()
+	outOffsetPtr := args[3].Pointer()
+	length := uint64(args[4].SizeT())
+	flags := args[5].Uint()
+
+	if flags != 0 {
+		return 0, nil, linuxerr.EINVAL
+	}
+
+	inFile := t.GetFile(inFD)
+	if inFile == nil {
+		return 0, nil, linuxerr.EBADF
+	}
+	defer inFile.DecRef(t)
+	outFile := t.GetFile(outFD)
+	if outFile == nil {
+		return 0, nil, linuxerr.EBADF
+	}
+	defer outFile.DecRef(t)
+
+	// Both files must be regular files. Compare Linux's
+	// fs/remap_range.c:generic_file_rw_checks().
+	statOpts := vfs.StatOptions{Mask: linux.STATX_TYPE | linux.STATX_INO}
+	inStat, err := inFile.Stat(t, statOpts)
+	if err != nil {
+		return 0, nil, err
+	}
+	outStat, err := outFile.Stat(t, statOpts)
+	if err != nil {
+		return 0, nil, err
+	}
+	if inStat.Mode&linux.S_IFMT == linux.S_IFDIR || outStat.Mode&linux.S_IFMT == linux.S_IFDIR {
+		return 0, nil, linuxerr.EISDIR
+	}
+	if inStat.Mode&linux.S_IFMT != linux.S_IFREG || outStat.Mode&linux.S_IFMT != linux.S_IFREG {
+		return 0, nil, linuxerr.EINVAL
+	}
+	if !inFile.IsReadable() || !outFile.IsWritable() || outFile.StatusFlags()&linux.O_APPEND != 0 {
+		return 0, nil, linuxerr.EBADF
+	}
+
+	inOffset, err := copyFileRangeOffset(t, inFile, inOffsetPtr, inFile.Options().DenyPRead)
+	if err != nil {
+		return 0, nil, err
+	}
+	outOffset, err := copyFileRangeOffset(t, outFile, outOffsetPtr, outFile.Options().DenyPWrite)
+	if err != nil {
+		return 0, nil, err
+	}
+
+	// Compare Linux's fs/read_write.c:generic_copy_file_checks().
+	if length > math.MaxInt64 || inOffset+int64(length) < inOffset || outOffset+int64(length) < outOffset {
+		return 0, nil, linuxerr.EOVERFLOW
+	}
+	if length == 0 {
+		return 0, nil, nil
+	}
+	count := int64(min(length, uint64(linux.MAX_RW_COUNT)))
+	if inStat.Ino == outStat.Ino && inStat.DevMajor == outStat.DevMajor && inStat.DevMinor == outStat.DevMinor &&
+		inOffset < outOffset+count && outOffset < inOffset+count {
+		// Copying between overlapping ranges of the same file.
+		return 0, nil, linuxerr.EINVAL
+	}
+
+	// Let the output file copy the data if it can do so more cheaply than by
+	// reading and writing it (e.g. by sharing pages or offloading the copy to
+	// the host). Otherwise, copy through a buffer as sendfile(2) does.
+	var total int64
+	var bufPtr *[]byte
+	for total < count {
+		var n int64
+		n, err = outFile.CopyFileRangeFrom(t, inFile, inOffset+total, outOffset+total, count-total)
+		if n == 0 && err == nil {
+			if bufPtr == nil {
+				bufPtr = sendfileBufPool.Get().(*[]byte)
+				defer sendfileBufPool.Put(bufPtr)
+			}
+			buf := (*bufPtr)[:min(count-total, pipe.MaximumPipeSize)]
+			n, err = inFile.PRead(t, usermem.BytesIOSequence(buf), inOffset+total, vfs.ReadOptions{})
+			if n > 0 {
+				n, err = outFile.PWrite(t, usermem.BytesIOSequence(buf[:n]), outOffset+total, vfs.WriteOptions{})
+			}
+		}
+		total += n
+		if n == 0 || err != nil {
+			break
+		}
+		if total < count && t.Interrupted() {
+			err = linuxerr.ErrInterrupted
+			break
+		}
+	}
+
+	if total != 0 {
+		// Advance offsets past the copied data. The data has already been
+		// written, so failing to update an offset must not hide that.
+		if err := setCopyFileRangeOffset(t, inFile, inOffsetPtr, inOffset+total); err != nil {
+			log.Debugf("copy_file_range failed to update the input offset after a copy: %v", err)
+		}
+		if err := setCopyFileRangeOffset(t, outFile, outOffsetPtr, outOffset+total); err != nil {
+			log.Debugf("copy_file_range failed to update the output offset after a copy: %v", err)
+		}
+		if err != nil && err != io.EOF {
+			// If a partial copy is completed, the error is dropped. Log it here.
+			log.Debugf("copy_file_range completed a partial copy with error: %v", err)
+			err = nil
+		}
+	}
+
+	// We can only pass a single file to handleIOError, so pick inFile arbitrarily.
+	// This is used only for debugging purposes.
+	return uintptr(total), nil, HandleIOError(t, total != 0, err, linuxerr.ERESTARTSYS, "copy_file_range", inFile)
+}
+
+// copyFileRangeOffset returns the offset in file used by copy_file_range(2),
+// which is read from offsetPtr if it is not 0, or is file's offset otherwise.
+// If deny is true, file's offset must be used.
+func copyFileRangeOffset(t *kernel.Task, file *vfs.FileDescription, offsetPtr hostarch.Addr, deny bool) (int64, error) {
+	if offsetPtr == 0 {
+		return file.Seek(t, 0, linux.SEEK_CUR)
+	}
+	if deny {
+		return 0, linuxerr.ESPIPE
+	}
+	var offsetP primitive.Int64
+	if _, err := offsetP.CopyIn(t, offsetPtr); err != nil {
+		return 0, err
+	}
+	if offsetP < 0 {
+		return 0, linuxerr.EINVAL
+	}
+	return int64(offsetP), nil
+}
+
+// setCopyFileRangeOffset stores the offset in file following a
+// copy_file_range(2) to offsetPtr if it is not 0, or to file's offset
+// otherwise.
+func setCopyFileRangeOffset(t *kernel.Task, file *vfs.FileDescription, offsetPtr hostarch.Addr, offset int64) error {
+	if offsetPtr == 0 {
+		if _, err := file.Seek(t, offset, linux.SEEK_SET); err != nil {
+			// Log the error but don't return it, since the copy has already
+			// completed successfully.
+			log.Warningf("failed to update file offset: %v", err)
+		}
+		return nil
+	}
+	offsetP := primitive.Int64(offset)
+	_, err := offsetP.CopyOut(t, offsetPtr)
+	return err
+}
+
 // dualWaiter is used to wait on one or both vfs.FileDescriptions. It is not
 // thread-safe, and does not take a reference on the vfs.FileDescriptions.
 //
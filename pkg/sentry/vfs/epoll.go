@@ -48,6 +48,11 @@ type EpollInstance struct {
 	// EpollInstance for monitoring.
 	interest map[epollInterestKey]*epollInterest
 
+	// nested is the subset of interest for which key.file is an
+	// EpollInstance. It allows cycle checks to avoid iterating over all of
+	// interest, which may be very large. nested is protected by interestMu.
+	nested map[*epollInterest]struct{}
+
 	// readyMu protects ready, readySeq, epollInterest.ready, and
 	// epollInterest.epollInterestEntry. ready is analogous to Linux's struct
 	// eventpoll::lock.
@@ -145,6 +150,7 @@ func (ep *EpollInstance) Release(ctx context.Context) {
 		file.epollMu.Unlock()
 	}
 	ep.interest = nil
+	ep.nested = nil
 }
 
 // Readiness implements waiter.Waitable.Readiness.
@@ -240,6 +246,12 @@ func (ep *EpollInstance) AddInterest(file *FileDescription, num int32, event lin
 
 	// Check for cyclic polling if necessary.
 	subep, _ := file.impl.(*EpollInstance)
+	if event.Events&linux.EPOLLEXCLUSIVE != 0 {
+		// Linux: fs/eventpoll.c:do_epoll_ctl()
+		if subep != nil || event.Events&^linux.EPOLLEXCLUSIVE_OK_BITS != 0 {
+			return linuxerr.EINVAL
+		}
+	}
 	if subep != nil {
 		epollCycleMu.Lock()
 		// epollCycleMu must be locked for the rest of AddInterest to ensure
@@ -271,8 +283,18 @@ func (ep *EpollInstance) AddInterest(file *FileDescription, num int32, event lin
 		userData: event.Data,
 	}
 	ep.interest[key] = epi
+	if subep != nil {
+		if ep.nested == nil {
+			ep.nested = make(map[*epollInterest]struct{})
+		}
+		ep.nested[epi] = struct{}{}
+	}
 	wmask := waiter.EventMaskFromLinux(mask)
-	epi.waiter.Init(epi, wmask)
+	if mask&linux.EPOLLEXCLUSIVE != 0 {
+		epi.waiter.InitExclusive(epi, wmask)
+	} else {
+		epi.waiter.Init(epi, wmask)
+	}
 	if err := file.EventRegister(&epi.waiter); err != nil {
 		return err
 	}
@@ -301,11 +323,8 @@ func (ep *EpollInstance) mightPoll(ep2 *EpollInstance) bool {
 func (ep *EpollInstance) mightPollRecursive(ep2 *EpollInstance, remainingRecursion int) bool {
 	ep.interestMu.Lock()
 	defer ep.interestMu.Unlock()
-	for key := range ep.interest {
-		nextep, ok := key.file.impl.(*EpollInstance)
-		if !ok {
-			continue
-		}
+	for epi := range ep.nested {
+		nextep := epi.key.file.impl.(*EpollInstance)
 		if nextep == ep2 {
 			return true
 		}
@@ -323,6 +342,11 @@ func (ep *EpollInstance) mightPollRecursive(ep2 *EpollInstance, remainingRecursi
 //
 // Preconditions: A reference must be held on file.
 func (ep *EpollInstance) ModifyInterest(file *FileDescription, num int32, event linux.EpollEvent) error {
+	// EPOLLEXCLUSIVE can only be set by EPOLL_CTL_ADD.
+	if event.Events&linux.EPOLLEXCLUSIVE != 0 {
+		return linuxerr.EINVAL
+	}
+
 	ep.interestMu.Lock()
 	defer ep.interestMu.Unlock()
 
@@ -335,17 +359,25 @@ func (ep *EpollInstance) ModifyInterest(file *FileDescription, num int32, event
 		return linuxerr.ENOENT
 	}
 
+	// Linux: fs/eventpoll.c:do_epoll_ctl()
+	if epi.mask&linux.EPOLLEXCLUSIVE != 0 {
+		return linuxerr.EINVAL
+	}
+
 	// Update epi for the next call to ep.ReadEvents().
 	mask := event.Events | linux.EPOLLERR | linux.EPOLLHUP
 	epi.mask = mask
 	epi.userData = event.Data
 
-	// Re-register with the new mask.
-	file.EventUnregister(&epi.waiter)
+	// Re-register with the new mask. This is unnecessary if the mask is
+	// unchanged, as when EPOLLONESHOT interests are rearmed.
 	wmask := waiter.EventMaskFromLinux(mask)
-	epi.waiter.Init(epi, wmask)
-	if err := file.EventRegister(&epi.waiter); err != nil {
-		return err
+	if wmask != epi.waiter.Mask() {
+		file.EventUnregister(&epi.waiter)
+		epi.waiter.Init(epi, wmask)
+		if err := file.EventRegister(&epi.waiter); err != nil {
+			return err
+		}
 	}
 
 	// Check if the file is already ready with the new mask.
@@ -401,9 +433,20 @@ func (epi *epollInterest) NotifyEvent(waiter.EventMask) {
 	}
 }
 
+// NotifyEventExclusive implements
+// waiter.ExclusiveEventListener.NotifyEventExclusive.
+func (epi *epollInterest) NotifyEventExclusive(mask waiter.EventMask) bool {
+	epi.NotifyEvent(mask)
+	// As in Linux's ep_poll_callback(), only consume the notification if it
+	// may wake a waiter on the EpollInstance, so that the next EpollInstance
+	// gets a chance if no task is blocked in epoll_wait() on this one.
+	return !epi.epoll.q.IsEmpty()
+}
+
 // Preconditions: ep.interestMu must be locked.
 func (ep *EpollInstance) removeLocked(epi *epollInterest) {
 	delete(ep.interest, epi.key)
+	delete(ep.nested, epi)
 	epi.mask = 0
 	ep.readyMu.Lock()
 	if epi.ready {
@@ -690,6 +690,56 @@ func (fd *FileDescription) Read(ctx context.Context, dst usermem.IOSequence, opt
 	return n, err
 }
 
+// SplicePageSource is an optional interface implemented by
+// FileDescriptionImpls whose data is stored in reference-counted memmap.File
+// pages, allowing splice(2) to move references on those pages into pipes
+// rather than copying file data.
+type SplicePageSource interface {
+	// SplicePages is similar to PRead, or Read if offset is -1, but instead of
+	// copying up to count bytes of file data it passes the ranges of memmap.File
+	// that store the data to f, in file order. file is nil for ranges that read
+	// as zeroes, in which case only fr.Length() is meaningful. f returns the
+	// number of bytes it consumed from fr; SplicePages stops early if f
+	// consumes less than all of fr. SplicePages returns the total number of
+	// bytes consumed.
+	//
+	// f is called with locks held that prevent the pages in fr from being
+	// released. It must take its own references, using memmap.File.IncRef, on
+	// any pages it retains, and must not block.
+	//
+	// If the data at offset can not be provided by reference (e.g. because it
+	// is not cached), SplicePages returns (0, nil) without calling f, and the
+	// caller should fall back to copying.
+	SplicePages(ctx context.Context, offset, count int64, f SplicePagesFunc) (int64, error)
+}
+
+// SplicePagesFunc is the callback type for SplicePageSource.SplicePages.
+type SplicePagesFunc func(file memmap.File, fr memmap.FileRange) uint64
+
+// SplicePages calls SplicePageSource.SplicePages on fd's implementation. If
+// the implementation does not support SplicePageSource, SplicePages returns
+// (0, nil).
+func (fd *FileDescription) SplicePages(ctx context.Context, offset, count int64, f SplicePagesFunc) (int64, error) {
+	ps, ok := fd.impl.(SplicePageSource)
+	if !ok {
+		return 0, nil
+	}
+	if offset != -1 && fd.opts.DenyPRead {
+		return 0, linuxerr.ESPIPE
+	}
+	if !fd.IsReadable() {
+		return 0, linuxerr.EBADF
+	}
+	start := fsmetric.StartReadWait()
+	n, err := ps.SplicePages(ctx, offset, count, f)
+	if n > 0 {
+		fd.Dentry().InotifyWithParent(ctx, linux.IN_ACCESS, 0, PathEvent)
+	}
+	fsmetric.Reads.Increment()
+	fsmetric.FinishReadWait(fsmetric.ReadWait, start)
+	return n, err
+}
+
 // PWrite writes src to the file represented by fd, starting at the given
 // offset, and returns the number of bytes written. PWrite is permitted to
 // return partial writes with a nil error.
@@ -719,6 +769,68 @@ func (fd *FileDescription) Write(ctx context.Context, src usermem.IOSequence, op
 	return n, err
 }
 
+// FileRangeCopier is an optional interface implemented by FileDescriptionImpls
+// that can copy data into their file from another file more cheaply than by
+// reading and writing it, as for copy_file_range(2).
+type FileRangeCopier interface {
+	// CopyFileRangeFrom copies up to count bytes from src, starting at
+	// srcOffset, into the file starting at dstOffset, and returns the number
+	// of bytes copied. Neither file's offset is used or changed. Fewer than
+	// count bytes are copied only if src ends before srcOffset+count or an
+	// error occurs.
+	//
+	// If the copy can not be done more cheaply than by reading and writing
+	// (e.g. because src is not supported by the implementation),
+	// CopyFileRangeFrom returns (0, nil), and the caller should fall back to
+	// copying.
+	CopyFileRangeFrom(ctx context.Context, src *FileDescription, srcOffset, dstOffset, count int64) (int64, error)
+}
+
+// CopyFileRangeFrom calls FileRangeCopier.CopyFileRangeFrom on fd's
+// implementation. If the implementation does not support FileRangeCopier,
+// CopyFileRangeFrom returns (0, nil).
+//
+// Preconditions: src and fd are regular files; src is readable and fd is
+// writable.
+func (fd *FileDescription) CopyFileRangeFrom(ctx context.Context, src *FileDescription, srcOffset, dstOffset, count int64) (int64, error) {
+	rc, ok := fd.impl.(FileRangeCopier)
+	if !ok {
+		return 0, nil
+	}
+	start := fsmetric.StartReadWait()
+	n, err := rc.CopyFileRangeFrom(ctx, src, srcOffset, dstOffset, count)
+	if n > 0 {
+		src.Dentry().InotifyWithParent(ctx, linux.IN_ACCESS, 0, PathEvent)
+		fd.Dentry().InotifyWithParent(ctx, linux.IN_MODIFY, 0, PathEvent)
+	}
+	fsmetric.Reads.Increment()
+	fsmetric.FinishReadWait(fsmetric.ReadWait, start)
+	return n, err
+}
+
+// Fadviser is an optional interface implemented by FileDescriptionImpls that
+// act on access pattern advice, as for posix_fadvise(2) and readahead(2).
+type Fadviser interface {
+	// Fadvise applies advice, one of linux.POSIX_FADV_*, to the given range of
+	// the file. If length is 0, the range extends to the end of the file.
+	// Advice about the access pattern (POSIX_FADV_NORMAL, POSIX_FADV_RANDOM
+	// and POSIX_FADV_SEQUENTIAL) applies to the whole file description.
+	//
+	// Preconditions: offset >= 0 and length >= 0.
+	Fadvise(ctx context.Context, offset, length int64, advice int32) error
+}
+
+// Fadvise calls Fadviser.Fadvise on fd's implementation. If the
+// implementation does not support Fadviser, Fadvise ignores the advice and
+// returns nil.
+func (fd *FileDescription) Fadvise(ctx context.Context, offset, length int64, advice int32) error {
+	fa, ok := fd.impl.(Fadviser)
+	if !ok {
+		return nil
+	}
+	return fa.Fadvise(ctx, offset, length, advice)
+}
+
 // IterDirents invokes cb on each entry in the directory represented by fd. If
 // IterDirents has been called since the last call to Seek, it continues
 // iteration from the end of the last call.
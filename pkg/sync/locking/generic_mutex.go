@@ -55,6 +55,27 @@ func (m *Mutex) NestedLock(i lockNameIndex) {
 	m.mu.Lock()
 }
 
+// TryLock tries to lock m and reports whether it succeeded.
+// +checklocksignore
+func (m *Mutex) TryLock() bool {
+	if !m.mu.TryLock() {
+		return false
+	}
+	locking.AddGLock(genericMarkIndex, -1)
+	return true
+}
+
+// NestedTryLock tries to lock m knowing that another lock of the same type is
+// held, and reports whether it succeeded.
+// +checklocksignore
+func (m *Mutex) NestedTryLock(i lockNameIndex) bool {
+	if !m.mu.TryLock() {
+		return false
+	}
+	locking.AddGLock(genericMarkIndex, int(i))
+	return true
+}
+
 // Unlock unlocks m.
 // +checklocksignore
 func (m *Mutex) Unlock() {
@@ -230,6 +230,10 @@ type SocketOptions struct {
 	// passing is enabled for IPv6.
 	ipv6RecvErrEnabled atomicbitops.Uint32
 
+	// zeroCopyEnabled determines whether MSG_ZEROCOPY sends are enabled
+	// (SO_ZEROCOPY).
+	zeroCopyEnabled atomicbitops.Uint32
+
 	// errQueue is the per-socket error queue. It is protected by errQueueMu.
 	errQueueMu sync.Mutex `state:"nosave"`
 	errQueue   sockErrorList
@@ -517,6 +521,16 @@ func (so *SocketOptions) SetIPv6RecvError(v bool) {
 	}
 }
 
+// GetZeroCopy gets value for SO_ZEROCOPY option.
+func (so *SocketOptions) GetZeroCopy() bool {
+	return so.zeroCopyEnabled.Load() != 0
+}
+
+// SetZeroCopy sets value for SO_ZEROCOPY option.
+func (so *SocketOptions) SetZeroCopy(v bool) {
+	storeAtomicBool(&so.zeroCopyEnabled, v)
+}
+
 // GetLastError gets value for SO_ERROR option.
 func (so *SocketOptions) GetLastError() Error {
 	return so.handler.LastError()
@@ -572,6 +586,10 @@ const (
 
 	// SockExtErrorOriginICMP6 indicates an IPv6 ICMP error.
 	SockExtErrorOriginICMP6
+
+	// SockExtErrorOriginZeroCopy indicates a MSG_ZEROCOPY completion
+	// notification.
+	SockExtErrorOriginZeroCopy
 )
 
 // IsICMPErr indicates if the error originated from an ICMP error.
@@ -592,6 +610,9 @@ type SockErrorCause interface {
 
 	// Info is any extra information about the error.
 	Info() uint32
+
+	// Data is any origin specific data about the error.
+	Data() uint32
 }
 
 // LocalSockError is a socket error that originated from the local host.
@@ -621,6 +642,55 @@ func (l *LocalSockError) Info() uint32 {
 	return l.info
 }
 
+// Data implements SockErrorCause.
+func (*LocalSockError) Data() uint32 {
+	return 0
+}
+
+// ZeroCopySockError is a MSG_ZEROCOPY completion notification. It reports
+// that the application buffers passed to the sends numbered [Lo, Hi] are no
+// longer referenced by the stack.
+//
+// +stateify savable
+type ZeroCopySockError struct {
+	// Lo and Hi are the first and last send numbers covered, inclusive.
+	Lo uint32
+	Hi uint32
+
+	// Copied is true if the data was copied rather than referenced.
+	Copied bool
+}
+
+// Origin implements SockErrorCause.
+func (*ZeroCopySockError) Origin() SockErrOrigin {
+	return SockExtErrorOriginZeroCopy
+}
+
+// Type implements SockErrorCause.
+func (*ZeroCopySockError) Type() uint8 {
+	return 0
+}
+
+// Code implements SockErrorCause.
+//
+// This is analogous to SO_EE_CODE_ZEROCOPY_COPIED.
+func (z *ZeroCopySockError) Code() uint8 {
+	if z.Copied {
+		return 1
+	}
+	return 0
+}
+
+// Info implements SockErrorCause.
+func (z *ZeroCopySockError) Info() uint32 {
+	return z.Lo
+}
+
+// Data implements SockErrorCause.
+func (z *ZeroCopySockError) Data() uint32 {
+	return z.Hi
+}
+
 // SockError represents a queue entry in the per-socket error queue.
 //
 // +stateify savable
@@ -690,6 +760,26 @@ func (so *SocketOptions) QueueLocalErr(err Error, net NetworkProtocolNumber, inf
 	})
 }
 
+// QueueZeroCopyErr queues a MSG_ZEROCOPY completion notification for the
+// sends numbered [lo, hi]. If the notification at the back of the queue ends
+// at lo-1 and agrees on copied, it is extended instead.
+//
+// This is analogous to net/core/skbuff.c:__msg_zerocopy_callback().
+func (so *SocketOptions) QueueZeroCopyErr(net NetworkProtocolNumber, lo, hi uint32, copied bool) {
+	so.errQueueMu.Lock()
+	defer so.errQueueMu.Unlock()
+	if last := so.errQueue.Back(); last != nil {
+		if z, ok := last.Cause.(*ZeroCopySockError); ok && z.Copied == copied && z.Hi+1 == lo {
+			z.Hi = hi
+			return
+		}
+	}
+	so.errQueue.PushBack(&SockError{
+		Cause:    &ZeroCopySockError{Lo: lo, Hi: hi, Copied: copied},
+		NetProto: net,
+	})
+}
+
 // GetBindToDevice gets value for SO_BINDTODEVICE option.
 func (so *SocketOptions) GetBindToDevice() int32 {
 	return so.bindToDevice.Load()
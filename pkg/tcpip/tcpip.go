@@ -42,6 +42,7 @@ import (
 	"time"
 
 	"gvisor.dev/gvisor/pkg/atomicbitops"
+	"gvisor.dev/gvisor/pkg/buffer"
 	"gvisor.dev/gvisor/pkg/rand"
 	"gvisor.dev/gvisor/pkg/sync"
 	"gvisor.dev/gvisor/pkg/waiter"
@@ -558,6 +559,17 @@ type Payloader interface {
 	Len() int
 }
 
+// BufferPayloader is a Payloader whose data is already held in buffer views.
+// Endpoints that support it take the views instead of copying the data.
+type BufferPayloader interface {
+	Payloader
+
+	// TakeBuffer removes up to n bytes from the front of the unread portion
+	// of the Payloader and returns them. The caller owns the returned
+	// Buffer.
+	TakeBuffer(n int) buffer.Buffer
+}
+
 var _ Payloader = (*bytes.Buffer)(nil)
 var _ Payloader = (*bytes.Reader)(nil)
 
@@ -621,6 +633,13 @@ type SendableControlMessages struct {
 
 	// IPv6PacketInfo holds interface and address data on an incoming packet.
 	IPv6PacketInfo IPv6PacketInfo
+
+	// HasGSOSize indicates whether GSOSize is valid/set.
+	HasGSOSize bool
+
+	// GSOSize is the UDP segment size used to split the write into multiple
+	// datagrams. It overrides UDPSegmentOption.
+	GSOSize uint16
 }
 
 // ReceivableControlMessages contains socket control messages that can be
@@ -685,6 +704,13 @@ type ReceivableControlMessages struct {
 	// and port of the incoming packet.
 	OriginalDstAddress FullAddress
 
+	// HasGROSize indicates whether GROSize is valid/set.
+	HasGROSize bool
+
+	// GROSize is the size of each UDP datagram coalesced into the read data,
+	// except possibly the last one, which may be shorter.
+	GROSize uint16
+
 	// SockErr is the dequeued socket error on recvmsg(MSG_ERRQUEUE).
 	SockErr *SockError
 }
@@ -884,6 +910,29 @@ type EndpointWithPreflight interface {
 	Preflight(WriteOptions) Error
 }
 
+// EndpointWithBatchIO is the interface implemented by datagram endpoints that
+// can read or write several datagrams while acquiring their locks once per
+// batch rather than once per datagram.
+type EndpointWithBatchIO interface {
+	// ReadBatch reads up to len(dsts) datagrams, writing the i-th one to
+	// dsts[i] and its result to results[i]. It returns the number of
+	// datagrams read. If none could be read, it returns the error Read would
+	// have returned. If writing the i-th datagram to dsts[i] fails, that
+	// datagram is consumed, results[i] describes it, and the error is
+	// returned along with i. opts.Peek is not supported.
+	//
+	// Precondition: len(results) >= len(dsts).
+	ReadBatch(dsts []io.Writer, opts ReadOptions, results []ReadResult) (int, Error)
+
+	// WriteBatch writes each of ps as a separate datagram using the
+	// corresponding element of opts, and stores the number of bytes written
+	// for each in ns. It returns the number of datagrams written and, if
+	// fewer than len(ps) were written, the error that stopped it.
+	//
+	// Precondition: len(opts) >= len(ps) and len(ns) >= len(ps).
+	WriteBatch(ps []Payloader, opts []WriteOptions, ns []int64) (int, Error)
+}
+
 // LinkPacketInfo holds Link layer information for a received packet.
 //
 // +stateify savable
@@ -1012,6 +1061,16 @@ const (
 	// IPv6MulticastInterfaceOption is used to set/get the NIC used for
 	// IPv6 multicast Tx.
 	IPv6MulticastInterfaceOption
+
+	// UDPSegmentOption is used by SetSockOptInt/GetSockOptInt to set/get the
+	// segment size used to split large UDP writes into multiple datagrams, as
+	// specified using the UDP_SEGMENT option. Zero disables segmentation.
+	UDPSegmentOption
+
+	// UDPGROOption is used by SetSockOptInt/GetSockOptInt to enable or
+	// disable coalescing of received UDP datagrams, as specified using the
+	// UDP_GRO option.
+	UDPGROOption
 )
 
 const (
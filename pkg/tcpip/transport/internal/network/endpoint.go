@@ -307,6 +307,34 @@ func (c *WriteContext) TryNewPacketBufferFromPayloader(reserveHdrBytes int, payl
 	return c.newPacketBufferLocked(reserveHdrBytes, data, mark), nil
 }
 
+// TryNewPacketBuffers is like TryNewPacketBuffer, but splits data into packet
+// buffers of segmentSize bytes each, except possibly the last one which may be
+// shorter. The send buffer is only checked once, so either all of the packet
+// buffers are returned or none are.
+//
+// It takes ownership of data.
+func (c *WriteContext) TryNewPacketBuffers(reserveHdrBytes int, data buffer.Buffer, segmentSize int) []*stack.PacketBuffer {
+	e := c.e
+
+	e.sendBufferSizeInUseMu.Lock()
+	defer e.sendBufferSizeInUseMu.Unlock()
+
+	if !e.hasSendSpaceRLocked() {
+		data.Release()
+		return nil
+	}
+
+	mark := e.ops.GetMark()
+	pkts := make([]*stack.PacketBuffer, 0, (int(data.Size())+segmentSize-1)/segmentSize)
+	for data.Size() > int64(segmentSize) {
+		segment := data.Clone()
+		segment.Truncate(int64(segmentSize))
+		data.TrimFront(int64(segmentSize))
+		pkts = append(pkts, c.newPacketBufferLocked(reserveHdrBytes, segment, mark))
+	}
+	return append(pkts, c.newPacketBufferLocked(reserveHdrBytes, data, mark))
+}
+
 // +checklocks:c.e.sendBufferSizeInUseMu
 func (c *WriteContext) newPacketBufferLocked(reserveHdrBytes int, data buffer.Buffer, mark uint32) *stack.PacketBuffer {
 	e := c.e
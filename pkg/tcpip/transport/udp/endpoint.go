@@ -21,6 +21,7 @@ import (
 	"math"
 	"time"
 
+	"gvisor.dev/gvisor/pkg/buffer"
 	"gvisor.dev/gvisor/pkg/sync"
 	"gvisor.dev/gvisor/pkg/tcpip"
 	"gvisor.dev/gvisor/pkg/tcpip/checksum"
@@ -75,6 +76,10 @@ type endpoint struct {
 	rcvBufSize int
 	rcvClosed  bool
 
+	// groEnabled is true if datagrams of the same flow are coalesced when
+	// read, as specified using the UDP_GRO option.
+	groEnabled bool
+
 	lastErrorMu sync.Mutex `state:"nosave"`
 	lastError   tcpip.Error
 
@@ -103,8 +108,20 @@ type endpoint struct {
 
 	localPort  uint16
 	remotePort uint16
+
+	// gsoSize is the size of the datagrams that writes are split into, as
+	// specified using the UDP_SEGMENT option. Zero disables segmentation.
+	gsoSize uint16
 }
 
+// maxGSOSegments is the maximum number of datagrams a single write may be
+// split into. It is the same as Linux's UDP_MAX_SEGMENTS.
+const maxGSOSegments = 1 << 7
+
+// maxGROSegments is the maximum number of datagrams that are coalesced into a
+// single read. It is the same as Linux's UDP_GRO_CNT_MAX.
+const maxGROSegments = 64
+
 func newEndpoint(s *stack.Stack, netProto tcpip.NetworkProtocolNumber, waiterQueue *waiter.Queue) *endpoint {
 	e := &endpoint{
 		stack:       s,
@@ -232,13 +249,148 @@ func (e *endpoint) Read(dst io.Writer, opts tcpip.ReadOptions) (tcpip.ReadResult
 	}
 
 	p := e.rcvList.Front()
+	segs := e.groSegmentsLocked(p)
 	if !opts.Peek {
-		e.rcvList.Remove(p)
-		defer p.pkt.DecRef()
-		e.rcvBufSize -= p.pkt.Data().Size()
+		e.dequeueLocked(p, segs)
+		defer releasePackets(p, segs)
+	}
+	e.rcvMu.Unlock()
+
+	return e.readPacket(p, segs, dst, opts)
+}
+
+// ReadBatch implements tcpip.EndpointWithBatchIO.ReadBatch.
+func (e *endpoint) ReadBatch(dsts []io.Writer, opts tcpip.ReadOptions, results []tcpip.ReadResult) (int, tcpip.Error) {
+	if opts.Peek {
+		return 0, &tcpip.ErrNotSupported{}
+	}
+	if err := e.LastError(); err != nil {
+		return 0, err
+	}
+
+	// Dequeue as many datagrams as are requested and available with a single
+	// acquisition of e.rcvMu.
+	e.rcvMu.Lock()
+	if e.rcvList.Empty() {
+		var err tcpip.Error = &tcpip.ErrWouldBlock{}
+		if e.rcvClosed {
+			e.stats.ReadErrors.ReadClosed.Increment()
+			err = &tcpip.ErrClosedForReceive{}
+		}
+		e.rcvMu.Unlock()
+		return 0, err
+	}
+	n := min(len(dsts), e.rcvList.Len())
+	pkts := make([]*udpPacket, 0, n)
+	segs := make([][]*udpPacket, 0, n)
+	for len(pkts) < len(dsts) && !e.rcvList.Empty() {
+		p := e.rcvList.Front()
+		s := e.groSegmentsLocked(p)
+		e.dequeueLocked(p, s)
+		pkts = append(pkts, p)
+		segs = append(segs, s)
 	}
 	e.rcvMu.Unlock()
 
+	for i, p := range pkts {
+		res, err := e.readPacket(p, segs[i], dsts[i], opts)
+		releasePackets(p, segs[i])
+		results[i] = res
+		if err != nil {
+			// As with Read, the datagram that couldn't be written is
+			// dropped. Return the rest to the receive queue.
+			e.requeue(pkts[i+1:], segs[i+1:])
+			return i, err
+		}
+	}
+	return len(pkts), nil
+}
+
+// groSegmentsLocked returns the datagrams following p in the receive queue
+// that are coalesced with it into a single read when UDP_GRO is enabled.
+//
+// As in Linux's net/ipv4/udp_offload.c:udp_gro_receive_segment(), datagrams
+// are coalesced if they belong to the same flow and are no larger than p,
+// and coalescing stops after a shorter datagram.
+//
+// +checklocks:e.rcvMu
+func (e *endpoint) groSegmentsLocked(p *udpPacket) []*udpPacket {
+	if !e.groEnabled {
+		return nil
+	}
+	size := p.pkt.Data().Size()
+	if size == 0 {
+		return nil
+	}
+	var segs []*udpPacket
+	total := size
+	for q := p.Next(); q != nil && len(segs)+1 < maxGROSegments; q = q.Next() {
+		qSize := q.pkt.Data().Size()
+		if qSize == 0 || qSize > size || total+qSize > header.UDPMaximumPacketSize-header.UDPMinimumSize || !sameFlow(p, q) {
+			break
+		}
+		segs = append(segs, q)
+		total += qSize
+		if qSize < size {
+			break
+		}
+	}
+	return segs
+}
+
+// sameFlow returns true if datagrams p and q can be coalesced.
+func sameFlow(p, q *udpPacket) bool {
+	return p.netProto == q.netProto &&
+		p.senderAddress == q.senderAddress &&
+		p.destinationAddress == q.destinationAddress &&
+		p.packetInfo == q.packetInfo &&
+		p.tosOrTClass == q.tosOrTClass &&
+		p.ttlOrHopLimit == q.ttlOrHopLimit
+}
+
+// dequeueLocked removes p, which is at the front of the receive queue, and
+// the datagrams coalesced with it from the receive queue.
+//
+// +checklocks:e.rcvMu
+func (e *endpoint) dequeueLocked(p *udpPacket, segs []*udpPacket) {
+	e.rcvList.Remove(p)
+	e.rcvBufSize -= p.pkt.Data().Size()
+	for _, s := range segs {
+		e.rcvList.Remove(s)
+		e.rcvBufSize -= s.pkt.Data().Size()
+	}
+}
+
+// releasePackets releases p and the datagrams coalesced with it.
+func releasePackets(p *udpPacket, segs []*udpPacket) {
+	p.pkt.DecRef()
+	for _, s := range segs {
+		s.pkt.DecRef()
+	}
+}
+
+// requeue returns pkts and the datagrams coalesced with each of them in segs,
+// which were the datagrams at the front of the receive queue, to the front of
+// the receive queue.
+func (e *endpoint) requeue(pkts []*udpPacket, segs [][]*udpPacket) {
+	if len(pkts) == 0 {
+		return
+	}
+	e.rcvMu.Lock()
+	defer e.rcvMu.Unlock()
+	for i := len(pkts) - 1; i >= 0; i-- {
+		for j := len(segs[i]) - 1; j >= 0; j-- {
+			e.rcvList.PushFront(segs[i][j])
+			e.rcvBufSize += segs[i][j].pkt.Data().Size()
+		}
+		e.rcvList.PushFront(pkts[i])
+		e.rcvBufSize += pkts[i].pkt.Data().Size()
+	}
+}
+
+// readPacket writes the datagram p to dst, followed by the datagrams in segs
+// that were coalesced with it.
+func (e *endpoint) readPacket(p *udpPacket, segs []*udpPacket, dst io.Writer, opts tcpip.ReadOptions) (tcpip.ReadResult, tcpip.Error) {
 	// Control Messages
 	// TODO(https://gvisor.dev/issue/7012): Share control message code with other
 	// network endpoints.
@@ -286,9 +438,18 @@ func (e *endpoint) Read(dst io.Writer, opts tcpip.ReadOptions) (tcpip.ReadResult
 		cm.OriginalDstAddress = p.destinationAddress
 	}
 
+	total := p.pkt.Data().Size()
+	if len(segs) > 0 {
+		cm.HasGROSize = true
+		cm.GROSize = uint16(total)
+		for _, s := range segs {
+			total += s.pkt.Data().Size()
+		}
+	}
+
 	// Read Result
 	res := tcpip.ReadResult{
-		Total:           p.pkt.Data().Size(),
+		Total:           total,
 		ControlMessages: cm,
 	}
 	if opts.NeedRemoteAddr {
@@ -300,6 +461,14 @@ func (e *endpoint) Read(dst io.Writer, opts tcpip.ReadOptions) (tcpip.ReadResult
 	}
 
 	n, err := p.pkt.Data().ReadTo(dst, opts.Peek)
+	for _, s := range segs {
+		if err != nil {
+			break
+		}
+		var m int
+		m, err = s.pkt.Data().ReadTo(dst, opts.Peek)
+		n += m
+	}
 	if n == 0 && err != nil {
 		return res, &tcpip.ErrBadBuffer{}
 	}
@@ -348,6 +517,8 @@ func (e *endpoint) prepareForWriteInner(to *tcpip.FullAddress) (retry bool, err
 
 var _ tcpip.EndpointWithPreflight = (*endpoint)(nil)
 
+var _ tcpip.EndpointWithBatchIO = (*endpoint)(nil)
+
 // Validates the passed WriteOptions and prepares the endpoint for writes
 // using those options. If the endpoint is unbound and the `To` address
 // is specified, binds the endpoint to that address.
@@ -364,6 +535,73 @@ func (e *endpoint) Preflight(opts tcpip.WriteOptions) tcpip.Error {
 // if the data cannot be written.
 func (e *endpoint) Write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, tcpip.Error) {
 	n, err := e.write(p, opts)
+	e.updateWriteStats(err)
+	return n, err
+}
+
+// WriteBatch implements tcpip.EndpointWithBatchIO.WriteBatch.
+func (e *endpoint) WriteBatch(ps []tcpip.Payloader, opts []tcpip.WriteOptions, ns []int64) (int, tcpip.Error) {
+	if err := e.LastError(); err != nil {
+		e.updateWriteStats(err)
+		return 0, err
+	}
+
+	// Prepare every datagram with a single acquisition of e.mu. Consecutive
+	// datagrams with the same destination and options share a write context.
+	// As in write, e.mu is not held while sending.
+	infos := make([]udpPacketInfo, 0, len(ps))
+	var err tcpip.Error
+	e.mu.RLock()
+	for i, p := range ps {
+		if i > 0 && sameWriteTarget(&opts[i-1], &opts[i]) && p.Len() <= header.UDPMaximumPacketSize {
+			info := infos[i-1]
+			info.shared = true
+			infos = append(infos, info)
+			continue
+		}
+		info, perr := e.prepareForWriteRLocked(p, opts[i])
+		if perr != nil {
+			err = perr
+			break
+		}
+		infos = append(infos, info)
+	}
+	e.mu.RUnlock()
+	defer func() {
+		for i := range infos {
+			if !infos[i].shared {
+				infos[i].ctx.Release()
+			}
+		}
+	}()
+
+	for i := range infos {
+		n, werr := e.writePacket(&infos[i], ps[i])
+		e.updateWriteStats(werr)
+		if werr != nil {
+			return i, werr
+		}
+		ns[i] = n
+	}
+	if err != nil {
+		e.updateWriteStats(err)
+	}
+	return len(infos), err
+}
+
+// sameWriteTarget returns true if datagrams written with options a and b can
+// share a write context.
+func sameWriteTarget(a, b *tcpip.WriteOptions) bool {
+	if (a.To == nil) != (b.To == nil) || (a.To != nil && *a.To != *b.To) {
+		return false
+	}
+	ac, bc := *a, *b
+	ac.To, bc.To = nil, nil
+	return ac == bc
+}
+
+// updateWriteStats records the outcome of writing a datagram.
+func (e *endpoint) updateWriteStats(err tcpip.Error) {
 	switch err.(type) {
 	case nil:
 		e.stats.PacketsSent.Increment()
@@ -380,13 +618,16 @@ func (e *endpoint) Write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, tcp
 		// For all other errors when writing to the network layer.
 		e.stats.SendErrors.SendToNetworkFailed.Increment()
 	}
-	return n, err
 }
 
 func (e *endpoint) prepareForWrite(p tcpip.Payloader, opts tcpip.WriteOptions) (udpPacketInfo, tcpip.Error) {
 	e.mu.RLock()
 	defer e.mu.RUnlock()
+	return e.prepareForWriteRLocked(p, opts)
+}
 
+// +checklocksread:e.mu
+func (e *endpoint) prepareForWriteRLocked(p tcpip.Payloader, opts tcpip.WriteOptions) (udpPacketInfo, tcpip.Error) {
 	// Prepare for write.
 	for {
 		retry, err := e.prepareForWriteInner(opts.To)
@@ -436,10 +677,16 @@ func (e *endpoint) prepareForWrite(p tcpip.Payloader, opts tcpip.WriteOptions) (
 		return udpPacketInfo{}, &tcpip.ErrMessageTooLong{}
 	}
 
+	gsoSize := e.gsoSize
+	if opts.ControlMessages.HasGSOSize {
+		gsoSize = opts.ControlMessages.GSOSize
+	}
+
 	return udpPacketInfo{
 		ctx:        ctx,
 		localPort:  e.localPort,
 		remotePort: dst.Port,
+		gsoSize:    gsoSize,
 	}, nil
 }
 
@@ -465,6 +712,15 @@ func (e *endpoint) write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, tcp
 	}
 	defer udpInfo.ctx.Release()
 
+	return e.writePacket(&udpInfo, p)
+}
+
+// writePacket sends the contents of p as a datagram using udpInfo.
+func (e *endpoint) writePacket(udpInfo *udpPacketInfo, p tcpip.Payloader) (int64, tcpip.Error) {
+	if gsoSize := int(udpInfo.gsoSize); gsoSize > 0 && p.Len() > gsoSize {
+		return e.writeSegments(udpInfo, p, gsoSize)
+	}
+
 	dataSz := p.Len()
 	pktInfo := udpInfo.ctx.PacketInfo()
 	pkt, err := udpInfo.ctx.TryNewPacketBufferFromPayloader(header.UDPMinimumSize+int(pktInfo.MaxHeaderLength), p)
@@ -473,6 +729,54 @@ func (e *endpoint) write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, tcp
 	}
 	defer pkt.DecRef()
 
+	if err := e.sendPacket(udpInfo, &pktInfo, pkt); err != nil {
+		return 0, err
+	}
+	return int64(dataSz), nil
+}
+
+// writeSegments sends the contents of p as datagrams of gsoSize bytes each,
+// except possibly the last one which may be shorter.
+//
+// This implements UDP_SEGMENT. No netstack link endpoint segments UDP, so the
+// payload is read once and split into views of it, saving the per-datagram
+// cost of the system call and of preparing the write.
+//
+// The checks are the same as in Linux's net/ipv4/udp.c:udp_send_skb().
+func (e *endpoint) writeSegments(udpInfo *udpPacketInfo, p tcpip.Payloader, gsoSize int) (int64, tcpip.Error) {
+	dataSz := p.Len()
+	pktInfo := udpInfo.ctx.PacketInfo()
+	if header.UDPMinimumSize+gsoSize > int(udpInfo.ctx.MTU()) ||
+		dataSz > gsoSize*maxGSOSegments ||
+		(e.ops.GetNoChecksum() && pktInfo.NetProto == header.IPv4ProtocolNumber) {
+		return 0, &tcpip.ErrInvalidOptionValue{}
+	}
+
+	var data buffer.Buffer
+	if _, err := data.WriteFromReader(p, int64(dataSz)); err != nil {
+		data.Release()
+		return 0, &tcpip.ErrBadBuffer{}
+	}
+	pkts := udpInfo.ctx.TryNewPacketBuffers(header.UDPMinimumSize+int(pktInfo.MaxHeaderLength), data, gsoSize)
+	if pkts == nil {
+		return 0, &tcpip.ErrWouldBlock{}
+	}
+	defer func() {
+		for _, pkt := range pkts {
+			pkt.DecRef()
+		}
+	}()
+
+	for _, pkt := range pkts {
+		if err := e.sendPacket(udpInfo, &pktInfo, pkt); err != nil {
+			return 0, err
+		}
+	}
+	return int64(dataSz), nil
+}
+
+// sendPacket adds the UDP header to pkt and sends it using udpInfo.
+func (e *endpoint) sendPacket(udpInfo *udpPacketInfo, pktInfo *network.WritePacketInfo, pkt *stack.PacketBuffer) tcpip.Error {
 	// Initialize the UDP header.
 	udp := header.UDP(pkt.TransportHeader().Push(header.UDPMinimumSize))
 	pkt.TransportProtocolNumber = ProtocolNumber
@@ -520,12 +824,12 @@ func (e *endpoint) write(p tcpip.Payloader, opts tcpip.WriteOptions) (int64, tcp
 	}
 	if err := udpInfo.ctx.WritePacket(pkt, false /* headerIncluded */); err != nil {
 		e.stack.Stats().UDP.PacketSendErrors.Increment()
-		return 0, err
+		return err
 	}
 
 	// Track count of packets sent.
 	e.stack.Stats().UDP.PacketsSent.Increment()
-	return int64(dataSz), nil
+	return nil
 }
 
 // OnReuseAddressSet implements tcpip.SocketOptionsHandler.
@@ -544,7 +848,25 @@ func (e *endpoint) OnReusePortSet(v bool) {
 
 // SetSockOptInt implements tcpip.Endpoint.
 func (e *endpoint) SetSockOptInt(opt tcpip.SockOptInt, v int) tcpip.Error {
-	return e.net.SetSockOptInt(opt, v)
+	switch opt {
+	case tcpip.UDPSegmentOption:
+		if v < 0 || v > math.MaxUint16 {
+			return &tcpip.ErrInvalidOptionValue{}
+		}
+		e.mu.Lock()
+		e.gsoSize = uint16(v)
+		e.mu.Unlock()
+		return nil
+
+	case tcpip.UDPGROOption:
+		e.rcvMu.Lock()
+		e.groEnabled = v != 0
+		e.rcvMu.Unlock()
+		return nil
+
+	default:
+		return e.net.SetSockOptInt(opt, v)
+	}
 }
 
 var _ tcpip.SocketOptionsHandler = (*endpoint)(nil)
@@ -568,6 +890,24 @@ func (e *endpoint) GetSockOptInt(opt tcpip.SockOptInt) (int, tcpip.Error) {
 		if !e.rcvList.Empty() {
 			p := e.rcvList.Front()
 			v = p.pkt.Data().Size()
+			for _, s := range e.groSegmentsLocked(p) {
+				v += s.pkt.Data().Size()
+			}
+		}
+		e.rcvMu.Unlock()
+		return v, nil
+
+	case tcpip.UDPSegmentOption:
+		e.mu.RLock()
+		v := int(e.gsoSize)
+		e.mu.RUnlock()
+		return v, nil
+
+	case tcpip.UDPGROOption:
+		v := 0
+		e.rcvMu.Lock()
+		if e.groEnabled {
+			v = 1
 		}
 		e.rcvMu.Unlock()
 		return v, nil
@@ -587,6 +927,14 @@ type udpPacketInfo struct {
 	ctx        network.WriteContext
 	localPort  uint16
 	remotePort uint16
+
+	// shared is true if ctx is owned by another udpPacketInfo; see
+	// endpoint.WriteBatch.
+	shared bool
+
+	// gsoSize is the size of the datagrams the write is split into. Zero
+	// disables segmentation.
+	gsoSize uint16
 }
 
 // Disconnect implements tcpip.Endpoint.
@@ -1126,6 +1126,230 @@ func TestWriteIncrementsPacketsSent(t *testing.T) {
 	}
 }
 
+func TestReadBatch(t *testing.T) {
+	c := context.New(t, []stack.TransportProtocolFactory{udp.NewProtocol, icmp.NewProtocol6, icmp.NewProtocol4})
+	defer c.Cleanup()
+
+	c.CreateEndpointForFlow(context.UnicastV4, udp.ProtocolNumber)
+	if err := c.EP.Bind(tcpip.FullAddress{Port: context.StackPort}); err != nil {
+		c.T.Fatalf("Bind failed: %s", err)
+	}
+
+	var payloads [][]byte
+	for i := 0; i < 3; i++ {
+		payload := newRandomPayload(arbitraryPayloadSize + i)
+		payloads = append(payloads, payload)
+		c.InjectPacket(header.IPv4ProtocolNumber, context.BuildUDPPacket(payload, context.UnicastV4, context.Incoming, testTOS, testTTL, false))
+	}
+
+	ep := c.EP.(tcpip.EndpointWithBatchIO)
+	for _, batch := range [][][]byte{payloads[:2], payloads[2:]} {
+		bufs := make([]bytes.Buffer, 4)
+		dsts := make([]io.Writer, len(bufs))
+		for i := range bufs {
+			dsts[i] = &bufs[i]
+		}
+		results := make([]tcpip.ReadResult, len(dsts))
+		// Ask for at most as many datagrams as are expected from the first
+		// batch, and for more than are left in the second.
+		if len(batch) == 2 {
+			dsts = dsts[:2]
+		}
+		n, err := ep.ReadBatch(dsts, tcpip.ReadOptions{NeedRemoteAddr: true}, results)
+		if err != nil {
+			t.Fatalf("ReadBatch failed: %s", err)
+		}
+		if n != len(batch) {
+			t.Fatalf("got ReadBatch(...) = %d, want = %d", n, len(batch))
+		}
+		for i, want := range batch {
+			if got := bufs[i].Bytes(); !bytes.Equal(got, want) {
+				t.Errorf("datagram %d: got payload %x, want %x", i, got, want)
+			}
+			if got, want := results[i].Count, len(want); got != want {
+				t.Errorf("datagram %d: got Count = %d, want = %d", i, got, want)
+			}
+			if got, want := results[i].RemoteAddr.Port, context.TestPort; got != want {
+				t.Errorf("datagram %d: got RemoteAddr.Port = %d, want = %d", i, got, want)
+			}
+		}
+	}
+
+	var buf bytes.Buffer
+	_, err := ep.ReadBatch([]io.Writer{&buf}, tcpip.ReadOptions{}, make([]tcpip.ReadResult, 1))
+	if _, ok := err.(*tcpip.ErrWouldBlock); !ok {
+		t.Fatalf("got ReadBatch(...) = %s, want = %s", err, &tcpip.ErrWouldBlock{})
+	}
+}
+
+func TestWriteBatch(t *testing.T) {
+	c := context.New(t, []stack.TransportProtocolFactory{udp.NewProtocol, icmp.NewProtocol6, icmp.NewProtocol4})
+	defer c.Cleanup()
+
+	c.CreateEndpointForFlow(context.UnicastV4, udp.ProtocolNumber)
+
+	h := context.UnicastV4.MakeHeader4Tuple(context.Outgoing)
+	to := tcpip.FullAddress{Addr: h.Dst.Addr, Port: h.Dst.Port}
+	var (
+		payloads [][]byte
+		ps       []tcpip.Payloader
+		opts     []tcpip.WriteOptions
+	)
+	for i := 0; i < 3; i++ {
+		payload := newRandomPayload(arbitraryPayloadSize + i)
+		payloads = append(payloads, payload)
+		ps = append(ps, bytes.NewReader(payload))
+		opts = append(opts, tcpip.WriteOptions{To: &to})
+	}
+	// Change the options of the last datagram so that it can't share a write
+	// context with the others.
+	opts[2].ControlMessages = tcpip.SendableControlMessages{HasTTL: true, TTL: testTTL}
+
+	ns := make([]int64, len(ps))
+	n, err := c.EP.(tcpip.EndpointWithBatchIO).WriteBatch(ps, opts, ns)
+	if err != nil {
+		t.Fatalf("WriteBatch failed: %s", err)
+	}
+	if n != len(ps) {
+		t.Fatalf("got WriteBatch(...) = %d, want = %d", n, len(ps))
+	}
+	if got, want := c.Stack.Stats().UDP.PacketsSent.Value(), uint64(len(ps)); got != want {
+		t.Errorf("got PacketsSent = %d, want = %d", got, want)
+	}
+
+	for i, payload := range payloads {
+		if got, want := ns[i], int64(len(payload)); got != want {
+			t.Errorf("datagram %d: got %d bytes written, want %d", i, got, want)
+		}
+		p := c.LinkEP.Read()
+		if p == nil {
+			t.Fatalf("datagram %d wasn't written out", i)
+		}
+		v := p.ToView()
+		p.DecRef()
+		udpH := header.UDP(header.IPv4(v.AsSlice()).Payload())
+		if !bytes.Equal(udpH.Payload(), payload) {
+			t.Errorf("datagram %d: got payload %x, want %x", i, udpH.Payload(), payload)
+		}
+		v.Release()
+	}
+}
+
+func TestSegmentationOffload(t *testing.T) {
+	const gsoSize = 100
+	for _, useCmsg := range []bool{false, true} {
+		t.Run(fmt.Sprintf("useCmsg:%t", useCmsg), func(t *testing.T) {
+			c := context.New(t, []stack.TransportProtocolFactory{udp.NewProtocol, icmp.NewProtocol6, icmp.NewProtocol4})
+			defer c.Cleanup()
+
+			c.CreateEndpointForFlow(context.UnicastV4, udp.ProtocolNumber)
+
+			h := context.UnicastV4.MakeHeader4Tuple(context.Outgoing)
+			opts := tcpip.WriteOptions{To: &tcpip.FullAddress{Addr: h.Dst.Addr, Port: h.Dst.Port}}
+			if useCmsg {
+				opts.ControlMessages = tcpip.SendableControlMessages{HasGSOSize: true, GSOSize: gsoSize}
+			} else if err := c.EP.SetSockOptInt(tcpip.UDPSegmentOption, gsoSize); err != nil {
+				t.Fatalf("SetSockOptInt(UDPSegmentOption, %d) failed: %s", gsoSize, err)
+			}
+
+			payload := newRandomPayload(2*gsoSize + gsoSize/2)
+			n, err := c.EP.Write(bytes.NewReader(payload), opts)
+			if err != nil {
+				t.Fatalf("Write failed: %s", err)
+			}
+			if got, want := n, int64(len(payload)); got != want {
+				t.Fatalf("got Write(...) = %d, want = %d", got, want)
+			}
+
+			for i := 0; i*gsoSize < len(payload); i++ {
+				want := payload[i*gsoSize : min((i+1)*gsoSize, len(payload))]
+				p := c.LinkEP.Read()
+				if p == nil {
+					t.Fatalf("segment %d wasn't written out", i)
+				}
+				v := p.ToView()
+				p.DecRef()
+				checker.IPv4(t, v, checker.UDP(checker.DstPort(h.Dst.Port)))
+				udpH := header.UDP(header.IPv4(v.AsSlice()).Payload())
+				if !bytes.Equal(udpH.Payload(), want) {
+					t.Errorf("segment %d: got payload %x, want %x", i, udpH.Payload(), want)
+				}
+				v.Release()
+			}
+			if p := c.LinkEP.Read(); p != nil {
+				p.DecRef()
+				t.Fatalf("got unexpected extra segment")
+			}
+		})
+	}
+}
+
+func TestSegmentationOffloadTooManySegments(t *testing.T) {
+	c := context.New(t, []stack.TransportProtocolFactory{udp.NewProtocol, icmp.NewProtocol6, icmp.NewProtocol4})
+	defer c.Cleanup()
+
+	c.CreateEndpointForFlow(context.UnicastV4, udp.ProtocolNumber)
+
+	h := context.UnicastV4.MakeHeader4Tuple(context.Outgoing)
+	opts := tcpip.WriteOptions{
+		To:              &tcpip.FullAddress{Addr: h.Dst.Addr, Port: h.Dst.Port},
+		ControlMessages: tcpip.SendableControlMessages{HasGSOSize: true, GSOSize: 1},
+	}
+	// Linux splits a write into at most 128 segments.
+	_, err := c.EP.Write(bytes.NewReader(newRandomPayload(129)), opts)
+	if _, ok := err.(*tcpip.ErrInvalidOptionValue); !ok {
+		t.Fatalf("got Write(...) = %s, want = %s", err, &tcpip.ErrInvalidOptionValue{})
+	}
+}
+
+func TestReceiveCoalescing(t *testing.T) {
+	c := context.New(t, []stack.TransportProtocolFactory{udp.NewProtocol, icmp.NewProtocol6, icmp.NewProtocol4})
+	defer c.Cleanup()
+
+	c.CreateEndpointForFlow(context.UnicastV4, udp.ProtocolNumber)
+	if err := c.EP.Bind(tcpip.FullAddress{Port: context.StackPort}); err != nil {
+		c.T.Fatalf("Bind failed: %s", err)
+	}
+	if err := c.EP.SetSockOptInt(tcpip.UDPGROOption, 1); err != nil {
+		c.T.Fatalf("SetSockOptInt(UDPGROOption, 1) failed: %s", err)
+	}
+
+	// The first three datagrams are coalesced, as the third is shorter than
+	// the first. The fourth is read on its own.
+	var payloads [][]byte
+	for _, size := range []int{100, 100, 60, 100} {
+		payload := newRandomPayload(size)
+		payloads = append(payloads, payload)
+		c.InjectPacket(header.IPv4ProtocolNumber, context.BuildUDPPacket(payload, context.UnicastV4, context.Incoming, testTOS, testTTL, false))
+	}
+
+	for _, test := range []struct {
+		want       []byte
+		hasGROSize bool
+	}{
+		{want: bytes.Join(payloads[:3], nil), hasGROSize: true},
+		{want: payloads[3]},
+	} {
+		var buf bytes.Buffer
+		res, err := c.EP.Read(&buf, tcpip.ReadOptions{})
+		if err != nil {
+			t.Fatalf("Read failed: %s", err)
+		}
+		if !bytes.Equal(buf.Bytes(), test.want) {
+			t.Errorf("got payload %x, want %x", buf.Bytes(), test.want)
+		}
+		if got, want := res.Total, len(test.want); got != want {
+			t.Errorf("got Total = %d, want = %d", got, want)
+		}
+		if got := res.ControlMessages.HasGROSize; got != test.hasGROSize {
+			t.Errorf("got HasGROSize = %t, want = %t", got, test.hasGROSize)
+		}
+		if test.hasGROSize && res.ControlMessages.GROSize != 100 {
+			t.Errorf("got GROSize = %d, want = 100", res.ControlMessages.GROSize)
+		}
+	}
+}
+
 func TestNoChecksum(t *testing.T) {
 	for _, writeOpSequence := range writeOpSequences {
 		for _, flow := range []context.TestFlow{context.UnicastV4, context.UnicastV6} {
@@ -131,6 +131,20 @@ type EventListener interface {
 	NotifyEvent(mask EventMask)
 }
 
+// ExclusiveEventListener is an EventListener that can be registered with a
+// Queue as an exclusive waiter, using Entry.InitExclusive.
+type ExclusiveEventListener interface {
+	EventListener
+
+	// NotifyEventExclusive is called instead of NotifyEvent for exclusive
+	// entries. It returns true if the notification was consumed, in which
+	// case no further exclusive entries are notified of the same event.
+	//
+	// NotifyEventExclusive is subject to the same restrictions as
+	// NotifyEvent.
+	NotifyEventExclusive(mask EventMask) bool
+}
+
 // Entry represents a waiter that can be add to the a wait queue. It can
 // only be in one queue at a time, and is added "intrusively" to the queue with
 // no extra memory allocations.
@@ -144,6 +158,11 @@ type Entry struct {
 
 	// mask should be immutable once queued.
 	mask EventMask
+
+	// exclusive is true if eventListener is an ExclusiveEventListener that
+	// should be notified as an exclusive waiter. exclusive is immutable once
+	// queued.
+	exclusive bool
 }
 
 // Init initializes the Entry.
@@ -152,6 +171,19 @@ type Entry struct {
 func (e *Entry) Init(eventListener EventListener, mask EventMask) {
 	e.eventListener = eventListener
 	e.mask = mask
+	e.exclusive = false
+}
+
+// InitExclusive initializes the Entry as an exclusive waiter. When a Queue is
+// notified, all of its non-exclusive entries are notified, but exclusive
+// entries are only notified until one of them consumes the notification. This
+// is analogous to Linux's WQ_FLAG_EXCLUSIVE.
+//
+// This must only be called when unregistered.
+func (e *Entry) InitExclusive(eventListener ExclusiveEventListener, mask EventMask) {
+	e.eventListener = eventListener
+	e.mask = mask
+	e.exclusive = true
 }
 
 // SetQueuedMask changes the entry mask.
@@ -244,14 +276,22 @@ func (q *Queue) EventUnregister(e *Entry) {
 }
 
 // Notify notifies all waiters in the queue whose masks have at least one bit
-// in common with the notification mask.
+// in common with the notification mask, except for exclusive waiters after
+// the first that consumes the notification.
 func (q *Queue) Notify(mask EventMask) {
 	q.mu.RLock()
+	consumed := false
 	for e := q.list.Front(); e != nil; e = e.Next() {
 		m := mask & e.mask
 		if m == 0 {
 			continue
 		}
+		if e.exclusive {
+			if !consumed {
+				consumed = e.eventListener.(ExclusiveEventListener).NotifyEventExclusive(m)
+			}
+			continue
+		}
 		e.eventListener.NotifyEvent(m) // Skip intermediate call.
 	}
 	q.mu.RUnlock()
@@ -180,3 +180,62 @@ func TestConcurrentNotification(t *testing.T) {
 		t.Errorf("cnt = %d, want %d", cnt.Load(), concurrency*waiterCount)
 	}
 }
+
+type exclusiveListener struct {
+	cnt     int
+	consume bool
+}
+
+func (l *exclusiveListener) NotifyEvent(EventMask) {
+	panic("NotifyEvent called on exclusive entry")
+}
+
+func (l *exclusiveListener) NotifyEventExclusive(EventMask) bool {
+	l.cnt++
+	return l.consume
+}
+
+func TestExclusive(t *testing.T) {
+	var q Queue
+	var cnt int
+	e := NewFunctionEntry(EventIn, func(EventMask) { cnt++ })
+	q.EventRegister(&e)
+	defer q.EventUnregister(&e)
+
+	var ls [3]exclusiveListener
+	var es [3]Entry
+	for i := range es {
+		es[i].InitExclusive(&ls[i], EventIn)
+		q.EventRegister(&es[i])
+		defer q.EventUnregister(&es[i])
+	}
+
+	// The first exclusive entry doesn't consume the notification, so it
+	// should be passed on to the second, but not the third.
+	ls[1].consume = true
+	q.Notify(EventIn)
+	if cnt != 1 {
+		t.Errorf("non-exclusive entry notified %d times, want 1", cnt)
+	}
+	for i, want := range []int{1, 1, 0} {
+		if ls[i].cnt != want {
+			t.Errorf("exclusive entry %d notified %d times, want %d", i, ls[i].cnt, want)
+		}
+	}
+
+	// If no exclusive entry consumes the notification, all of them should be
+	// notified.
+	ls[1].consume = false
+	q.Notify(EventIn)
+	for i, want := range []int{2, 2, 1} {
+		if ls[i].cnt != want {
+			t.Errorf("exclusive entry %d notified %d times, want %d", i, ls[i].cnt, want)
+		}
+	}
+
+	// Exclusive entries are subject to masks like other entries.
+	q.Notify(EventOut)
+	if cnt != 2 || ls[0].cnt != 2 {
+		t.Errorf("entries notified with disjoint mask")
+	}
+}
@@ -195,6 +195,7 @@ func (i *connectionImpl) SupportedMessages() []lisafs.MID {
 		lisafs.Accept,
 		lisafs.ConnectWithCreds,
 		lisafs.RenameAt2,
+		lisafs.WalkChildren,
 	}
 }
 
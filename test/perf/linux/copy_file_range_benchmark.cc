@@ -0,0 +1,134 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of the buffer used to copy files with read(2) and write(2).
+constexpr int kBufSize = 64 << 10;
+
+// How the benchmark copies files.
+enum CopyMethod {
+  kReadWrite = 0,
+  kCopyFileRange = 1,
+};
+
+// Where the benchmark's files are.
+enum FileKind {
+  // Files in the test's temporary directory.
+  kTmpdirFile = 0,
+  // memfds, which are tmpfs files.
+  kMemfd = 1,
+};
+
+FileDescriptor NewFile(FileKind kind, TempPath* path) {
+  if (kind == kMemfd) {
+    int fd = syscall(SYS_memfd_create, "copy_file_range_benchmark", 0);
+    TEST_PCHECK(fd >= 0);
+    return FileDescriptor(fd);
+  }
+  *path = TempPath::CreateFile().ValueOrDie();
+  return Open(path->path(), O_RDWR).ValueOrDie();
+}
+
+// CopyReadWrite copies size bytes from the start of in to the start of out
+// with pread(2) and pwrite(2).
+void CopyReadWrite(int in, int out, int64_t size, std::vector<char>& buf) {
+  for (int64_t off = 0; off < size;) {
+    const int64_t len = std::min<int64_t>(buf.size(), size - off);
+    TEST_PCHECK(pread(in, buf.data(), len, off) == len);
+    TEST_PCHECK(pwrite(out, buf.data(), len, off) == len);
+    off += len;
+  }
+}
+
+// CopyWithCopyFileRange copies size bytes from the start of in to the start
+// of out with copy_file_range(2).
+void CopyWithCopyFileRange(int in, int out, int64_t size) {
+  loff_t in_off = 0;
+  loff_t out_off = 0;
+  while (in_off < size) {
+    const ssize_t n = syscall(SYS_copy_file_range, in, &in_off, out, &out_off,
+                              size - in_off, 0);
+    TEST_PCHECK(n > 0);
+  }
+}
+
+// BM_CopyFile measures copying a whole file over an existing file of the same
+// size.
+//
+// state.range(0) is the file size.
+// state.range(1) is a CopyMethod.
+// state.range(2) is a FileKind.
+void BM_CopyFile(benchmark::State& state) {
+  const int64_t size = state.range(0);
+  const CopyMethod method = static_cast<CopyMethod>(state.range(1));
+  const FileKind kind = static_cast<FileKind>(state.range(2));
+
+  TempPath in_path, out_path;
+  FileDescriptor in = NewFile(kind, &in_path);
+  FileDescriptor out = NewFile(kind, &out_path);
+
+  std::vector<char> buf(kBufSize);
+  RandomizeBuffer(buf.data(), buf.size());
+  for (int64_t off = 0; off < size; off += buf.size()) {
+    const int64_t len = std::min<int64_t>(buf.size(), size - off);
+    TEST_PCHECK(pwrite(in.get(), buf.data(), len, off) == len);
+    TEST_PCHECK(pwrite(out.get(), buf.data(), len, off) == len);
+  }
+
+  for (auto _ : state) {
+    if (method == kCopyFileRange) {
+      CopyWithCopyFileRange(in.get(), out.get(), size);
+    } else {
+      CopyReadWrite(in.get(), out.get(), size, buf);
+    }
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+void CopyArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t size : {4 << 10, 64 << 10, 1 << 20, 16 << 20}) {
+    for (int method : {kReadWrite, kCopyFileRange}) {
+      for (int kind : {kTmpdirFile, kMemfd}) {
+        benchmark->Args({size, method, kind});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_CopyFile)->Apply(&CopyArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
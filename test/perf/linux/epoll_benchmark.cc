@@ -12,9 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <netinet/in.h>
+#include <sched.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -25,6 +33,7 @@
 #include "test/util/file_descriptor.h"
 #include "test/util/posix_error.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -79,6 +88,268 @@ void BM_EpollAllEvents(benchmark::State& state) {
 
 BENCHMARK(BM_EpollAllEvents)->Range(2, 1024);
 
+// InterestSet is an epoll instance with a large set of registered eventfds.
+class InterestSet {
+ public:
+  // Registers n eventfds with events. It returns false if RLIMIT_NOFILE
+  // can't be raised high enough for n eventfds.
+  bool Init(int n, uint32_t events) {
+    // Leave room for the epoll fd, stdio, etc.
+    const rlim_t want = static_cast<rlim_t>(n) + 64;
+    struct rlimit rlim;
+    TEST_PCHECK(getrlimit(RLIMIT_NOFILE, &rlim) == 0);
+    if (rlim.rlim_cur < want) {
+      // Raising the hard limit requires CAP_SYS_RESOURCE.
+      struct rlimit raised = {want, std::max(want, rlim.rlim_max)};
+      if (setrlimit(RLIMIT_NOFILE, &raised) < 0) {
+        return false;
+      }
+    }
+
+    const int epoll_raw = epoll_create1(0);
+    TEST_PCHECK(epoll_raw >= 0);
+    epollfd_ = FileDescriptor(epoll_raw);
+    eventfds_.reserve(n);
+    for (int i = 0; i < n; i++) {
+      const int efd = eventfd(0, EFD_NONBLOCK);
+      TEST_PCHECK(efd >= 0);
+      eventfds_.emplace_back(efd);
+      struct epoll_event event = {};
+      event.events = events;
+      event.data.u64 = i;
+      TEST_PCHECK(epoll_ctl(epollfd_.get(), EPOLL_CTL_ADD, efd, &event) == 0);
+    }
+    return true;
+  }
+
+  int epollfd() const { return epollfd_.get(); }
+  int fd(int i) const { return eventfds_[i].get(); }
+
+ private:
+  FileDescriptor epollfd_;
+  std::vector<FileDescriptor> eventfds_;
+};
+
+// BM_EpollSparse measures the cost of epoll_wait() on a large, mostly idle
+// interest set in which only a few files become ready at a time, as for a
+// proxy with many idle connections.
+//
+// state.range(0) is the number of registered eventfds.
+// state.range(1) is the number of eventfds that become ready per iteration.
+// state.range(2) is 1 for edge-triggered (EPOLLET) registration, and 0 for
+// level-triggered.
+void BM_EpollSparse(benchmark::State& state) {
+  const int interest = state.range(0);
+  const int active = state.range(1);
+  const bool edge = state.range(2);
+
+  InterestSet set;
+  if (!set.Init(interest,
+                EPOLLIN | (edge ? static_cast<uint32_t>(EPOLLET) : 0u))) {
+    state.SkipWithError("RLIMIT_NOFILE is too low");
+    return;
+  }
+
+  // Spread active files across the interest set, and rotate them between
+  // iterations.
+  const int stride = interest / active;
+  std::vector<struct epoll_event> result(active);
+  int offset = 0;
+  for (auto _ : state) {
+    constexpr uint64_t kVal = 1;
+    for (int i = 0; i < active; i++) {
+      TEST_PCHECK(WriteFd(set.fd(i * stride + offset), &kVal,
+                          sizeof(kVal)) == sizeof(kVal));
+    }
+    int ready = 0;
+    while (ready < active) {
+      const int n = epoll_wait(set.epollfd(), result.data(), active, -1);
+      TEST_PCHECK(n > 0);
+      for (int i = 0; i < n; i++) {
+        uint64_t val;
+        TEST_PCHECK(ReadFd(set.fd(result[i].data.u64), &val,
+                           sizeof(val)) == sizeof(val));
+      }
+      ready += n;
+    }
+    offset = (offset + 1) % stride;
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(active) * state.iterations());
+}
+
+void SparseArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t interest : {1 << 10, 10 << 10, 100 << 10, 1 << 20}) {
+    for (int active : {1, 16}) {
+      for (int edge : {0, 1}) {
+        benchmark->Args({interest, active, edge});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_EpollSparse)->Apply(&SparseArgs);
+
+// BM_EpollModChurn measures EPOLL_CTL_MOD on a large interest set, as done
+// by servers that toggle interest in each connection's writability, or that
+// rearm EPOLLONESHOT registrations after every event.
+//
+// state.range(0) is the number of registered eventfds.
+// state.range(1) is 1 if each EPOLL_CTL_MOD rearms an EPOLLONESHOT
+// registration with an unchanged event mask, and 0 if each EPOLL_CTL_MOD
+// changes the event mask.
+void BM_EpollModChurn(benchmark::State& state) {
+  const int interest = state.range(0);
+  const bool oneshot = state.range(1);
+
+  const uint32_t base =
+      EPOLLIN | (oneshot ? static_cast<uint32_t>(EPOLLONESHOT) : 0u);
+  InterestSet set;
+  if (!set.Init(interest, base)) {
+    state.SkipWithError("RLIMIT_NOFILE is too low");
+    return;
+  }
+
+  // EPOLLPRI is never raised by eventfds, so toggling it doesn't make
+  // any file ready.
+  uint32_t toggle = oneshot ? 0u : static_cast<uint32_t>(EPOLLPRI);
+  int i = 0;
+  for (auto _ : state) {
+    struct epoll_event event = {};
+    event.events = base | toggle;
+    event.data.u64 = i;
+    TEST_PCHECK(epoll_ctl(set.epollfd(), EPOLL_CTL_MOD, set.fd(i),
+                          &event) == 0);
+    if (++i == interest) {
+      i = 0;
+      if (!oneshot) {
+        toggle ^= EPOLLPRI;
+      }
+    }
+  }
+}
+
+void ModChurnArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t interest : {1 << 10, 10 << 10, 100 << 10, 1 << 20}) {
+    for (int oneshot : {0, 1}) {
+      benchmark->Args({interest, oneshot});
+    }
+  }
+}
+
+BENCHMARK(BM_EpollModChurn)->Apply(&ModChurnArgs);
+
+// BM_EpollThunderingHerd measures the cost of accepting connections on a
+// single listening socket that is watched by many threads, each blocked in
+// epoll_wait() on its own epoll instance, as is done by multi-process and
+// multi-threaded servers. Without EPOLLEXCLUSIVE, every connection wakes
+// every thread.
+//
+// Counters, per connection:
+// - wakeups: epoll_wait() calls that returned the listening socket.
+// - failed_accepts: wakeups that lost the race to accept the connection.
+// - cpu_us: CPU time consumed by the whole process, including wakeups that
+//   were absorbed by the kernel because the socket was no longer readable
+//   once the woken thread ran.
+//
+// state.range(0) is the number of threads.
+// state.range(1) is 1 if the listening socket is registered with
+// EPOLLEXCLUSIVE.
+void BM_EpollThunderingHerd(benchmark::State& state) {
+  const int threads = state.range(0);
+  const bool exclusive = state.range(1);
+
+  const int listen_raw = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  TEST_PCHECK(listen_raw >= 0);
+  FileDescriptor listen_fd(listen_raw);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrlen = sizeof(addr);
+  TEST_PCHECK(bind(listen_fd.get(), reinterpret_cast<struct sockaddr*>(&addr),
+                   addrlen) == 0);
+  TEST_PCHECK(getsockname(listen_fd.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr),
+                          &addrlen) == 0);
+  TEST_PCHECK(listen(listen_fd.get(), SOMAXCONN) == 0);
+
+  std::atomic<bool> done(false);
+  std::atomic<int64_t> wakeups(0);
+  std::atomic<int64_t> failed_accepts(0);
+  std::atomic<int64_t> accepted(0);
+  std::vector<std::unique_ptr<ScopedThread>> workers;
+  for (int i = 0; i < threads; i++) {
+    const int epoll_raw = epoll_create1(0);
+    TEST_PCHECK(epoll_raw >= 0);
+    auto epollfd = std::make_shared<FileDescriptor>(epoll_raw);
+    struct epoll_event event = {};
+    event.events =
+        EPOLLIN | (exclusive ? static_cast<uint32_t>(EPOLLEXCLUSIVE) : 0u);
+    TEST_PCHECK(epoll_ctl(epollfd->get(), EPOLL_CTL_ADD, listen_fd.get(),
+                          &event) == 0);
+    workers.push_back(std::make_unique<ScopedThread>([&, epollfd] {
+      struct epoll_event result;
+      while (!done.load(std::memory_order_relaxed)) {
+        // Time out periodically to check done.
+        const int n = epoll_wait(epollfd->get(), &result, 1, 100);
+        if (n <= 0) {
+          continue;
+        }
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        const int fd = accept4(listen_fd.get(), nullptr, nullptr, 0);
+        if (fd < 0) {
+          failed_accepts.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        close(fd);
+        accepted.fetch_add(1, std::memory_order_release);
+      }
+    }));
+  }
+
+  struct rusage start;
+  TEST_PCHECK(getrusage(RUSAGE_SELF, &start) == 0);
+  int64_t connections = 0;
+  for (auto _ : state) {
+    const int client = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_PCHECK(client >= 0);
+    TEST_PCHECK(RetryEINTR(connect)(client,
+                                    reinterpret_cast<struct sockaddr*>(&addr),
+                                    addrlen) == 0);
+    connections++;
+    while (accepted.load(std::memory_order_acquire) < connections) {
+      sched_yield();
+    }
+    close(client);
+  }
+
+  struct rusage end;
+  TEST_PCHECK(getrusage(RUSAGE_SELF, &end) == 0);
+  done.store(true);
+  workers.clear();
+
+  auto cpu_us = [](const struct rusage& ru) {
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e6 +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+  };
+  state.counters["wakeups"] = benchmark::Counter(
+      static_cast<double>(wakeups.load()) / connections);
+  state.counters["failed_accepts"] = benchmark::Counter(
+      static_cast<double>(failed_accepts.load()) / connections);
+  state.counters["cpu_us"] =
+      benchmark::Counter((cpu_us(end) - cpu_us(start)) / connections);
+}
+
+void ThunderingHerdArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int threads : {1, 4, 16, 64}) {
+    for (int exclusive : {0, 1}) {
+      benchmark->Args({threads, exclusive});
+    }
+  }
+}
+
+BENCHMARK(BM_EpollThunderingHerd)->Apply(&ThunderingHerdArgs)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
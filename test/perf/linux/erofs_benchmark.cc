@@ -0,0 +1,174 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr int64_t kErofsSuperMagic = 0xE0F5E1E2;
+
+// The benchmarks read this benchmark's own executable, and start a trivial
+// dynamically-linked program, both of which come from the root filesystem.
+constexpr char kReadPath[] = "/proc/self/exe";
+constexpr char kStartupPath[] = "/bin/true";
+
+// SkipIfNotErofs skips the benchmark and returns true if path is not on an
+// EROFS filesystem.
+bool SkipIfNotErofs(benchmark::State& state, const char* path) {
+  struct statfs st;
+  if (statfs(path, &st) < 0) {
+    state.SkipWithError("statfs failed");
+    return true;
+  }
+  if (static_cast<uint32_t>(st.f_type) != kErofsSuperMagic) {
+    state.SkipWithError("not running on an EROFS filesystem");
+    return true;
+  }
+  return false;
+}
+
+// ResidentBytes returns the resident set size of the calling process.
+int64_t ResidentBytes() {
+  const std::string statm =
+      TEST_CHECK_NO_ERRNO_AND_VALUE(GetContents("/proc/self/statm"));
+  int64_t size, resident;
+  TEST_CHECK(sscanf(statm.c_str(), "%ld %ld", &size, &resident) == 2);
+  return resident * getpagesize();
+}
+
+void BM_RandRead(benchmark::State& state) {
+  if (SkipIfNotErofs(state, kReadPath)) {
+    return;
+  }
+  const int size = state.range(0);
+
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(kReadPath, O_RDONLY));
+  struct stat st;
+  TEST_PCHECK(fstat(fd.get(), &st) == 0);
+  if (st.st_size <= size) {
+    state.SkipWithError("file is smaller than read size");
+    return;
+  }
+  std::vector<char> buf(size);
+
+  unsigned int seed = 1;
+  for (auto _ : state) {
+    TEST_CHECK(PreadFd(fd.get(), buf.data(), buf.size(),
+                       rand_r(&seed) % (st.st_size - size)) == size);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_RandRead)->Range(1, 1 << 20)->UseRealTime();
+
+// BM_MmapRead maps the whole file privately, as the dynamic linker does for
+// libraries, reads one byte from each page, and unmaps it. The rss counter is
+// the average increase in the process' resident set size while the file is
+// mapped.
+void BM_MmapRead(benchmark::State& state) {
+  if (SkipIfNotErofs(state, kReadPath)) {
+    return;
+  }
+
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(kReadPath, O_RDONLY));
+  struct stat st;
+  TEST_PCHECK(fstat(fd.get(), &st) == 0);
+  const int64_t page_size = getpagesize();
+
+  int64_t rss = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const int64_t before = ResidentBytes();
+    state.ResumeTiming();
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    TEST_PCHECK(addr != MAP_FAILED);
+    const volatile char* p = static_cast<const volatile char*>(addr);
+    for (int64_t off = 0; off < st.st_size; off += page_size) {
+      benchmark::DoNotOptimize(p[off]);
+    }
+
+    state.PauseTiming();
+    rss += ResidentBytes() - before;
+    state.ResumeTiming();
+
+    TEST_PCHECK(munmap(addr, st.st_size) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(st.st_size) *
+                          static_cast<int64_t>(state.iterations()));
+  state.counters["rss"] = benchmark::Counter(
+      rss, benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024);
+}
+
+BENCHMARK(BM_MmapRead)->UseRealTime();
+
+// BM_Startup runs a trivial dynamically-linked program to completion. The
+// maxrss counter is the program's average peak resident set size.
+void BM_Startup(benchmark::State& state) {
+  if (SkipIfNotErofs(state, kStartupPath)) {
+    return;
+  }
+
+  int64_t maxrss = 0;
+  for (auto _ : state) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      char* const argv[] = {const_cast<char*>(kStartupPath), nullptr};
+      execv(kStartupPath, argv);
+      _exit(1);
+    }
+    TEST_PCHECK(pid > 0);
+    int status;
+    struct rusage ru;
+    TEST_PCHECK(wait4(pid, &status, 0, &ru) == pid);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    maxrss += ru.ru_maxrss;
+  }
+
+  // ru_maxrss is in kilobytes.
+  state.counters["maxrss"] =
+      benchmark::Counter(maxrss * 1024, benchmark::Counter::kAvgIterations,
+                         benchmark::Counter::kIs1024);
+}
+
+BENCHMARK(BM_Startup)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
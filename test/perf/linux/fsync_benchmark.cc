@@ -0,0 +1,101 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// BM_WriteFsync appends records to a file and syncs it after each batch of
+// records, as done by write-ahead logs when committing transactions.
+//
+// state.range(0) is the size of each record. state.range(1) is the number of
+// records written between calls to fsync(2).
+void BM_WriteFsync(benchmark::State& state) {
+  const int size = state.range(0);
+  const int writes = state.range(1);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_WRONLY | O_APPEND));
+  std::vector<char> buf(size);
+  RandomizeBuffer(buf.data(), buf.size());
+
+  for (auto _ : state) {
+    for (int i = 0; i < writes; i++) {
+      TEST_CHECK(WriteFd(fd.get(), buf.data(), buf.size()) == size);
+    }
+    TEST_PCHECK(fsync(fd.get()) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(size) * writes *
+                          static_cast<int64_t>(state.iterations()));
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WriteFsync)
+    ->ArgsProduct({{64, 4096}, {1, 16, 256}})
+    ->UseRealTime();
+
+// SharedFile returns the path of a file shared by all threads running
+// BM_ConcurrentFsync.
+const std::string& SharedFile() {
+  static const TempPath* const file =
+      new TempPath(TEST_CHECK_NO_ERRNO_AND_VALUE(TempPath::CreateFile()));
+  return file->path();
+}
+
+// Each thread in BM_ConcurrentFsync appends a record to the same file through
+// its own file descriptor and syncs it, as done by databases that commit
+// transactions from many threads.
+void BM_ConcurrentFsync(benchmark::State& state) {
+  constexpr int kSize = 4096;
+
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(SharedFile(), O_WRONLY | O_APPEND));
+  std::vector<char> buf(kSize);
+  RandomizeBuffer(buf.data(), buf.size());
+
+  for (auto _ : state) {
+    TEST_CHECK(WriteFd(fd.get(), buf.data(), buf.size()) == kSize);
+    TEST_PCHECK(fdatasync(fd.get()) == 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConcurrentFsync)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->Threads(64)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -13,20 +13,29 @@
 // limitations under the License.
 
 #include <linux/futex.h>
+#include <sys/mman.h>
 
 #include <atomic>
 #include <cerrno>
+#include <climits>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
+#include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "benchmark/benchmark.h"
 #include "test/util/logging.h"
+#include "test/util/test_util.h"
 #include "test/util/thread_util.h"
 
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449
+#endif
+
 namespace gvisor {
 namespace testing {
 
@@ -57,6 +66,22 @@ inline int FutexWake(std::atomic<int32_t>* v, int32_t count) {
   return syscall(SYS_futex, v, FUTEX_WAKE_PRIVATE, count);
 }
 
+// FutexWaitvEntry is struct futex_waitv, which older headers don't define.
+struct FutexWaitvEntry {
+  uint64_t val;
+  uint64_t uaddr;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+// FUTEX2_SIZE_U32 | FUTEX2_PRIVATE.
+constexpr uint32_t kFutexWaitvPrivateU32 = 0x02 | FUTEX_PRIVATE_FLAG;
+
+inline int FutexWaitv(std::vector<FutexWaitvEntry>& waiters) {
+  return syscall(SYS_futex_waitv, waiters.data(), waiters.size(), 0, nullptr,
+                 0);
+}
+
 // This just uses FUTEX_WAKE on an address with nothing waiting, very simple.
 void BM_FutexWakeNop(benchmark::State& state) {
   std::atomic<int32_t> v(0);
@@ -192,6 +217,364 @@ BENCHMARK(BM_FutexRoundtripDelayed)
     ->Arg(50)
     ->Arg(100);
 
+// Values of the futexes waited on by BM_FutexWaitvRoundtrip and
+// BM_FutexThreadsRoundtrip.
+constexpr int32_t kFutexIdle = 0;
+constexpr int32_t kFutexWake = 1;
+constexpr int32_t kFutexStop = 2;
+
+// Each iteration of BM_FutexWaitvRoundtrip wakes one of N futexes on which a
+// single thread is waiting with futex_waitv, and waits for that thread to
+// acknowledge the wakeup. Compare to BM_FutexThreadsRoundtrip, which waits on
+// the same futexes with N threads instead.
+//
+// state.range(0) is the number of futexes.
+void BM_FutexWaitvRoundtrip(benchmark::State& state) {
+  const int n = state.range(0);
+  std::vector<std::atomic<int32_t>> v(n);
+  std::atomic<int32_t> ack(0);
+
+  std::vector<FutexWaitvEntry> waiters(n);
+  for (int i = 0; i < n; i++) {
+    waiters[i].val = kFutexIdle;
+    waiters[i].uaddr = reinterpret_cast<uintptr_t>(&v[i]);
+    waiters[i].flags = kFutexWaitvPrivateU32;
+  }
+  // An empty futex_waitv fails with EINVAL if the syscall is supported.
+  if (syscall(SYS_futex_waitv, nullptr, 0, 0, nullptr, 0) < 0 &&
+      errno == ENOSYS) {
+    state.SkipWithError("futex_waitv not supported");
+    return;
+  }
+
+  ScopedThread t([&] {
+    while (true) {
+      int idx = FutexWaitv(waiters);
+      if (idx < 0) {
+        // EAGAIN: a futex was changed before we started waiting.
+        TEST_PCHECK(errno == EAGAIN || errno == EINTR);
+        for (idx = 0; idx < n; idx++) {
+          if (v[idx].load(std::memory_order_acquire) != kFutexIdle) {
+            break;
+          }
+        }
+        if (idx == n) {
+          continue;
+        }
+      }
+      const int32_t val = v[idx].load(std::memory_order_acquire);
+      if (val == kFutexStop) {
+        return;
+      }
+      if (val == kFutexIdle) {
+        continue;
+      }
+      v[idx].store(kFutexIdle, std::memory_order_relaxed);
+      ack.store(1, std::memory_order_release);
+      FutexWake(&ack, 1);
+    }
+  });
+
+  int i = 0;
+  for (auto _ : state) {
+    v[i].store(kFutexWake, std::memory_order_release);
+    FutexWake(&v[i], 1);
+    while (ack.load(std::memory_order_acquire) == 0) {
+      FutexWait(&ack, 0);
+    }
+    ack.store(0, std::memory_order_relaxed);
+    i = (i + 1) % n;
+  }
+
+  v[0].store(kFutexStop, std::memory_order_release);
+  FutexWake(&v[0], 1);
+}
+
+BENCHMARK(BM_FutexWaitvRoundtrip)
+    ->MinTime(5)
+    ->UseRealTime()
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128);
+
+// BM_FutexThreadsRoundtrip is equivalent to BM_FutexWaitvRoundtrip, but waits
+// on each futex with a separate thread using FUTEX_WAIT, as done by runtimes
+// that lack futex_waitv.
+//
+// state.range(0) is the number of futexes and threads.
+void BM_FutexThreadsRoundtrip(benchmark::State& state) {
+  const int n = state.range(0);
+  std::vector<std::atomic<int32_t>> v(n);
+  std::atomic<int32_t> ack(0);
+
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < n; i++) {
+    threads.push_back(std::make_unique<ScopedThread>([&, i] {
+      while (true) {
+        int32_t val;
+        while ((val = v[i].load(std::memory_order_acquire)) == kFutexIdle) {
+          FutexWait(&v[i], kFutexIdle);
+        }
+        if (val == kFutexStop) {
+          return;
+        }
+        v[i].store(kFutexIdle, std::memory_order_relaxed);
+        ack.store(1, std::memory_order_release);
+        FutexWake(&ack, 1);
+      }
+    }));
+  }
+
+  int i = 0;
+  for (auto _ : state) {
+    v[i].store(kFutexWake, std::memory_order_release);
+    FutexWake(&v[i], 1);
+    while (ack.load(std::memory_order_acquire) == 0) {
+      FutexWait(&ack, 0);
+    }
+    ack.store(0, std::memory_order_relaxed);
+    i = (i + 1) % n;
+  }
+
+  for (i = 0; i < n; i++) {
+    v[i].store(kFutexStop, std::memory_order_release);
+    FutexWake(&v[i], 1);
+  }
+}
+
+BENCHMARK(BM_FutexThreadsRoundtrip)
+    ->MinTime(5)
+    ->UseRealTime()
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128);
+
+// PaddedFutex is a futex on its own cache line, so that benchmarks of
+// contention on distinct futexes don't also measure false sharing.
+struct alignas(64) PaddedFutex {
+  std::atomic<int32_t> v;
+};
+
+constexpr int kMaxContendedFutexes = 1024;
+
+PaddedFutex* MapContendedFutexes(bool shared) {
+  void* const p = mmap(nullptr, kMaxContendedFutexes * sizeof(PaddedFutex),
+                       PROT_READ | PROT_WRITE,
+                       (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_ANONYMOUS,
+                       -1, 0);
+  TEST_PCHECK(p != MAP_FAILED);
+  return static_cast<PaddedFutex*>(p);
+}
+
+// ContendedFutexes returns kMaxContendedFutexes zeroed futexes. If shared is
+// true, they are in shared memory, and should be used without
+// FUTEX_PRIVATE_FLAG.
+PaddedFutex* ContendedFutexes(bool shared) {
+  static PaddedFutex* const private_futexes = MapContendedFutexes(false);
+  static PaddedFutex* const shared_futexes = MapContendedFutexes(true);
+  return shared ? shared_futexes : private_futexes;
+}
+
+// FutexOp returns op, with FUTEX_PRIVATE_FLAG unless shared is true.
+int FutexOp(int op, bool shared) {
+  return shared ? op : op | FUTEX_PRIVATE_FLAG;
+}
+
+// Each thread in BM_FutexContendedWake repeatedly calls FUTEX_WAKE on one of
+// M futexes with no waiters, such that threads using distinct futexes only
+// contend on the sentry's futex hash table.
+//
+// state.range(0) is the number of futexes, M.
+// state.range(1) is 1 if the futexes are shared, and 0 if they are private.
+void BM_FutexContendedWake(benchmark::State& state) {
+  const int m = state.range(0);
+  const bool shared = state.range(1);
+  const int op = FutexOp(FUTEX_WAKE, shared);
+  PaddedFutex* const f =
+      &ContendedFutexes(shared)[state.thread_index() % m];
+
+  for (auto _ : state) {
+    TEST_PCHECK(syscall(SYS_futex, &f->v, op, 1) == 0);
+  }
+}
+
+// Each thread in BM_FutexContendedMutex repeatedly locks and unlocks one of M
+// futex-based mutexes, such that N threads contend for each mutex's futex if
+// M is 1, and for only the futex hash table if M >= N.
+//
+// The arguments are the same as for BM_FutexContendedWake.
+void BM_FutexContendedMutex(benchmark::State& state) {
+  const int m = state.range(0);
+  const bool shared = state.range(1);
+  const int wait_op = FutexOp(FUTEX_WAIT, shared);
+  const int wake_op = FutexOp(FUTEX_WAKE, shared);
+  std::atomic<int32_t>* const v =
+      &ContendedFutexes(shared)[state.thread_index() % m].v;
+
+  // This is the mutex from Drepper's "Futexes Are Tricky": 0 is unlocked, 1 is
+  // locked without waiters, and 2 is locked with possible waiters.
+  for (auto _ : state) {
+    int32_t c = 0;
+    if (!v->compare_exchange_strong(c, 1, std::memory_order_acquire)) {
+      if (c != 2) {
+        c = v->exchange(2, std::memory_order_acquire);
+      }
+      while (c != 0) {
+        syscall(SYS_futex, v, wait_op, 2, nullptr);
+        c = v->exchange(2, std::memory_order_acquire);
+      }
+    }
+    if (v->fetch_sub(1, std::memory_order_release) != 1) {
+      v->store(0, std::memory_order_release);
+      syscall(SYS_futex, v, wake_op, 1);
+    }
+  }
+}
+
+void ContendedArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t m : {1, 16, kMaxContendedFutexes}) {
+    for (int64_t shared : {0, 1}) {
+      benchmark->Args({m, shared});
+    }
+  }
+}
+
+BENCHMARK(BM_FutexContendedWake)
+    ->Apply(&ContendedArgs)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(64)
+    ->UseRealTime();
+
+BENCHMARK(BM_FutexContendedMutex)
+    ->Apply(&ContendedArgs)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(64)
+    ->UseRealTime();
+
+// BM_FutexCmpRequeue measures FUTEX_CMP_REQUEUE moving N blocked waiters
+// between two futexes, as done by pthread_cond_broadcast in older versions of
+// glibc. Each iteration requeues all waiters from one futex to the other, and
+// then back.
+//
+// state.range(0) is the number of waiters.
+// state.range(1) is 1 if the futexes are shared, and 0 if they are private.
+void BM_FutexCmpRequeue(benchmark::State& state) {
+  const int n = state.range(0);
+  const bool shared = state.range(1);
+  const int wait_op = FutexOp(FUTEX_WAIT, shared);
+  const int wake_op = FutexOp(FUTEX_WAKE, shared);
+  const int requeue_op = FutexOp(FUTEX_CMP_REQUEUE, shared);
+  std::atomic<int32_t>* const a = &ContendedFutexes(shared)[0].v;
+  std::atomic<int32_t>* const b = &ContendedFutexes(shared)[1].v;
+  std::atomic<bool> stop(false);
+
+  std::vector<std::unique_ptr<ScopedThread>> waiters;
+  for (int i = 0; i < n; i++) {
+    waiters.push_back(std::make_unique<ScopedThread>([&] {
+      while (!stop.load(std::memory_order_acquire)) {
+        syscall(SYS_futex, a, wait_op, 0, nullptr);
+      }
+    }));
+  }
+  // There is no portable way to tell when all waiters are blocked, since
+  // gVisor's FUTEX_CMP_REQUEUE returns only the number of woken waiters; give
+  // them plenty of time.
+  absl::SleepFor(absl::Milliseconds(100));
+
+  for (auto _ : state) {
+    TEST_PCHECK(syscall(SYS_futex, a, requeue_op, 0, INT_MAX, b, 0) >= 0);
+    TEST_PCHECK(syscall(SYS_futex, b, requeue_op, 0, INT_MAX, a, 0) >= 0);
+  }
+
+  // Change a so that waiters that haven't yet blocked don't.
+  stop.store(true, std::memory_order_release);
+  a->store(1, std::memory_order_release);
+  for (auto* f : {a, b}) {
+    TEST_PCHECK(syscall(SYS_futex, f, wake_op, INT_MAX) >= 0);
+  }
+  waiters.clear();
+  a->store(0, std::memory_order_relaxed);
+}
+
+void CmpRequeueArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t n : {1, 16, 256}) {
+    for (int64_t shared : {0, 1}) {
+      benchmark->Args({n, shared});
+    }
+  }
+}
+
+BENCHMARK(BM_FutexCmpRequeue)->Apply(&CmpRequeueArgs)->UseRealTime();
+
+// BM_FutexPIUncontended measures FUTEX_LOCK_PI and FUTEX_UNLOCK_PI on an
+// unowned futex. Userspace PI mutexes normally avoid these syscalls when
+// uncontended, but must make them when racing with another thread that has
+// just released the mutex.
+void BM_FutexPIUncontended(benchmark::State& state) {
+  std::atomic<int32_t> v(0);
+
+  for (auto _ : state) {
+    TEST_PCHECK(syscall(SYS_futex, &v, FUTEX_LOCK_PI_PRIVATE, 0, nullptr) ==
+                0);
+    TEST_PCHECK(syscall(SYS_futex, &v, FUTEX_UNLOCK_PI_PRIVATE) == 0);
+  }
+}
+
+BENCHMARK(BM_FutexPIUncontended)->MinTime(5);
+
+// PIMutex is a priority-inheritance mutex, as implemented by glibc for
+// PTHREAD_PRIO_INHERIT mutexes.
+class PIMutex {
+ public:
+  void Lock(int32_t tid) {
+    int32_t unowned = 0;
+    if (!v_.compare_exchange_strong(unowned, tid, std::memory_order_acquire)) {
+      TEST_PCHECK(RetryEINTR(syscall)(SYS_futex, &v_, FUTEX_LOCK_PI_PRIVATE, 0,
+                                      nullptr) == 0);
+    }
+  }
+
+  void Unlock(int32_t tid) {
+    int32_t owned = tid;
+    if (!v_.compare_exchange_strong(owned, 0, std::memory_order_release)) {
+      TEST_PCHECK(syscall(SYS_futex, &v_, FUTEX_UNLOCK_PI_PRIVATE) == 0);
+    }
+  }
+
+ private:
+  std::atomic<int32_t> v_{0};
+};
+
+// Each thread in BM_FutexPIMutex repeatedly locks a single PIMutex, holds it
+// for a critical section, and unlocks it. With 2 threads, this measures
+// ownership handoff between a pair of threads; with more threads, waiters
+// form a convoy behind the owner.
+//
+// state.range(0) is the length of the critical section in nanoseconds.
+void BM_FutexPIMutex(benchmark::State& state) {
+  static PIMutex mu;
+  const int64_t critical_section_ns = state.range(0);
+  const int32_t tid = syscall(SYS_gettid);
+
+  for (auto _ : state) {
+    mu.Lock(tid);
+    SpinNanos(critical_section_ns);
+    mu.Unlock(tid);
+  }
+}
+
+BENCHMARK(BM_FutexPIMutex)
+    ->Arg(0)
+    ->Arg(1000)
+    ->Threads(2)
+    ->Threads(8)
+    ->Threads(64)
+    ->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
@@ -12,10 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cstdint>
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
 #include "test/util/file_descriptor.h"
@@ -42,6 +46,15 @@ namespace {
 
 constexpr int kBufferSize = 65536;
 
+// New Linux dirent format.
+struct linux_dirent64 {
+  uint64_t d_ino;           // Inode number
+  int64_t d_off;            // Offset to next linux_dirent64
+  unsigned short d_reclen;  // NOLINT, Length of this linux_dirent64
+  unsigned char d_type;     // NOLINT, File type
+  char d_name[0];           // Filename (null-terminated)
+};
+
 PosixErrorOr<TempPath> CreateDirectory(int count,
                                        std::vector<std::string>* files) {
   ASSIGN_OR_RETURN_ERRNO(TempPath dir, TempPath::CreateDir());
@@ -56,7 +69,7 @@ PosixErrorOr<TempPath> CreateDirectory(int count,
     files->push_back(file);
   }
 
-  return std::move(dir);
+  return dir;
 }
 
 PosixError CleanupDirectory(const TempPath& dir,
@@ -145,6 +158,61 @@ void BM_GetdentsNewFD(benchmark::State& state) {
 
 BENCHMARK(BM_GetdentsNewFD)->Range(1, 1 << 12)->UseRealTime();
 
+// Creates a directory containing `files` files, and reads all the directory
+// entries from the directory using a new FD each time, then stats each entry,
+// as done by ls -l and find.
+void BM_GetdentsStat(benchmark::State& state) {
+  const int count = state.range(0);
+
+  // See BM_GetdentsSameFD.
+  TempPath dir;
+  std::vector<std::string> files;
+  char buffer[kBufferSize];
+
+  // We read and stat all directory entries on each iteration, but report this
+  // as a "batch" iteration so that reported times are per file.
+  while (state.KeepRunningBatch(count)) {
+    state.PauseTiming();
+    // Each iteration reads a new directory, so that its entries aren't already
+    // cached from being looked up by previous iterations. N.B. the previous
+    // iteration's directory is cleaned up here, inside of PauseTiming.
+    if (!files.empty()) {
+      ASSERT_NO_ERRNO(CleanupDirectory(dir, &files));
+      files.clear();
+    }
+    dir = ASSERT_NO_ERRNO_AND_VALUE(CreateDirectory(count, &files));
+    state.ResumeTiming();
+
+    FileDescriptor fd =
+        ASSERT_NO_ERRNO_AND_VALUE(Open(dir.path(), O_RDONLY | O_DIRECTORY));
+
+    int ret;
+    do {
+      ASSERT_THAT(ret = syscall(SYS_getdents64, fd.get(), buffer, kBufferSize),
+                  SyscallSucceeds());
+      for (int off = 0; off < ret;) {
+        const auto* dirent =
+            reinterpret_cast<const struct linux_dirent64*>(buffer + off);
+        off += dirent->d_reclen;
+        if (strcmp(dirent->d_name, ".") == 0 ||
+            strcmp(dirent->d_name, "..") == 0) {
+          continue;
+        }
+        struct stat st;
+        ASSERT_THAT(
+            fstatat(fd.get(), dirent->d_name, &st, AT_SYMLINK_NOFOLLOW),
+            SyscallSucceeds());
+      }
+    } while (ret > 0);
+  }
+
+  ASSERT_NO_ERRNO(CleanupDirectory(dir, &files));
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetdentsStat)->Range(10, 100000)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
@@ -12,16 +12,27 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "benchmark/benchmark.h"
+#include "test/util/eventfd_util.h"
+#include "test/util/file_descriptor.h"
 #include "test/util/logging.h"
 #include "test/util/memory_util.h"
 #include "test/util/posix_error.h"
 #include "test/util/test_util.h"
+#include "test/util/thread_util.h"
 
 namespace gvisor {
 namespace testing {
@@ -75,6 +86,64 @@ void BM_MapTouchUnmap(benchmark::State& state) {
 
 BENCHMARK(BM_MapTouchUnmap)->Range(1, 1 << 17)->UseRealTime();
 
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+// How BM_MapPopulateTouchUnmap prefaults the mapping before touching it.
+enum Prefault {
+  // Don't prefault; each touch takes a demand fault.
+  kDemandFault = 0,
+  kPopulateRead = 1,
+  kPopulateWrite = 2,
+};
+
+// Like BM_MapTouchUnmap, but optionally prefaults the mapping with
+// madvise(MADV_POPULATE_*) before touching it.
+//
+// state.range(0) is the number of pages to map.
+// state.range(1) is a Prefault.
+void BM_MapPopulateTouchUnmap(benchmark::State& state) {
+  const int pages = state.range(0);
+  const Prefault prefault = static_cast<Prefault>(state.range(1));
+  const size_t len = pages * kPageSize;
+
+  for (auto _ : state) {
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    TEST_CHECK_MSG(addr != MAP_FAILED, "mmap failed");
+
+    if (prefault == kPopulateRead) {
+      TEST_PCHECK(madvise(addr, len, MADV_POPULATE_READ) == 0);
+    } else if (prefault == kPopulateWrite) {
+      TEST_PCHECK(madvise(addr, len, MADV_POPULATE_WRITE) == 0);
+    }
+
+    char* c = reinterpret_cast<char*>(addr);
+    char* const end = c + len;
+    for (; c < end; c += kPageSize) {
+      *c = 42;
+    }
+
+    TEST_PCHECK(munmap(addr, len) == 0);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(len) * state.iterations());
+}
+
+void PopulateArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int pages : {1, 64, 4096, 1 << 16}) {
+    for (int prefault : {kDemandFault, kPopulateRead, kPopulateWrite}) {
+      benchmark->Args({pages, prefault});
+    }
+  }
+}
+
+BENCHMARK(BM_MapPopulateTouchUnmap)->Apply(&PopulateArgs)->UseRealTime();
+
 // Map and touch many pages, unmapping all at once.
 //
 // NOTE(b/111429208): This is a regression test to ensure performant mapping and
@@ -157,6 +226,106 @@ void BM_PageFault(benchmark::State& state) {
 
 BENCHMARK(BM_PageFault)->UseRealTime();
 
+// Number of pages in the region in which BM_UserfaultfdFault takes faults.
+constexpr size_t kUserfaultfdPages = 1024;
+
+// How BM_UserfaultfdFault's handler resolves faults.
+enum UserfaultfdResolution {
+  kUffdCopy = 0,
+  kUffdZeropage = 1,
+};
+
+// Maps a private anonymous region of kUserfaultfdPages pages and registers it
+// with the userfaultfd uffd.
+Mapping MapAndRegister(int uffd) {
+  Mapping m = TEST_CHECK_NO_ERRNO_AND_VALUE(MmapAnon(
+      kUserfaultfdPages * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  TEST_PCHECK(ioctl(uffd, UFFDIO_REGISTER, &reg) == 0);
+  return m;
+}
+
+// BM_UserfaultfdFault measures the latency of a page fault that is resolved
+// by a userfaultfd handler thread, from the faulting access until the access
+// completes. Compare with BM_PageFault for faults resolved by the kernel.
+//
+// state.range(0) is a UserfaultfdResolution.
+void BM_UserfaultfdFault(benchmark::State& state) {
+  const auto resolution = static_cast<UserfaultfdResolution>(state.range(0));
+
+  int fd = syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+  if (fd < 0 && (errno == ENOSYS || errno == EPERM)) {
+    state.SkipWithError("userfaultfd unavailable");
+    return;
+  }
+  TEST_PCHECK(fd >= 0);
+  const FileDescriptor uffd(fd);
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  TEST_PCHECK(ioctl(uffd.get(), UFFDIO_API, &api) == 0);
+
+  const FileDescriptor stop =
+      TEST_CHECK_NO_ERRNO_AND_VALUE(NewEventFD(0, EFD_CLOEXEC));
+  ScopedThread handler([&] {
+    std::vector<char> src(kPageSize, 'a');
+    struct pollfd pfds[2] = {{uffd.get(), POLLIN, 0}, {stop.get(), POLLIN, 0}};
+    while (true) {
+      TEST_PCHECK(RetryEINTR(poll)(pfds, 2, -1) > 0);
+      if (pfds[1].revents) {
+        return;
+      }
+      struct uffd_msg msg;
+      if (read(uffd.get(), &msg, sizeof(msg)) < 0) {
+        TEST_PCHECK(errno == EAGAIN);
+        continue;
+      }
+      const uint64_t page = msg.arg.pagefault.address & ~(kPageSize - 1);
+      if (resolution == kUffdCopy) {
+        struct uffdio_copy cp = {};
+        cp.dst = page;
+        cp.src = reinterpret_cast<uintptr_t>(src.data());
+        cp.len = kPageSize;
+        TEST_PCHECK(ioctl(uffd.get(), UFFDIO_COPY, &cp) == 0 ||
+                    errno == EEXIST);
+      } else {
+        struct uffdio_zeropage zp = {};
+        zp.range.start = page;
+        zp.range.len = kPageSize;
+        TEST_PCHECK(ioctl(uffd.get(), UFFDIO_ZEROPAGE, &zp) == 0 ||
+                    errno == EEXIST);
+      }
+    }
+  });
+
+  Mapping m = MapAndRegister(uffd.get());
+  size_t cur_page = 0;
+  for (auto _ : state) {
+    if (cur_page == kUserfaultfdPages) {
+      // Replace the region, since populated pages don't fault again.
+      state.PauseTiming();
+      m.reset();
+      m = MapAndRegister(uffd.get());
+      cur_page = 0;
+      state.ResumeTiming();
+    }
+    const char c =
+        *reinterpret_cast<volatile char*>(m.addr() + cur_page * kPageSize);
+    benchmark::DoNotOptimize(c);
+    cur_page++;
+  }
+
+  TEST_PCHECK(eventfd_write(stop.get(), 1) == 0);
+  handler.Join();
+}
+
+BENCHMARK(BM_UserfaultfdFault)
+    ->Arg(kUffdCopy)
+    ->Arg(kUffdZeropage)
+    ->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
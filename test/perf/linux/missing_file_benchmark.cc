@@ -0,0 +1,121 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Subdirectories of each library directory that the dynamic linker searches
+// before the directory itself.
+constexpr const char* kHwcapsDirs[] = {
+    "glibc-hwcaps/x86-64-v4",
+    "glibc-hwcaps/x86-64-v3",
+    "glibc-hwcaps/x86-64-v2",
+};
+
+constexpr char kLibrary[] = "libbenchmark.so.6";
+
+// BM_LibrarySearch opens a library the way the dynamic linker does: each
+// directory in the library search path, and each of its glibc-hwcaps
+// subdirectories, is probed in turn, and only the last directory contains the
+// library.
+//
+// state.range(0) is the number of directories in the search path.
+void BM_LibrarySearch(benchmark::State& state) {
+  const int dirs = state.range(0);
+
+  const TempPath top_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> probes;
+  for (int i = 0; i < dirs; i++) {
+    const std::string dir = JoinPath(top_dir.path(), absl::StrCat("lib", i));
+    TEST_PCHECK(mkdir(dir.c_str(), 0755) == 0);
+    TEST_PCHECK(mkdir(JoinPath(dir, "glibc-hwcaps").c_str(), 0755) == 0);
+    for (const char* hwcaps : kHwcapsDirs) {
+      const std::string hwcaps_dir = JoinPath(dir, hwcaps);
+      TEST_PCHECK(mkdir(hwcaps_dir.c_str(), 0755) == 0);
+      probes.push_back(JoinPath(hwcaps_dir, kLibrary));
+    }
+    probes.push_back(JoinPath(dir, kLibrary));
+  }
+  const int lib_fd =
+      open(probes.back().c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+  TEST_PCHECK(lib_fd >= 0);
+  TEST_PCHECK(close(lib_fd) == 0);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < probes.size() - 1; i++) {
+      TEST_CHECK(open(probes[i].c_str(), O_RDONLY | O_CLOEXEC) < 0);
+      TEST_PCHECK(errno == ENOENT);
+    }
+    const int fd = open(probes.back().c_str(), O_RDONLY | O_CLOEXEC);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(close(fd) == 0);
+  }
+
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+BENCHMARK(BM_LibrarySearch)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+// BM_StatMissing stats nonexistent files in a single directory in a loop, as
+// done by PATH searches and language runtimes probing for modules.
+//
+// state.range(0) is the number of distinct names that are probed.
+void BM_StatMissing(benchmark::State& state) {
+  const int names = state.range(0);
+
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> paths;
+  paths.reserve(names);
+  for (int i = 0; i < names; i++) {
+    paths.push_back(JoinPath(dir.path(), absl::StrCat("missing", i)));
+  }
+
+  struct stat st;
+  size_t i = 0;
+  for (auto _ : state) {
+    TEST_CHECK(stat(paths[i].c_str(), &st) < 0);
+    TEST_PCHECK(errno == ENOENT);
+    if (++i == paths.size()) {
+      i = 0;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StatMissing)->Arg(1)->Arg(100)->Arg(10000)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -14,6 +14,7 @@
 
 #include <fcntl.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <memory>
@@ -21,6 +22,7 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 #include "test/util/fs_util.h"
 #include "test/util/logging.h"
@@ -50,6 +52,53 @@ void BM_Open(benchmark::State& state) {
 
 BENCHMARK(BM_Open)->Range(1, 128)->UseRealTime();
 
+// BM_OpenDepth opens files at the given depth below a directory in a loop.
+// Each iteration opens the file in the next of a set of identical trees, so
+// that when the trees together exceed the dentry cache, every component of the
+// path must be walked remotely on gofer mounts.
+//
+// state.range(0) is the number of path components below the top directory.
+// state.range(1) is the number of trees.
+void BM_OpenDepth(benchmark::State& state) {
+  const int depth = state.range(0);
+  const int trees = state.range(1);
+
+  const TempPath top_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> paths;
+  paths.reserve(trees);
+  for (int i = 0; i < trees; i++) {
+    std::string path = JoinPath(top_dir.path(), absl::StrCat(i));
+    for (int j = 1; j < depth; j++) {
+      TEST_PCHECK(mkdir(path.c_str(), 0755) == 0);
+      path = JoinPath(path, "d");
+    }
+    const int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(close(fd) == 0);
+    paths.push_back(path);
+  }
+
+  int i = 0;
+  for (auto _ : state) {
+    const int fd = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(close(fd) == 0);
+    if (++i == trees) {
+      i = 0;
+    }
+  }
+}
+
+void OpenDepthArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t depth : {1, 2, 4, 8, 16, 32}) {
+    for (int64_t trees : {1, 1024}) {
+      benchmark->Args({depth, trees});
+    }
+  }
+}
+
+BENCHMARK(BM_OpenDepth)->Apply(&OpenDepthArgs)->UseRealTime();
+
 }  // namespace
 
 }  // namespace testing
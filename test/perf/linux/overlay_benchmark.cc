@@ -0,0 +1,382 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "benchmark/benchmark.h"
+#include "test/util/capability_util.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+#ifndef SYS_getdents64
+#if defined(__x86_64__)
+#define SYS_getdents64 217
+#elif defined(__aarch64__)
+#define SYS_getdents64 61
+#elif defined(__riscv)
+#define SYS_getdents64 61
+#else
+#error "Unknown architecture"
+#endif
+#endif  // SYS_getdents64
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr char kFileName[] = "file";
+constexpr char kDirName[] = "dir";
+
+// Size of each region of data written to files in lower layers.
+constexpr int64_t kExtentSize = 1 << 20;
+
+// Overlay is an overlay with a given number of lower layers, all of which are
+// directories in a private tmpfs mount. Overlay can't be used as the upper
+// layer of another overlay, so a tmpfs is used even if the test runs on an
+// overlay root.
+class Overlay {
+ public:
+  explicit Overlay(int layers)
+      : base_dir_(TEST_CHECK_NO_ERRNO_AND_VALUE(TempPath::CreateDir())) {
+    TEST_PCHECK(mount("tmpfs", base_dir_.path().c_str(), "tmpfs", 0,
+                      "mode=0700") == 0);
+    for (int i = 0; i < layers; i++) {
+      lowers_.push_back(JoinPath(base_dir_.path(), absl::StrCat("lower", i)));
+    }
+    upper_ = JoinPath(base_dir_.path(), "upper");
+    work_ = JoinPath(base_dir_.path(), "work");
+    merged_ = JoinPath(base_dir_.path(), "merged");
+    for (const std::string& dir : lowers_) {
+      MakeDir(dir);
+    }
+    for (const std::string& dir : {upper_, work_, merged_}) {
+      MakeDir(dir);
+    }
+    // lowerdir lists layers from top to bottom.
+    opts_ = absl::StrCat("lowerdir=", absl::StrJoin(lowers_, ":"),
+                         ",upperdir=", upper_, ",workdir=", work_);
+  }
+
+  ~Overlay() {
+    if (mounted_) {
+      Unmount();
+    }
+    TEST_PCHECK(umount2(base_dir_.path().c_str(), 0) == 0);
+  }
+
+  // lower returns the path of the ith lower layer, where layer 0 is the
+  // top-most lower layer.
+  const std::string& lower(int i) const { return lowers_[i]; }
+  const std::string& bottom() const { return lowers_.back(); }
+  const std::string& upper() const { return upper_; }
+  const std::string& merged() const { return merged_; }
+
+  void Mount() {
+    TEST_PCHECK(mount("overlay", merged_.c_str(), "overlay", 0,
+                      opts_.c_str()) == 0);
+    mounted_ = true;
+  }
+
+  void Unmount() {
+    TEST_PCHECK(umount2(merged_.c_str(), 0) == 0);
+    mounted_ = false;
+  }
+
+  // MakeDirInLowers creates a directory with the given name in every lower
+  // layer.
+  void MakeDirInLowers(const std::string& name) const {
+    for (const std::string& dir : lowers_) {
+      MakeDir(JoinPath(dir, name));
+    }
+  }
+
+ private:
+  static void MakeDir(const std::string& path) {
+    TEST_PCHECK(mkdir(path.c_str(), 0755) == 0);
+  }
+
+  TempPath base_dir_;
+  std::vector<std::string> lowers_;
+  std::string upper_;
+  std::string work_;
+  std::string merged_;
+  std::string opts_;
+  bool mounted_ = false;
+};
+
+// SkipIfNoOverlay skips the benchmark and returns true if overlays can't be
+// mounted.
+bool SkipIfNoOverlay(benchmark::State& state) {
+  if (!HaveCapability(CAP_SYS_ADMIN).ValueOrDie()) {
+    state.SkipWithError("CAP_SYS_ADMIN is required to mount overlay");
+    return true;
+  }
+  return false;
+}
+
+// CreateFile creates a file at path with the given size. If sparse is true,
+// only every 16th MB of the file contains data.
+void CreateFile(const std::string& path, int64_t size, bool sparse) {
+  const int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+  TEST_PCHECK(fd >= 0);
+  TEST_PCHECK(ftruncate(fd, size) == 0);
+  const std::vector<char> buf(std::min(kExtentSize, size), 'a');
+  const int64_t stride = sparse ? 16 * kExtentSize : kExtentSize;
+  for (int64_t off = 0; off < size; off += stride) {
+    const int64_t len = std::min(kExtentSize, size - off);
+    TEST_PCHECK(pwrite(fd, buf.data(), len, off) == len);
+  }
+  TEST_PCHECK(close(fd) == 0);
+}
+
+// ReadDir reads all entries of the directory at path with getdents64, and
+// returns the number of bytes of entries read.
+int64_t ReadDir(const std::string& path) {
+  char buf[65536];
+  const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  TEST_PCHECK(fd >= 0);
+  int64_t total = 0;
+  int n;
+  while ((n = syscall(SYS_getdents64, fd, buf, sizeof(buf))) > 0) {
+    total += n;
+  }
+  TEST_PCHECK(n == 0);
+  TEST_PCHECK(close(fd) == 0);
+  return total;
+}
+
+// BM_FirstWrite measures the latency of the first write to a file that exists
+// only on the bottom-most lower layer of an overlay, which must copy the file
+// to the upper layer before writing to it.
+//
+// state.range(0) is the size of the file.
+// state.range(1) is the number of lower layers.
+// state.range(2) is 1 if only every 16th MB of the file contains data, and 0
+// if the whole file does.
+void BM_FirstWrite(benchmark::State& state) {
+  if (SkipIfNoOverlay(state)) {
+    return;
+  }
+  const int64_t size = state.range(0);
+  const int layers = state.range(1);
+  const bool sparse = state.range(2);
+
+  Overlay overlay(layers);
+  CreateFile(JoinPath(overlay.bottom(), kFileName), size, sparse);
+  const std::string merged_file = JoinPath(overlay.merged(), kFileName);
+  const std::string upper_file = JoinPath(overlay.upper(), kFileName);
+
+  char c = 'b';
+  for (auto _ : state) {
+    // Each iteration needs a file that hasn't been copied up, and unlinking
+    // the copied-up file through the overlay would leave a whiteout.
+    state.PauseTiming();
+    overlay.Mount();
+    state.ResumeTiming();
+
+    const int fd = open(merged_file.c_str(), O_WRONLY | O_CLOEXEC);
+    TEST_PCHECK(fd >= 0);
+    TEST_PCHECK(pwrite(fd, &c, 1, 0) == 1);
+    TEST_PCHECK(close(fd) == 0);
+
+    state.PauseTiming();
+    overlay.Unmount();
+    TEST_PCHECK(unlink(upper_file.c_str()) == 0);
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+void FirstWriteArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t layers : {1, 4}) {
+    for (int64_t size = 64 << 10; size <= 256 << 20; size *= 16) {
+      benchmark->Args({size, layers, 0});
+      if (size > 16 * kExtentSize) {
+        benchmark->Args({size, layers, 1});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_FirstWrite)->Apply(&FirstWriteArgs)->UseRealTime();
+
+// BM_Stat stats files that exist only on the bottom-most lower layer of an
+// overlay, in a directory that exists on every layer, so that lookup must
+// consult each layer.
+//
+// state.range(0) is the number of lower layers.
+// state.range(1) is the number of files.
+void BM_Stat(benchmark::State& state) {
+  if (SkipIfNoOverlay(state)) {
+    return;
+  }
+  const int layers = state.range(0);
+  const int files = state.range(1);
+
+  Overlay overlay(layers);
+  overlay.MakeDirInLowers(kDirName);
+  std::vector<std::string> paths;
+  for (int i = 0; i < files; i++) {
+    const std::string name = absl::StrCat(kFileName, i);
+    CreateFile(JoinPath(overlay.bottom(), kDirName, name), 0, false);
+    paths.push_back(JoinPath(overlay.merged(), kDirName, name));
+  }
+  overlay.Mount();
+
+  struct stat st;
+  size_t i = 0;
+  for (auto _ : state) {
+    TEST_PCHECK(stat(paths[i].c_str(), &st) == 0);
+    if (++i == paths.size()) {
+      i = 0;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Stat)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {1, 1000}})
+    ->UseRealTime();
+
+// BM_OpenRead opens, reads and closes a file that exists only on the
+// bottom-most lower layer of an overlay.
+//
+// state.range(0) is the size of the file.
+// state.range(1) is the number of lower layers.
+void BM_OpenRead(benchmark::State& state) {
+  if (SkipIfNoOverlay(state)) {
+    return;
+  }
+  const int64_t size = state.range(0);
+  const int layers = state.range(1);
+
+  Overlay overlay(layers);
+  overlay.MakeDirInLowers(kDirName);
+  CreateFile(JoinPath(overlay.bottom(), kDirName, kFileName), size, false);
+  overlay.Mount();
+  const std::string path = JoinPath(overlay.merged(), kDirName, kFileName);
+
+  std::vector<char> buf(std::min(kExtentSize, std::max(size, int64_t{1})));
+  for (auto _ : state) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    TEST_PCHECK(fd >= 0);
+    int64_t n;
+    while ((n = read(fd, buf.data(), buf.size())) > 0) {
+    }
+    TEST_PCHECK(n == 0);
+    TEST_PCHECK(close(fd) == 0);
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_OpenRead)
+    ->ArgsProduct({{0, 4 << 10, 1 << 20}, {1, 2, 4, 8, 16}})
+    ->UseRealTime();
+
+// BM_ReaddirMerge reads a directory that exists on every lower layer of an
+// overlay, with the directory's entries divided evenly between layers.
+//
+// state.range(0) is the number of entries.
+// state.range(1) is the number of lower layers.
+void BM_ReaddirMerge(benchmark::State& state) {
+  if (SkipIfNoOverlay(state)) {
+    return;
+  }
+  const int entries = state.range(0);
+  const int layers = state.range(1);
+
+  Overlay overlay(layers);
+  overlay.MakeDirInLowers(kDirName);
+  for (int i = 0; i < entries; i++) {
+    CreateFile(JoinPath(overlay.lower(i % layers), kDirName,
+                        absl::StrCat(kFileName, i)),
+               0, false);
+  }
+  overlay.Mount();
+  const std::string dir = JoinPath(overlay.merged(), kDirName);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ReadDir(dir));
+  }
+
+  state.SetItemsProcessed(state.iterations() * entries);
+}
+
+BENCHMARK(BM_ReaddirMerge)
+    ->ArgsProduct({{100, 10000}, {1, 2, 4, 8, 16}})
+    ->UseRealTime();
+
+// BM_ReaddirWhiteouts reads a directory in which most entries from the lower
+// layers have been deleted through the overlay, leaving whiteouts on the upper
+// layer that must be filtered out.
+//
+// state.range(0) is the number of entries in the lower layers, of which 1 in
+// 100 remain.
+// state.range(1) is the number of lower layers.
+void BM_ReaddirWhiteouts(benchmark::State& state) {
+  if (SkipIfNoOverlay(state)) {
+    return;
+  }
+  const int entries = state.range(0);
+  const int layers = state.range(1);
+
+  Overlay overlay(layers);
+  overlay.MakeDirInLowers(kDirName);
+  for (int i = 0; i < entries; i++) {
+    CreateFile(JoinPath(overlay.lower(i % layers), kDirName,
+                        absl::StrCat(kFileName, i)),
+               0, false);
+  }
+  overlay.Mount();
+  const std::string dir = JoinPath(overlay.merged(), kDirName);
+  for (int i = 0; i < entries; i++) {
+    if (i % 100 != 0) {
+      const std::string path = JoinPath(dir, absl::StrCat(kFileName, i));
+      TEST_PCHECK(unlink(path.c_str()) == 0);
+    }
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ReadDir(dir));
+  }
+
+  state.SetItemsProcessed(state.iterations() * entries);
+}
+
+BENCHMARK(BM_ReaddirWhiteouts)
+    ->ArgsProduct({{1000, 10000}, {1, 4}})
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
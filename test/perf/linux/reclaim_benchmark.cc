@@ -0,0 +1,202 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/test_util.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_process_madvise
+#define SYS_process_madvise 440
+#endif
+#ifndef SYS_process_mrelease
+#define SYS_process_mrelease 448
+#endif
+
+#ifndef MADV_COLD
+#define MADV_COLD 20
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// TouchPages writes to every page in [addr, addr+len).
+void TouchPages(char* addr, uint64_t len) {
+  for (uint64_t off = 0; off < len; off += kPageSize) {
+    addr[off] = 1;
+  }
+}
+
+// Child is a child process that owns a private anonymous mapping, and touches
+// all of it whenever its parent asks.
+class Child {
+ public:
+  explicit Child(uint64_t len) : len_(len) {
+    addr_ = static_cast<char*>(mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    TEST_PCHECK(addr_ != MAP_FAILED);
+    int req[2], resp[2];
+    TEST_PCHECK(pipe(req) == 0);
+    TEST_PCHECK(pipe(resp) == 0);
+    pid_ = fork();
+    if (pid_ == 0) {
+      close(req[1]);
+      close(resp[0]);
+      char c = 0;
+      do {
+        TouchPages(addr_, len_);
+        TEST_PCHECK(WriteFd(resp[1], &c, 1) == 1);
+      } while (ReadFd(req[0], &c, 1) == 1);
+      _exit(0);
+    }
+    TEST_PCHECK(pid_ > 0);
+    close(req[0]);
+    close(resp[1]);
+    req_ = FileDescriptor(req[1]);
+    resp_ = FileDescriptor(resp[0]);
+    TEST_PCHECK(munmap(addr_, len_) == 0);
+
+    const int pidfd = syscall(SYS_pidfd_open, pid_, 0);
+    TEST_PCHECK(pidfd >= 0);
+    pidfd_ = FileDescriptor(pidfd);
+    WaitForTouch();
+  }
+
+  ~Child() {
+    req_.reset();
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid_, &status, 0) == pid_);
+  }
+
+  pid_t pid() const { return pid_; }
+  int pidfd() const { return pidfd_.get(); }
+  char* addr() const { return addr_; }
+
+  // Touch asks the child to touch all of its mapping, and waits for it to do
+  // so.
+  void Touch() {
+    char c = 0;
+    TEST_PCHECK(WriteFd(req_.get(), &c, 1) == 1);
+    WaitForTouch();
+  }
+
+ private:
+  void WaitForTouch() {
+    char c;
+    TEST_PCHECK(ReadFd(resp_.get(), &c, 1) == 1);
+  }
+
+  const uint64_t len_;
+  char* addr_;
+  pid_t pid_;
+  FileDescriptor pidfd_;
+  FileDescriptor req_;
+  FileDescriptor resp_;
+};
+
+// BM_ProcessMadvise measures process_madvise(2) on a child's fully-resident
+// private anonymous mapping, as done by memory managers that reclaim memory
+// from idle processes.
+//
+// state.range(0) is the size of the mapping in MB.
+// state.range(1) is the advice.
+void BM_ProcessMadvise(benchmark::State& state) {
+  const uint64_t len = static_cast<uint64_t>(state.range(0)) << 20;
+  const int advice = state.range(1);
+
+  Child child(len);
+  struct iovec iov = {child.addr(), len};
+  for (auto _ : state) {
+    const ssize_t n =
+        syscall(SYS_process_madvise, child.pidfd(), &iov, 1, advice, 0);
+    if (n < 0) {
+      // EPERM without CAP_SYS_NICE, ENOSYS on kernels before 5.10.
+      state.SkipWithError("process_madvise failed");
+      break;
+    }
+    TEST_CHECK(static_cast<uint64_t>(n) == len);
+
+    state.PauseTiming();
+    child.Touch();
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(len * static_cast<int64_t>(state.iterations()));
+}
+
+void ProcessMadviseArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t mb : {64, 256, 1024}) {
+    for (int advice : {MADV_COLD, MADV_PAGEOUT}) {
+      benchmark->Args({mb, advice});
+    }
+  }
+}
+
+BENCHMARK(BM_ProcessMadvise)->Apply(&ProcessMadviseArgs)->UseRealTime();
+
+// BM_ProcessMrelease measures process_mrelease(2) on a killed child with a
+// fully-resident private anonymous mapping.
+//
+// state.range(0) is the size of the mapping in MB.
+void BM_ProcessMrelease(benchmark::State& state) {
+  const uint64_t len = static_cast<uint64_t>(state.range(0)) << 20;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto child = std::make_unique<Child>(len);
+    TEST_PCHECK(kill(child->pid(), SIGKILL) == 0);
+    state.ResumeTiming();
+
+    // ESRCH means that the child's memory was already released by its exit.
+    if (syscall(SYS_process_mrelease, child->pidfd(), 0) < 0 &&
+        errno != ESRCH) {
+      // ENOSYS on kernels before 5.15.
+      state.SkipWithError("process_mrelease failed");
+      break;
+    }
+
+    state.PauseTiming();
+    child.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(len * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_ProcessMrelease)->Arg(64)->Arg(256)->Arg(1024)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
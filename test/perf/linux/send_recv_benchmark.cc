@@ -18,6 +18,10 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif  // __linux__
+
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -33,6 +37,18 @@
 namespace gvisor {
 namespace testing {
 
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
 namespace {
 
 constexpr ssize_t kMessageSize = 1024;
@@ -274,11 +290,44 @@ void BM_RecvmsgWithControlBuf(benchmark::State& state) {
 
 BENCHMARK(BM_RecvmsgWithControlBuf)->UseRealTime();
 
+// ReapZerocopyCompletions drains MSG_ZEROCOPY completion notifications from
+// the error queue of fd without blocking, and returns the number of sends they
+// cover.
+int64_t ReapZerocopyCompletions(int fd) {
+  int64_t completed = 0;
+  while (true) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in))];
+    struct msghdr hdr = {};
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &hdr, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      TEST_CHECK(errno == EAGAIN);
+      return completed;
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) {
+        continue;
+      }
+      sock_extended_err err;
+      memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+      TEST_CHECK(err.ee_errno == 0);
+      TEST_CHECK(err.ee_origin == SO_EE_ORIGIN_ZEROCOPY);
+      completed += err.ee_data - err.ee_info + 1;
+    }
+  }
+}
+
 // BM_SendmsgTCP measures the sendmsg throughput with varying payload sizes.
 //
 // state.Args[0] indicates whether the underlying socket should be blocking or
 // non-blocking w/ 0 indicating non-blocking and 1 to indicate blocking.
 // state.Args[1] is the size of the payload to be used per sendmsg call.
+// state.Args[2] indicates whether the payload is sent with MSG_ZEROCOPY, in
+// which case completion notifications are reaped after every payload.
 void BM_SendmsgTCP(benchmark::State& state) {
   auto listen_socket =
       ASSERT_NO_ERRNO_AND_VALUE(Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
@@ -323,6 +372,18 @@ void BM_SendmsgTCP(benchmark::State& state) {
     ASSERT_THAT(fcntl(send_socket.get(), F_SETFL, opts), SyscallSucceeds());
   }
 
+  const bool zerocopy = state.range(2);
+  int send_flags = 0;
+  if (zerocopy) {
+    constexpr int kOne = 1;
+    if (setsockopt(send_socket.get(), SOL_SOCKET, SO_ZEROCOPY, &kOne,
+                   sizeof(kOne)) < 0) {
+      state.SkipWithError("SO_ZEROCOPY not supported");
+      return;
+    }
+    send_flags = MSG_ZEROCOPY;
+  }
+
   absl::Notification notification;
 
   // Get the buffer size we should use for this iteration of the test.
@@ -341,6 +402,8 @@ void BM_SendmsgTCP(benchmark::State& state) {
 
   int64_t bytes_sent = 0;
   int ncalls = 0;
+  int64_t zerocopy_sends = 0;
+  int64_t zerocopy_completed = 0;
   for (auto ignored : state) {
     int sent = 0;
     while (true) {
@@ -351,9 +414,12 @@ void BM_SendmsgTCP(benchmark::State& state) {
       iov.iov_len = snd_header->msg_iov->iov_len - sent;
       hdr.msg_iov = &iov;
       hdr.msg_iovlen = 1;
-      int n = RetryEINTR(sendmsg)(send_socket.get(), &hdr, 0);
+      int n = RetryEINTR(sendmsg)(send_socket.get(), &hdr, send_flags);
       ncalls++;
       if (n > 0) {
+        if (zerocopy) {
+          zerocopy_sends++;
+        }
         sent += n;
         if (sent == buf_size) {
           break;
@@ -362,14 +428,33 @@ void BM_SendmsgTCP(benchmark::State& state) {
         // poll.
         continue;
       }
+      if (zerocopy) {
+        // Pending completions make the socket report POLLERR, so reap them
+        // before polling.
+        zerocopy_completed += ReapZerocopyCompletions(send_socket.get());
+        struct pollfd poll_fd = {send_socket.get(), POLL_OUT, 0};
+        ASSERT_THAT(RetryEINTR(poll)(&poll_fd, 1, 10), SyscallSucceeds());
+        continue;
+      }
       // Poll the fd for it to become writable.
       struct pollfd poll_fd = {send_socket.get(), POLL_OUT, 0};
       EXPECT_THAT(RetryEINTR(poll)(&poll_fd, 1, 10),
                   SyscallSucceedsWithValue(0));
     }
+    if (zerocopy) {
+      zerocopy_completed += ReapZerocopyCompletions(send_socket.get());
+    }
     bytes_sent += static_cast<int64_t>(sent);
   }
 
+  // Wait for the remaining completions; these require the receiver to consume
+  // the data, so keep it running until then.
+  while (zerocopy_completed < zerocopy_sends) {
+    struct pollfd poll_fd = {send_socket.get(), 0, 0};
+    ASSERT_THAT(RetryEINTR(poll)(&poll_fd, 1, 1000), SyscallSucceeds());
+    zerocopy_completed += ReapZerocopyCompletions(send_socket.get());
+  }
+
   notification.Notify();
   send_socket.reset();
   state.SetBytesProcessed(bytes_sent);
@@ -378,7 +463,11 @@ void BM_SendmsgTCP(benchmark::State& state) {
 void Args(benchmark::internal::Benchmark* benchmark) {
   for (int blocking = 0; blocking < 2; blocking++) {
     for (int buf_size = 1024; buf_size <= 256 << 20; buf_size *= 2) {
-      benchmark->Args({blocking, buf_size});
+      benchmark->Args({blocking, buf_size, /*zerocopy=*/0});
+    }
+    // Zero-copy only pays off for large payloads.
+    for (int buf_size = 64 << 10; buf_size <= 256 << 20; buf_size *= 2) {
+      benchmark->Args({blocking, buf_size, /*zerocopy=*/1});
     }
   }
 }
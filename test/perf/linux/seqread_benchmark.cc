@@ -0,0 +1,145 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of each read(2), chosen to match common file copying tools.
+constexpr int kReadSize = 64 << 10;
+
+// Size of each write(2) used to create the test file.
+constexpr int kWriteSize = 1 << 20;
+
+// FillFile writes size bytes of random data to the file at path. If the
+// filesystem doesn't have room for the file, FillFile skips the benchmark and
+// returns false.
+bool FillFile(benchmark::State& state, const std::string& path, int64_t size) {
+  struct statvfs st;
+  TEST_PCHECK(statvfs(path.c_str(), &st) == 0);
+  if (static_cast<int64_t>(st.f_bavail * st.f_frsize) < 2 * size) {
+    state.SkipWithError("not enough free space for the test file");
+    return false;
+  }
+  FileDescriptor fd = TEST_CHECK_NO_ERRNO_AND_VALUE(Open(path, O_WRONLY));
+  std::vector<char> buf(kWriteSize);
+  RandomizeBuffer(buf.data(), buf.size());
+  for (int64_t off = 0; off < size; off += kWriteSize) {
+    const int64_t n = std::min<int64_t>(kWriteSize, size - off);
+    TEST_CHECK(PwriteFd(fd.get(), buf.data(), n, off) == n);
+  }
+  TEST_PCHECK(fsync(fd.get()) == 0);
+  return true;
+}
+
+// BM_SeqRead reads a file from start to end with read(2), starting with
+// nothing cached, as done by tools that copy, checksum, or scan files.
+//
+// state.range(0) is the file size. state.range(1) is the advice given to
+// posix_fadvise(2) before each pass: POSIX_FADV_NORMAL or
+// POSIX_FADV_SEQUENTIAL.
+void BM_SeqRead(benchmark::State& state) {
+  const int64_t size = state.range(0);
+  const int advice = state.range(1);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  if (!FillFile(state, file.path(), size)) {
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+  std::vector<char> buf(kReadSize);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Drop the file's cached data, so that each pass reads it from the
+    // filesystem.
+    TEST_CHECK(posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) == 0);
+    TEST_CHECK(posix_fadvise(fd.get(), 0, 0, advice) == 0);
+    TEST_PCHECK(lseek(fd.get(), 0, SEEK_SET) == 0);
+    state.ResumeTiming();
+
+    int64_t done = 0;
+    while (done < size) {
+      const ssize_t n = ReadFd(fd.get(), buf.data(), buf.size());
+      TEST_PCHECK(n > 0);
+      done += n;
+    }
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_SeqRead)
+    ->ArgsProduct({{1 << 20, 32 << 20, 1 << 30, int64_t{10} << 30},
+                   {POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL}})
+    ->UseRealTime();
+
+// BM_MmapSeqRead is BM_SeqRead for a file that is mapped with mmap(2) and
+// advised MADV_SEQUENTIAL, and read by touching each page in order.
+void BM_MmapSeqRead(benchmark::State& state) {
+  const int64_t size = state.range(0);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  if (!FillFile(state, file.path(), size)) {
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+  const int64_t page_size = getpagesize();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    TEST_CHECK(posix_fadvise(fd.get(), 0, 0, POSIX_FADV_DONTNEED) == 0);
+    state.ResumeTiming();
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0);
+    TEST_PCHECK(addr != MAP_FAILED);
+    TEST_PCHECK(madvise(addr, size, MADV_SEQUENTIAL) == 0);
+    const volatile char* p = static_cast<const volatile char*>(addr);
+    for (int64_t off = 0; off < size; off += page_size) {
+      benchmark::DoNotOptimize(p[off]);
+    }
+    TEST_PCHECK(munmap(addr, size) == 0);
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_MmapSeqRead)
+    ->Arg(1 << 20)
+    ->Arg(32 << 20)
+    ->Arg(1 << 30)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,212 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Size of the sparse file used by BM_SeekData and BM_SeekHole.
+constexpr int64_t kSparseFileSize = int64_t{8} << 30;
+
+// Size and spacing of the data chunks written to the sparse file.
+constexpr int64_t kChunkSize = 64 << 10;
+constexpr int64_t kChunkStride = 64 << 20;
+
+// Allocate calls fallocate(2) and returns true if it succeeds. If the
+// filesystem doesn't support mode, or doesn't have room for the allocation,
+// Allocate skips the benchmark and returns false.
+bool Allocate(benchmark::State& state, int fd, int mode, int64_t offset,
+              int64_t len) {
+  if (fallocate(fd, mode, offset, len) == 0) {
+    return true;
+  }
+  if (errno == EOPNOTSUPP) {
+    state.SkipWithError("fallocate mode not supported");
+    return false;
+  }
+  if (errno == ENOSPC) {
+    state.SkipWithError("not enough free space for the allocation");
+    return false;
+  }
+  TEST_PCHECK_MSG(false, "fallocate failed");
+  return false;
+}
+
+// HasFreeSpace returns true if the filesystem containing path has at least
+// size bytes free. Otherwise, it skips the benchmark and returns false.
+bool HasFreeSpace(benchmark::State& state, const std::string& path,
+                  int64_t size) {
+  struct statvfs st;
+  TEST_PCHECK(statvfs(path.c_str(), &st) == 0);
+  if (static_cast<int64_t>(st.f_bavail * st.f_frsize) < size) {
+    state.SkipWithError("not enough free space for the allocation");
+    return false;
+  }
+  return true;
+}
+
+// BM_Allocate preallocates a file with fallocate(2) and then truncates it, as
+// done by databases and VM disk images that reserve space ahead of writes.
+//
+// state.range(0) is the allocation size. state.range(1) is the fallocate(2)
+// mode: 0 or FALLOC_FL_KEEP_SIZE.
+void BM_Allocate(benchmark::State& state) {
+  const int64_t size = state.range(0);
+  const int mode = state.range(1);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  if (!HasFreeSpace(state, file.path(), 2 * size)) {
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDWR));
+
+  for (auto _ : state) {
+    if (!Allocate(state, fd.get(), mode, 0, size)) {
+      return;
+    }
+    state.PauseTiming();
+    // Truncation also releases pages allocated beyond EOF with
+    // FALLOC_FL_KEEP_SIZE.
+    TEST_PCHECK(ftruncate(fd.get(), 0) == 0);
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_Allocate)
+    ->ArgsProduct({{1 << 20, 1 << 30, int64_t{4} << 30},
+                   {0, FALLOC_FL_KEEP_SIZE}})
+    ->UseRealTime();
+
+// BM_PunchHole releases the storage of a fully allocated file with
+// FALLOC_FL_PUNCH_HOLE, as done by VM disk images when the guest discards
+// blocks.
+//
+// state.range(0) is the file size. state.range(1) is the size of each hole
+// punched.
+void BM_PunchHole(benchmark::State& state) {
+  const int64_t size = state.range(0);
+  const int64_t hole = state.range(1);
+
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  if (!HasFreeSpace(state, file.path(), 2 * size)) {
+    return;
+  }
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDWR));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (!Allocate(state, fd.get(), 0, 0, size)) {
+      return;
+    }
+    state.ResumeTiming();
+
+    for (int64_t off = 0; off < size; off += hole) {
+      if (!Allocate(state, fd.get(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                    off, hole)) {
+        return;
+      }
+    }
+  }
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_PunchHole)
+    ->ArgsProduct({{1 << 30, int64_t{4} << 30}, {2 << 20, 1 << 30}})
+    ->UseRealTime();
+
+// SparseFile returns a file descriptor for a kSparseFileSize file containing
+// a kChunkSize chunk of data every kChunkStride bytes, and holes elsewhere.
+// The file is shared by BM_SeekData and BM_SeekHole.
+int SparseFile() {
+  static const int fd = [] {
+    static const TempPath* const file =
+        new TempPath(TEST_CHECK_NO_ERRNO_AND_VALUE(TempPath::CreateFile()));
+    FileDescriptor fd =
+        TEST_CHECK_NO_ERRNO_AND_VALUE(Open(file->path(), O_RDWR));
+    std::vector<char> buf(kChunkSize);
+    RandomizeBuffer(buf.data(), buf.size());
+    for (int64_t off = 0; off < kSparseFileSize; off += kChunkStride) {
+      TEST_CHECK(PwriteFd(fd.get(), buf.data(), buf.size(), off) == kChunkSize);
+    }
+    TEST_PCHECK(ftruncate(fd.get(), kSparseFileSize) == 0);
+    return fd.release();
+  }();
+  return fd;
+}
+
+// BM_SeekData and BM_SeekHole walk the data chunks or holes of a multi-GB
+// sparse file with lseek(2), as done by tools that copy or back up sparse
+// files.
+void BM_SeekData(benchmark::State& state) {
+  const int fd = SparseFile();
+  int64_t chunks = 0;
+
+  for (auto _ : state) {
+    off_t off = 0;
+    while ((off = lseek(fd, off, SEEK_DATA)) >= 0) {
+      off += kChunkSize;
+      chunks++;
+    }
+    TEST_PCHECK(errno == ENXIO);
+  }
+
+  state.SetItemsProcessed(chunks);
+}
+
+BENCHMARK(BM_SeekData)->UseRealTime();
+
+void BM_SeekHole(benchmark::State& state) {
+  const int fd = SparseFile();
+  int64_t holes = 0;
+
+  for (auto _ : state) {
+    off_t off = 0;
+    while (off < kSparseFileSize) {
+      off = lseek(fd, off, SEEK_HOLE);
+      TEST_PCHECK(off >= 0);
+      // Skip to the next chunk of data.
+      off = (off / kChunkStride + 1) * kChunkStride;
+      holes++;
+    }
+  }
+
+  state.SetItemsProcessed(holes);
+}
+
+BENCHMARK(BM_SeekHole)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
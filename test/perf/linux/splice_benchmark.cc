@@ -0,0 +1,594 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/sendfile.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/socket_util.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Smallest and largest transfer sizes benchmarked.
+constexpr int64_t kMinSize = 4 << 10;
+constexpr int64_t kMaxSize = 64 << 20;
+
+// Size of the pipes used by the benchmarks. Pipes are grown to this size
+// where possible so that per-call overhead does not dominate large transfers.
+constexpr int kPipeSize = 1 << 20;
+
+// How many bytes to write at once to initialize source files.
+constexpr int kWriteSize = 65536;
+
+// FileBacking selects the filesystem that backs source files.
+enum FileBacking {
+  // The test temporary directory. Under runsc this is served by the gofer,
+  // which depending on the test variant is backed by lisafs or by host file
+  // descriptors (directfs).
+  kTestTmpdir = 0,
+
+  // A sentry-internal tmpfs mount.
+  kTmpfs = 1,
+};
+
+std::string BackingDir(int backing) {
+  switch (backing) {
+    case kTestTmpdir:
+      return GetAbsoluteTestTmpdir();
+    case kTmpfs:
+      return "/dev/shm";
+    default:
+      TEST_CHECK_MSG(false, "unknown file backing");
+      return "";
+  }
+}
+
+// CreateSourceFile creates a file of the given size filled with random data
+// in the directory selected by backing.
+PosixErrorOr<TempPath> CreateSourceFile(int backing, int64_t size) {
+  ASSIGN_OR_RETURN_ERRNO(TempPath path,
+                         TempPath::CreateFileIn(BackingDir(backing)));
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd, Open(path.path(), O_WRONLY));
+
+  std::vector<char> buffer(kWriteSize);
+  RandomizeBuffer(buffer.data(), buffer.size());
+  const std::vector<std::vector<struct iovec>> iovecs_list =
+      GenerateIovecs(size, buffer.data(), buffer.size());
+  for (const auto& iovecs : iovecs_list) {
+    RETURN_ERROR_IF_SYSCALL_FAIL(
+        writev(fd.get(), iovecs.data(), iovecs.size()));
+  }
+  return path;
+}
+
+// Pipe holds both ends of a pipe.
+struct Pipe {
+  FileDescriptor rfd;
+  FileDescriptor wfd;
+};
+
+// CreatePipe returns a pipe grown to kPipeSize where permitted.
+Pipe CreatePipe() {
+  int fds[2];
+  TEST_PCHECK(pipe(fds) == 0);
+  // Growing the pipe may fail with EPERM if kPipeSize exceeds
+  // /proc/sys/fs/pipe-max-size; the default size is good enough then.
+  fcntl(fds[1], F_SETPIPE_SZ, kPipeSize);
+  return Pipe{FileDescriptor(fds[0]), FileDescriptor(fds[1])};
+}
+
+// ConnectedTCPPair returns a connected pair of TCP sockets on the IPv4
+// loopback address, with the sending end first.
+std::pair<FileDescriptor, FileDescriptor> ConnectedTCPPair() {
+  FileDescriptor listen_socket =
+      Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP).ValueOrDie();
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrlen = sizeof(addr);
+  TEST_PCHECK(bind(listen_socket.get(),
+                   reinterpret_cast<struct sockaddr*>(&addr), addrlen) == 0);
+  TEST_PCHECK(listen(listen_socket.get(), SOMAXCONN) == 0);
+  TEST_PCHECK(getsockname(listen_socket.get(),
+                          reinterpret_cast<struct sockaddr*>(&addr),
+                          &addrlen) == 0);
+
+  FileDescriptor send_socket =
+      Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP).ValueOrDie();
+  TEST_PCHECK(RetryEINTR(connect)(send_socket.get(),
+                                  reinterpret_cast<struct sockaddr*>(&addr),
+                                  addrlen) == 0);
+  FileDescriptor recv_socket =
+      Accept(listen_socket.get(), nullptr, nullptr).ValueOrDie();
+  return {std::move(send_socket), std::move(recv_socket)};
+}
+
+// Drain reads from fd until EOF.
+void Drain(int fd) {
+  std::vector<char> buf(kPipeSize);
+  while (true) {
+    ssize_t n = RetryEINTR(read)(fd, buf.data(), buf.size());
+    TEST_PCHECK(n >= 0);
+    if (n == 0) {
+      return;
+    }
+  }
+}
+
+// Fill writes random data to fd until the read end of the pipe is closed.
+void Fill(int fd) {
+  // Block SIGPIPE so that closing the read end is reported as EPIPE.
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGPIPE);
+  TEST_PCHECK(pthread_sigmask(SIG_BLOCK, &set, nullptr) == 0);
+
+  std::vector<char> buf(kPipeSize);
+  RandomizeBuffer(buf.data(), buf.size());
+  while (true) {
+    ssize_t n = RetryEINTR(write)(fd, buf.data(), buf.size());
+    if (n < 0) {
+      TEST_PCHECK(errno == EPIPE);
+      return;
+    }
+  }
+}
+
+// SpliceToNull moves exactly count bytes from the pipe read end fd into
+// /dev/null.
+void SpliceToNull(int fd, int null_fd, int64_t count) {
+  while (count > 0) {
+    ssize_t n =
+        RetryEINTR(splice)(fd, nullptr, null_fd, nullptr, count, SPLICE_F_MOVE);
+    TEST_PCHECK(n > 0);
+    count -= n;
+  }
+}
+
+// BM_SendfileToSocket measures sendfile(2) from a regular file to a connected
+// TCP socket, which is what static file servers do for every response.
+//
+// state.range(0) is the FileBacking of the source file.
+// state.range(1) is the number of bytes sent per iteration.
+void BM_SendfileToSocket(benchmark::State& state) {
+  const int backing = state.range(0);
+  const int64_t size = state.range(1);
+
+  auto file_or = CreateSourceFile(backing, size);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  TempPath file = std::move(file_or).ValueOrDie();
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+
+  auto sockets = ConnectedTCPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+  ScopedThread t([&recv_socket] { Drain(recv_socket.get()); });
+
+  for (auto _ : state) {
+    off_t offset = 0;
+    while (offset < size) {
+      TEST_PCHECK(RetryEINTR(sendfile)(send_socket.get(), fd.get(), &offset,
+                                       size - offset) > 0);
+    }
+  }
+
+  TEST_PCHECK(shutdown(send_socket.get(), SHUT_WR) == 0);
+  t.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+void FileToSocketArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int backing : {kTestTmpdir, kTmpfs}) {
+    for (int64_t size = kMinSize; size <= kMaxSize; size *= 4) {
+      benchmark->Args({backing, size});
+    }
+  }
+}
+
+BENCHMARK(BM_SendfileToSocket)->Apply(&FileToSocketArgs)->UseRealTime();
+
+// BM_SpliceFileToSocket measures moving a file to a connected TCP socket with
+// splice(2) through an intermediate pipe, as log shippers and proxies do. It
+// is the zero-copy counterpart to BM_ReadWriteFileToSocket.
+//
+// state.range(0) is the FileBacking of the source file.
+// state.range(1) is the number of bytes moved per iteration.
+void BM_SpliceFileToSocket(benchmark::State& state) {
+  const int backing = state.range(0);
+  const int64_t size = state.range(1);
+
+  auto file_or = CreateSourceFile(backing, size);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  TempPath file = std::move(file_or).ValueOrDie();
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+
+  Pipe p = CreatePipe();
+  auto sockets = ConnectedTCPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+  ScopedThread t([&recv_socket] { Drain(recv_socket.get()); });
+
+  for (auto _ : state) {
+    loff_t offset = 0;
+    while (offset < size) {
+      ssize_t n = RetryEINTR(splice)(fd.get(), &offset, p.wfd.get(), nullptr,
+                                     size - offset, SPLICE_F_MOVE);
+      TEST_PCHECK(n > 0);
+      while (n > 0) {
+        ssize_t m = RetryEINTR(splice)(p.rfd.get(), nullptr, send_socket.get(),
+                                       nullptr, n, SPLICE_F_MOVE);
+        TEST_PCHECK(m > 0);
+        n -= m;
+      }
+    }
+  }
+
+  TEST_PCHECK(shutdown(send_socket.get(), SHUT_WR) == 0);
+  t.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_SpliceFileToSocket)->Apply(&FileToSocketArgs)->UseRealTime();
+
+// BM_ReadWriteFileToSocket is the read(2)+write(2) baseline for
+// BM_SpliceFileToSocket, using a buffer as large as its pipe.
+//
+// state.range(0) is the FileBacking of the source file.
+// state.range(1) is the number of bytes moved per iteration.
+void BM_ReadWriteFileToSocket(benchmark::State& state) {
+  const int backing = state.range(0);
+  const int64_t size = state.range(1);
+
+  auto file_or = CreateSourceFile(backing, size);
+  if (!file_or.ok()) {
+    state.SkipWithError(file_or.error().ToString().c_str());
+    return;
+  }
+  TempPath file = std::move(file_or).ValueOrDie();
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDONLY));
+
+  auto sockets = ConnectedTCPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+  ScopedThread t([&recv_socket] { Drain(recv_socket.get()); });
+
+  std::vector<char> buf(kPipeSize);
+  for (auto _ : state) {
+    off_t offset = 0;
+    while (offset < size) {
+      ssize_t n = PreadFd(fd.get(), buf.data(),
+                          std::min<int64_t>(buf.size(), size - offset), offset);
+      TEST_PCHECK(n > 0);
+      TEST_PCHECK(WriteFd(send_socket.get(), buf.data(), n) == n);
+      offset += n;
+    }
+  }
+
+  TEST_PCHECK(shutdown(send_socket.get(), SHUT_WR) == 0);
+  t.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_ReadWriteFileToSocket)->Apply(&FileToSocketArgs)->UseRealTime();
+
+// BM_SplicePipeToPipe measures splice(2) between two pipes. A writer thread
+// fills the first pipe and a reader thread drains the second; the benchmark
+// thread only splices.
+//
+// state.range(0) is the number of bytes spliced per iteration.
+void BM_SplicePipeToPipe(benchmark::State& state) {
+  const int64_t size = state.range(0);
+
+  Pipe in = CreatePipe();
+  Pipe out = CreatePipe();
+
+  ScopedThread writer([&in] { Fill(in.wfd.get()); });
+  ScopedThread reader([&out] { Drain(out.rfd.get()); });
+
+  for (auto _ : state) {
+    int64_t remaining = size;
+    while (remaining > 0) {
+      ssize_t n = RetryEINTR(splice)(in.rfd.get(), nullptr, out.wfd.get(),
+                                     nullptr, remaining, SPLICE_F_MOVE);
+      TEST_PCHECK(n > 0);
+      remaining -= n;
+    }
+  }
+
+  in.rfd.reset();
+  out.wfd.reset();
+  writer.Join();
+  reader.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_SplicePipeToPipe)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, kMaxSize)
+    ->UseRealTime();
+
+// BM_TeeFanout measures tee(2) duplicating one pipe into several. Each chunk
+// is tee'd to every output but the last and then spliced into the last one,
+// which consumes it from the input, as a logging fan-out would. Outputs are
+// drained into /dev/null by the benchmark thread so that tee never has to
+// wait for output space.
+//
+// state.range(0) is the number of output pipes.
+// state.range(1) is the number of bytes delivered to each output per
+// iteration.
+void BM_TeeFanout(benchmark::State& state) {
+  const int fanout = state.range(0);
+  const int64_t size = state.range(1);
+
+  FileDescriptor null_fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_WRONLY));
+  Pipe in = CreatePipe();
+  std::vector<Pipe> outs;
+  for (int i = 0; i < fanout; i++) {
+    outs.push_back(CreatePipe());
+  }
+
+  ScopedThread writer([&in] { Fill(in.wfd.get()); });
+
+  for (auto _ : state) {
+    int64_t remaining = size;
+    while (remaining > 0) {
+      // Every output is empty here, so as much as is available in the input
+      // (up to remaining) can be duplicated into each of them.
+      ssize_t n;
+      if (fanout > 1) {
+        n = RetryEINTR(tee)(in.rfd.get(), outs[0].wfd.get(), remaining, 0);
+        TEST_PCHECK(n > 0);
+        for (int i = 1; i < fanout - 1; i++) {
+          TEST_PCHECK(RetryEINTR(tee)(in.rfd.get(), outs[i].wfd.get(), n, 0) ==
+                      n);
+        }
+        TEST_PCHECK(RetryEINTR(splice)(in.rfd.get(), nullptr,
+                                       outs[fanout - 1].wfd.get(), nullptr, n,
+                                       SPLICE_F_MOVE) == n);
+      } else {
+        n = RetryEINTR(splice)(in.rfd.get(), nullptr, outs[0].wfd.get(),
+                               nullptr, remaining, SPLICE_F_MOVE);
+        TEST_PCHECK(n > 0);
+      }
+      for (auto& out : outs) {
+        SpliceToNull(out.rfd.get(), null_fd.get(), n);
+      }
+      remaining -= n;
+    }
+  }
+
+  in.rfd.reset();
+  writer.Join();
+
+  state.SetBytesProcessed(size * fanout *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void TeeArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int fanout : {1, 2, 4, 8}) {
+    for (int64_t size = kMinSize; size <= kMaxSize; size *= 4) {
+      benchmark->Args({fanout, size});
+    }
+  }
+}
+
+BENCHMARK(BM_TeeFanout)->Apply(&TeeArgs)->UseRealTime();
+
+// BM_Vmsplice measures vmsplice(2) of a user buffer into a pipe, which a
+// reader thread drains into /dev/null with splice(2) so that the data is
+// never copied back to user memory.
+//
+// state.range(0) is the number of bytes spliced per iteration.
+void BM_Vmsplice(benchmark::State& state) {
+  const int64_t size = state.range(0);
+
+  Pipe p = CreatePipe();
+  std::vector<char> buf(size);
+  RandomizeBuffer(buf.data(), buf.size());
+
+  // Check for support before starting the reader.
+  struct iovec iov = {buf.data(), 1};
+  if (vmsplice(p.wfd.get(), &iov, 1, 0) < 0) {
+    state.SkipWithError(absl::StrCat("vmsplice: ", strerror(errno)).c_str());
+    return;
+  }
+  TEST_PCHECK(RetryEINTR(read)(p.rfd.get(), buf.data(), 1) == 1);
+
+  FileDescriptor null_fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_WRONLY));
+  ScopedThread reader([&p, &null_fd] {
+    while (true) {
+      ssize_t n = RetryEINTR(splice)(p.rfd.get(), nullptr, null_fd.get(),
+                                     nullptr, kPipeSize, SPLICE_F_MOVE);
+      TEST_PCHECK(n >= 0);
+      if (n == 0) {
+        return;
+      }
+    }
+  });
+
+  for (auto _ : state) {
+    int64_t done = 0;
+    while (done < size) {
+      iov.iov_base = buf.data() + done;
+      iov.iov_len = size - done;
+      ssize_t n = RetryEINTR(vmsplice)(p.wfd.get(), &iov, 1, 0);
+      TEST_PCHECK(n > 0);
+      done += n;
+    }
+  }
+
+  p.wfd.reset();
+  reader.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_Vmsplice)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, kMaxSize)
+    ->UseRealTime();
+
+// How BM_PipeThroughput moves data into the pipe.
+enum PipeWriteMethod {
+  kPipeWrite = 0,
+  kPipeVmsplice = 1,
+  kPipeVmspliceGift = 2,
+};
+
+// Where BM_PipeThroughput's reader moves data out of the pipe to.
+enum PipeSink {
+  // read(2) into a user buffer.
+  kPipeRead = 0,
+  // splice(2) into a file in the test temporary directory.
+  kPipeSpliceToFile = 1,
+};
+
+// BM_PipeThroughput measures moving a user buffer through a pipe with
+// write(2) or vmsplice(2), with or without SPLICE_F_GIFT, while a reader
+// thread drains the pipe with read(2) or splices it into a file.
+//
+// state.range(0) is a PipeWriteMethod.
+// state.range(1) is a PipeSink.
+// state.range(2) is the number of bytes written per iteration.
+void BM_PipeThroughput(benchmark::State& state) {
+  const int method = state.range(0);
+  const int sink = state.range(1);
+  const int64_t size = state.range(2);
+
+  // The reader overwrites the start of the file once it has written this
+  // many bytes, to keep the file small.
+  constexpr loff_t kMaxFileSize = 16 << 20;
+
+  Pipe p = CreatePipe();
+  // SPLICE_F_GIFT requires page-aligned buffers.
+  Mapping m = MmapAnon(size, PROT_READ | PROT_WRITE, MAP_PRIVATE).ValueOrDie();
+  char* const data = static_cast<char*>(m.ptr());
+  RandomizeBuffer(data, size);
+  const int flags = method == kPipeVmspliceGift ? SPLICE_F_GIFT : 0;
+
+  // Check for support before starting the reader.
+  if (method != kPipeWrite) {
+    struct iovec iov = {data, 1};
+    if (vmsplice(p.wfd.get(), &iov, 1, flags) < 0) {
+      state.SkipWithError(absl::StrCat("vmsplice: ", strerror(errno)).c_str());
+      return;
+    }
+    char c;
+    TEST_PCHECK(RetryEINTR(read)(p.rfd.get(), &c, 1) == 1);
+  }
+
+  TempPath out_path =
+      TempPath::CreateFileIn(BackingDir(kTestTmpdir)).ValueOrDie();
+  FileDescriptor out_fd = Open(out_path.path(), O_WRONLY).ValueOrDie();
+  ScopedThread reader([&p, &out_fd, sink] {
+    std::vector<char> buf(kPipeSize);
+    loff_t off = 0;
+    while (true) {
+      ssize_t n;
+      if (sink == kPipeSpliceToFile) {
+        if (off >= kMaxFileSize) {
+          off = 0;
+        }
+        n = RetryEINTR(splice)(p.rfd.get(), nullptr, out_fd.get(), &off,
+                               kPipeSize, SPLICE_F_MOVE);
+      } else {
+        n = RetryEINTR(read)(p.rfd.get(), buf.data(), buf.size());
+      }
+      TEST_PCHECK(n >= 0);
+      if (n == 0) {
+        return;
+      }
+    }
+  });
+
+  for (auto _ : state) {
+    int64_t done = 0;
+    while (done < size) {
+      ssize_t n;
+      if (method == kPipeWrite) {
+        n = RetryEINTR(write)(p.wfd.get(), data + done, size - done);
+      } else {
+        // Gifted pages may still be in the pipe when they are gifted again.
+        // That changes what the reader sees, which doesn't matter here.
+        struct iovec iov = {data + done, static_cast<size_t>(size - done)};
+        n = RetryEINTR(vmsplice)(p.wfd.get(), &iov, 1, flags);
+      }
+      TEST_PCHECK(n > 0);
+      done += n;
+    }
+  }
+
+  p.wfd.reset();
+  reader.Join();
+
+  state.SetBytesProcessed(size * static_cast<int64_t>(state.iterations()));
+}
+
+void PipeThroughputArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int method : {kPipeWrite, kPipeVmsplice, kPipeVmspliceGift}) {
+    for (int sink : {kPipeRead, kPipeSpliceToFile}) {
+      for (int64_t size : {64 << 10, 1 << 20, 16 << 20}) {
+        benchmark->Args({method, sink, size});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_PipeThroughput)->Apply(&PipeThroughputArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -0,0 +1,295 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/logging.h"
+#include "test/util/posix_error.h"
+#include "test/util/socket_util.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Largest number of messages passed to a single sendmmsg(2) or recvmmsg(2).
+constexpr int kMaxBatch = 64;
+
+// Receive buffer size requested for receiving sockets, so that the receiver
+// is rarely the reason datagrams are dropped.
+constexpr int kRecvBufSize = 8 << 20;
+
+// Batch holds the buffers and headers for one sendmmsg(2) or recvmmsg(2)
+// call.
+class Batch {
+ public:
+  Batch(int count, int size)
+      : buffer_(count * size), iovs_(count), hdrs_(count) {
+    RandomizeBuffer(buffer_.data(), buffer_.size());
+    for (int i = 0; i < count; i++) {
+      iovs_[i].iov_base = buffer_.data() + i * size;
+      iovs_[i].iov_len = size;
+      hdrs_[i].msg_hdr.msg_iov = &iovs_[i];
+      hdrs_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  struct mmsghdr* headers() { return hdrs_.data(); }
+
+  int count() const { return hdrs_.size(); }
+
+ private:
+  std::vector<char> buffer_;
+  std::vector<struct iovec> iovs_;
+  std::vector<struct mmsghdr> hdrs_;
+};
+
+// BoundUDPSocket returns a UDP socket bound to an ephemeral port on the IPv4
+// loopback address.
+FileDescriptor BoundUDPSocket() {
+  FileDescriptor fd = Socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP).ValueOrDie();
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  TEST_PCHECK(bind(fd.get(), reinterpret_cast<struct sockaddr*>(&addr),
+                   sizeof(addr)) == 0);
+  return fd;
+}
+
+// ConnectedUDPPair returns a pair of UDP sockets on the IPv4 loopback address
+// that are connected to each other, with the sending end first. The
+// receiving end times out receives after a short while so that receiver
+// threads can notice when to stop.
+std::pair<FileDescriptor, FileDescriptor> ConnectedUDPPair() {
+  FileDescriptor send_socket = BoundUDPSocket();
+  FileDescriptor recv_socket = BoundUDPSocket();
+
+  // The receive buffer may be capped by net.core.rmem_max; the capped size
+  // is good enough then.
+  setsockopt(recv_socket.get(), SOL_SOCKET, SO_RCVBUF, &kRecvBufSize,
+             sizeof(kRecvBufSize));
+  struct timeval timeout = {};
+  timeout.tv_usec = 100 * 1000;
+  TEST_PCHECK(setsockopt(recv_socket.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                         sizeof(timeout)) == 0);
+
+  for (auto [from, to] : {std::pair{send_socket.get(), recv_socket.get()},
+                          std::pair{recv_socket.get(), send_socket.get()}}) {
+    struct sockaddr_storage addr = {};
+    socklen_t addrlen = sizeof(addr);
+    TEST_PCHECK(getsockname(to, reinterpret_cast<struct sockaddr*>(&addr),
+                            &addrlen) == 0);
+    TEST_PCHECK(connect(from, reinterpret_cast<struct sockaddr*>(&addr),
+                        addrlen) == 0);
+  }
+  return {std::move(send_socket), std::move(recv_socket)};
+}
+
+// SendBatch sends every message in batch with as few sendmmsg(2) calls as
+// possible.
+void SendBatch(int fd, Batch& batch) {
+  int sent = 0;
+  while (sent < batch.count()) {
+    int n = RetryEINTR(sendmmsg)(fd, batch.headers() + sent,
+                                 batch.count() - sent, 0);
+    TEST_PCHECK(n > 0);
+    sent += n;
+  }
+}
+
+// BM_SendmmsgUDP measures sending datagrams over loopback with sendmmsg(2). A
+// reader thread drains the receiving socket with recvmmsg(2).
+//
+// state.range(0) is the number of messages per sendmmsg(2) call.
+// state.range(1) is the size of each message.
+void BM_SendmmsgUDP(benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int size = state.range(1);
+
+  auto sockets = ConnectedUDPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+
+  std::atomic<bool> done = false;
+  ScopedThread reader([&recv_socket, &done, size] {
+    Batch batch(kMaxBatch, size);
+    while (!done.load()) {
+      int n = RetryEINTR(recvmmsg)(recv_socket.get(), batch.headers(),
+                                   batch.count(), 0, nullptr);
+      TEST_PCHECK(n > 0 || errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+  });
+
+  Batch batch(batch_size, size);
+  for (auto _ : state) {
+    SendBatch(send_socket.get(), batch);
+  }
+
+  done.store(true);
+  reader.Join();
+
+  const int64_t messages =
+      batch_size * static_cast<int64_t>(state.iterations());
+  state.SetItemsProcessed(messages);
+  state.SetBytesProcessed(messages * size);
+}
+
+void BatchArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int batch_size : {1, 16, kMaxBatch}) {
+    for (int size : {64, 512, 1472, 4096, 9000}) {
+      benchmark->Args({batch_size, size});
+    }
+  }
+}
+
+BENCHMARK(BM_SendmmsgUDP)->Apply(&BatchArgs)->UseRealTime();
+
+// BM_RecvmmsgUDP measures receiving datagrams over loopback with
+// recvmmsg(2). A writer thread keeps the receiving socket supplied with
+// sendmmsg(2).
+//
+// state.range(0) is the number of messages per recvmmsg(2) call.
+// state.range(1) is the size of each message.
+void BM_RecvmmsgUDP(benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int size = state.range(1);
+
+  auto sockets = ConnectedUDPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+
+  std::atomic<bool> done = false;
+  ScopedThread writer([&send_socket, &done, size] {
+    Batch batch(kMaxBatch, size);
+    while (!done.load()) {
+      SendBatch(send_socket.get(), batch);
+    }
+  });
+
+  Batch batch(batch_size, size);
+  int64_t messages = 0;
+  for (auto _ : state) {
+    int n = RetryEINTR(recvmmsg)(recv_socket.get(), batch.headers(),
+                                 batch.count(), MSG_DONTWAIT, nullptr);
+    while (n < 0) {
+      TEST_PCHECK(errno == EAGAIN || errno == EWOULDBLOCK);
+      // Wait for the writer rather than spinning.
+      n = RetryEINTR(recvmmsg)(recv_socket.get(), batch.headers(), 1, 0,
+                               nullptr);
+    }
+    messages += n;
+  }
+
+  done.store(true);
+  writer.Join();
+
+  state.SetItemsProcessed(messages);
+  state.SetBytesProcessed(messages * size);
+}
+
+BENCHMARK(BM_RecvmmsgUDP)->Apply(&BatchArgs)->UseRealTime();
+
+// BM_SendUDPSegments measures sending datagrams of a fixed size over loopback,
+// either with one send(2) per datagram or with a single send(2) that is split
+// into datagrams by UDP_SEGMENT. A reader thread drains the receiving socket.
+//
+// state.range(0) is the number of datagrams sent per iteration.
+// state.range(1) is the size of each datagram.
+// state.range(2) is 1 if UDP_SEGMENT is used, 0 otherwise.
+void BM_SendUDPSegments(benchmark::State& state) {
+  const int segments = state.range(0);
+  const int size = state.range(1);
+  const bool offload = state.range(2);
+
+  auto sockets = ConnectedUDPPair();
+  FileDescriptor send_socket = std::move(sockets.first);
+  FileDescriptor recv_socket = std::move(sockets.second);
+
+  if (offload) {
+    if (setsockopt(send_socket.get(), SOL_UDP, UDP_SEGMENT, &size,
+                   sizeof(size)) < 0) {
+      state.SkipWithError("UDP_SEGMENT not supported");
+      return;
+    }
+  }
+
+  std::atomic<bool> done = false;
+  ScopedThread reader([&recv_socket, &done, size] {
+    Batch batch(kMaxBatch, size);
+    while (!done.load()) {
+      int n = RetryEINTR(recvmmsg)(recv_socket.get(), batch.headers(),
+                                   batch.count(), 0, nullptr);
+      TEST_PCHECK(n > 0 || errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+  });
+
+  std::vector<char> buf(segments * size);
+  RandomizeBuffer(buf.data(), buf.size());
+  for (auto _ : state) {
+    if (offload) {
+      TEST_PCHECK(RetryEINTR(send)(send_socket.get(), buf.data(), buf.size(),
+                                   0) == static_cast<ssize_t>(buf.size()));
+      continue;
+    }
+    for (int i = 0; i < segments; i++) {
+      TEST_PCHECK(RetryEINTR(send)(send_socket.get(), buf.data() + i * size,
+                                   size, 0) == size);
+    }
+  }
+
+  done.store(true);
+  reader.Join();
+
+  const int64_t sent = segments * static_cast<int64_t>(state.iterations());
+  state.SetItemsProcessed(sent);
+  state.SetBytesProcessed(sent * size);
+}
+
+void SegmentArgs(benchmark::internal::Benchmark* benchmark) {
+  // Sizes are typical QUIC datagram sizes; 40 of them fit in the largest UDP
+  // payload.
+  for (int segments : {1, 8, 40}) {
+    for (int size : {1200, 1472}) {
+      for (int offload : {0, 1}) {
+        benchmark->Args({segments, size, offload});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_SendUDPSegments)->Apply(&SegmentArgs)->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
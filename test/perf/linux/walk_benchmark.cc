@@ -0,0 +1,134 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "test/util/fs_util.h"
+#include "test/util/logging.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// CreateFile creates an empty file at path.
+void CreateFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+  TEST_PCHECK(fd >= 0);
+  TEST_PCHECK(close(fd) == 0);
+}
+
+// CreateTree creates a tree of directories under dir in which every directory
+// above depth has fanout subdirectories, and every directory at depth has
+// fanout files. It appends the paths of the files to paths.
+void CreateTree(const std::string& dir, int depth, int fanout,
+                std::vector<std::string>* paths) {
+  for (int i = 0; i < fanout; i++) {
+    const std::string path = JoinPath(dir, absl::StrCat(i));
+    if (depth == 0) {
+      CreateFile(path);
+      paths->push_back(path);
+      continue;
+    }
+    TEST_PCHECK(mkdir(path.c_str(), 0755) == 0);
+    CreateTree(path, depth - 1, fanout, paths);
+  }
+}
+
+// StatAll stats each of paths in a loop, so that the working set of path
+// resolution is every component of every path.
+void StatAll(benchmark::State& state, const std::vector<std::string>& paths) {
+  struct stat st;
+  size_t i = 0;
+  for (auto _ : state) {
+    TEST_PCHECK(stat(paths[i].c_str(), &st) == 0);
+    if (++i == paths.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// BM_StatWorkingSet stats files in a set of directories in a loop, as done
+// by build systems checking whether inputs have changed.
+//
+// state.range(0) is the total number of files.
+// state.range(1) is the number of files per directory.
+void BM_StatWorkingSet(benchmark::State& state) {
+  const int files = state.range(0);
+  const int per_dir = state.range(1);
+
+  const TempPath top_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> paths;
+  paths.reserve(files);
+  std::string dir;
+  for (int i = 0; i < files; i++) {
+    if (i % per_dir == 0) {
+      dir = JoinPath(top_dir.path(), absl::StrCat("d", i / per_dir));
+      TEST_PCHECK(mkdir(dir.c_str(), 0755) == 0);
+    }
+    paths.push_back(JoinPath(dir, absl::StrCat(i)));
+    CreateFile(paths.back());
+  }
+
+  StatAll(state, paths);
+}
+
+void WorkingSetArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t files : {500, 5000, 50000}) {
+    for (int64_t per_dir : {int64_t{100}, files}) {
+      benchmark->Args({files, per_dir});
+    }
+  }
+}
+
+BENCHMARK(BM_StatWorkingSet)->Apply(&WorkingSetArgs)->UseRealTime();
+
+// BM_StatTree stats every leaf file of a directory tree in a loop.
+//
+// state.range(0) is the depth of the tree.
+// state.range(1) is the number of entries in each directory.
+void BM_StatTree(benchmark::State& state) {
+  const int depth = state.range(0);
+  const int fanout = state.range(1);
+
+  const TempPath top_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  std::vector<std::string> paths;
+  CreateTree(top_dir.path(), depth, fanout, &paths);
+
+  StatAll(state, paths);
+}
+
+BENCHMARK(BM_StatTree)
+    ->Args({2, 10})   // 1000 files.
+    ->Args({3, 10})   // 10000 files.
+    ->Args({9, 2})    // 1024 files.
+    ->Args({13, 2})   // 16384 files.
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
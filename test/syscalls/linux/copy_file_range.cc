@@ -0,0 +1,399 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/temp_path.h"
+#include "test/util/test_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Number of pages of data in test files.
+constexpr int kPages = 4;
+
+ssize_t CopyFileRange(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                      size_t len, unsigned int flags) {
+  return syscall(SYS_copy_file_range, fd_in, off_in, fd_out, off_out, len,
+                 flags);
+}
+
+PosixErrorOr<FileDescriptor> Memfd(const std::string& name) {
+  int fd = syscall(SYS_memfd_create, name.c_str(), 0);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "memfd_create");
+  }
+  return FileDescriptor(fd);
+}
+
+// RandomData returns size bytes of random data.
+std::vector<char> RandomData(size_t size) {
+  std::vector<char> data(size);
+  RandomizeBuffer(data.data(), data.size());
+  return data;
+}
+
+// WriteData writes data to fd at offset 0.
+void WriteData(int fd, const std::vector<char>& data) {
+  ASSERT_THAT(pwrite(fd, data.data(), data.size(), 0),
+              SyscallSucceedsWithValue(data.size()));
+}
+
+// ExpectData expects fd's contents to be data.
+void ExpectData(int fd, const std::vector<char>& data) {
+  std::vector<char> got(data.size() + 1);
+  ASSERT_THAT(pread(fd, got.data(), got.size(), 0),
+              SyscallSucceedsWithValue(data.size()));
+  got.resize(data.size());
+  EXPECT_TRUE(got == data);
+}
+
+// Fixture for tests that copy between two files in the test's temporary
+// directory.
+class CopyFileRangeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    in_file_ = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+    out_file_ = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+    in_ = ASSERT_NO_ERRNO_AND_VALUE(Open(in_file_.path(), O_RDWR));
+    out_ = ASSERT_NO_ERRNO_AND_VALUE(Open(out_file_.path(), O_RDWR));
+  }
+
+  TempPath in_file_;
+  TempPath out_file_;
+  FileDescriptor in_;
+  FileDescriptor out_;
+};
+
+TEST_F(CopyFileRangeTest, CopyWithFileOffsets) {
+  const std::vector<char> data = RandomData(kPages * kPageSize);
+  ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data));
+  ASSERT_THAT(lseek(in_.get(), 0, SEEK_SET), SyscallSucceeds());
+
+  EXPECT_THAT(CopyFileRange(in_.get(), nullptr, out_.get(), nullptr,
+                            data.size(), 0),
+              SyscallSucceedsWithValue(data.size()));
+  ExpectData(out_.get(), data);
+
+  // Both file offsets were advanced.
+  EXPECT_THAT(lseek(in_.get(), 0, SEEK_CUR),
+              SyscallSucceedsWithValue(data.size()));
+  EXPECT_THAT(lseek(out_.get(), 0, SEEK_CUR),
+              SyscallSucceedsWithValue(data.size()));
+}
+
+TEST_F(CopyFileRangeTest, CopyWithOffsetPointers) {
+  const std::vector<char> data = RandomData(kPages * kPageSize);
+  ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data));
+
+  constexpr int kLen = 3000;
+  loff_t in_off = 100;
+  loff_t out_off = 5000;
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), &out_off, kLen, 0),
+              SyscallSucceedsWithValue(kLen));
+  EXPECT_EQ(in_off, 100 + kLen);
+  EXPECT_EQ(out_off, 5000 + kLen);
+
+  // The skipped part of the output file reads as zeroes.
+  std::vector<char> want(5000 + kLen, 0);
+  memcpy(want.data() + 5000, data.data() + 100, kLen);
+  ExpectData(out_.get(), want);
+
+  // File offsets were not used.
+  EXPECT_THAT(lseek(in_.get(), 0, SEEK_CUR), SyscallSucceedsWithValue(0));
+  EXPECT_THAT(lseek(out_.get(), 0, SEEK_CUR), SyscallSucceedsWithValue(0));
+}
+
+TEST_F(CopyFileRangeTest, ShortCopyAtEOF) {
+  const std::vector<char> data = RandomData(kPageSize + 10);
+  ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data));
+
+  loff_t in_off = 0;
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), nullptr,
+                            2 * data.size(), 0),
+              SyscallSucceedsWithValue(data.size()));
+  ExpectData(out_.get(), data);
+
+  // Copying from EOF copies nothing.
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), nullptr,
+                            data.size(), 0),
+              SyscallSucceedsWithValue(0));
+}
+
+TEST_F(CopyFileRangeTest, ZeroLength) {
+  EXPECT_THAT(CopyFileRange(in_.get(), nullptr, out_.get(), nullptr, 0, 0),
+              SyscallSucceedsWithValue(0));
+}
+
+TEST_F(CopyFileRangeTest, InvalidFlags) {
+  EXPECT_THAT(CopyFileRange(in_.get(), nullptr, out_.get(), nullptr, 1, 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(CopyFileRangeTest, NegativeOffset) {
+  loff_t in_off = -1;
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), nullptr, 0, 0),
+              SyscallFailsWithErrno(EINVAL));
+  // Linux may report EOVERFLOW for non-zero lengths.
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), nullptr, 1, 0),
+              AnyOf(SyscallFailsWithErrno(EINVAL),
+                    SyscallFailsWithErrno(EOVERFLOW)));
+}
+
+TEST_F(CopyFileRangeTest, BadFileModes) {
+  const FileDescriptor in_wronly =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(in_file_.path(), O_WRONLY));
+  EXPECT_THAT(
+      CopyFileRange(in_wronly.get(), nullptr, out_.get(), nullptr, 1, 0),
+      SyscallFailsWithErrno(EBADF));
+
+  const FileDescriptor out_rdonly =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file_.path(), O_RDONLY));
+  EXPECT_THAT(
+      CopyFileRange(in_.get(), nullptr, out_rdonly.get(), nullptr, 1, 0),
+      SyscallFailsWithErrno(EBADF));
+
+  const FileDescriptor out_append =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file_.path(), O_WRONLY | O_APPEND));
+  EXPECT_THAT(
+      CopyFileRange(in_.get(), nullptr, out_append.get(), nullptr, 1, 0),
+      SyscallFailsWithErrno(EBADF));
+
+  EXPECT_THAT(CopyFileRange(-1, nullptr, out_.get(), nullptr, 1, 0),
+              SyscallFailsWithErrno(EBADF));
+}
+
+TEST_F(CopyFileRangeTest, Directory) {
+  const FileDescriptor dir = ASSERT_NO_ERRNO_AND_VALUE(
+      Open(GetAbsoluteTestTmpdir(), O_RDONLY | O_DIRECTORY));
+  EXPECT_THAT(CopyFileRange(dir.get(), nullptr, out_.get(), nullptr, 1, 0),
+              SyscallFailsWithErrno(EISDIR));
+}
+
+TEST_F(CopyFileRangeTest, Pipe) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+  EXPECT_THAT(CopyFileRange(in_.get(), nullptr, wfd.get(), nullptr, 1, 0),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(CopyFileRange(rfd.get(), nullptr, out_.get(), nullptr, 1, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(CopyFileRangeTest, SameFile) {
+  const std::vector<char> data = RandomData(2 * kPageSize);
+  ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data));
+
+  // Overlapping ranges of the same file can't be copied.
+  loff_t in_off = 0;
+  loff_t out_off = kPageSize / 2;
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, in_.get(), &out_off,
+                            kPageSize, 0),
+              SyscallFailsWithErrno(EINVAL));
+
+  // Ranges that don't overlap can.
+  out_off = data.size();
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, in_.get(), &out_off,
+                            data.size(), 0),
+              SyscallSucceedsWithValue(data.size()));
+  std::vector<char> want = data;
+  want.insert(want.end(), data.begin(), data.end());
+  ExpectData(in_.get(), want);
+}
+
+TEST_F(CopyFileRangeTest, Overwrite) {
+  const std::vector<char> data = RandomData(kPages * kPageSize);
+  ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data));
+  std::vector<char> want = RandomData(kPages * kPageSize);
+  ASSERT_NO_FATAL_FAILURE(WriteData(out_.get(), want));
+
+  // Overwrite the middle of the output file, starting and ending mid-page.
+  loff_t in_off = kPageSize + 10;
+  loff_t out_off = kPageSize + 10;
+  const size_t len = 2 * kPageSize - 20;
+  EXPECT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), &out_off, len, 0),
+              SyscallSucceedsWithValue(len));
+  memcpy(want.data() + kPageSize + 10, data.data() + kPageSize + 10, len);
+  ExpectData(out_.get(), want);
+}
+
+// Fixture for tests that copy between two memfds, which are tmpfs files.
+class CopyFileRangeMemfdTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    in_ = ASSERT_NO_ERRNO_AND_VALUE(Memfd("in"));
+    out_ = ASSERT_NO_ERRNO_AND_VALUE(Memfd("out"));
+    data_ = RandomData(kPages * kPageSize);
+    ASSERT_NO_FATAL_FAILURE(WriteData(in_.get(), data_));
+  }
+
+  // CopyAll copies all of in_ to the start of out_.
+  void CopyAll() {
+    loff_t in_off = 0;
+    loff_t out_off = 0;
+    ASSERT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), &out_off,
+                              data_.size(), 0),
+                SyscallSucceedsWithValue(data_.size()));
+  }
+
+  FileDescriptor in_;
+  FileDescriptor out_;
+  std::vector<char> data_;
+};
+
+TEST_F(CopyFileRangeMemfdTest, WriteSourceAfterCopy) {
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Writing to the source doesn't change the copy.
+  std::vector<char> modified = data_;
+  memset(modified.data() + kPageSize, 'a', 100);
+  ASSERT_THAT(pwrite(in_.get(), modified.data() + kPageSize, 100, kPageSize),
+              SyscallSucceedsWithValue(100));
+  ExpectData(in_.get(), modified);
+  ExpectData(out_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, WriteCopyAfterCopy) {
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Writing to the copy doesn't change the source.
+  std::vector<char> modified = data_;
+  memset(modified.data() + 2 * kPageSize - 50, 'b', 100);
+  ASSERT_THAT(pwrite(out_.get(), modified.data() + 2 * kPageSize - 50, 100,
+                     2 * kPageSize - 50),
+              SyscallSucceedsWithValue(100));
+  ExpectData(out_.get(), modified);
+  ExpectData(in_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, TruncateSourceAfterCopy) {
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Shrinking the source to mid-page zeroes the rest of that page, which
+  // must not affect the copy.
+  ASSERT_THAT(ftruncate(in_.get(), kPageSize + 10), SyscallSucceeds());
+  ASSERT_THAT(ftruncate(in_.get(), data_.size()), SyscallSucceeds());
+  std::vector<char> want = data_;
+  memset(want.data() + kPageSize + 10, 0, want.size() - kPageSize - 10);
+  ExpectData(in_.get(), want);
+  ExpectData(out_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, MapCopyAfterCopy) {
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Writing to the copy through a shared mapping doesn't change the source,
+  // and is visible to reads of the copy.
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, data_.size(), PROT_READ | PROT_WRITE, MAP_SHARED,
+           out_.get(), 0));
+  EXPECT_EQ(memcmp(m.ptr(), data_.data(), data_.size()), 0);
+  std::vector<char> modified = data_;
+  memset(modified.data(), 'c', modified.size());
+  memset(m.ptr(), 'c', modified.size());
+  ExpectData(out_.get(), modified);
+  ExpectData(in_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, MapSourceAfterCopy) {
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Writing to the source through a shared mapping doesn't change the copy.
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, data_.size(), PROT_READ | PROT_WRITE, MAP_SHARED,
+           in_.get(), 0));
+  memset(m.ptr(), 'd', data_.size());
+  ExpectData(out_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, CopyFromMappedFile) {
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, data_.size(), PROT_READ | PROT_WRITE, MAP_SHARED,
+           in_.get(), 0));
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+
+  // Writes through the source's mapping after the copy don't change it.
+  memset(m.ptr(), 'e', data_.size());
+  ExpectData(out_.get(), data_);
+}
+
+TEST_F(CopyFileRangeMemfdTest, Sparse) {
+  // Make a source file whose first two pages are a hole.
+  const FileDescriptor sparse = ASSERT_NO_ERRNO_AND_VALUE(Memfd("sparse"));
+  ASSERT_THAT(pwrite(sparse.get(), data_.data(), kPageSize, 2 * kPageSize),
+              SyscallSucceedsWithValue(kPageSize));
+
+  // Copying it over existing data leaves zeroes where the hole was.
+  loff_t in_off = 0;
+  loff_t out_off = 0;
+  ASSERT_THAT(CopyFileRange(sparse.get(), &in_off, in_.get(), &out_off,
+                            3 * kPageSize, 0),
+              SyscallSucceedsWithValue(3 * kPageSize));
+  std::vector<char> want = data_;
+  memset(want.data(), 0, 2 * kPageSize);
+  memcpy(want.data() + 2 * kPageSize, data_.data(), kPageSize);
+  ExpectData(in_.get(), want);
+}
+
+TEST_F(CopyFileRangeMemfdTest, UnalignedOffsets) {
+  // Offsets that differ within a page can't share whole pages.
+  loff_t in_off = 1;
+  loff_t out_off = 2;
+  const size_t len = data_.size() - 1;
+  ASSERT_THAT(CopyFileRange(in_.get(), &in_off, out_.get(), &out_off, len, 0),
+              SyscallSucceedsWithValue(len));
+  std::vector<char> want(len + 2, 0);
+  memcpy(want.data() + 2, data_.data() + 1, len);
+  ExpectData(out_.get(), want);
+}
+
+TEST_F(CopyFileRangeMemfdTest, Chain) {
+  // Copies of copies are independent of each other.
+  ASSERT_NO_FATAL_FAILURE(CopyAll());
+  const FileDescriptor out2 = ASSERT_NO_ERRNO_AND_VALUE(Memfd("out2"));
+  loff_t in_off = 0;
+  loff_t out_off = 0;
+  ASSERT_THAT(CopyFileRange(out_.get(), &in_off, out2.get(), &out_off,
+                            data_.size(), 0),
+              SyscallSucceedsWithValue(data_.size()));
+
+  std::vector<char> modified = data_;
+  memset(modified.data(), 'f', modified.size());
+  WriteData(out_.get(), modified);
+  ExpectData(in_.get(), data_);
+  ExpectData(out_.get(), modified);
+  ExpectData(out2.get(), data_);
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
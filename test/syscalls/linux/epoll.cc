@@ -25,8 +25,14 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "test/util/epoll_util.h"
 #include "test/util/eventfd_util.h"
 #include "test/util/file_descriptor.h"
@@ -445,6 +451,40 @@ TEST(EpollTest, DoubleEpollOneShot) {
   client2.Join();
 }
 
+TEST(EpollTest, OneshotRearmSameMask) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+  ASSERT_NO_ERRNO(RegisterEpollFD(epollfd.get(), eventfd.get(),
+                                  EPOLLIN | EPOLLONESHOT, kMagicConstant));
+
+  struct epoll_event result[kFDsPerEpoll];
+  for (int i = 0; i < 3; i++) {
+    // The eventfd becoming readable should be reported exactly once.
+    uint64_t val = 1;
+    ASSERT_THAT(WriteFd(eventfd.get(), &val, sizeof(val)),
+                SyscallSucceedsWithValue(sizeof(val)));
+    ASSERT_THAT(RetryEINTR(epoll_wait)(epollfd.get(), result, kFDsPerEpoll, -1),
+                SyscallSucceedsWithValue(1));
+    EXPECT_EQ(result[0].events, EPOLLIN);
+    EXPECT_EQ(result[0].data.u64, kMagicConstant);
+    ASSERT_THAT(RetryEINTR(epoll_wait)(epollfd.get(), result, kFDsPerEpoll, 0),
+                SyscallSucceedsWithValue(0));
+    ASSERT_THAT(ReadFd(eventfd.get(), &val, sizeof(val)),
+                SyscallSucceedsWithValue(sizeof(val)));
+
+    // Rearm with the same events, which should not report anything until the
+    // eventfd becomes readable again.
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = kMagicConstant;
+    ASSERT_THAT(
+        epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(), &event),
+        SyscallSucceeds());
+    ASSERT_THAT(RetryEINTR(epoll_wait)(epollfd.get(), result, kFDsPerEpoll, 0),
+                SyscallSucceedsWithValue(0));
+  }
+}
+
 TEST(EpollTest, EdgeTriggered) {
   // Test edge-triggered entry: make it edge-triggered, first wait should
   // return it, second one should time out, make it writable again, third wait
@@ -554,6 +594,30 @@ TEST(EpollTest, CycleOfThreeDisallowed) {
               SyscallFailsWithErrno(ELOOP));
 }
 
+TEST(EpollTest, CycleAfterDeleteAllowed) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto epollfd1 = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+
+  ASSERT_NO_ERRNO(
+      RegisterEpollFD(epollfd.get(), eventfd.get(), EPOLLIN, kMagicConstant));
+  ASSERT_NO_ERRNO(
+      RegisterEpollFD(epollfd.get(), epollfd1.get(), EPOLLIN, kMagicConstant));
+
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.u64 = kMagicConstant;
+  EXPECT_THAT(epoll_ctl(epollfd1.get(), EPOLL_CTL_ADD, epollfd.get(), &event),
+              SyscallFailsWithErrno(ELOOP));
+
+  // Once epollfd no longer polls epollfd1, epollfd1 may poll epollfd.
+  ASSERT_THAT(
+      epoll_ctl(epollfd.get(), EPOLL_CTL_DEL, epollfd1.get(), nullptr),
+      SyscallSucceeds());
+  EXPECT_THAT(epoll_ctl(epollfd1.get(), EPOLL_CTL_ADD, epollfd.get(), &event),
+              SyscallSucceeds());
+}
+
 TEST(EpollTest, CloseFile) {
   auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
   auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
@@ -720,6 +784,103 @@ TEST(EpollTest, ReadyMutexCircularity) {
   read(sigfd.get(), &info, sizeof(info));
 }
 
+TEST(EpollTest, ExclusiveModifyDisallowed) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+  ASSERT_NO_ERRNO(
+      RegisterEpollFD(epollfd.get(), eventfd.get(), EPOLLIN, kMagicConstant));
+
+  // EPOLLEXCLUSIVE may only be set by EPOLL_CTL_ADD.
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLEXCLUSIVE;
+  event.data.u64 = kMagicConstant;
+  EXPECT_THAT(
+      epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(), &event),
+      SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(EpollTest, ExclusiveEntryModifyDisallowed) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+  ASSERT_NO_ERRNO(RegisterEpollFD(epollfd.get(), eventfd.get(),
+                                  EPOLLIN | EPOLLEXCLUSIVE, kMagicConstant));
+
+  struct epoll_event event;
+  event.events = EPOLLOUT;
+  event.data.u64 = kMagicConstant;
+  EXPECT_THAT(
+      epoll_ctl(epollfd.get(), EPOLL_CTL_MOD, eventfd.get(), &event),
+      SyscallFailsWithErrno(EINVAL));
+
+  // The entry can still be deleted.
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_DEL, eventfd.get(), nullptr),
+              SyscallSucceeds());
+}
+
+TEST(EpollTest, ExclusiveInvalidFlags) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+
+  for (uint32_t flag : {EPOLLONESHOT, EPOLLPRI, EPOLLRDHUP}) {
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLEXCLUSIVE | flag;
+    event.data.u64 = kMagicConstant;
+    EXPECT_THAT(
+        epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, eventfd.get(), &event),
+        SyscallFailsWithErrno(EINVAL))
+        << "flag: " << flag;
+  }
+}
+
+TEST(EpollTest, ExclusiveNestedEpollDisallowed) {
+  auto epollfd = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+  auto epollfd1 = ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD());
+
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLEXCLUSIVE;
+  event.data.u64 = kMagicConstant;
+  EXPECT_THAT(epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, epollfd1.get(), &event),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+// Multiple threads blocked in epoll_wait() on distinct epoll instances that
+// share an EPOLLEXCLUSIVE file should not all be woken by a single event.
+TEST(EpollTest, ExclusiveWakesOne) {
+  constexpr int kThreads = 8;
+  auto eventfd = ASSERT_NO_ERRNO_AND_VALUE(NewEventFD());
+  std::vector<FileDescriptor> epollfds;
+  for (int i = 0; i < kThreads; i++) {
+    epollfds.push_back(ASSERT_NO_ERRNO_AND_VALUE(NewEpollFD()));
+    ASSERT_NO_ERRNO(RegisterEpollFD(epollfds[i].get(), eventfd.get(),
+                                    EPOLLIN | EPOLLEXCLUSIVE, kMagicConstant));
+  }
+
+  // Prevent save/restore from spuriously waking threads.
+  DisableSave ds;
+  std::atomic<int> woken(0);
+  std::vector<std::unique_ptr<ScopedThread>> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.push_back(std::make_unique<ScopedThread>([&, i] {
+      struct epoll_event result;
+      int n = RetryEINTR(epoll_wait)(epollfds[i].get(), &result, 1, 3000);
+      EXPECT_THAT(n, SyscallSucceeds());
+      if (n == 1) {
+        woken.fetch_add(1);
+      }
+    }));
+  }
+
+  // Give the threads time to block in epoll_wait().
+  absl::SleepFor(absl::Seconds(1));
+  uint64_t val = 1;
+  ASSERT_THAT(WriteFd(eventfd.get(), &val, sizeof(val)),
+              SyscallSucceedsWithValue(sizeof(val)));
+  threads.clear();
+
+  EXPECT_GE(woken.load(), 1);
+  EXPECT_LT(woken.load(), kThreads);
+}
+
 }  // namespace
 
 }  // namespace testing
@@ -25,7 +25,9 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <ctime>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
@@ -89,6 +91,74 @@ TEST_F(AllocateTest, Fallocate) {
   EXPECT_EQ(buf.st_size, 40);
 }
 
+TEST_F(AllocateTest, FallocateKeepSize) {
+  int ret = fallocate(test_file_fd_.get(), FALLOC_FL_KEEP_SIZE, 0, 4096);
+  // Not all filesystems support FALLOC_FL_KEEP_SIZE.
+  SKIP_IF(ret == -1 && errno == EOPNOTSUPP);
+  ASSERT_THAT(ret, SyscallSucceeds());
+
+  struct stat buf;
+  ASSERT_THAT(fstat(test_file_fd_.get(), &buf), SyscallSucceeds());
+  EXPECT_EQ(buf.st_size, 0);
+}
+
+TEST_F(AllocateTest, FallocatePunchHole) {
+  const int kPageSize = getpagesize();
+  const std::string contents(4 * kPageSize, 'a');
+  ASSERT_THAT(
+      PwriteFd(test_file_fd_.get(), contents.data(), contents.size(), 0),
+      SyscallSucceedsWithValue(contents.size()));
+
+  // Punching a hole requires FALLOC_FL_KEEP_SIZE.
+  EXPECT_THAT(fallocate(test_file_fd_.get(), FALLOC_FL_PUNCH_HOLE, 0, 1),
+              SyscallFailsWithErrno(EOPNOTSUPP));
+
+  // Punch a hole from the middle of the first page to the middle of the
+  // third page.
+  int ret = fallocate(test_file_fd_.get(),
+                      FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                      kPageSize / 2, 2 * kPageSize);
+  // Not all filesystems support FALLOC_FL_PUNCH_HOLE.
+  SKIP_IF(ret == -1 && errno == EOPNOTSUPP);
+  ASSERT_THAT(ret, SyscallSucceeds());
+
+  struct stat stat_buf;
+  ASSERT_THAT(fstat(test_file_fd_.get(), &stat_buf), SyscallSucceeds());
+  EXPECT_EQ(stat_buf.st_size, contents.size());
+
+  std::string expected = contents;
+  std::fill(expected.begin() + kPageSize / 2,
+            expected.begin() + kPageSize / 2 + 2 * kPageSize, '\0');
+  std::string buf(contents.size(), 'x');
+  ASSERT_THAT(PreadFd(test_file_fd_.get(), buf.data(), buf.size(), 0),
+              SyscallSucceedsWithValue(buf.size()));
+  EXPECT_EQ(buf, expected);
+}
+
+TEST_F(AllocateTest, FallocatePunchHoleSeek) {
+  const int kPageSize = getpagesize();
+  const std::string contents(4 * kPageSize, 'a');
+  ASSERT_THAT(
+      PwriteFd(test_file_fd_.get(), contents.data(), contents.size(), 0),
+      SyscallSucceedsWithValue(contents.size()));
+  int ret = fallocate(test_file_fd_.get(),
+                      FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, kPageSize,
+                      2 * kPageSize);
+  SKIP_IF(ret == -1 && errno == EOPNOTSUPP);
+  ASSERT_THAT(ret, SyscallSucceeds());
+
+  // Not all filesystems report holes: SEEK_HOLE may return EOF, in which case
+  // the rest of the checks don't apply.
+  off_t hole = lseek(test_file_fd_.get(), 0, SEEK_HOLE);
+  SKIP_IF(hole == -1 && errno == EINVAL);
+  SKIP_IF(hole == static_cast<off_t>(contents.size()));
+  EXPECT_EQ(hole, kPageSize);
+  EXPECT_THAT(lseek(test_file_fd_.get(), kPageSize, SEEK_DATA),
+              SyscallSucceedsWithValue(3 * kPageSize));
+  EXPECT_THAT(lseek(test_file_fd_.get(), 3 * kPageSize, SEEK_HOLE),
+              SyscallSucceedsWithValue(contents.size()));
+}
+
 TEST_F(AllocateTest, FallocateInvalid) {
   // Invalid FD
   EXPECT_THAT(fallocate(-1, 0, 0, 10), SyscallFailsWithErrno(EBADF));
@@ -0,0 +1,270 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "test/util/save_util.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+#include "test/util/timer_util.h"
+
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+constexpr uint32_t kFutex2SizeU32 = 0x02;
+constexpr uint32_t kFutex2SizeU64 = 0x03;
+constexpr uint32_t kFutex2Private = FUTEX_PRIVATE_FLAG;
+constexpr int kFutexWaitvMax = 128;
+
+// FutexWaitv is struct futex_waitv, which older headers don't define.
+struct FutexWaitv {
+  uint64_t val;
+  uint64_t uaddr;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+int futex_waitv(std::vector<FutexWaitv>& waiters, const struct timespec* ts,
+                clockid_t clockid) {
+  return syscall(SYS_futex_waitv, waiters.data(), waiters.size(), 0, ts,
+                 clockid);
+}
+
+int futex_wake(bool priv, std::atomic<int>* uaddr, int count) {
+  int op = FUTEX_WAKE;
+  if (priv) {
+    op |= FUTEX_PRIVATE_FLAG;
+  }
+  return syscall(SYS_futex, uaddr, op, count);
+}
+
+// Waiters returns a futex_waitv array that waits on each of futexes while it
+// contains its current value.
+std::vector<FutexWaitv> Waiters(bool priv,
+                                std::vector<std::atomic<int>>& futexes) {
+  std::vector<FutexWaitv> waiters(futexes.size());
+  for (size_t i = 0; i < futexes.size(); i++) {
+    waiters[i].val = static_cast<uint32_t>(futexes[i].load());
+    waiters[i].uaddr = reinterpret_cast<uintptr_t>(&futexes[i]);
+    waiters[i].flags = kFutex2SizeU32 | (priv ? kFutex2Private : 0);
+  }
+  return waiters;
+}
+
+void SkipIfFutexWaitvUnsupported() {
+  std::vector<FutexWaitv> waiters;
+  SKIP_IF(futex_waitv(waiters, nullptr, 0) < 0 && errno == ENOSYS);
+}
+
+class FutexWaitvTest : public ::testing::TestWithParam<bool> {
+ protected:
+  bool IsPrivate() const { return GetParam(); }
+
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(SkipIfFutexWaitvUnsupported());
+  }
+};
+
+// WakeIndex starts a thread that waits on n futexes with futex_waitv, wakes
+// the futex at idx, and checks that futex_waitv returns idx.
+void WakeIndex(bool priv, int n, int idx) {
+  std::vector<std::atomic<int>> futexes(n);
+  std::vector<FutexWaitv> waiters = Waiters(priv, futexes);
+
+  // Prevent save/restore from restarting futex_waitv after futex_wake has
+  // dequeued it.
+  DisableSave ds;
+  std::atomic<bool> done(false);
+  ScopedThread thread([&] {
+    EXPECT_THAT(RetryEINTR(futex_waitv)(waiters, nullptr, 0),
+                SyscallSucceedsWithValue(idx));
+    done.store(true);
+  });
+
+  // futex_wake returns 0 until the thread has started waiting.
+  int woken = 0;
+  while (woken == 0) {
+    ASSERT_THAT(woken = futex_wake(priv, &futexes[idx], 1), SyscallSucceeds());
+    if (woken == 0) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+  }
+  EXPECT_EQ(woken, 1);
+  thread.Join();
+  EXPECT_TRUE(done.load());
+
+  // The thread must no longer be waiting on any futex.
+  for (int i = 0; i < n; i++) {
+    EXPECT_THAT(futex_wake(priv, &futexes[i], 1), SyscallSucceedsWithValue(0));
+  }
+}
+
+TEST_P(FutexWaitvTest, WakeOne) { WakeIndex(IsPrivate(), 1, 0); }
+
+TEST_P(FutexWaitvTest, WakeMiddle) { WakeIndex(IsPrivate(), 8, 5); }
+
+TEST_P(FutexWaitvTest, WakeMax) {
+  WakeIndex(IsPrivate(), kFutexWaitvMax, kFutexWaitvMax - 1);
+}
+
+TEST_P(FutexWaitvTest, WrongValue) {
+  std::vector<std::atomic<int>> futexes(4);
+  std::vector<FutexWaitv> waiters = Waiters(IsPrivate(), futexes);
+  waiters[3].val = 1;
+  EXPECT_THAT(futex_waitv(waiters, nullptr, 0), SyscallFailsWithErrno(EAGAIN));
+
+  // Waiters queued before the mismatched futex must have been dequeued.
+  for (auto& f : futexes) {
+    EXPECT_THAT(futex_wake(IsPrivate(), &f, 1), SyscallSucceedsWithValue(0));
+  }
+}
+
+TEST_P(FutexWaitvTest, MonotonicTimeout) {
+  std::vector<std::atomic<int>> futexes(4);
+  std::vector<FutexWaitv> waiters = Waiters(IsPrivate(), futexes);
+
+  constexpr absl::Duration kTimeout = absl::Milliseconds(500);
+  struct timespec now;
+  ASSERT_THAT(clock_gettime(CLOCK_MONOTONIC, &now), SyscallSucceeds());
+  const struct timespec deadline =
+      absl::ToTimespec(absl::DurationFromTimespec(now) + kTimeout);
+
+  MonotonicTimer timer;
+  timer.Start();
+  EXPECT_THAT(RetryEINTR(futex_waitv)(waiters, &deadline, CLOCK_MONOTONIC),
+              SyscallFailsWithErrno(ETIMEDOUT));
+  EXPECT_GE(timer.Duration(), kTimeout);
+}
+
+TEST_P(FutexWaitvTest, RealtimeTimeout) {
+  std::vector<std::atomic<int>> futexes(4);
+  std::vector<FutexWaitv> waiters = Waiters(IsPrivate(), futexes);
+
+  constexpr absl::Duration kTimeout = absl::Milliseconds(500);
+  const struct timespec deadline = absl::ToTimespec(absl::Now() + kTimeout);
+
+  MonotonicTimer timer;
+  timer.Start();
+  EXPECT_THAT(RetryEINTR(futex_waitv)(waiters, &deadline, CLOCK_REALTIME),
+              SyscallFailsWithErrno(ETIMEDOUT));
+  EXPECT_GE(timer.Duration(), kTimeout);
+}
+
+TEST_P(FutexWaitvTest, PastTimeout) {
+  std::vector<std::atomic<int>> futexes(4);
+  std::vector<FutexWaitv> waiters = Waiters(IsPrivate(), futexes);
+  const struct timespec deadline = {};
+  EXPECT_THAT(futex_waitv(waiters, &deadline, CLOCK_MONOTONIC),
+              SyscallFailsWithErrno(ETIMEDOUT));
+}
+
+INSTANTIATE_TEST_SUITE_P(SharedPrivate, FutexWaitvTest, ::testing::Bool());
+
+class FutexWaitvInvalidTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(SkipIfFutexWaitvUnsupported());
+    waiters_ = Waiters(true, futexes_);
+  }
+
+  std::vector<std::atomic<int>> futexes_ =
+      std::vector<std::atomic<int>>(2);
+  std::vector<FutexWaitv> waiters_;
+};
+
+TEST_F(FutexWaitvInvalidTest, Flags) {
+  EXPECT_THAT(syscall(SYS_futex_waitv, waiters_.data(), waiters_.size(), 1,
+                      nullptr, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, ZeroCount) {
+  EXPECT_THAT(syscall(SYS_futex_waitv, waiters_.data(), 0, 0, nullptr, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, TooMany) {
+  std::vector<std::atomic<int>> futexes(kFutexWaitvMax + 1);
+  std::vector<FutexWaitv> waiters = Waiters(true, futexes);
+  EXPECT_THAT(futex_waitv(waiters, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, NullWaiters) {
+  EXPECT_THAT(syscall(SYS_futex_waitv, nullptr, 1, 0, nullptr, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, BadWaitersAddress) {
+  EXPECT_THAT(syscall(SYS_futex_waitv, 8, 1, 0, nullptr, 0),
+              SyscallFailsWithErrno(EFAULT));
+}
+
+TEST_F(FutexWaitvInvalidTest, Clock) {
+  const struct timespec deadline = {};
+  EXPECT_THAT(futex_waitv(waiters_, &deadline, CLOCK_PROCESS_CPUTIME_ID),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, Timespec) {
+  const struct timespec deadline = {.tv_sec = 0, .tv_nsec = 1000000000};
+  EXPECT_THAT(futex_waitv(waiters_, &deadline, CLOCK_MONOTONIC),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, WaiterFlags) {
+  waiters_[1].flags |= 0x1000;
+  EXPECT_THAT(futex_waitv(waiters_, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, WaiterReserved) {
+  waiters_[1].reserved = 1;
+  EXPECT_THAT(futex_waitv(waiters_, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, WaiterSize) {
+  waiters_[1].flags = kFutex2SizeU64 | kFutex2Private;
+  EXPECT_THAT(futex_waitv(waiters_, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, WaiterValue) {
+  waiters_[1].val = uint64_t{1} << 32;
+  EXPECT_THAT(futex_waitv(waiters_, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_F(FutexWaitvInvalidTest, WaiterUnaligned) {
+  waiters_[1].uaddr += 1;
+  EXPECT_THAT(futex_waitv(waiters_, nullptr, 0), SyscallFailsWithErrno(EINVAL));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
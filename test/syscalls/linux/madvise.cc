@@ -22,6 +22,7 @@
 #include <unistd.h>
 
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -38,6 +39,13 @@ namespace testing {
 
 namespace {
 
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
 void ExpectAllMappingBytes(Mapping const& m, char c) {
   auto const v = m.view();
   for (size_t i = 0; i < v.size(); i++) {
@@ -335,6 +343,210 @@ TEST(MadviseDontforkTest, DontforkAnonPrivate) {
   ExpectAllMappingBytes(mp3, 3);
 }
 
+TEST(MadviseFreeTest, PrivateAnonPage) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 1, m.len());
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_FREE), SyscallSucceeds());
+
+  // The page may or may not have been reclaimed yet, but either way it is
+  // never partially reclaimed.
+  auto const v = m.view();
+  const char c = v[0];
+  EXPECT_TRUE(c == 0 || c == 1) << "unexpected value " << int(c);
+  ExpectAllMappingBytes(m, c);
+
+  // Writing to the page cancels reclamation.
+  memset(m.ptr(), 2, m.len());
+  ExpectAllMappingBytes(m, 2);
+}
+
+TEST(MadviseFreeTest, WriteBySyscallCancelsReclamation) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 1, m.len());
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_FREE), SyscallSucceeds());
+
+  int pipefds[2];
+  ASSERT_THAT(pipe(pipefds), SyscallSucceeds());
+  const FileDescriptor rfd(pipefds[0]);
+  const FileDescriptor wfd(pipefds[1]);
+  const std::string data(kPageSize, 3);
+  ASSERT_THAT(WriteFd(wfd.get(), data.data(), data.size()),
+              SyscallSucceedsWithValue(kPageSize));
+  ASSERT_THAT(ReadFd(rfd.get(), m.ptr(), m.len()),
+              SyscallSucceedsWithValue(kPageSize));
+  ExpectAllMappingBytes(m, 3);
+}
+
+TEST(MadviseFreeTest, MremapMovedPages) {
+  constexpr int kPages = 16;
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPages * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  memset(m.ptr(), 1, m.len());
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_FREE), SyscallSucceeds());
+
+  // Move the freed pages to a new address. They remain reclaimable there.
+  auto dst = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPages * kPageSize, PROT_NONE, MAP_PRIVATE));
+  void* const addr =
+      mremap(m.ptr(), m.len(), m.len(), MREMAP_MAYMOVE | MREMAP_FIXED,
+             dst.ptr());
+  ASSERT_NE(addr, MAP_FAILED) << "mremap failed: " << errno;
+  ASSERT_EQ(addr, dst.ptr());
+  m.release();
+
+  // Apply memory pressure to the moved pages. Each page may or may not be
+  // reclaimed, but is never partially reclaimed.
+  ASSERT_THAT(madvise(dst.ptr(), dst.len(), MADV_PAGEOUT), SyscallSucceeds());
+  auto const v = dst.view();
+  for (size_t i = 0; i < dst.len(); i += kPageSize) {
+    const char c = v[i];
+    ASSERT_TRUE(c == 0 || c == 1) << "unexpected value " << int(c);
+    for (size_t j = i; j < i + kPageSize; j++) {
+      ASSERT_EQ(v[j], c) << "page partially reclaimed at offset " << j;
+    }
+  }
+
+  // Writing to the moved pages cancels reclamation.
+  memset(dst.ptr(), 2, dst.len());
+  ASSERT_THAT(madvise(dst.ptr(), dst.len(), MADV_PAGEOUT), SyscallSucceeds());
+  ExpectAllMappingBytes(dst, 2);
+}
+
+TEST(MadviseFreeTest, SharedAnonFails) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_FREE),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(MadviseFreeTest, FileFails) {
+  TempPath f = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      /* parent = */ GetAbsoluteTestTmpdir(),
+      /* content = */ std::string(kPageSize, 1), TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(f.path(), O_RDWR));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(Mmap(
+      nullptr, kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd.get(), 0));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_FREE),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(MadviseFreeTest, Unmapped) {
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(munmap(reinterpret_cast<void*>(m.addr() + kPageSize), kPageSize),
+              SyscallSucceeds());
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_FREE),
+              SyscallFailsWithErrno(ENOMEM));
+}
+
+// Returns true if all pages in m are resident according to mincore(2).
+PosixErrorOr<bool> AllResident(Mapping const& m) {
+  std::vector<unsigned char> vec(m.len() / kPageSize);
+  RETURN_ERROR_IF_SYSCALL_FAIL(mincore(m.ptr(), m.len(), vec.data()));
+  for (unsigned char c : vec) {
+    if (!(c & 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(MadvisePopulateTest, ReadPrivateAnon) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(16 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_READ),
+              SyscallSucceeds());
+  EXPECT_THAT(AllResident(m), IsPosixErrorOkAndHolds(true));
+  ExpectAllMappingBytes(m, 0);
+}
+
+TEST(MadvisePopulateTest, WritePrivateAnon) {
+  auto m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(16 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_WRITE),
+              SyscallSucceeds());
+  EXPECT_THAT(AllResident(m), IsPosixErrorOkAndHolds(true));
+  ExpectAllMappingBytes(m, 0);
+}
+
+TEST(MadvisePopulateTest, WritePrivateFileDoesNotModifyFile) {
+  TempPath f = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      /* parent = */ GetAbsoluteTestTmpdir(),
+      /* content = */ std::string(kPageSize, 1), TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(f.path(), O_RDWR));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(Mmap(
+      nullptr, kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd.get(), 0));
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_WRITE),
+              SyscallSucceeds());
+  ExpectAllMappingBytes(m, 1);
+
+  // Populating for writing broke copy-on-write, so writes are not visible
+  // in the file.
+  memset(m.ptr(), 2, m.len());
+  char buf[1];
+  ASSERT_THAT(PreadFd(fd.get(), buf, 1, 0), SyscallSucceedsWithValue(1));
+  EXPECT_EQ(buf[0], 1);
+}
+
+TEST(MadvisePopulateTest, WriteReadOnlyFails) {
+  auto m =
+      ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(kPageSize, PROT_READ, MAP_PRIVATE));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_WRITE),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_READ),
+              SyscallSucceeds());
+}
+
+TEST(MadvisePopulateTest, ProtNoneFails) {
+  auto m =
+      ASSERT_NO_ERRNO_AND_VALUE(MmapAnon(kPageSize, PROT_NONE, MAP_PRIVATE));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_READ),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(MadvisePopulateTest, Unmapped) {
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(munmap(reinterpret_cast<void*>(m.addr() + kPageSize), kPageSize),
+              SyscallSucceeds());
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_READ),
+              SyscallFailsWithErrno(ENOMEM));
+}
+
+TEST(MadvisePopulateTest, BeyondEOFFails) {
+  TempPath f = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      /* parent = */ GetAbsoluteTestTmpdir(),
+      /* content = */ std::string(kPageSize, 1), TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(f.path(), O_RDWR));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, 2 * kPageSize, PROT_READ, MAP_SHARED, fd.get(), 0));
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_POPULATE_READ),
+              SyscallFailsWithErrno(EFAULT));
+}
+
+TEST(MadviseWillneedTest, File) {
+  TempPath f = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFileWith(
+      /* parent = */ GetAbsoluteTestTmpdir(),
+      /* content = */ std::string(4 * kPageSize, 1),
+      TempPath::kDefaultFileMode));
+  FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(Open(f.path(), O_RDWR));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      Mmap(nullptr, 4 * kPageSize, PROT_READ, MAP_SHARED, fd.get(), 0));
+  ASSERT_THAT(madvise(m.ptr(), m.len(), MADV_WILLNEED), SyscallSucceeds());
+  ExpectAllMappingBytes(m, 1);
+}
+
+TEST(MadviseWillneedTest, Unmapped) {
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_THAT(munmap(reinterpret_cast<void*>(m.addr() + kPageSize), kPageSize),
+              SyscallSucceeds());
+  EXPECT_THAT(madvise(m.ptr(), m.len(), MADV_WILLNEED),
+              SyscallFailsWithErrno(ENOMEM));
+}
+
 }  // namespace
 
 }  // namespace testing
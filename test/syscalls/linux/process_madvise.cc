@@ -0,0 +1,407 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/linux_capability_util.h"
+#include "test/util/logging.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_process_madvise
+#define SYS_process_madvise 440
+#endif
+#ifndef SYS_process_mrelease
+#define SYS_process_mrelease 448
+#endif
+
+#ifndef MADV_COLD
+#define MADV_COLD 20
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+PosixErrorOr<FileDescriptor> PidfdOpen(pid_t pid) {
+  int fd = syscall(SYS_pidfd_open, pid, 0);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "pidfd_open");
+  }
+  return FileDescriptor(fd);
+}
+
+int ProcessMadvise(int pidfd, const struct iovec* iov, size_t vlen, int advice,
+                   unsigned int flags) {
+  return syscall(SYS_process_madvise, pidfd, iov, vlen, advice, flags);
+}
+
+int ProcessMrelease(int pidfd, unsigned int flags) {
+  return syscall(SYS_process_mrelease, pidfd, flags);
+}
+
+// FillPattern fills len bytes at addr with a pattern derived from seed.
+void FillPattern(char* addr, size_t len, uint8_t seed) {
+  for (size_t i = 0; i < len; i++) {
+    addr[i] = static_cast<char>((i / kPageSize + seed) & 0xff);
+  }
+}
+
+// CheckPattern returns true if the len bytes at addr contain the pattern
+// written by FillPattern(addr, len, seed).
+bool CheckPattern(const char* addr, size_t len, uint8_t seed) {
+  for (size_t i = 0; i < len; i++) {
+    if (addr[i] != static_cast<char>((i / kPageSize + seed) & 0xff)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Skip tests if process_madvise(2) is not supported by the kernel.
+void SkipIfProcessMadviseUnsupported() {
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  SKIP_IF(ProcessMadvise(pidfd.get(), nullptr, 0, MADV_COLD, 0) < 0 &&
+          errno == ENOSYS);
+}
+
+TEST(ProcessMadviseTest, PageoutSelfPreservesContents) {
+  SkipIfProcessMadviseUnsupported();
+  const size_t kSize = 64 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  FillPattern(p, kSize, 1);
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov = {p, kSize};
+  ASSERT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallSucceedsWithValue(kSize));
+  EXPECT_TRUE(CheckPattern(p, kSize, 1));
+}
+
+TEST(ProcessMadviseTest, ColdSelfReturnsTotalLength) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(8 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  FillPattern(p, m.len(), 2);
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov[] = {
+      {p, kPageSize},
+      {p + 2 * kPageSize, 3 * kPageSize},
+      {p + 6 * kPageSize, 0},
+  };
+  ASSERT_THAT(ProcessMadvise(pidfd.get(), iov, 3, MADV_COLD, 0),
+              SyscallSucceedsWithValue(4 * kPageSize));
+  EXPECT_TRUE(CheckPattern(p, m.len(), 2));
+}
+
+TEST(ProcessMadviseTest, PageoutSharedMemoryPreservesContents) {
+  SkipIfProcessMadviseUnsupported();
+  const size_t kSize = 16 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_SHARED));
+  char* const p = static_cast<char*>(m.ptr());
+  FillPattern(p, kSize, 3);
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov = {p, kSize};
+  ASSERT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallSucceedsWithValue(kSize));
+  EXPECT_TRUE(CheckPattern(p, kSize, 3));
+}
+
+TEST(ProcessMadviseTest, InvalidFlags) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov = {p, kPageSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_COLD, 1),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(ProcessMadviseTest, TooManyIovecs) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  std::vector<struct iovec> iov(IOV_MAX + 1, {p, kPageSize});
+  EXPECT_THAT(
+      ProcessMadvise(pidfd.get(), iov.data(), iov.size(), MADV_COLD, 0),
+      SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(ProcessMadviseTest, NotAPidfd) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  struct iovec iov = {p, kPageSize};
+  EXPECT_THAT(ProcessMadvise(fd.get(), &iov, 1, MADV_COLD, 0),
+              SyscallFailsWithErrno(EBADF));
+}
+
+TEST(ProcessMadviseTest, UnalignedAddress) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov = {p + 1, kPageSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(ProcessMadviseTest, UnmappedRange) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  m.reset();
+  struct iovec iov = {p, 2 * kPageSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallFailsWithErrno(ENOMEM));
+}
+
+TEST(ProcessMadviseTest, PartialFailureReturnsAdvisedBytes) {
+  SkipIfProcessMadviseUnsupported();
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(3 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  FillPattern(p, m.len(), 4);
+  // Punch a hole in the middle of the mapping.
+  ASSERT_THAT(munmap(p + kPageSize, kPageSize), SyscallSucceeds());
+
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov[] = {
+      {p, kPageSize},
+      {p + kPageSize, kPageSize},
+      {p + 2 * kPageSize, kPageSize},
+  };
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), iov, 3, MADV_PAGEOUT, 0),
+              SyscallSucceedsWithValue(kPageSize));
+  EXPECT_TRUE(CheckPattern(p, kPageSize, 4));
+}
+
+TEST(ProcessMadviseTest, MlockedRange) {
+  SkipIfProcessMadviseUnsupported();
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_IPC_LOCK)));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  ASSERT_THAT(mlock(p, m.len()), SyscallSucceeds());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  struct iovec iov = {p, kPageSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+// A child process that has written a pattern to a private mapping and waits
+// to be told to check it.
+class PatternChild {
+ public:
+  PatternChild(char* addr, size_t len, uint8_t seed) {
+    int ready[2], go[2];
+    TEST_PCHECK(pipe(ready) == 0);
+    TEST_PCHECK(pipe(go) == 0);
+    pid_ = fork();
+    if (pid_ == 0) {
+      close(ready[0]);
+      close(go[1]);
+      FillPattern(addr, len, seed);
+      char c = 0;
+      TEST_PCHECK(write(ready[1], &c, 1) == 1);
+      TEST_PCHECK(read(go[0], &c, 1) == 1);
+      _exit(CheckPattern(addr, len, seed) ? 0 : 1);
+    }
+    TEST_PCHECK(pid_ > 0);
+    close(ready[1]);
+    close(go[0]);
+    go_ = FileDescriptor(go[1]);
+    char c;
+    TEST_PCHECK(ReadFd(ready[0], &c, 1) == 1);
+    close(ready[0]);
+  }
+
+  pid_t pid() const { return pid_; }
+
+  // CheckAndWait tells the child to check its pattern and returns its wait
+  // status.
+  int CheckAndWait() {
+    char c = 0;
+    TEST_PCHECK(WriteFd(go_.get(), &c, 1) == 1);
+    int status;
+    TEST_PCHECK(RetryEINTR(waitpid)(pid_, &status, 0) == pid_);
+    return status;
+  }
+
+ private:
+  pid_t pid_;
+  FileDescriptor go_;
+};
+
+TEST(ProcessMadviseTest, PageoutChildPreservesContents) {
+  SkipIfProcessMadviseUnsupported();
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_NICE)));
+  const size_t kSize = 256 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+
+  PatternChild child(p, kSize, 5);
+  const FileDescriptor pidfd =
+      ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child.pid()));
+  struct iovec iov = {p, kSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_PAGEOUT, 0),
+              SyscallSucceedsWithValue(kSize));
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_COLD, 0),
+              SyscallSucceedsWithValue(kSize));
+  const int status = child.CheckAndWait();
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << "status = " << status;
+}
+
+TEST(ProcessMadviseTest, DestructiveAdviceRejectedForChild) {
+  SkipIfProcessMadviseUnsupported();
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_NICE)));
+  const size_t kSize = 4 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+
+  PatternChild child(p, kSize, 6);
+  const FileDescriptor pidfd =
+      ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child.pid()));
+  struct iovec iov = {p, kSize};
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_DONTNEED, 0),
+              SyscallFailsWithErrno(EINVAL));
+  EXPECT_THAT(ProcessMadvise(pidfd.get(), &iov, 1, MADV_FREE, 0),
+              SyscallFailsWithErrno(EINVAL));
+  const int status = child.CheckAndWait();
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << "status = " << status;
+}
+
+// Skip tests if process_mrelease(2) is not supported by the kernel.
+void SkipIfProcessMreleaseUnsupported() {
+  SKIP_IF(ProcessMrelease(-1, 0) < 0 && errno == ENOSYS);
+}
+
+TEST(ProcessMreleaseTest, InvalidFlags) {
+  SkipIfProcessMreleaseUnsupported();
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  EXPECT_THAT(ProcessMrelease(pidfd.get(), 1), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(ProcessMreleaseTest, NotAPidfd) {
+  SkipIfProcessMreleaseUnsupported();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open("/dev/null", O_RDONLY));
+  EXPECT_THAT(ProcessMrelease(fd.get(), 0), SyscallFailsWithErrno(EBADF));
+}
+
+TEST(ProcessMreleaseTest, LiveProcess) {
+  SkipIfProcessMreleaseUnsupported();
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(getpid()));
+  EXPECT_THAT(ProcessMrelease(pidfd.get(), 0), SyscallFailsWithErrno(EINVAL));
+
+  const size_t kSize = 4 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  PatternChild child(p, kSize, 7);
+  const FileDescriptor child_pidfd =
+      ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child.pid()));
+  EXPECT_THAT(ProcessMrelease(child_pidfd.get(), 0),
+              SyscallFailsWithErrno(EINVAL));
+  const int status = child.CheckAndWait();
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      << "status = " << status;
+}
+
+TEST(ProcessMreleaseTest, KilledProcess) {
+  SkipIfProcessMreleaseUnsupported();
+  const size_t kSize = 1024 * kPageSize;
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const p = static_cast<char*>(m.ptr());
+  PatternChild child(p, kSize, 8);
+  const FileDescriptor pidfd =
+      ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child.pid()));
+  ASSERT_THAT(kill(child.pid(), SIGKILL), SyscallSucceeds());
+  // The child may already have released its memory by exiting.
+  const int ret = ProcessMrelease(pidfd.get(), 0);
+  if (ret < 0) {
+    EXPECT_EQ(errno, ESRCH);
+  }
+  int status;
+  ASSERT_THAT(RetryEINTR(waitpid)(child.pid(), &status, 0),
+              SyscallSucceedsWithValue(child.pid()));
+  EXPECT_TRUE(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL)
+      << "status = " << status;
+}
+
+TEST(ProcessMreleaseTest, ExitedProcess) {
+  SkipIfProcessMreleaseUnsupported();
+  const pid_t child = fork();
+  if (child == 0) {
+    _exit(0);
+  }
+  ASSERT_THAT(child, SyscallSucceeds());
+  const FileDescriptor pidfd = ASSERT_NO_ERRNO_AND_VALUE(PidfdOpen(child));
+  // Wait for the child to become a zombie without reaping it.
+  siginfo_t info;
+  ASSERT_THAT(RetryEINTR(waitid)(P_PID, child, &info, WEXITED | WNOWAIT),
+              SyscallSucceeds());
+  EXPECT_THAT(ProcessMrelease(pidfd.get(), 0), SyscallFailsWithErrno(ESRCH));
+  int status;
+  ASSERT_THAT(RetryEINTR(waitpid)(child, &status, 0),
+              SyscallSucceedsWithValue(child));
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -15,6 +15,9 @@
 #include "test/syscalls/linux/socket_ip_tcp_generic.h"
 
 #include <fcntl.h>
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif  // __linux__
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <poll.h>
@@ -24,6 +27,9 @@
 #include <sys/types.h>
 #include <sys/un.h>
 
+#include <cstring>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/time/clock.h"
@@ -40,6 +46,18 @@ namespace testing {
 using ::testing::AnyOf;
 using ::testing::Eq;
 
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
 // The amount of time to wait for something expected to occur.
 constexpr int kPositiveTimeoutMs = 60 * 1000;
 
@@ -1503,5 +1521,77 @@ TEST_P(TCPSocketPairTest, WaitTillTimeoutWithCorkOption) {
               SyscallSucceedsWithValue(sizeof(buf)));
 }
 
+TEST_P(TCPSocketPairTest, ZerocopySendNotifiesCompletion) {
+  // Completions for data in flight across save/restore are not delivered.
+  const DisableSave ds;
+  auto sockets = ASSERT_NO_ERRNO_AND_VALUE(NewSocketPair());
+
+  constexpr int kOne = 1;
+  ASSERT_THAT(setsockopt(sockets->first_fd(), SOL_SOCKET, SO_ZEROCOPY, &kOne,
+                         sizeof(kOne)),
+              SyscallSucceeds());
+  int get = 0;
+  socklen_t get_len = sizeof(get);
+  ASSERT_THAT(getsockopt(sockets->first_fd(), SOL_SOCKET, SO_ZEROCOPY, &get,
+                         &get_len),
+              SyscallSucceeds());
+  EXPECT_EQ(get, kOne);
+
+  // Each send is assigned the next number, starting at 0, whether it is made
+  // with send(2) or sendmsg(2).
+  constexpr uint32_t kSends = 2;
+  std::vector<char> sent(16 << 10);
+  std::vector<char> received(sent.size());
+  for (uint32_t i = 0; i < kSends; i++) {
+    RandomizeBuffer(sent.data(), sent.size());
+    if (i % 2 == 0) {
+      ASSERT_THAT(RetryEINTR(send)(sockets->first_fd(), sent.data(),
+                                   sent.size(), MSG_ZEROCOPY),
+                  SyscallSucceedsWithValue(sent.size()));
+    } else {
+      struct iovec iov = {sent.data(), sent.size()};
+      struct msghdr msg = {};
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      ASSERT_THAT(RetryEINTR(sendmsg)(sockets->first_fd(), &msg, MSG_ZEROCOPY),
+                  SyscallSucceedsWithValue(sent.size()));
+    }
+    ASSERT_THAT(RetryEINTR(recv)(sockets->second_fd(), received.data(),
+                                 received.size(), MSG_WAITALL),
+                SyscallSucceedsWithValue(received.size()));
+    EXPECT_EQ(sent, received);
+  }
+
+  // Completions may be coalesced into a single notification.
+  uint32_t next = 0;
+  while (next < kSends) {
+    struct pollfd poll_fd = {sockets->first_fd(), 0, 0};
+    ASSERT_THAT(RetryEINTR(poll)(&poll_fd, 1, kPositiveTimeoutMs),
+                SyscallSucceedsWithValue(1));
+    EXPECT_EQ(poll_fd.revents & POLLERR, POLLERR);
+
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ASSERT_THAT(recvmsg(sockets->first_fd(), &msg, MSG_ERRQUEUE),
+                SyscallSucceedsWithValue(0));
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    ASSERT_NE(cmsg, nullptr);
+    EXPECT_TRUE((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                (cmsg->cmsg_level == SOL_IPV6 &&
+                 cmsg->cmsg_type == IPV6_RECVERR));
+
+    sock_extended_err err = {};
+    memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+    EXPECT_EQ(err.ee_errno, 0);
+    EXPECT_EQ(err.ee_origin, SO_EE_ORIGIN_ZEROCOPY);
+    EXPECT_EQ(err.ee_info, next);
+    ASSERT_GE(err.ee_data, err.ee_info);
+    next = err.ee_data + 1;
+  }
+  EXPECT_EQ(next, kSends);
+}
+
 }  // namespace testing
 }  // namespace gvisor
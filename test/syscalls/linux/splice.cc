@@ -15,9 +15,11 @@
 #include <fcntl.h>
 #include <linux/unistd.h>
 #include <sys/eventfd.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/sendfile.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "gmock/gmock.h"
@@ -946,6 +948,184 @@ TEST(SpliceTest, FromPipeWithWriterToDevNull) {
       SyscallFailsWithErrno(EAGAIN));
 }
 
+TEST(VmspliceTest, ToPipe) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  std::vector<char> wbuf(3 * kPageSize);
+  RandomizeBuffer(wbuf.data(), wbuf.size());
+  struct iovec iov[2] = {
+      {wbuf.data(), kPageSize},
+      {wbuf.data() + kPageSize, 2 * kPageSize},
+  };
+  EXPECT_THAT(vmsplice(wfd.get(), iov, 2, 0),
+              SyscallSucceedsWithValue(wbuf.size()));
+
+  std::vector<char> rbuf(wbuf.size());
+  ASSERT_THAT(ReadFd(rfd.get(), rbuf.data(), rbuf.size()),
+              SyscallSucceedsWithValue(rbuf.size()));
+  EXPECT_EQ(memcmp(rbuf.data(), wbuf.data(), rbuf.size()), 0);
+}
+
+TEST(VmspliceTest, FromPipe) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  std::vector<char> wbuf(kPageSize);
+  RandomizeBuffer(wbuf.data(), wbuf.size());
+  ASSERT_THAT(WriteFd(wfd.get(), wbuf.data(), wbuf.size()),
+              SyscallSucceedsWithValue(wbuf.size()));
+
+  // The pipe's read end is not writable, so data moves out of the pipe.
+  std::vector<char> rbuf(wbuf.size());
+  struct iovec iov[2] = {
+      {rbuf.data(), 100},
+      {rbuf.data() + 100, rbuf.size() - 100},
+  };
+  EXPECT_THAT(vmsplice(rfd.get(), iov, 2, 0),
+              SyscallSucceedsWithValue(rbuf.size()));
+  EXPECT_EQ(memcmp(rbuf.data(), wbuf.data(), rbuf.size()), 0);
+}
+
+TEST(VmspliceTest, GiftToPipe) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(4 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  char* const data = static_cast<char*>(m.ptr());
+  RandomizeBuffer(data, m.len());
+  const std::vector<char> expected(data, data + m.len());
+
+  // Include unaligned iovecs, whose partial pages must not be exposed.
+  struct iovec iov[2] = {
+      {data + 10, kPageSize},
+      {data + kPageSize + 10, 3 * kPageSize - 10},
+  };
+  const size_t size = iov[0].iov_len + iov[1].iov_len;
+  EXPECT_THAT(vmsplice(wfd.get(), iov, 2, SPLICE_F_GIFT),
+              SyscallSucceedsWithValue(size));
+
+  // The pipe holds its own references on gifted pages, so they outlive the
+  // mapping.
+  m.reset();
+
+  std::vector<char> rbuf(size);
+  ASSERT_THAT(ReadFd(rfd.get(), rbuf.data(), rbuf.size()),
+              SyscallSucceedsWithValue(rbuf.size()));
+  EXPECT_EQ(memcmp(rbuf.data(), expected.data() + 10, kPageSize), 0);
+  EXPECT_EQ(memcmp(rbuf.data() + kPageSize,
+                   expected.data() + kPageSize + 10, 3 * kPageSize - 10),
+            0);
+}
+
+TEST(VmspliceTest, GiftThenSpliceToFile) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  RandomizeBuffer(static_cast<char*>(m.ptr()), m.len());
+  struct iovec iov = {m.ptr(), m.len()};
+  ASSERT_THAT(vmsplice(wfd.get(), &iov, 1, SPLICE_F_GIFT),
+              SyscallSucceedsWithValue(m.len()));
+
+  const TempPath out_file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor out_fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(out_file.path(), O_RDWR));
+  EXPECT_THAT(splice(rfd.get(), nullptr, out_fd.get(), nullptr, m.len(), 0),
+              SyscallSucceedsWithValue(m.len()));
+
+  std::vector<char> rbuf(m.len());
+  ASSERT_THAT(pread(out_fd.get(), rbuf.data(), rbuf.size(), 0),
+              SyscallSucceedsWithValue(rbuf.size()));
+  EXPECT_EQ(memcmp(rbuf.data(), m.ptr(), rbuf.size()), 0);
+}
+
+TEST(VmspliceTest, NonBlocking) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  // Nothing to read.
+  std::vector<char> buf(kPageSize);
+  struct iovec iov = {buf.data(), buf.size()};
+  EXPECT_THAT(vmsplice(rfd.get(), &iov, 1, SPLICE_F_NONBLOCK),
+              SyscallFailsWithErrno(EAGAIN));
+
+  // Fill the pipe, then expect further writes to fail.
+  int pipe_size;
+  ASSERT_THAT(pipe_size = fcntl(wfd.get(), F_GETPIPE_SZ), SyscallSucceeds());
+  std::vector<char> fill(pipe_size);
+  ASSERT_THAT(WriteFd(wfd.get(), fill.data(), fill.size()),
+              SyscallSucceedsWithValue(fill.size()));
+  for (int flags : {0, SPLICE_F_GIFT}) {
+    EXPECT_THAT(vmsplice(wfd.get(), &iov, 1, SPLICE_F_NONBLOCK | flags),
+                SyscallFailsWithErrno(EAGAIN));
+  }
+}
+
+TEST(VmspliceTest, Blocking) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  std::vector<char> wbuf(kPageSize);
+  RandomizeBuffer(wbuf.data(), wbuf.size());
+  ScopedThread t([&]() {
+    absl::SleepFor(absl::Milliseconds(100));
+    ASSERT_THAT(WriteFd(wfd.get(), wbuf.data(), wbuf.size()),
+                SyscallSucceedsWithValue(wbuf.size()));
+  });
+
+  std::vector<char> rbuf(wbuf.size());
+  struct iovec iov = {rbuf.data(), rbuf.size()};
+  EXPECT_THAT(vmsplice(rfd.get(), &iov, 1, 0),
+              SyscallSucceedsWithValue(rbuf.size()));
+  EXPECT_EQ(memcmp(rbuf.data(), wbuf.data(), rbuf.size()), 0);
+}
+
+TEST(VmspliceTest, ZeroSegments) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  EXPECT_THAT(vmsplice(wfd.get(), nullptr, 0, 0), SyscallSucceedsWithValue(0));
+}
+
+TEST(VmspliceTest, InvalidFlags) {
+  int fds[2];
+  ASSERT_THAT(pipe(fds), SyscallSucceeds());
+  const FileDescriptor rfd(fds[0]);
+  const FileDescriptor wfd(fds[1]);
+
+  char c = 0;
+  struct iovec iov = {&c, 1};
+  EXPECT_THAT(vmsplice(wfd.get(), &iov, 1, 0x80),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(VmspliceTest, NotPipe) {
+  const TempPath file = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateFile());
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(Open(file.path(), O_RDWR));
+
+  char c = 0;
+  struct iovec iov = {&c, 1};
+  EXPECT_THAT(vmsplice(fd.get(), &iov, 1, 0), SyscallFailsWithErrno(EBADF));
+}
+
 }  // namespace
 
 }  // namespace testing
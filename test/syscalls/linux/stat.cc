@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -593,6 +594,46 @@ TEST_F(StatTest, LstatSymlinkDir) {
   EXPECT_FALSE(S_ISLNK(st.st_mode));
 }
 
+// Test that files created at paths that previously failed to resolve are
+// visible, even if the failed lookup was cached.
+TEST_F(StatTest, MissingFileCreated) {
+  const TempPath dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  const TempPath src_dir = ASSERT_NO_ERRNO_AND_VALUE(TempPath::CreateDir());
+  const std::string src = JoinPath(src_dir.path(), "src");
+  ASSERT_NO_ERRNO(CreateWithContents(src, ""));
+
+  const std::vector<std::function<int(const std::string&)>> creators = {
+      [](const std::string& path) {
+        return open(path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+      },
+      [](const std::string& path) { return mkdir(path.c_str(), 0755); },
+      [](const std::string& path) { return symlink("target", path.c_str()); },
+      [&](const std::string& path) {
+        return link(src.c_str(), path.c_str());
+      },
+      [&](const std::string& path) {
+        return rename(src.c_str(), path.c_str());
+      },
+  };
+  for (size_t i = 0; i < creators.size(); i++) {
+    SCOPED_TRACE(absl::StrCat("creator ", i));
+    const std::string path = JoinPath(dir.path(), absl::StrCat("file", i));
+    struct stat st;
+    ASSERT_THAT(lstat(path.c_str(), &st), SyscallFailsWithErrno(ENOENT));
+    ASSERT_THAT(lstat(path.c_str(), &st), SyscallFailsWithErrno(ENOENT));
+    const int ret = creators[i](path);
+    ASSERT_THAT(ret, SyscallSucceeds());
+    if (i == 0) {
+      ASSERT_THAT(close(ret), SyscallSucceeds());
+    }
+    EXPECT_THAT(lstat(path.c_str(), &st), SyscallSucceeds());
+  }
+
+  // The renamed file is gone from its original directory.
+  struct stat st;
+  EXPECT_THAT(lstat(src.c_str(), &st), SyscallFailsWithErrno(ENOENT));
+}
+
 // Verify that we get an ELOOP from too many symbolic links even when there
 // are directories in the middle.
 TEST_F(StatTest, LstatELOOPPath) {
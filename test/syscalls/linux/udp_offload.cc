@@ -0,0 +1,264 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/posix_error.h"
+#include "test/util/socket_util.h"
+#include "test/util/test_util.h"
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+// Segment size used by tests.
+constexpr int kSegmentSize = 100;
+
+// SendWithSegmentSize sends len bytes of data on fd with a UDP_SEGMENT control
+// message holding segment_size, which is normally a uint16_t.
+template <typename T>
+ssize_t SendWithSegmentSize(int fd, const char* data, size_t len,
+                            T segment_size) {
+  struct iovec iov = {};
+  iov.iov_base = const_cast<char*>(data);
+  iov.iov_len = len;
+  char control[CMSG_SPACE(sizeof(segment_size))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size));
+  memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+  return sendmsg(fd, &msg, 0);
+}
+
+// Fixture for UDP_SEGMENT and UDP_GRO tests, parameterized by the address
+// family to use (AF_INET and AF_INET6).
+class UdpOffloadTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    const int family = GetParam();
+    sender_ =
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(family, SOCK_DGRAM, IPPROTO_UDP));
+    receiver_ =
+        ASSERT_NO_ERRNO_AND_VALUE(Socket(family, SOCK_DGRAM, IPPROTO_UDP));
+
+    for (int fd : {sender_.get(), receiver_.get()}) {
+      struct sockaddr_storage addr = InetLoopbackAddr(family);
+      ASSERT_THAT(bind(fd, AsSockAddr(&addr), sizeof(addr)),
+                  SyscallSucceeds());
+    }
+    socklen_t addrlen = sizeof(receiver_addr_);
+    ASSERT_THAT(
+        getsockname(receiver_.get(), AsSockAddr(&receiver_addr_), &addrlen),
+        SyscallSucceeds());
+    ASSERT_THAT(connect(sender_.get(), AsSockAddr(&receiver_addr_), addrlen),
+                SyscallSucceeds());
+
+    // Don't let a missing datagram hang the test.
+    struct timeval timeout = {};
+    timeout.tv_sec = 5;
+    ASSERT_THAT(setsockopt(receiver_.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                           sizeof(timeout)),
+                SyscallSucceeds());
+  }
+
+  // SendSegmented sends buf on sender_ with a UDP_SEGMENT control message.
+  void SendSegmented(const std::vector<char>& buf) {
+    ASSERT_THAT(SendWithSegmentSize(sender_.get(), buf.data(), buf.size(),
+                                    static_cast<uint16_t>(kSegmentSize)),
+                SyscallSucceedsWithValue(buf.size()));
+  }
+
+  // ExpectSegments receives the datagrams that buf was split into.
+  void ExpectSegments(const std::vector<char>& buf) {
+    std::vector<char> got(buf.size() + 1);
+    for (size_t off = 0; off < buf.size(); off += kSegmentSize) {
+      const size_t want = std::min<size_t>(kSegmentSize, buf.size() - off);
+      ASSERT_THAT(RetryEINTR(recv)(receiver_.get(), got.data(), got.size(), 0),
+                  SyscallSucceedsWithValue(want));
+      EXPECT_EQ(memcmp(got.data(), buf.data() + off, want), 0);
+    }
+    // Nothing else was sent.
+    EXPECT_THAT(RetryEINTR(recv)(receiver_.get(), got.data(), got.size(),
+                                 MSG_DONTWAIT),
+                SyscallFailsWithErrno(EAGAIN));
+  }
+
+  FileDescriptor sender_;
+  FileDescriptor receiver_;
+  struct sockaddr_storage receiver_addr_ = {};
+};
+
+TEST_P(UdpOffloadTest, SockOpts) {
+  int v = -1;
+  socklen_t len = sizeof(v);
+  ASSERT_THAT(getsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, &len),
+              SyscallSucceeds());
+  EXPECT_EQ(len, sizeof(v));
+  EXPECT_EQ(v, 0);
+
+  v = -1;
+  ASSERT_THAT(getsockopt(receiver_.get(), SOL_UDP, UDP_GRO, &v, &len),
+              SyscallSucceeds());
+  EXPECT_EQ(v, 0);
+
+  v = kSegmentSize;
+  ASSERT_THAT(
+      setsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, sizeof(v)),
+      SyscallSucceeds());
+  v = 1;
+  ASSERT_THAT(setsockopt(receiver_.get(), SOL_UDP, UDP_GRO, &v, sizeof(v)),
+              SyscallSucceeds());
+
+  ASSERT_THAT(getsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, &len),
+              SyscallSucceeds());
+  EXPECT_EQ(v, kSegmentSize);
+  ASSERT_THAT(getsockopt(receiver_.get(), SOL_UDP, UDP_GRO, &v, &len),
+              SyscallSucceeds());
+  EXPECT_EQ(v, 1);
+}
+
+TEST_P(UdpOffloadTest, SegmentSizeOutOfRange) {
+  for (int v : {-1, 1 << 16}) {
+    EXPECT_THAT(setsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, sizeof(v)),
+                SyscallFailsWithErrno(EINVAL));
+  }
+}
+
+TEST_P(UdpOffloadTest, SegmentWithSockOpt) {
+  int v = kSegmentSize;
+  ASSERT_THAT(setsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, sizeof(v)),
+              SyscallSucceeds());
+
+  std::vector<char> buf(2 * kSegmentSize + kSegmentSize / 2);
+  RandomizeBuffer(buf.data(), buf.size());
+  ASSERT_THAT(send(sender_.get(), buf.data(), buf.size(), 0),
+              SyscallSucceedsWithValue(buf.size()));
+  ExpectSegments(buf);
+}
+
+TEST_P(UdpOffloadTest, SegmentWithControlMessage) {
+  std::vector<char> buf(3 * kSegmentSize);
+  RandomizeBuffer(buf.data(), buf.size());
+  ASSERT_NO_FATAL_FAILURE(SendSegmented(buf));
+  ExpectSegments(buf);
+}
+
+TEST_P(UdpOffloadTest, SmallWriteIsNotSegmented) {
+  int v = kSegmentSize;
+  ASSERT_THAT(setsockopt(sender_.get(), SOL_UDP, UDP_SEGMENT, &v, sizeof(v)),
+              SyscallSucceeds());
+
+  std::vector<char> buf(kSegmentSize / 2);
+  RandomizeBuffer(buf.data(), buf.size());
+  ASSERT_THAT(send(sender_.get(), buf.data(), buf.size(), 0),
+              SyscallSucceedsWithValue(buf.size()));
+  ExpectSegments(buf);
+}
+
+TEST_P(UdpOffloadTest, ControlMessageWrongLength) {
+  std::vector<char> buf(2 * kSegmentSize);
+  EXPECT_THAT(SendWithSegmentSize(sender_.get(), buf.data(), buf.size(),
+                                  static_cast<int>(kSegmentSize)),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_P(UdpOffloadTest, TooManySegments) {
+  // A write may be split into at most 128 segments.
+  std::vector<char> buf(129);
+  EXPECT_THAT(SendWithSegmentSize(sender_.get(), buf.data(), buf.size(),
+                                  static_cast<uint16_t>(1)),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST_P(UdpOffloadTest, ReceiveCoalesced) {
+  int v = 1;
+  ASSERT_THAT(setsockopt(receiver_.get(), SOL_UDP, UDP_GRO, &v, sizeof(v)),
+              SyscallSucceeds());
+
+  std::vector<char> buf(4 * kSegmentSize + kSegmentSize / 2);
+  RandomizeBuffer(buf.data(), buf.size());
+  ASSERT_NO_FATAL_FAILURE(SendSegmented(buf));
+
+  // Segments may be coalesced into fewer reads, each carrying the segment
+  // size in a UDP_GRO control message. Whichever way they are split, the
+  // data must arrive in order.
+  std::vector<char> got(buf.size() + 1);
+  size_t received = 0;
+  while (received < buf.size()) {
+    struct iovec iov = {};
+    iov.iov_base = got.data() + received;
+    iov.iov_len = got.size() - received;
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n;
+    ASSERT_THAT(n = RetryEINTR(recvmsg)(receiver_.get(), &msg, 0),
+                SyscallSucceeds());
+    ASSERT_GT(n, 0);
+    EXPECT_EQ(msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC), 0);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg != nullptr) {
+      EXPECT_EQ(cmsg->cmsg_level, SOL_UDP);
+      EXPECT_EQ(cmsg->cmsg_type, UDP_GRO);
+      ASSERT_EQ(cmsg->cmsg_len, CMSG_LEN(sizeof(int)));
+      int gro_size;
+      memcpy(&gro_size, CMSG_DATA(cmsg), sizeof(gro_size));
+      EXPECT_EQ(gro_size, kSegmentSize);
+    } else {
+      // Uncoalesced reads hold a single segment.
+      EXPECT_LE(n, kSegmentSize);
+    }
+    received += n;
+  }
+  EXPECT_EQ(received, buf.size());
+  EXPECT_EQ(memcmp(got.data(), buf.data(), buf.size()), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllInetTests, UdpOffloadTest,
+                         ::testing::Values(AF_INET, AF_INET6));
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor
@@ -60,6 +60,18 @@ namespace testing {
 
 namespace {
 
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
 int IcmpTimeoutMillis() {
   // Fuchsia's CI infra is susceptible to timing jumps. Set a negative timeout
   // so that poll will block indefinitely, which effectively delegates the
@@ -2575,6 +2587,118 @@ TEST(UdpInet6SocketTest, ConnectInet4Sockaddr) {
   ASSERT_TRUE(IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) << addr;
 }
 
+TEST_P(UdpSocketTest, BlockingSendmmsgFillingSendBufferSendsAll) {
+  ASSERT_NO_ERRNO(BindLoopback());
+  ASSERT_THAT(connect(sock_.get(), bind_addr_, addrlen_), SyscallSucceeds());
+
+  // The send buffer only has room for a few messages, so it fills up partway
+  // through the batch.
+  constexpr int kSendBufSize = 4096;
+  ASSERT_THAT(setsockopt(sock_.get(), SOL_SOCKET, SO_SNDBUF, &kSendBufSize,
+                         sizeof(kSendBufSize)),
+              SyscallSucceeds());
+  constexpr int kRcvBufSize = 1 << 20;
+  ASSERT_THAT(setsockopt(bind_.get(), SOL_SOCKET, SO_RCVBUF, &kRcvBufSize,
+                         sizeof(kRcvBufSize)),
+              SyscallSucceeds());
+  const struct timeval timeout = {5, 0};
+  ASSERT_THAT(setsockopt(bind_.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                         sizeof(timeout)),
+              SyscallSucceeds());
+
+  constexpr uint32_t kMessages = 64;
+  char sent[kMessages][1024];
+  struct iovec iovs[kMessages];
+  struct mmsghdr msgs[kMessages] = {};
+  for (uint32_t i = 0; i < kMessages; i++) {
+    RandomizeBuffer(sent[i], sizeof(sent[i]));
+    iovs[i] = {sent[i], sizeof(sent[i])};
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // Drain bind_ concurrently so that the blocked sender can make progress.
+  uint32_t received_count = 0;
+  ScopedThread t([&] {
+    char received[sizeof(sent[0])];
+    while (received_count < kMessages) {
+      ASSERT_THAT(RetryEINTR(recv)(bind_.get(), received, sizeof(received), 0),
+                  SyscallSucceedsWithValue(sizeof(received)));
+      EXPECT_EQ(memcmp(sent[received_count], received, sizeof(received)), 0);
+      received_count++;
+    }
+  });
+
+  // A blocking sendmmsg waits for space rather than returning a short count.
+  ASSERT_THAT(RetryEINTR(sendmmsg)(sock_.get(), msgs, kMessages, 0),
+              SyscallSucceedsWithValue(kMessages));
+  for (uint32_t i = 0; i < kMessages; i++) {
+    EXPECT_EQ(msgs[i].msg_len, sizeof(sent[i]));
+  }
+  t.Join();
+  EXPECT_EQ(received_count, kMessages);
+}
+
+TEST_P(UdpSocketTest, ZerocopySendmmsgNotifiesCompletion) {
+  // Completions for data in flight across save/restore are not delivered.
+  const DisableSave ds;
+  ASSERT_NO_ERRNO(BindLoopback());
+  ASSERT_THAT(connect(sock_.get(), bind_addr_, addrlen_), SyscallSucceeds());
+
+  constexpr int kOne = 1;
+  ASSERT_THAT(
+      setsockopt(sock_.get(), SOL_SOCKET, SO_ZEROCOPY, &kOne, sizeof(kOne)),
+      SyscallSucceeds());
+
+  // Each message is assigned the next number, starting at 0.
+  constexpr uint32_t kMessages = 4;
+  char sent[kMessages][512];
+  struct iovec iovs[kMessages];
+  struct mmsghdr msgs[kMessages] = {};
+  for (uint32_t i = 0; i < kMessages; i++) {
+    RandomizeBuffer(sent[i], sizeof(sent[i]));
+    iovs[i] = {sent[i], sizeof(sent[i])};
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  ASSERT_THAT(RetryEINTR(sendmmsg)(sock_.get(), msgs, kMessages, MSG_ZEROCOPY),
+              SyscallSucceedsWithValue(kMessages));
+  for (uint32_t i = 0; i < kMessages; i++) {
+    EXPECT_EQ(msgs[i].msg_len, sizeof(sent[i]));
+    char received[sizeof(sent[i])];
+    ASSERT_THAT(RetryEINTR(recv)(bind_.get(), received, sizeof(received), 0),
+                SyscallSucceedsWithValue(sizeof(received)));
+    EXPECT_EQ(memcmp(sent[i], received, sizeof(received)), 0);
+  }
+
+  // Completions may be coalesced into a single notification.
+  uint32_t next = 0;
+  while (next < kMessages) {
+    struct pollfd poll_fd = {sock_.get(), 0, 0};
+    ASSERT_THAT(RetryEINTR(poll)(&poll_fd, 1, 1000),
+                SyscallSucceedsWithValue(1));
+    EXPECT_EQ(poll_fd.revents & POLLERR, POLLERR);
+
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ASSERT_THAT(recvmsg(sock_.get(), &msg, MSG_ERRQUEUE),
+                SyscallSucceedsWithValue(0));
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    ASSERT_NE(cmsg, nullptr);
+
+    sock_extended_err err = {};
+    memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+    EXPECT_EQ(err.ee_errno, 0);
+    EXPECT_EQ(err.ee_origin, SO_EE_ORIGIN_ZEROCOPY);
+    EXPECT_EQ(err.ee_info, next);
+    ASSERT_GE(err.ee_data, err.ee_info);
+    next = err.ee_data + 1;
+  }
+  EXPECT_EQ(next, kMessages);
+}
+
 }  // namespace
 
 }  // namespace testing
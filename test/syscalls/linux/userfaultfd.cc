@@ -0,0 +1,415 @@
+// Copyright 2026 The gVisor Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "test/util/file_descriptor.h"
+#include "test/util/linux_capability_util.h"
+#include "test/util/memory_util.h"
+#include "test/util/posix_error.h"
+#include "test/util/test_util.h"
+#include "test/util/thread_util.h"
+
+namespace gvisor {
+namespace testing {
+
+namespace {
+
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+
+// Wrapper around userfaultfd(2) that returns a FileDescriptor, without
+// performing the UFFDIO_API handshake.
+PosixErrorOr<FileDescriptor> NewUserfaultfd(int flags) {
+  int fd = syscall(SYS_userfaultfd, flags);
+  MaybeSave();
+  if (fd < 0) {
+    return PosixError(errno, "userfaultfd failed");
+  }
+  return FileDescriptor(fd);
+}
+
+// Returns a userfaultfd on which the UFFDIO_API handshake has been performed.
+PosixErrorOr<FileDescriptor> NewUserfaultfdAPI(int flags) {
+  ASSIGN_OR_RETURN_ERRNO(FileDescriptor fd, NewUserfaultfd(flags));
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  RETURN_ERROR_IF_SYSCALL_FAIL(ioctl(fd.get(), UFFDIO_API, &api));
+  return fd;
+}
+
+// Skips the test if userfaultfd(2) is unavailable, which is the case on Linux
+// if it is disabled or restricted to privileged users.
+#define SKIP_IF_NO_USERFAULTFD()                                      \
+  do {                                                                \
+    int fd = syscall(SYS_userfaultfd, O_CLOEXEC);                     \
+    if (fd < 0 && (errno == ENOSYS || errno == EPERM)) {              \
+      GTEST_SKIP() << "userfaultfd unavailable: " << strerror(errno); \
+    }                                                                 \
+    if (fd >= 0) {                                                    \
+      close(fd);                                                      \
+    }                                                                 \
+  } while (0)
+
+// Registers the memory in m with the userfaultfd fd for missing-page faults.
+PosixError Register(int fd, const Mapping& m) {
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  RETURN_ERROR_IF_SYSCALL_FAIL(ioctl(fd, UFFDIO_REGISTER, &reg));
+  return NoError();
+}
+
+// Waits for and returns the next message from the userfaultfd fd.
+PosixErrorOr<struct uffd_msg> ReadMsg(int fd) {
+  struct pollfd pfd = {fd, POLLIN, 0};
+  RETURN_ERROR_IF_SYSCALL_FAIL(RetryEINTR(poll)(&pfd, 1, -1));
+  struct uffd_msg msg;
+  int n = RetryEINTR(read)(fd, &msg, sizeof(msg));
+  if (n < 0) {
+    return PosixError(errno, "read failed");
+  }
+  if (n != sizeof(msg)) {
+    return PosixError(EIO, absl::StrCat("short read: ", n));
+  }
+  return msg;
+}
+
+TEST(UserfaultfdTest, InvalidFlags) {
+  SKIP_IF_NO_USERFAULTFD();
+  EXPECT_THAT(syscall(SYS_userfaultfd, O_RDWR), SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, KernelFaultsRequirePtraceCapability) {
+  // Linux allows unprivileged kernel-mode userfaultfds if
+  // vm.unprivileged_userfaultfd is set.
+  SKIP_IF(!IsRunningOnGvisor());
+  SKIP_IF(!ASSERT_NO_ERRNO_AND_VALUE(HaveCapability(CAP_SYS_PTRACE)));
+
+  AutoCapability cap(CAP_SYS_PTRACE, false);
+  EXPECT_THAT(syscall(SYS_userfaultfd, O_CLOEXEC),
+              SyscallFailsWithErrno(EPERM));
+  ASSERT_NO_ERRNO(NewUserfaultfd(O_CLOEXEC | UFFD_USER_MODE_ONLY));
+}
+
+TEST(UserfaultfdTest, API) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+
+  struct uffdio_api api = {};
+  api.api = UFFD_API;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_API, &api), SyscallSucceeds());
+  constexpr uint64_t kWant = (1ULL << _UFFDIO_REGISTER) |
+                             (1ULL << _UFFDIO_UNREGISTER) |
+                             (1ULL << _UFFDIO_API);
+  EXPECT_EQ(api.ioctls & kWant, kWant);
+
+  // The handshake can only be performed once.
+  api = {};
+  api.api = UFFD_API;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_API, &api),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, InvalidAPI) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+
+  struct uffdio_api api = {};
+  api.api = UFFD_API + 1;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_API, &api),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, RegisterBeforeAPI) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfd(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  EXPECT_THAT(Register(fd.get(), m), PosixErrorIs(EINVAL));
+}
+
+TEST(UserfaultfdTest, Register) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr();
+  reg.range.len = m.len();
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_REGISTER, &reg), SyscallSucceeds());
+  constexpr uint64_t kWant = (1ULL << _UFFDIO_WAKE) |
+                             (1ULL << _UFFDIO_COPY) |
+                             (1ULL << _UFFDIO_ZEROPAGE);
+  EXPECT_EQ(reg.ioctls & kWant, kWant);
+}
+
+TEST(UserfaultfdTest, RegisterUnaligned) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+
+  struct uffdio_register reg = {};
+  reg.range.start = m.addr() + 1;
+  reg.range.len = m.len() - 1;
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_REGISTER, &reg),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, RegisterUnmapped) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  const uintptr_t addr = m.addr();
+  m.reset();
+
+  struct uffdio_register reg = {};
+  reg.range.start = addr;
+  reg.range.len = kPageSize;
+  reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_REGISTER, &reg),
+              SyscallFailsWithErrno(EINVAL));
+}
+
+TEST(UserfaultfdTest, ReadWithoutFaultsWouldBlock) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  struct uffd_msg msg;
+  EXPECT_THAT(read(fd.get(), &msg, sizeof(msg)),
+              SyscallFailsWithErrno(EAGAIN));
+}
+
+TEST(UserfaultfdTest, ReadFaultResolvedByCopy) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(2 * kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  // Fault on the second page, so that the reported address is checked to be
+  // page-aligned.
+  const uintptr_t page = m.addr() + kPageSize;
+  std::atomic<int> got(0);
+  ScopedThread t([&] {
+    got.store(*reinterpret_cast<volatile int*>(page + sizeof(int)));
+  });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadMsg(fd.get()));
+  EXPECT_EQ(msg.event, UFFD_EVENT_PAGEFAULT);
+  EXPECT_EQ(msg.arg.pagefault.address, page);
+  EXPECT_EQ(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WRITE, 0);
+
+  std::vector<int> src(kPageSize / sizeof(int), 0);
+  src[1] = 42;
+  struct uffdio_copy cp = {};
+  cp.dst = page;
+  cp.src = reinterpret_cast<uintptr_t>(src.data());
+  cp.len = kPageSize;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_COPY, &cp), SyscallSucceeds());
+  EXPECT_EQ(cp.copy, kPageSize);
+
+  t.Join();
+  EXPECT_EQ(got.load(), 42);
+}
+
+TEST(UserfaultfdTest, WriteFaultResolvedByZeropage) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  ScopedThread t([&] { *reinterpret_cast<volatile int*>(m.addr()) = 7; });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadMsg(fd.get()));
+  EXPECT_EQ(msg.event, UFFD_EVENT_PAGEFAULT);
+  EXPECT_EQ(msg.arg.pagefault.address, m.addr());
+  EXPECT_NE(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WRITE, 0);
+
+  struct uffdio_zeropage zp = {};
+  zp.range.start = m.addr();
+  zp.range.len = kPageSize;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_ZEROPAGE, &zp), SyscallSucceeds());
+  EXPECT_EQ(zp.zeropage, kPageSize);
+
+  t.Join();
+  EXPECT_EQ(*reinterpret_cast<int*>(m.addr()), 7);
+  EXPECT_EQ(*reinterpret_cast<int*>(m.addr() + sizeof(int)), 0);
+}
+
+TEST(UserfaultfdTest, CopyOverPopulatedPage) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  struct uffdio_zeropage zp = {};
+  zp.range.start = m.addr();
+  zp.range.len = kPageSize;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_ZEROPAGE, &zp), SyscallSucceeds());
+
+  std::vector<char> src(kPageSize, 'a');
+  struct uffdio_copy cp = {};
+  cp.dst = m.addr();
+  cp.src = reinterpret_cast<uintptr_t>(src.data());
+  cp.len = kPageSize;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_COPY, &cp),
+              SyscallFailsWithErrno(EEXIST));
+  EXPECT_EQ(cp.copy, -EEXIST);
+  EXPECT_EQ(*reinterpret_cast<char*>(m.addr()), 0);
+}
+
+TEST(UserfaultfdTest, CopyUnregistered) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+
+  std::vector<char> src(kPageSize, 'a');
+  struct uffdio_copy cp = {};
+  cp.dst = m.addr();
+  cp.src = reinterpret_cast<uintptr_t>(src.data());
+  cp.len = kPageSize;
+  EXPECT_THAT(ioctl(fd.get(), UFFDIO_COPY, &cp),
+              SyscallFailsWithErrno(ENOENT));
+}
+
+TEST(UserfaultfdTest, UnregisterRestoresZeroFill) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  struct uffdio_range rng = {};
+  rng.start = m.addr();
+  rng.len = kPageSize;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_UNREGISTER, &rng), SyscallSucceeds());
+
+  // This would block forever if the page were still registered.
+  EXPECT_EQ(*reinterpret_cast<volatile int*>(m.addr()), 0);
+}
+
+// Accesses to registered memory by syscalls also wait for userspace.
+TEST(UserfaultfdTest, SyscallFaultResolvedByCopy) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  int pipefds[2];
+  ASSERT_THAT(pipe2(pipefds, O_CLOEXEC), SyscallSucceeds());
+  const FileDescriptor rfd(pipefds[0]);
+  const FileDescriptor wfd(pipefds[1]);
+
+  // write(2) reads from the registered page.
+  ScopedThread t([&] {
+    TEST_PCHECK(write(wfd.get(), m.ptr(), kPageSize) ==
+                static_cast<ssize_t>(kPageSize));
+  });
+
+  const struct uffd_msg msg = ASSERT_NO_ERRNO_AND_VALUE(ReadMsg(fd.get()));
+  EXPECT_EQ(msg.arg.pagefault.address, m.addr());
+
+  std::vector<char> src(kPageSize, 'x');
+  struct uffdio_copy cp = {};
+  cp.dst = m.addr();
+  cp.src = reinterpret_cast<uintptr_t>(src.data());
+  cp.len = kPageSize;
+  ASSERT_THAT(ioctl(fd.get(), UFFDIO_COPY, &cp), SyscallSucceeds());
+  t.Join();
+
+  std::vector<char> buf(kPageSize);
+  ASSERT_THAT(ReadFd(rfd.get(), buf.data(), buf.size()),
+              SyscallSucceedsWithValue(kPageSize));
+  EXPECT_EQ(buf, src);
+}
+
+TEST(UserfaultfdTest, UserModeOnlySyscallFaultFails) {
+  SKIP_IF_NO_USERFAULTFD();
+  const FileDescriptor fd = ASSERT_NO_ERRNO_AND_VALUE(
+      NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  int pipefds[2];
+  ASSERT_THAT(pipe2(pipefds, O_CLOEXEC), SyscallSucceeds());
+  const FileDescriptor rfd(pipefds[0]);
+  const FileDescriptor wfd(pipefds[1]);
+  EXPECT_THAT(write(wfd.get(), m.ptr(), kPageSize),
+              SyscallFailsWithErrno(EFAULT));
+}
+
+TEST(UserfaultfdTest, CloseWakesFaults) {
+  SKIP_IF_NO_USERFAULTFD();
+  FileDescriptor fd =
+      ASSERT_NO_ERRNO_AND_VALUE(NewUserfaultfdAPI(O_CLOEXEC | O_NONBLOCK));
+  const Mapping m = ASSERT_NO_ERRNO_AND_VALUE(
+      MmapAnon(kPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE));
+  ASSERT_NO_ERRNO(Register(fd.get(), m));
+
+  std::atomic<int> got(-1);
+  ScopedThread t(
+      [&] { got.store(*reinterpret_cast<volatile int*>(m.addr())); });
+  ASSERT_NO_ERRNO(ReadMsg(fd.get()));
+
+  // Closing the userfaultfd unregisters the memory, so the fault is resolved
+  // with a zeroed page.
+  fd.reset();
+  t.Join();
+  EXPECT_EQ(got.load(), 0);
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace gvisor